@@ -0,0 +1,64 @@
+// The 16-byte sprite layout of CompactSpriteInstance in Common.h
+struct CompactSpriteData
+{
+	uint PositionXY; // Half floats
+	uint ScaleXY; // Half floats
+	uint RotationRegion; // Fraction of a turn in the low 16 bits, atlas region index in the high 16 bits
+	uint Color; // RGBA8
+};
+
+struct Output
+{
+	float2 Texcoord : TEXCOORD0;
+	float4 Color : TEXCOORD1;
+	float4 Position : SV_Position;
+};
+
+// WARNING: StructuredBuffers are not natively supported by SDL's GPU API.
+// They will work with SDL_shadercross because it does special processing to
+// support them, but not with direct compilation via dxc.
+// See https://github.com/libsdl-org/SDL/issues/12200 for details.
+StructuredBuffer<CompactSpriteData> DataBuffer : register(t0, space0);
+StructuredBuffer<float4> AtlasRegions : register(t1, space0); // U, V, W, H
+
+cbuffer UniformBlock : register(b0, space1)
+{
+	float4x4 ViewProjectionMatrix : packoffset(c0);
+};
+
+static const uint triangleIndices[6] = {0, 1, 2, 3, 2, 1};
+static const float2 vertexPos[4] = {
+	{0.0f, 0.0f},
+	{1.0f, 0.0f},
+	{0.0f, 1.0f},
+	{1.0f, 1.0f}
+};
+
+Output main(uint id : SV_VertexID)
+{
+	uint spriteIndex = id / 6;
+	uint vert = triangleIndices[id % 6];
+	CompactSpriteData sprite = DataBuffer[spriteIndex];
+
+	float2 position = f16tof32(uint2(sprite.PositionXY, sprite.PositionXY >> 16));
+	float2 scale = f16tof32(uint2(sprite.ScaleXY, sprite.ScaleXY >> 16));
+	float angle = (sprite.RotationRegion & 0xFFFF) * (6.28318530718f / 65536.0f);
+	float4 region = AtlasRegions[sprite.RotationRegion >> 16];
+	uint4 color = uint4(sprite.Color, sprite.Color >> 8, sprite.Color >> 16, sprite.Color >> 24) & 0xFF;
+
+	float c = cos(angle);
+	float s = sin(angle);
+
+	float2 coord = vertexPos[vert];
+	coord *= scale;
+	float2x2 rotation = {c, s, -s, c};
+	coord = mul(coord, rotation);
+
+	Output output;
+
+	output.Position = mul(ViewProjectionMatrix, float4(coord + position, 0.0f, 1.0f));
+	output.Texcoord = region.xy + vertexPos[vert] * region.zw;
+	output.Color = color / 255.0f;
+
+	return output;
+}
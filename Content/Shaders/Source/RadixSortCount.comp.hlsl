@@ -0,0 +1,40 @@
+// Pass 1 of 3 of a radix sort pass over 4 bits: counts each digit in a block of 1024 keys.
+// The histogram is stored digit-major, so one exclusive scan over it gives every block the
+// first output slot of each of its digits.
+StructuredBuffer<uint> Keys : register(t0, space0);
+RWStructuredBuffer<uint> Histograms : register(u0, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	uint KeyCount : packoffset(c0.x);
+	uint Shift : packoffset(c0.y);
+	uint GroupCount : packoffset(c0.z);
+};
+
+groupshared uint DigitCounts[16];
+
+[numthreads(256, 1, 1)]
+void main(uint3 GroupID : SV_GroupID, uint GroupIndex : SV_GroupIndex)
+{
+	if (GroupIndex < 16)
+	{
+		DigitCounts[GroupIndex] = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	uint blockStart = GroupID.x * 1024;
+	for (uint i = 0; i < 4; i += 1)
+	{
+		uint index = blockStart + i * 256 + GroupIndex;
+		if (index < KeyCount)
+		{
+			InterlockedAdd(DigitCounts[(Keys[index] >> Shift) & 15], 1);
+		}
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (GroupIndex < 16)
+	{
+		Histograms[GroupIndex * GroupCount + GroupID.x] = DigitCounts[GroupIndex];
+	}
+}
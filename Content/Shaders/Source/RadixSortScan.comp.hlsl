@@ -0,0 +1,46 @@
+// Pass 2 of 3: an exclusive prefix sum over the whole histogram, in place, by a single group.
+// Each thread sums a contiguous run, the run totals are scanned in shared memory, then each
+// thread writes its run's offsets.
+RWStructuredBuffer<uint> Histograms : register(u0, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	uint KeyCount : packoffset(c0.x);
+	uint Shift : packoffset(c0.y);
+	uint GroupCount : packoffset(c0.z);
+};
+
+groupshared uint RunTotals[256];
+
+[numthreads(256, 1, 1)]
+void main(uint GroupIndex : SV_GroupIndex)
+{
+	uint length = GroupCount * 16;
+	uint runLength = (length + 255) / 256;
+	uint start = min(GroupIndex * runLength, length);
+	uint end = min(start + runLength, length);
+
+	uint total = 0;
+	for (uint i = start; i < end; i += 1)
+	{
+		total += Histograms[i];
+	}
+	RunTotals[GroupIndex] = total;
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint offset = 1; offset < 256; offset <<= 1)
+	{
+		uint previous = GroupIndex >= offset ? RunTotals[GroupIndex - offset] : 0;
+		GroupMemoryBarrierWithGroupSync();
+		RunTotals[GroupIndex] += previous;
+		GroupMemoryBarrierWithGroupSync();
+	}
+
+	uint running = RunTotals[GroupIndex] - total;
+	for (uint j = start; j < end; j += 1)
+	{
+		uint count = Histograms[j];
+		Histograms[j] = running;
+		running += count;
+	}
+}
@@ -0,0 +1,90 @@
+// Pass 3 of 3: moves every key/value pair to its sorted position for this digit. Each thread
+// owns four consecutive keys of the block and ranks them in order, so equal digits keep their
+// relative order and the whole sort is stable.
+StructuredBuffer<uint> KeysIn : register(t0, space0);
+StructuredBuffer<uint> ValuesIn : register(t1, space0);
+StructuredBuffer<uint> Offsets : register(t2, space0); // The scanned histogram
+RWStructuredBuffer<uint> KeysOut : register(u0, space1);
+RWStructuredBuffer<uint> ValuesOut : register(u1, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	uint KeyCount : packoffset(c0.x);
+	uint Shift : packoffset(c0.y);
+	uint GroupCount : packoffset(c0.z);
+};
+
+groupshared uint Ranks[16 * 256]; // Digit-major: [digit * 256 + thread]
+groupshared uint RunTotals[256];
+groupshared uint DigitStarts[16];
+
+[numthreads(256, 1, 1)]
+void main(uint3 GroupID : SV_GroupID, uint GroupIndex : SV_GroupIndex)
+{
+	for (uint d = 0; d < 16; d += 1)
+	{
+		Ranks[d * 256 + GroupIndex] = 0;
+	}
+
+	uint first = GroupID.x * 1024 + GroupIndex * 4;
+	uint keys[4];
+	uint digits[4];
+	for (uint i = 0; i < 4; i += 1)
+	{
+		uint index = first + i;
+		keys[i] = index < KeyCount ? KeysIn[index] : 0;
+		digits[i] = index < KeyCount ? (keys[i] >> Shift) & 15 : 16;
+		if (digits[i] < 16)
+		{
+			Ranks[digits[i] * 256 + GroupIndex] += 1;
+		}
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	// Exclusive scan of the counts, as in RadixSortScan.comp. Afterwards each entry is the
+	// position within the block of the thread's first key with that digit.
+	uint total = 0;
+	for (uint j = 0; j < 16; j += 1)
+	{
+		total += Ranks[GroupIndex * 16 + j];
+	}
+	RunTotals[GroupIndex] = total;
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint offset = 1; offset < 256; offset <<= 1)
+	{
+		uint previous = GroupIndex >= offset ? RunTotals[GroupIndex - offset] : 0;
+		GroupMemoryBarrierWithGroupSync();
+		RunTotals[GroupIndex] += previous;
+		GroupMemoryBarrierWithGroupSync();
+	}
+
+	uint running = RunTotals[GroupIndex] - total;
+	for (uint k = 0; k < 16; k += 1)
+	{
+		uint count = Ranks[GroupIndex * 16 + k];
+		Ranks[GroupIndex * 16 + k] = running;
+		running += count;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (GroupIndex < 16)
+	{
+		DigitStarts[GroupIndex] = Ranks[GroupIndex * 256];
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint n = 0; n < 4; n += 1)
+	{
+		uint digit = digits[n];
+		if (digit < 16)
+		{
+			uint rank = Ranks[digit * 256 + GroupIndex];
+			Ranks[digit * 256 + GroupIndex] = rank + 1;
+
+			uint destination = Offsets[digit * GroupCount + GroupID.x] + rank - DigitStarts[digit];
+			KeysOut[destination] = keys[n];
+			ValuesOut[destination] = ValuesIn[first + n];
+		}
+	}
+}
@@ -18,10 +18,19 @@ struct SpriteVertex
 StructuredBuffer<SpriteComputeData> ComputeBuffer : register(t0, space0);
 RWStructuredBuffer<SpriteVertex> VertexBuffer : register(u0, space1);
 
+cbuffer UBO : register(b0, space2)
+{
+	uint SpriteCount : packoffset(c0.x);
+};
+
 [numthreads(64, 1, 1)]
 void main(uint3 GlobalInvocationID : SV_DispatchThreadID)
 {
 	uint n = GlobalInvocationID.x;
+	if (n >= SpriteCount)
+	{
+		return;
+	}
 
 	SpriteComputeData sprite = ComputeBuffer[n];
 
@@ -0,0 +1,64 @@
+// The 16-byte sprite layout of CompactSpriteInstance in Common.h
+struct CompactSpriteData
+{
+	uint PositionXY; // Half floats
+	uint ScaleXY; // Half floats
+	uint RotationRegion; // Fraction of a turn in the low 16 bits, atlas region index in the high 16 bits
+	uint Color; // RGBA8
+};
+
+struct SpriteVertex
+{
+	float4 Position;
+	float2 Texcoord;
+	float4 Color;
+};
+
+StructuredBuffer<CompactSpriteData> ComputeBuffer : register(t0, space0);
+StructuredBuffer<float4> AtlasRegions : register(t1, space0); // U, V, W, H
+RWStructuredBuffer<SpriteVertex> VertexBuffer : register(u0, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	uint SpriteCount : packoffset(c0.x);
+};
+
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID)
+{
+	uint n = GlobalInvocationID.x;
+	if (n >= SpriteCount)
+	{
+		return;
+	}
+
+	CompactSpriteData sprite = ComputeBuffer[n];
+
+	float2 position = f16tof32(uint2(sprite.PositionXY, sprite.PositionXY >> 16));
+	float2 scale = f16tof32(uint2(sprite.ScaleXY, sprite.ScaleXY >> 16));
+	float angle = (sprite.RotationRegion & 0xFFFF) * (6.28318530718f / 65536.0f);
+	float4 region = AtlasRegions[sprite.RotationRegion >> 16];
+	float4 color = (uint4(sprite.Color, sprite.Color >> 8, sprite.Color >> 16, sprite.Color >> 24) & 0xFF) / 255.0f;
+
+	float c = cos(angle);
+	float s = sin(angle);
+
+	// Scale, then rotate, then translate, as in SpriteBatch.comp
+	float2 xAxis = float2(c, s) * scale.x;
+	float2 yAxis = float2(-s, c) * scale.y;
+
+	VertexBuffer[n * 4u]    .Position = float4(position, 0.0f, 1.0f);
+	VertexBuffer[n * 4u + 1].Position = float4(position + xAxis, 0.0f, 1.0f);
+	VertexBuffer[n * 4u + 2].Position = float4(position + yAxis, 0.0f, 1.0f);
+	VertexBuffer[n * 4u + 3].Position = float4(position + xAxis + yAxis, 0.0f, 1.0f);
+
+	VertexBuffer[n * 4u]    .Texcoord = region.xy;
+	VertexBuffer[n * 4u + 1].Texcoord = region.xy + float2(region.z, 0.0f);
+	VertexBuffer[n * 4u + 2].Texcoord = region.xy + float2(0.0f, region.w);
+	VertexBuffer[n * 4u + 3].Texcoord = region.xy + region.zw;
+
+	VertexBuffer[n * 4u]    .Color = color;
+	VertexBuffer[n * 4u + 1].Color = color;
+	VertexBuffer[n * 4u + 2].Color = color;
+	VertexBuffer[n * 4u + 3].Color = color;
+}
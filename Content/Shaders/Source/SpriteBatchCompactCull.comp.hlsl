@@ -0,0 +1,134 @@
+// The 16-byte sprite layout of CompactSpriteInstance in Common.h
+struct CompactSpriteData
+{
+	uint PositionXY; // Half floats
+	uint ScaleXY; // Half floats
+	uint RotationRegion; // Fraction of a turn in the low 16 bits, atlas region index in the high 16 bits
+	uint Color; // RGBA8
+};
+
+struct SpriteVertex
+{
+	float4 Position;
+	float2 Texcoord;
+	float4 Color;
+};
+
+StructuredBuffer<CompactSpriteData> ComputeBuffer : register(t0, space0);
+StructuredBuffer<float4> AtlasRegions : register(t1, space0); // U, V, W, H
+RWStructuredBuffer<SpriteVertex> VertexBuffer : register(u0, space1);
+RWStructuredBuffer<uint> DrawCommands : register(u1, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	float4x4 ViewProjection : packoffset(c0);
+	uint SpriteCount : packoffset(c4.x);
+};
+
+groupshared uint GroupVisibleCount;
+groupshared uint GroupFirstSprite;
+
+// DrawCommands holds the visible sprite count, then one SDL_GPUIndexedIndirectDrawCommand per
+// chunk of 16384 sprites, as the shared index buffer's 16-bit indices reach 65536 vertices.
+// A range of up to 64 sprites spans at most two chunks.
+#define SPRITE_CHUNK_SIZE 16384
+#define COMMAND_STRIDE 5 // uints
+
+void CountChunkIndices(uint firstSprite, uint count)
+{
+	uint chunk = firstSprite / SPRITE_CHUNK_SIZE;
+	uint firstChunkCount = min(count, (chunk + 1) * SPRITE_CHUNK_SIZE - firstSprite);
+	InterlockedAdd(DrawCommands[1 + chunk * COMMAND_STRIDE], firstChunkCount * 6);
+	if (firstChunkCount < count)
+	{
+		InterlockedAdd(DrawCommands[1 + (chunk + 1) * COMMAND_STRIDE], (count - firstChunkCount) * 6);
+	}
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+	uint n = GlobalInvocationID.x;
+
+	if (GroupIndex == 0)
+	{
+		GroupVisibleCount = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	float4 corners[4];
+	float4 region = 0.0f.xxxx;
+	float4 color = 0.0f.xxxx;
+	bool visible = false;
+	if (n < SpriteCount)
+	{
+		CompactSpriteData sprite = ComputeBuffer[n];
+
+		float2 position = f16tof32(uint2(sprite.PositionXY, sprite.PositionXY >> 16));
+		float2 scale = f16tof32(uint2(sprite.ScaleXY, sprite.ScaleXY >> 16));
+		float angle = (sprite.RotationRegion & 0xFFFF) * (6.28318530718f / 65536.0f);
+		region = AtlasRegions[sprite.RotationRegion >> 16];
+		color = (uint4(sprite.Color, sprite.Color >> 8, sprite.Color >> 16, sprite.Color >> 24) & 0xFF) / 255.0f;
+
+		// Scale, then rotate, then translate, as in SpriteBatch.comp
+		float c = cos(angle);
+		float s = sin(angle);
+		float2 xAxis = float2(c, s) * scale.x;
+		float2 yAxis = float2(-s, c) * scale.y;
+
+		corners[0] = float4(position, 0.0f, 1.0f);
+		corners[1] = float4(position + xAxis, 0.0f, 1.0f);
+		corners[2] = float4(position + yAxis, 0.0f, 1.0f);
+		corners[3] = float4(position + xAxis + yAxis, 0.0f, 1.0f);
+
+		// Keep the sprite unless its clip-space bounds miss the view rectangle
+		float2 clipMin = mul(ViewProjection, corners[0]).xy;
+		float2 clipMax = clipMin;
+		for (uint i = 1; i < 4; i += 1)
+		{
+			float2 clip = mul(ViewProjection, corners[i]).xy;
+			clipMin = min(clipMin, clip);
+			clipMax = max(clipMax, clip);
+		}
+		visible = all(clipMax >= -1.0f) && all(clipMin <= 1.0f);
+	}
+
+	// Compacted as in SpriteBatchCull.comp
+	uint groupSlot = 0;
+	if (visible)
+	{
+		InterlockedAdd(GroupVisibleCount, 1, groupSlot);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (GroupIndex == 0 && GroupVisibleCount > 0)
+	{
+		uint firstSprite;
+		InterlockedAdd(DrawCommands[0], GroupVisibleCount, firstSprite);
+		CountChunkIndices(firstSprite, GroupVisibleCount);
+		GroupFirstSprite = firstSprite;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (!visible)
+	{
+		return;
+	}
+
+	uint v = (GroupFirstSprite + groupSlot) * 4u;
+
+	VertexBuffer[v]    .Position = corners[0];
+	VertexBuffer[v + 1].Position = corners[1];
+	VertexBuffer[v + 2].Position = corners[2];
+	VertexBuffer[v + 3].Position = corners[3];
+
+	VertexBuffer[v]    .Texcoord = region.xy;
+	VertexBuffer[v + 1].Texcoord = region.xy + float2(region.z, 0.0f);
+	VertexBuffer[v + 2].Texcoord = region.xy + float2(0.0f, region.w);
+	VertexBuffer[v + 3].Texcoord = region.xy + region.zw;
+
+	VertexBuffer[v]    .Color = color;
+	VertexBuffer[v + 1].Color = color;
+	VertexBuffer[v + 2].Color = color;
+	VertexBuffer[v + 3].Color = color;
+}
@@ -0,0 +1,128 @@
+struct SpriteComputeData
+{
+	float3 Position;
+	float Rotation;
+	float2 Scale;
+	float2 Padding;
+	float TexU, TexV, TexW, TexH;
+	float4 Color;
+};
+
+struct SpriteVertex
+{
+	float4 Position;
+	float2 Texcoord;
+	float4 Color;
+};
+
+StructuredBuffer<SpriteComputeData> ComputeBuffer : register(t0, space0);
+RWStructuredBuffer<SpriteVertex> VertexBuffer : register(u0, space1);
+RWStructuredBuffer<uint> DrawCommands : register(u1, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	float4x4 ViewProjection : packoffset(c0);
+	uint SpriteCount : packoffset(c4.x);
+};
+
+groupshared uint GroupVisibleCount;
+groupshared uint GroupFirstSprite;
+
+// DrawCommands holds the visible sprite count, then one SDL_GPUIndexedIndirectDrawCommand per
+// chunk of 16384 sprites, as the shared index buffer's 16-bit indices reach 65536 vertices.
+// A range of up to 64 sprites spans at most two chunks.
+#define SPRITE_CHUNK_SIZE 16384
+#define COMMAND_STRIDE 5 // uints
+
+void CountChunkIndices(uint firstSprite, uint count)
+{
+	uint chunk = firstSprite / SPRITE_CHUNK_SIZE;
+	uint firstChunkCount = min(count, (chunk + 1) * SPRITE_CHUNK_SIZE - firstSprite);
+	InterlockedAdd(DrawCommands[1 + chunk * COMMAND_STRIDE], firstChunkCount * 6);
+	if (firstChunkCount < count)
+	{
+		InterlockedAdd(DrawCommands[1 + (chunk + 1) * COMMAND_STRIDE], (count - firstChunkCount) * 6);
+	}
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+	uint n = GlobalInvocationID.x;
+
+	if (GroupIndex == 0)
+	{
+		GroupVisibleCount = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	// Scale, then rotate, then translate, as in SpriteBatch.comp
+	float4 corners[4];
+	bool visible = false;
+	SpriteComputeData sprite = (SpriteComputeData) 0;
+	if (n < SpriteCount)
+	{
+		sprite = ComputeBuffer[n];
+
+		float c = cos(sprite.Rotation);
+		float s = sin(sprite.Rotation);
+		float3 xAxis = float3(c, s, 0.0f) * sprite.Scale.x;
+		float3 yAxis = float3(-s, c, 0.0f) * sprite.Scale.y;
+
+		corners[0] = float4(sprite.Position, 1.0f);
+		corners[1] = float4(sprite.Position + xAxis, 1.0f);
+		corners[2] = float4(sprite.Position + yAxis, 1.0f);
+		corners[3] = float4(sprite.Position + xAxis + yAxis, 1.0f);
+
+		// Keep the sprite unless its clip-space bounds miss the view rectangle
+		float2 clipMin = mul(ViewProjection, corners[0]).xy;
+		float2 clipMax = clipMin;
+		for (uint i = 1; i < 4; i += 1)
+		{
+			float2 clip = mul(ViewProjection, corners[i]).xy;
+			clipMin = min(clipMin, clip);
+			clipMax = max(clipMax, clip);
+		}
+		visible = all(clipMax >= -1.0f) && all(clipMin <= 1.0f);
+	}
+
+	// Compact the survivors: one slot per visible sprite within the group, then one global
+	// atomic per group. Groups land in any order, so the draw order of sprites varies.
+	uint groupSlot = 0;
+	if (visible)
+	{
+		InterlockedAdd(GroupVisibleCount, 1, groupSlot);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (GroupIndex == 0 && GroupVisibleCount > 0)
+	{
+		uint firstSprite;
+		InterlockedAdd(DrawCommands[0], GroupVisibleCount, firstSprite);
+		CountChunkIndices(firstSprite, GroupVisibleCount);
+		GroupFirstSprite = firstSprite;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (!visible)
+	{
+		return;
+	}
+
+	uint v = (GroupFirstSprite + groupSlot) * 4u;
+
+	VertexBuffer[v]    .Position = corners[0];
+	VertexBuffer[v + 1].Position = corners[1];
+	VertexBuffer[v + 2].Position = corners[2];
+	VertexBuffer[v + 3].Position = corners[3];
+
+	VertexBuffer[v]    .Texcoord = float2(sprite.TexU,               sprite.TexV);
+	VertexBuffer[v + 1].Texcoord = float2(sprite.TexU + sprite.TexW, sprite.TexV);
+	VertexBuffer[v + 2].Texcoord = float2(sprite.TexU,               sprite.TexV + sprite.TexH);
+	VertexBuffer[v + 3].Texcoord = float2(sprite.TexU + sprite.TexW, sprite.TexV + sprite.TexH);
+
+	VertexBuffer[v]    .Color = sprite.Color;
+	VertexBuffer[v + 1].Color = sprite.Color;
+	VertexBuffer[v + 2].Color = sprite.Color;
+	VertexBuffer[v + 3].Color = sprite.Color;
+}
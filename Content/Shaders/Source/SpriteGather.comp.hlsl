@@ -0,0 +1,28 @@
+struct SpriteComputeData
+{
+	float3 Position;
+	float Rotation;
+	float2 Scale;
+	float2 Padding;
+	float TexU, TexV, TexW, TexH;
+	float4 Color;
+};
+
+StructuredBuffer<SpriteComputeData> ComputeBuffer : register(t0, space0);
+StructuredBuffer<uint> Order : register(t1, space0); // Sorted sprite indices
+RWStructuredBuffer<SpriteComputeData> SortedBuffer : register(u0, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	uint SpriteCount : packoffset(c0.x);
+};
+
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID)
+{
+	uint n = GlobalInvocationID.x;
+	if (n < SpriteCount)
+	{
+		SortedBuffer[n] = ComputeBuffer[Order[n]];
+	}
+}
@@ -0,0 +1,61 @@
+// The layouts of SpriteInstance and SpriteMotion in Common.h
+struct SpriteComputeData
+{
+	float3 Position;
+	float Rotation;
+	float2 Scale;
+	float2 Padding;
+	float TexU, TexV, TexW, TexH;
+	float4 Color;
+};
+
+struct SpriteMotion
+{
+	float2 Velocity;
+	float Spin;
+	float Hue;
+};
+
+RWStructuredBuffer<SpriteComputeData> Sprites : register(u0, space1);
+RWStructuredBuffer<SpriteMotion> Motions : register(u1, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+	float DeltaTime : packoffset(c0.x);
+	uint SpriteCount : packoffset(c0.y);
+	float2 AreaSize : packoffset(c0.z);
+};
+
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID)
+{
+	uint n = GlobalInvocationID.x;
+	if (n >= SpriteCount)
+	{
+		return;
+	}
+
+	SpriteComputeData sprite = Sprites[n];
+	SpriteMotion motion = Motions[n];
+
+	// Bounce off the edges, keeping the sprite's origin where the whole sprite would fit
+	float2 limit = max(AreaSize - sprite.Scale, 0.0f.xx);
+	float2 position = sprite.Position.xy + motion.Velocity * DeltaTime;
+	if (position.x < 0.0f || position.x > limit.x)
+	{
+		motion.Velocity.x = -motion.Velocity.x;
+	}
+	if (position.y < 0.0f || position.y > limit.y)
+	{
+		motion.Velocity.y = -motion.Velocity.y;
+	}
+	sprite.Position.xy = clamp(position, 0.0f.xx, limit);
+
+	sprite.Rotation = fmod(sprite.Rotation + motion.Spin * DeltaTime, 6.28318530718f);
+
+	motion.Hue = frac(motion.Hue + DeltaTime * 0.25f);
+	sprite.Color.rgb = 0.5f.xxx + cos(6.28318530718f * (motion.Hue.xxx + float3(0.0f, 0.666667f, 0.333333f))) * 0.5f;
+
+	Sprites[n] = sprite;
+	Motions[n] = motion;
+}
@@ -0,0 +1,104 @@
+struct SpriteComputeData
+{
+	float3 Position;
+	float Rotation;
+	float2 Scale;
+	float2 Padding;
+	float TexU, TexV, TexW, TexH;
+	float4 Color;
+};
+
+StructuredBuffer<SpriteComputeData> ComputeBuffer : register(t0, space0);
+RWStructuredBuffer<uint> Keys : register(u0, space1);
+RWStructuredBuffer<uint> Values : register(u1, space1);
+RWStructuredBuffer<uint> DrawCommands : register(u2, space1); // As in SpriteBatchCull.comp
+
+cbuffer UBO : register(b0, space2)
+{
+	float4x4 ViewProjection : packoffset(c0);
+	uint SpriteCount : packoffset(c4.x);
+	uint CullSprites : packoffset(c4.y);
+};
+
+groupshared uint GroupVisibleCount;
+
+#define SPRITE_CHUNK_SIZE 16384
+#define COMMAND_STRIDE 5 // uints
+
+void CountChunkIndices(uint firstSprite, uint count)
+{
+	uint chunk = firstSprite / SPRITE_CHUNK_SIZE;
+	uint firstChunkCount = min(count, (chunk + 1) * SPRITE_CHUNK_SIZE - firstSprite);
+	InterlockedAdd(DrawCommands[1 + chunk * COMMAND_STRIDE], firstChunkCount * 6);
+	if (firstChunkCount < count)
+	{
+		InterlockedAdd(DrawCommands[1 + (chunk + 1) * COMMAND_STRIDE], (count - firstChunkCount) * 6);
+	}
+}
+
+// Sorts back to front by z (1 is furthest), then by atlas cell so that neighbours in the
+// batch sample the same part of the texture. Culled sprites get bit 23 and sort last, so the
+// visible sprites stay in order at the front of the batch. Keys use 24 bits, or 6 sort passes.
+// Where each group's visible sprites are counted does not matter, as the sorted batch puts
+// them all first: the ranges handed out by the counter add up to the right chunk sizes.
+[numthreads(64, 1, 1)]
+void main(uint3 GlobalInvocationID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+	uint n = GlobalInvocationID.x;
+
+	if (GroupIndex == 0)
+	{
+		GroupVisibleCount = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (n < SpriteCount)
+	{
+		SpriteComputeData sprite = ComputeBuffer[n];
+
+		uint depth = (uint) ((1.0f - saturate(sprite.Position.z)) * 2097151.0f); // 21 bits
+		uint cell = (sprite.TexV >= 0.5f ? 2 : 0) + (sprite.TexU >= 0.5f ? 1 : 0);
+		uint key = (depth << 2) | cell;
+
+		if (CullSprites != 0)
+		{
+			// The same test as SpriteBatchCull.comp
+			float c = cos(sprite.Rotation);
+			float s = sin(sprite.Rotation);
+			float3 xAxis = float3(c, s, 0.0f) * sprite.Scale.x;
+			float3 yAxis = float3(-s, c, 0.0f) * sprite.Scale.y;
+
+			float2 clipMin = mul(ViewProjection, float4(sprite.Position, 1.0f)).xy;
+			float2 clipMax = clipMin;
+			float2 clip = mul(ViewProjection, float4(sprite.Position + xAxis, 1.0f)).xy;
+			clipMin = min(clipMin, clip);
+			clipMax = max(clipMax, clip);
+			clip = mul(ViewProjection, float4(sprite.Position + yAxis, 1.0f)).xy;
+			clipMin = min(clipMin, clip);
+			clipMax = max(clipMax, clip);
+			clip = mul(ViewProjection, float4(sprite.Position + xAxis + yAxis, 1.0f)).xy;
+			clipMin = min(clipMin, clip);
+			clipMax = max(clipMax, clip);
+
+			if (all(clipMax >= -1.0f) && all(clipMin <= 1.0f))
+			{
+				InterlockedAdd(GroupVisibleCount, 1);
+			}
+			else
+			{
+				key |= 0x800000;
+			}
+		}
+
+		Keys[n] = key;
+		Values[n] = n;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (GroupIndex == 0 && GroupVisibleCount > 0)
+	{
+		uint firstSprite;
+		InterlockedAdd(DrawCommands[0], GroupVisibleCount, firstSprite);
+		CountChunkIndices(firstSprite, GroupVisibleCount);
+	}
+}
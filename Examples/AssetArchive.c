@@ -0,0 +1,472 @@
+#include "Common.h"
+
+#if defined(SDL_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(SDL_PLATFORM_UNIX) || defined(SDL_PLATFORM_APPLE)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSET_ARCHIVE_MMAP 1
+#endif
+
+// Asset Archive
+// A single file holding every asset: a header, a table of contents sorted by name,
+// a string table, and then each payload at a 4 KiB-aligned offset. The file is
+// mapped into memory, so lookups are a binary search and payloads are never copied.
+// All fields are little-endian.
+
+#define ASSET_ARCHIVE_MAGIC SDL_FOURCC('S', 'G', 'P', 'K')
+#define ASSET_ARCHIVE_VERSION 1
+#define ASSET_ARCHIVE_ALIGNMENT 4096
+
+typedef struct AssetArchiveHeader
+{
+	Uint32 Magic;
+	Uint32 Version;
+	Uint32 EntryCount;
+	Uint32 StringTableSize;
+} AssetArchiveHeader;
+
+typedef struct AssetArchiveEntry
+{
+	Uint32 NameOffset;
+	Uint32 NameLength;
+	Uint32 Type;
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 Pitch;
+	Uint64 DataOffset;
+	Uint64 DataSize;
+} AssetArchiveEntry;
+
+typedef struct AssetArchive
+{
+	const Uint8* Data;
+	size_t Size;
+	bool IsMapped;
+#if defined(SDL_PLATFORM_WINDOWS)
+	HANDLE File;
+	HANDLE Mapping;
+#endif
+	const AssetArchiveEntry* Entries;
+	Uint32 EntryCount;
+	const char* Strings;
+} AssetArchive;
+
+static AssetArchive Archive;
+
+static bool MapArchiveFile(const char* path)
+{
+#if defined(SDL_PLATFORM_WINDOWS)
+	Archive.File = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (Archive.File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(Archive.File, &size);
+	Archive.Mapping = CreateFileMappingA(Archive.File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (Archive.Mapping == NULL)
+	{
+		CloseHandle(Archive.File);
+		return false;
+	}
+
+	Archive.Data = MapViewOfFile(Archive.Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (Archive.Data == NULL)
+	{
+		CloseHandle(Archive.Mapping);
+		CloseHandle(Archive.File);
+		return false;
+	}
+	Archive.Size = (size_t)size.QuadPart;
+	Archive.IsMapped = true;
+	return true;
+#elif defined(ASSET_ARCHIVE_MMAP)
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	Archive.Data = data;
+	Archive.Size = info.st_size;
+	Archive.IsMapped = true;
+	return true;
+#else
+	(void)path;
+	return false;
+#endif
+}
+
+static void UnmapArchiveFile()
+{
+	if (Archive.IsMapped)
+	{
+#if defined(SDL_PLATFORM_WINDOWS)
+		UnmapViewOfFile(Archive.Data);
+		CloseHandle(Archive.Mapping);
+		CloseHandle(Archive.File);
+#elif defined(ASSET_ARCHIVE_MMAP)
+		munmap((void*)Archive.Data, Archive.Size);
+#endif
+	}
+	else
+	{
+		SDL_free((void*)Archive.Data);
+	}
+}
+
+bool MountAssetArchive(const char* archiveFilename)
+{
+	UnmountAssetArchive();
+
+	char fullPath[256];
+	SDL_snprintf(fullPath, sizeof(fullPath), "%s%s", SDL_GetBasePath(), archiveFilename);
+
+	// Fall back to reading the whole file where it can't be mapped (e.g. Android assets)
+	if (!MapArchiveFile(fullPath))
+	{
+		size_t size;
+		Archive.Data = SDL_LoadFile(fullPath, &size);
+		if (Archive.Data == NULL)
+		{
+			return false;
+		}
+		Archive.Size = size;
+	}
+
+	const AssetArchiveHeader* header = (const AssetArchiveHeader*)Archive.Data;
+	Uint64 tableSize = Archive.Size >= sizeof(AssetArchiveHeader) ?
+		sizeof(AssetArchiveHeader) + (Uint64)header->EntryCount * sizeof(AssetArchiveEntry) + header->StringTableSize :
+		SDL_MAX_UINT64;
+	if (tableSize > Archive.Size || header->Magic != ASSET_ARCHIVE_MAGIC || header->Version != ASSET_ARCHIVE_VERSION)
+	{
+		SDL_Log("%s is not a valid asset archive!", fullPath);
+		UnmountAssetArchive();
+		return false;
+	}
+
+	Archive.EntryCount = header->EntryCount;
+	Archive.Entries = (const AssetArchiveEntry*)(header + 1);
+	Archive.Strings = (const char*)(Archive.Entries + Archive.EntryCount);
+
+	// Lookups index straight into the mapping, so every name and payload has to lie inside it
+	for (Uint32 i = 0; i < Archive.EntryCount; i += 1)
+	{
+		const AssetArchiveEntry* entry = &Archive.Entries[i];
+		if ((Uint64)entry->NameOffset + entry->NameLength > header->StringTableSize ||
+			entry->DataOffset < tableSize || entry->DataOffset > Archive.Size || entry->DataSize > Archive.Size - entry->DataOffset)
+		{
+			SDL_Log("%s has an out of range entry (%u)!", fullPath, i);
+			UnmountAssetArchive();
+			return false;
+		}
+	}
+
+	SDL_Log("Mounted asset archive %s (%u assets)", fullPath, Archive.EntryCount);
+	return true;
+}
+
+void UnmountAssetArchive()
+{
+	if (Archive.Data != NULL)
+	{
+		ReleaseArchivedShaderBlobs();
+		UnmapArchiveFile();
+	}
+	SDL_zero(Archive);
+}
+
+static const AssetArchiveEntry* FindArchivedAsset(const char* name)
+{
+	size_t nameLength = SDL_strlen(name);
+	int low = 0;
+	int high = (int)Archive.EntryCount - 1;
+
+	while (low <= high)
+	{
+		int middle = low + (high - low) / 2;
+		const AssetArchiveEntry* entry = &Archive.Entries[middle];
+
+		// Names are stored without terminators and sorted bytewise
+		size_t compareLength = SDL_min(nameLength, (size_t)entry->NameLength);
+		int order = SDL_memcmp(name, Archive.Strings + entry->NameOffset, compareLength);
+		if (order == 0)
+		{
+			order = (nameLength < entry->NameLength) ? -1 : (nameLength > entry->NameLength) ? 1 : 0;
+		}
+
+		if (order == 0)
+		{
+			return entry;
+		}
+		else if (order < 0)
+		{
+			high = middle - 1;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+
+	return NULL;
+}
+
+const void* GetArchivedAsset(const char* name, ArchivedAssetInfo* pInfo)
+{
+	const AssetArchiveEntry* entry = FindArchivedAsset(name);
+	if (entry == NULL)
+	{
+		return NULL;
+	}
+
+	if (pInfo != NULL)
+	{
+		pInfo->Type = (ArchivedAssetType)entry->Type;
+		pInfo->Width = entry->Width;
+		pInfo->Height = entry->Height;
+		pInfo->Pitch = entry->Pitch;
+		pInfo->Size = (size_t)entry->DataSize;
+	}
+	return Archive.Data + entry->DataOffset;
+}
+
+typedef struct PendingArchiveEntry
+{
+	char* Name;
+	ArchivedAssetType Type;
+} PendingArchiveEntry;
+
+static int CompareArchiveEntries(const void* a, const void* b)
+{
+	return SDL_strcmp(((const PendingArchiveEntry*)a)->Name, ((const PendingArchiveEntry*)b)->Name);
+}
+
+static bool WriteArchivePayload(SDL_IOStream* stream, Uint64* pOffset, const void* data, size_t size)
+{
+	static const Uint8 Padding[ASSET_ARCHIVE_ALIGNMENT];
+
+	Uint64 aligned = (*pOffset + ASSET_ARCHIVE_ALIGNMENT - 1) & ~(Uint64)(ASSET_ARCHIVE_ALIGNMENT - 1);
+	if (aligned > *pOffset && SDL_WriteIO(stream, Padding, aligned - *pOffset) != aligned - *pOffset)
+	{
+		return false;
+	}
+	if (SDL_WriteIO(stream, data, size) != size)
+	{
+		return false;
+	}
+
+	*pOffset = aligned + size;
+	return true;
+}
+
+bool WriteAssetArchive(const char* archivePath)
+{
+	// Always pack from the loose files
+	UnmountAssetArchive();
+
+	char contentPath[256];
+	SDL_snprintf(contentPath, sizeof(contentPath), "%sContent/", SDL_GetBasePath());
+
+	int pathCount;
+	char** paths = SDL_GlobDirectory(contentPath, NULL, 0, &pathCount);
+	if (paths == NULL)
+	{
+		SDL_Log("Failed to enumerate %s: %s", contentPath, SDL_GetError());
+		return false;
+	}
+
+	// Pick out the assets the loaders know how to resolve
+	PendingArchiveEntry* pending = SDL_calloc(SDL_max(pathCount, 1), sizeof(PendingArchiveEntry));
+	if (pending == NULL)
+	{
+		SDL_Log("Failed to allocate the archive entry list!");
+		SDL_free(paths);
+		return false;
+	}
+	int pendingCount = 0;
+	bool collected = true;
+	for (int i = 0; i < pathCount; i += 1)
+	{
+		for (char* c = paths[i]; *c != '\0'; c += 1)
+		{
+			if (*c == '\\')
+			{
+				*c = '/';
+			}
+		}
+
+		const char* extension = SDL_strrchr(paths[i], '.');
+		ArchivedAssetType type;
+		if (extension == NULL || (SDL_strncmp(paths[i], "Images/", 7) != 0 && SDL_strncmp(paths[i], "Shaders/Compiled/", 17) != 0))
+		{
+			continue;
+		}
+		else if (SDL_strcmp(extension, ".bmp") == 0)
+		{
+			type = ARCHIVEDASSET_IMAGE;
+		}
+		else if (SDL_strcmp(extension, ".hdr") == 0)
+		{
+			type = ARCHIVEDASSET_HDR_IMAGE;
+		}
+		else if (SDL_strcmp(extension, ".dds") == 0 || SDL_strcmp(extension, ".astc") == 0 ||
+			SDL_strcmp(extension, ".spv") == 0 || SDL_strcmp(extension, ".msl") == 0 || SDL_strcmp(extension, ".dxil") == 0)
+		{
+			type = ARCHIVEDASSET_FILE;
+		}
+		else
+		{
+			continue;
+		}
+
+		pending[pendingCount].Name = SDL_strdup(paths[i]);
+		if (pending[pendingCount].Name == NULL)
+		{
+			collected = false;
+			break;
+		}
+		pending[pendingCount].Type = type;
+		pendingCount += 1;
+	}
+	SDL_free(paths);
+
+	SDL_qsort(pending, pendingCount, sizeof(PendingArchiveEntry), CompareArchiveEntries);
+
+	AssetArchiveHeader header = {
+		.Magic = ASSET_ARCHIVE_MAGIC,
+		.Version = ASSET_ARCHIVE_VERSION,
+		.EntryCount = pendingCount
+	};
+	AssetArchiveEntry* entries = collected ? SDL_calloc(SDL_max(pendingCount, 1), sizeof(AssetArchiveEntry)) : NULL;
+	if (entries == NULL)
+	{
+		SDL_Log("Failed to allocate the archive entry list!");
+		for (int i = 0; i < pendingCount; i += 1)
+		{
+			SDL_free(pending[i].Name);
+		}
+		SDL_free(pending);
+		return false;
+	}
+	for (int i = 0; i < pendingCount; i += 1)
+	{
+		entries[i].NameOffset = header.StringTableSize;
+		entries[i].NameLength = (Uint32)SDL_strlen(pending[i].Name);
+		entries[i].Type = pending[i].Type;
+		header.StringTableSize += entries[i].NameLength;
+	}
+
+	SDL_IOStream* stream = SDL_IOFromFile(archivePath, "wb");
+	if (stream == NULL)
+	{
+		SDL_Log("Failed to create %s: %s", archivePath, SDL_GetError());
+		for (int i = 0; i < pendingCount; i += 1)
+		{
+			SDL_free(pending[i].Name);
+		}
+		SDL_free(entries);
+		SDL_free(pending);
+		return false;
+	}
+
+	// Reserve room for the table of contents; it gets rewritten once the offsets are known
+	bool succeeded = SDL_WriteIO(stream, &header, sizeof(header)) == sizeof(header);
+	succeeded = succeeded && SDL_WriteIO(stream, entries, pendingCount * sizeof(AssetArchiveEntry)) == pendingCount * sizeof(AssetArchiveEntry);
+	for (int i = 0; succeeded && i < pendingCount; i += 1)
+	{
+		succeeded = SDL_WriteIO(stream, pending[i].Name, entries[i].NameLength) == entries[i].NameLength;
+	}
+
+	Uint64 offset = sizeof(header) + pendingCount * sizeof(AssetArchiveEntry) + header.StringTableSize;
+	for (int i = 0; succeeded && i < pendingCount; i += 1)
+	{
+		AssetArchiveEntry* entry = &entries[i];
+		const char* imageName = pending[i].Name + 7; // Past "Images/"
+
+		if (pending[i].Type == ARCHIVEDASSET_IMAGE)
+		{
+			SDL_Surface* surface = LoadImage(imageName, 4);
+			succeeded = surface != NULL;
+			if (succeeded)
+			{
+				entry->Width = surface->w;
+				entry->Height = surface->h;
+				entry->Pitch = surface->pitch;
+				entry->DataSize = (Uint64)surface->pitch * surface->h;
+				succeeded = WriteArchivePayload(stream, &offset, surface->pixels, (size_t)entry->DataSize);
+				SDL_DestroySurface(surface);
+			}
+		}
+		else if (pending[i].Type == ARCHIVEDASSET_HDR_IMAGE)
+		{
+			int width, height, channels;
+			float* hdrData = LoadHDRImage(imageName, &width, &height, &channels, 4);
+			succeeded = hdrData != NULL;
+			if (succeeded)
+			{
+				entry->Width = width;
+				entry->Height = height;
+				entry->Pitch = width * 4 * sizeof(float);
+				entry->DataSize = (Uint64)entry->Pitch * height;
+				succeeded = WriteArchivePayload(stream, &offset, hdrData, (size_t)entry->DataSize);
+				SDL_free(hdrData);
+			}
+		}
+		else
+		{
+			char fullPath[256];
+			SDL_snprintf(fullPath, sizeof(fullPath), "%s%s", contentPath, pending[i].Name);
+			size_t size;
+			void* data = SDL_LoadFile(fullPath, &size);
+			succeeded = data != NULL;
+			if (succeeded)
+			{
+				entry->DataSize = size;
+				succeeded = WriteArchivePayload(stream, &offset, data, size);
+				SDL_free(data);
+			}
+		}
+
+		entry->DataOffset = offset - entry->DataSize;
+		if (!succeeded)
+		{
+			SDL_Log("Failed to pack %s", pending[i].Name);
+		}
+	}
+
+	succeeded = succeeded && SDL_SeekIO(stream, sizeof(header), SDL_IO_SEEK_SET) >= 0;
+	succeeded = succeeded && SDL_WriteIO(stream, entries, pendingCount * sizeof(AssetArchiveEntry)) == pendingCount * sizeof(AssetArchiveEntry);
+	succeeded = SDL_CloseIO(stream) && succeeded;
+
+	if (succeeded)
+	{
+		SDL_Log("Packed %d assets into %s (%llu bytes)", pendingCount, archivePath, (unsigned long long)offset);
+	}
+
+	for (int i = 0; i < pendingCount; i += 1)
+	{
+		SDL_free(pending[i].Name);
+	}
+	SDL_free(entries);
+	SDL_free(pending);
+	return succeeded;
+}
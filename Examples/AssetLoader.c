@@ -0,0 +1,204 @@
+#include "Common.h"
+
+// Async Asset Loading
+// Jobs are queued on a linked list through AsyncAsset.Next and taken from the head by whichever
+// worker wakes first. Each job runs with the lock released; its Done flag is set, and waiters
+// woken, only once the job has finished writing the asset.
+
+typedef struct AssetLoader
+{
+	SDL_Mutex* Lock;
+	SDL_Condition* JobAvailable;
+	SDL_Condition* JobFinished;
+	AsyncAsset* Head;
+	AsyncAsset* Tail;
+	SDL_Thread** Threads;
+	int ThreadCount;
+	bool ShuttingDown;
+} AssetLoader;
+
+static AssetLoader Loader;
+
+static void RunAssetJob(AsyncAsset* asset)
+{
+	switch (asset->Type)
+	{
+		case ASSETTYPE_IMAGE:
+			asset->Surface = LoadImage(asset->Filename, asset->DesiredChannels);
+			asset->Succeeded = asset->Surface != NULL;
+			if (asset->Succeeded)
+			{
+				asset->Width = asset->Surface->w;
+				asset->Height = asset->Surface->h;
+			}
+			break;
+
+		case ASSETTYPE_HDR_IMAGE:
+			asset->HDRData = LoadHDRImage(asset->Filename, &asset->Width, &asset->Height, &asset->Channels, asset->DesiredChannels);
+			asset->Succeeded = asset->HDRData != NULL;
+			break;
+
+		case ASSETTYPE_HDR_IMAGE_HALF:
+			asset->Data = LoadHDRImageHalf(asset->Filename, &asset->Width, &asset->Height);
+			asset->Channels = 4;
+			asset->Succeeded = asset->Data != NULL;
+			break;
+
+		case ASSETTYPE_DDS_IMAGE:
+		case ASSETTYPE_ASTC_IMAGE:
+		{
+			bool opened = (asset->Type == ASSETTYPE_DDS_IMAGE) ?
+				OpenDDSImage(asset->Filename, asset->Format, &asset->Image) :
+				OpenASTCImage(asset->Filename, &asset->Image);
+			if (!opened)
+			{
+				asset->Succeeded = false;
+				break;
+			}
+
+			asset->Width = asset->Image.Width;
+			asset->Height = asset->Image.Height;
+			asset->Data = SDL_malloc(asset->Image.DataLength);
+			asset->Succeeded = asset->Data != NULL && ReadCompressedImageData(&asset->Image, asset->Data);
+			if (!asset->Succeeded)
+			{
+				SDL_free(asset->Data);
+				asset->Data = NULL;
+			}
+			SDL_CloseIO(asset->Image.Stream);
+			asset->Image.Stream = NULL;
+			break;
+		}
+
+		case ASSETTYPE_COMPRESSED_IMAGE_DATA:
+			asset->Succeeded = ReadCompressedImageData(&asset->Image, asset->Data);
+			break;
+
+		case ASSETTYPE_DECOMPRESSED_IMAGE_DATA:
+		{
+			void* blocks = SDL_malloc(asset->Image.DataLength);
+			asset->Succeeded = blocks != NULL &&
+				ReadCompressedImageData(&asset->Image, blocks) &&
+				DecompressImage(&asset->Image, asset->Format, blocks, asset->Data);
+			SDL_free(blocks);
+			break;
+		}
+	}
+}
+
+static int AssetLoaderThread(void* data)
+{
+	SDL_LockMutex(Loader.Lock);
+	while (true)
+	{
+		while (Loader.Head == NULL && !Loader.ShuttingDown)
+		{
+			SDL_WaitCondition(Loader.JobAvailable, Loader.Lock);
+		}
+		if (Loader.Head == NULL)
+		{
+			break;
+		}
+
+		AsyncAsset* asset = Loader.Head;
+		Loader.Head = asset->Next;
+		if (Loader.Head == NULL)
+		{
+			Loader.Tail = NULL;
+		}
+
+		SDL_UnlockMutex(Loader.Lock);
+		PROFILE_BEGIN("Load Asset");
+		RunAssetJob(asset);
+		PROFILE_END();
+		SDL_LockMutex(Loader.Lock);
+
+		SDL_SetAtomicInt(&asset->Done, 1);
+		SDL_BroadcastCondition(Loader.JobFinished);
+	}
+	SDL_UnlockMutex(Loader.Lock);
+
+	return 0;
+}
+
+void SetAssetLoaderThreadCount(int threadCount)
+{
+	QuitAssetLoader();
+
+	Loader.Lock = SDL_CreateMutex();
+	Loader.JobAvailable = SDL_CreateCondition();
+	Loader.JobFinished = SDL_CreateCondition();
+	Loader.ThreadCount = SDL_max(threadCount, 1);
+	Loader.Threads = SDL_calloc(Loader.ThreadCount, sizeof(SDL_Thread*));
+	for (int i = 0; i < Loader.ThreadCount; i += 1)
+	{
+		Loader.Threads[i] = SDL_CreateThread(AssetLoaderThread, "AssetLoader", NULL);
+	}
+}
+
+void QuitAssetLoader()
+{
+	if (Loader.Threads == NULL)
+	{
+		return;
+	}
+
+	// Workers drain any queued jobs before exiting
+	SDL_LockMutex(Loader.Lock);
+	Loader.ShuttingDown = true;
+	SDL_BroadcastCondition(Loader.JobAvailable);
+	SDL_UnlockMutex(Loader.Lock);
+
+	for (int i = 0; i < Loader.ThreadCount; i += 1)
+	{
+		SDL_WaitThread(Loader.Threads[i], NULL);
+	}
+
+	SDL_free(Loader.Threads);
+	SDL_DestroyCondition(Loader.JobFinished);
+	SDL_DestroyCondition(Loader.JobAvailable);
+	SDL_DestroyMutex(Loader.Lock);
+	SDL_zero(Loader);
+}
+
+void LoadAssetAsync(AsyncAsset* asset)
+{
+	SDL_assert(Loader.Threads != NULL && "InitializeAssetLoader must be called first!");
+
+	SDL_SetAtomicInt(&asset->Done, 0);
+	asset->Succeeded = false;
+	asset->Next = NULL;
+
+	SDL_LockMutex(Loader.Lock);
+	if (Loader.Tail == NULL)
+	{
+		Loader.Head = asset;
+	}
+	else
+	{
+		Loader.Tail->Next = asset;
+	}
+	Loader.Tail = asset;
+	SDL_SignalCondition(Loader.JobAvailable);
+	SDL_UnlockMutex(Loader.Lock);
+}
+
+bool IsAssetReady(AsyncAsset* asset)
+{
+	return SDL_GetAtomicInt(&asset->Done) != 0;
+}
+
+void WaitForAsset(AsyncAsset* asset)
+{
+	if (IsAssetReady(asset))
+	{
+		return;
+	}
+
+	SDL_LockMutex(Loader.Lock);
+	while (!IsAssetReady(asset))
+	{
+		SDL_WaitCondition(Loader.JobFinished, Loader.Lock);
+	}
+	SDL_UnlockMutex(Loader.Lock);
+}
@@ -38,11 +38,11 @@ static int Init(Context* context)
 		}
 	);
 
-	DrawPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+	DrawPipeline = AcquireGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}}
 		},
 		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
@@ -71,8 +71,8 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	});
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	int w, h;
 	SDL_GetWindowSizeInPixels(context->Window, &w, &h);
@@ -100,19 +100,8 @@ static int Init(Context* context)
 		}
 	);
 
-	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(PositionTextureVertex) * 6
-		}
-	);
-
-	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		transferBuffer,
-		false
-	);
+	StagingAllocation staging;
+	PositionTextureVertex* transferData = MapStagingMemory(context->Device, sizeof(PositionTextureVertex) * 6, 0, &staging);
 
 	transferData[0] = (PositionTextureVertex) { -1, -1, 0, 0, 0 };
 	transferData[1] = (PositionTextureVertex) {  1, -1, 0, 1, 0 };
@@ -121,7 +110,7 @@ static int Init(Context* context)
 	transferData[4] = (PositionTextureVertex) {  1,  1, 0, 1, 1 };
 	transferData[5] = (PositionTextureVertex) { -1,  1, 0, 0, 1 };
 
-	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+	UnmapStagingMemory(context->Device, &staging);
 
 	SDL_GPUCommandBuffer* cmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
@@ -129,8 +118,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = 0
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -156,10 +145,9 @@ static int Init(Context* context)
 	SDL_DispatchGPUCompute(computePass, w / 8, h / 8, 1);
 	SDL_EndGPUComputePass(computePass);
 
-	SDL_SubmitGPUCommandBuffer(cmdBuf);
+	SubmitStagingCommandBuffer(context->Device, cmdBuf);
 
-	SDL_ReleaseGPUComputePipeline(context->Device, fillTexturePipeline);
-	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+	ReleaseComputePipeline(context->Device, fillTexturePipeline);
 
 	return 0;
 }
@@ -179,8 +167,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -207,14 +195,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, DrawPipeline);
+	ReleaseGraphicsPipeline(context->Device, DrawPipeline);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
 	SDL_ReleaseGPUSampler(context->Device, Sampler);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
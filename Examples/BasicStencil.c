@@ -57,7 +57,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 			.has_depth_stencil_target = true,
 			.depth_stencil_format = depthStencilFormat
@@ -109,7 +109,7 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	MaskerPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	MaskerPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (MaskerPipeline == NULL)
 	{
 		SDL_Log("Failed to create masker pipeline!");
@@ -134,15 +134,15 @@ static int Init(Context* context)
 		.write_mask = 0
 	};
 
-	MaskeePipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	MaskeePipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (MaskeePipeline == NULL)
 	{
 		SDL_Log("Failed to create maskee pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	VertexBuffer = SDL_CreateGPUBuffer(
 		context->Device,
@@ -169,19 +169,8 @@ static int Init(Context* context)
 		}
 	);
 
-	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(PositionColorVertex) * 6
-		}
-	);
-
-	PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		transferBuffer,
-		false
-	);
+	StagingAllocation staging;
+	PositionColorVertex* transferData = MapStagingMemory(context->Device, sizeof(PositionColorVertex) * 6, 0, &staging);
 
 	transferData[0] = (PositionColorVertex) { -0.5f, -0.5f, 0, 255, 255,   0, 255 };
 	transferData[1] = (PositionColorVertex) {  0.5f, -0.5f, 0, 255, 255,   0, 255 };
@@ -190,7 +179,7 @@ static int Init(Context* context)
 	transferData[4] = (PositionColorVertex) {     1,    -1, 0,   0, 255,   0, 255 };
 	transferData[5] = (PositionColorVertex) {     0,     1, 0,   0,   0, 255, 255 };
 
-	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+	UnmapStagingMemory(context->Device, &staging);
 
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
@@ -198,8 +187,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = 0
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -210,8 +199,7 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	return 0;
 }
@@ -231,8 +219,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -274,15 +262,15 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, MaskeePipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, MaskerPipeline);
+	ReleaseGraphicsPipeline(context->Device, MaskeePipeline);
+	ReleaseGraphicsPipeline(context->Device, MaskerPipeline);
 
 	SDL_ReleaseGPUTexture(context->Device, DepthStencilTexture);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
@@ -37,7 +37,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
@@ -46,7 +46,7 @@ static int Init(Context* context)
 	};
 
 	pipelineCreateInfo.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_FILL;
-	FillPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	FillPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (FillPipeline == NULL)
 	{
 		SDL_Log("Failed to create fill pipeline!");
@@ -54,7 +54,7 @@ static int Init(Context* context)
 	}
 
 	pipelineCreateInfo.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_LINE;
-	LinePipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	LinePipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (LinePipeline == NULL)
 	{
 		SDL_Log("Failed to create line pipeline!");
@@ -62,8 +62,8 @@ static int Init(Context* context)
 	}
 
 	// Clean up shader resources
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Finally, print instructions!
 	SDL_Log("Press Left to toggle wireframe mode");
@@ -103,8 +103,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -130,15 +130,15 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, FillPipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, LinePipeline);
+	ReleaseGraphicsPipeline(context->Device, FillPipeline);
+	ReleaseGraphicsPipeline(context->Device, LinePipeline);
 
 	UseWireframeMode = false;
 	UseSmallViewport = false;
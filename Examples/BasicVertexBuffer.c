@@ -31,7 +31,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+				.format = GetFrameTextureFormat(context->Device, context->Window),
 			}},
 		},
 		// This is set up to match the vertex shader layout!
@@ -61,15 +61,15 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the vertex buffer
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -81,25 +81,14 @@ static int Init(Context* context)
 	);
 
 	// To get data into the vertex buffer, we have to use a transfer buffer
-	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(PositionColorVertex) * 3
-		}
-	);
-
-	PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		transferBuffer,
-		false
-	);
+	StagingAllocation staging;
+	PositionColorVertex* transferData = MapStagingMemory(context->Device, sizeof(PositionColorVertex) * 3, 0, &staging);
 
 	transferData[0] = (PositionColorVertex) {    -1,    -1, 0, 255,   0,   0, 255 };
 	transferData[1] = (PositionColorVertex) {     1,    -1, 0,   0, 255,   0, 255 };
 	transferData[2] = (PositionColorVertex) {     0,     1, 0,   0,   0, 255, 255 };
 
-	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+	UnmapStagingMemory(context->Device, &staging);
 
 	// Upload the transfer data to the vertex buffer
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -108,8 +97,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = 0
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -120,8 +109,7 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	return 0;
 }
@@ -141,8 +129,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -168,14 +156,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 
 	CommonQuit(context);
@@ -0,0 +1,2084 @@
+#include "Common.h"
+#include <stddef.h>
+
+// Benchmarks
+// The runner's measuring modes: -bench with its JSON output and baseline comparison, the
+// asset loader, sprite and radix sort benchmarks, and the texture decoder check. Each one sets up
+// its own Context and needs no display.
+
+static AsyncAsset LoaderBenchmarkAssets[] =
+{
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "ravioli.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "ravioli_inverted.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "ravioli_atlas.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "latency.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube0.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube1.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube2.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube3.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube4.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_IMAGE, .Filename = "cube5.bmp", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_HDR_IMAGE, .Filename = "memorial.hdr", .DesiredChannels = 4 },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC1.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC2.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC3.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC4.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC5.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC6H_S.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC6H_U.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT },
+	{ .Type = ASSETTYPE_DDS_IMAGE, .Filename = "bcn/BC7.dds", .Format = SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/4x4.astc" },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/5x5.astc" },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/6x6.astc" },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/8x8.astc" },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/10x10.astc" },
+	{ .Type = ASSETTYPE_ASTC_IMAGE, .Filename = "astc/12x12.astc" },
+};
+
+static double LoadBenchmarkAssets(int threadCount)
+{
+	SetAssetLoaderThreadCount(threadCount);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < SDL_arraysize(LoaderBenchmarkAssets); i += 1)
+	{
+		LoadAssetAsync(&LoaderBenchmarkAssets[i]);
+	}
+	for (int i = 0; i < SDL_arraysize(LoaderBenchmarkAssets); i += 1)
+	{
+		WaitForAsset(&LoaderBenchmarkAssets[i]);
+	}
+	double elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+	for (int i = 0; i < SDL_arraysize(LoaderBenchmarkAssets); i += 1)
+	{
+		AsyncAsset* asset = &LoaderBenchmarkAssets[i];
+		if (!asset->Succeeded)
+		{
+			SDL_Log("Failed to load %s", asset->Filename);
+		}
+		SDL_DestroySurface(asset->Surface);
+		SDL_free(asset->HDRData);
+		SDL_free(asset->Data);
+		CloseCompressedImage(&asset->Image);
+		asset->Surface = NULL;
+		asset->HDRData = NULL;
+		asset->Data = NULL;
+	}
+
+	return elapsedMs;
+}
+
+/* Loads a representative set of Init-time assets with an increasing number
+ * of loader threads and reports the wall time of each run.
+ */
+void BenchmarkAssetLoader(void)
+{
+	const int iterations = 5;
+	int coreCount = SDL_GetNumLogicalCPUCores();
+	double baselineMs = 0;
+
+	// Warm up the OS file cache so the first row isn't penalized
+	LoadBenchmarkAssets(coreCount);
+
+	SDL_Log("Asset loader benchmark: %d assets, best of %d runs", (int) SDL_arraysize(LoaderBenchmarkAssets), iterations);
+	for (int threadCount = 1; threadCount <= coreCount; threadCount = (threadCount < coreCount) ? SDL_min(threadCount * 2, coreCount) : threadCount + 1)
+	{
+		double bestMs = 0;
+		for (int i = 0; i < iterations; i += 1)
+		{
+			double elapsedMs = LoadBenchmarkAssets(threadCount);
+			if (i == 0 || elapsedMs < bestMs)
+			{
+				bestMs = elapsedMs;
+			}
+		}
+		if (threadCount == 1)
+		{
+			baselineMs = bestMs;
+		}
+		SDL_Log("%3d threads: %8.2f ms (%.2fx)", threadCount, bestMs, baselineMs / bestMs);
+	}
+
+	SetAssetLoaderThreadCount(coreCount);
+}
+
+/* Compares the stb_image RGBA32F path against the SIMD RGBA16F decoder. */
+void BenchmarkHDRDecode(void)
+{
+	const int iterations = 5;
+	double floatMs = 0;
+	double halfMs = 0;
+	int w, h, n;
+
+	for (int i = 0; i < iterations; i += 1)
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		float* floatData = LoadHDRImage("memorial.hdr", &w, &h, &n, 4);
+		Uint64 middle = SDL_GetPerformanceCounter();
+		Uint16* halfData = LoadHDRImageHalf("memorial.hdr", &w, &h);
+		Uint64 end = SDL_GetPerformanceCounter();
+
+		double elapsedFloat = (middle - start) * 1000.0 / SDL_GetPerformanceFrequency();
+		double elapsedHalf = (end - middle) * 1000.0 / SDL_GetPerformanceFrequency();
+		floatMs = (i == 0) ? elapsedFloat : SDL_min(floatMs, elapsedFloat);
+		halfMs = (i == 0) ? elapsedHalf : SDL_min(halfMs, elapsedHalf);
+
+		SDL_free(floatData);
+		SDL_free(halfData);
+	}
+
+	SDL_Log("HDR decode (memorial.hdr, best of %d): RGBA32F %.2f ms, RGBA16F %.2f ms (%.2fx)", iterations, floatMs, halfMs, floatMs / halfMs);
+}
+
+/* Builds a million sprites with an increasing number of threads, compared against filling
+ * them one field at a time with SDL_rand, and reports the best throughput of each.
+ */
+void BenchmarkSpriteBuilder(void)
+{
+	const Uint32 spriteCount = 1024 * 1024;
+	const int iterations = 10;
+	int coreCount = SDL_GetNumLogicalCPUCores();
+	SpriteInstance* sprites = SDL_aligned_alloc(64, spriteCount * sizeof(SpriteInstance));
+	SpriteBuildInfo info = { .AreaWidth = 640, .AreaHeight = 480, .SpriteSize = 32 };
+
+	double randMs = 0;
+	for (int i = 0; i < iterations; i += 1)
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (Uint32 j = 0; j < spriteCount; j += 1)
+		{
+			Sint32 ravioli = SDL_rand(4);
+			sprites[j] = (SpriteInstance) {
+				.x = (float)SDL_rand(640),
+				.y = (float)SDL_rand(480),
+				.rotation = SDL_randf() * SDL_PI_F * 2,
+				.w = 32,
+				.h = 32,
+				.tex_u = (ravioli & 1) * 0.5f,
+				.tex_v = (ravioli >> 1) * 0.5f,
+				.tex_w = 0.5f,
+				.tex_h = 0.5f,
+				.r = 1.0f,
+				.g = 1.0f,
+				.b = 1.0f,
+				.a = 1.0f
+			};
+		}
+		double elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+		randMs = (i == 0) ? elapsedMs : SDL_min(randMs, elapsedMs);
+	}
+
+	SDL_Log("Sprite builder benchmark: %u sprites, best of %d runs", spriteCount, iterations);
+	SDL_Log("SDL_rand loop: %10.0f sprites/ms", spriteCount / randMs);
+	for (int threadCount = 1; threadCount <= coreCount; threadCount = (threadCount < coreCount) ? SDL_min(threadCount * 2, coreCount) : threadCount + 1)
+	{
+		SetSpriteBuilderThreadCount(threadCount);
+		double bestMs = 0;
+		for (int i = 0; i < iterations; i += 1)
+		{
+			info.Seed = i;
+			Uint64 start = SDL_GetPerformanceCounter();
+			BuildSprites(sprites, spriteCount, &info);
+			double elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+			bestMs = (i == 0) ? elapsedMs : SDL_min(bestMs, elapsedMs);
+		}
+		SDL_Log("%3d threads:   %10.0f sprites/ms (%.2fx)", threadCount, spriteCount / bestMs, randMs / bestMs);
+	}
+
+	SetSpriteBuilderThreadCount(coreCount);
+	SDL_aligned_free(sprites);
+}
+
+/* Renders PullSpriteBatch at increasing sprite counts, uploading the instance data through a
+ * cycled transfer buffer, through the frame ring, and through the frame ring in the compact
+ * 16-byte format, then simulating the sprites on the GPU, and reports the average frame time.
+ */
+void BenchmarkSpriteUploads(void)
+{
+	const Uint32 spriteCounts[] = { 8192, 65536, 1048576 };
+	const struct { const char* Name; bool UseFrameRing; PullSpriteSource Source; } modes[] = {
+		{ "cycle", false, PULLSPRITESOURCE_CPU },
+		{ "frame ring", true, PULLSPRITESOURCE_CPU },
+		{ "ring+compact", true, PULLSPRITESOURCE_CPU_COMPACT },
+		{ "gpu sim", false, PULLSPRITESOURCE_GPU_SIMULATION }
+	};
+	const int warmupFrames = 30;
+	const int measuredFrames = 200;
+
+	SDL_Log("Sprite upload benchmark: average of %d frames after %d warm-up frames", measuredFrames, warmupFrames);
+	for (int i = 0; i < SDL_arraysize(spriteCounts); i += 1)
+	{
+		for (int mode = 0; mode < SDL_arraysize(modes); mode += 1)
+		{
+			Context context = { 0 };
+			context.ExampleName = PullSpriteBatch_Example.Name;
+			context.DeltaTime = 1.0f / 60.0f;
+			SetPullSpriteBatchMode(spriteCounts[i], modes[mode].UseFrameRing, modes[mode].Source);
+			if (PullSpriteBatch_Example.Init(&context) < 0)
+			{
+				SDL_Log("Init failed!");
+				return;
+			}
+			if (GetPullSpriteBatchSource() != modes[mode].Source)
+			{
+				SDL_Log("%8u sprites, %-13s skipped, its shaders haven't been compiled", spriteCounts[i], modes[mode].Name);
+				PullSpriteBatch_Example.Quit(&context);
+				continue;
+			}
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			for (int frame = 0; frame < warmupFrames + measuredFrames; frame += 1)
+			{
+				if (frame == warmupFrames)
+				{
+					start = SDL_GetPerformanceCounter();
+				}
+				SDL_PumpEvents();
+				if (PullSpriteBatch_Example.Draw(&context) < 0)
+				{
+					SDL_Log("Draw failed!");
+					break;
+				}
+				UpdateReadbacks(context.Device);
+			}
+			double frameMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / measuredFrames;
+
+			if (modes[mode].Source == PULLSPRITESOURCE_GPU_SIMULATION)
+			{
+				SpriteSimulationStats stats = GetPullSpriteBatchSimulationStats();
+				SDL_Log(
+					"%8u sprites, %-13s %8.3f ms/frame, %.1f KiB uploaded per frame after the first",
+					spriteCounts[i],
+					modes[mode].Name,
+					frameMs,
+					(stats.UploadedBytes - spriteCounts[i] * (sizeof(SpriteInstance) + sizeof(SpriteMotion))) / (1024.0 * (stats.Steps - 1))
+				);
+			}
+			else if (modes[mode].UseFrameRing)
+			{
+				FrameRingStats stats = GetPullSpriteBatchRingStats();
+				SDL_Log(
+					"%8u sprites, %-13s %8.3f ms/frame, %d stall(s), %.1f MiB",
+					spriteCounts[i],
+					modes[mode].Name,
+					frameMs,
+					stats.Stalls,
+					stats.MemoryBytes / (1024.0 * 1024.0)
+				);
+			}
+			else
+			{
+				SDL_Log(
+					"%8u sprites, cycle         %8.3f ms/frame, %.1f MiB plus backend cycles",
+					spriteCounts[i],
+					frameMs,
+					spriteCounts[i] * 64 * 2 / (1024.0 * 1024.0) // 64-byte instances, transfer and GPU buffer
+				);
+			}
+
+			PullSpriteBatch_Example.Quit(&context);
+		}
+	}
+
+	SetPullSpriteBatchMode(8192, true, PULLSPRITESOURCE_CPU);
+}
+
+static void CopyReadbackData(void* userdata, const void* data, Uint32 size)
+{
+	SDL_memcpy(userdata, data, size);
+}
+
+static int CompareSortPairs(const void* a, const void* b)
+{
+	Uint64 left = *(const Uint64*) a;
+	Uint64 right = *(const Uint64*) b;
+	return (left > right) - (left < right);
+}
+
+/* Sorts random 32-bit keys with indices as values on the GPU at increasing counts, checks the
+ * first sort against the input, and compares the best time against SDL_qsort of the same pairs.
+ */
+void BenchmarkRadixSort(void)
+{
+	const Uint32 keyCounts[] = { 65536, 262144, 1048576, 4194304 };
+	const int warmupSorts = 3;
+	const int iterations = 10;
+
+	Context context = { 0 };
+	context.ExampleName = "RadixSortBenchmark";
+	if (CommonInit(&context, 0) < 0)
+	{
+		return;
+	}
+
+	RadixSorter sorter;
+	if (!CreateRadixSorter(&sorter, context.Device, keyCounts[SDL_arraysize(keyCounts) - 1]))
+	{
+		SDL_Log("Could not create the radix sorter, skipping the radix sort benchmark!");
+		CommonQuit(&context);
+		return;
+	}
+
+	SDL_Log("Radix sort benchmark: 32-bit keys and values, best of %d sorts", iterations);
+	for (int i = 0; i < SDL_arraysize(keyCounts); i += 1)
+	{
+		Uint32 count = keyCounts[i];
+		Uint32 size = count * sizeof(Uint32);
+		Uint32* keys = SDL_malloc(size);
+		Uint32* values = SDL_malloc(size);
+		Uint32* sortedKeys = SDL_malloc(size);
+		Uint32* sortedValues = SDL_malloc(size);
+		Uint64* pairs = SDL_malloc(count * sizeof(Uint64));
+		if (keys == NULL || values == NULL || sortedKeys == NULL || sortedValues == NULL || pairs == NULL)
+		{
+			SDL_Log("Out of memory, skipping %u keys!", count);
+			SDL_free(keys);
+			SDL_free(values);
+			SDL_free(sortedKeys);
+			SDL_free(sortedValues);
+			SDL_free(pairs);
+			continue;
+		}
+
+		Uint64 state = count;
+		for (Uint32 j = 0; j < count; j += 1)
+		{
+			keys[j] = SDL_rand_bits_r(&state);
+			values[j] = j;
+		}
+
+		double gpuMs = 0;
+		bool sorted = true;
+		for (int iteration = 0; iteration < warmupSorts + iterations; iteration += 1)
+		{
+			// Each sort starts from the unsorted input, which is uploaded outside the timing
+			StagingAllocation keyStaging;
+			StagingAllocation valueStaging;
+			if (!StageData(context.Device, keys, size, 0, &keyStaging) ||
+				!StageData(context.Device, values, size, 0, &valueStaging))
+			{
+				SDL_Log("Could not stage %u keys!", count);
+				break;
+			}
+			SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context.Device);
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) { .transfer_buffer = keyStaging.TransferBuffer, .offset = keyStaging.Offset },
+				&(SDL_GPUBufferRegion) { .buffer = sorter.Keys[0], .offset = 0, .size = size },
+				false
+			);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) { .transfer_buffer = valueStaging.TransferBuffer, .offset = valueStaging.Offset },
+				&(SDL_GPUBufferRegion) { .buffer = sorter.Values[0], .offset = 0, .size = size },
+				false
+			);
+			SDL_EndGPUCopyPass(copyPass);
+			SubmitStagingCommandBuffer(context.Device, uploadCmdBuf);
+			WaitForStagingSubmissions(context.Device);
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			SDL_GPUCommandBuffer* cmdBuf = SDL_AcquireGPUCommandBuffer(context.Device);
+			int result = SortRadix(&sorter, cmdBuf, count, 32);
+			SubmitStagingCommandBuffer(context.Device, cmdBuf);
+			WaitForStagingSubmissions(context.Device);
+			double elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+			if (iteration == warmupSorts)
+			{
+				gpuMs = elapsedMs;
+
+				SDL_GPUCommandBuffer* readbackCmdBuf = SDL_AcquireGPUCommandBuffer(context.Device);
+				SDL_GPUCopyPass* readbackPass = SDL_BeginGPUCopyPass(readbackCmdBuf);
+				ReadbackBuffer(
+					context.Device,
+					readbackPass,
+					&(SDL_GPUBufferRegion) { .buffer = sorter.Keys[result], .offset = 0, .size = size },
+					CopyReadbackData,
+					sortedKeys
+				);
+				ReadbackBuffer(
+					context.Device,
+					readbackPass,
+					&(SDL_GPUBufferRegion) { .buffer = sorter.Values[result], .offset = 0, .size = size },
+					CopyReadbackData,
+					sortedValues
+				);
+				SDL_EndGPUCopyPass(readbackPass);
+				SubmitStagingCommandBuffer(context.Device, readbackCmdBuf);
+				FinishReadbacks(context.Device);
+
+				// Sorted, stable, and every value still carries its own key
+				for (Uint32 j = 0; j < count && sorted; j += 1)
+				{
+					sorted = sortedValues[j] < count && keys[sortedValues[j]] == sortedKeys[j] &&
+						(j == 0 || sortedKeys[j - 1] < sortedKeys[j] || (sortedKeys[j - 1] == sortedKeys[j] && sortedValues[j - 1] < sortedValues[j]));
+				}
+			}
+			else if (iteration > warmupSorts)
+			{
+				gpuMs = SDL_min(gpuMs, elapsedMs);
+			}
+		}
+
+		double cpuMs = 0;
+		for (int iteration = 0; iteration < iterations; iteration += 1)
+		{
+			for (Uint32 j = 0; j < count; j += 1)
+			{
+				pairs[j] = ((Uint64) keys[j] << 32) | values[j];
+			}
+			Uint64 start = SDL_GetPerformanceCounter();
+			SDL_qsort(pairs, count, sizeof(Uint64), CompareSortPairs);
+			double elapsedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+			cpuMs = (iteration == 0) ? elapsedMs : SDL_min(cpuMs, elapsedMs);
+		}
+
+		SDL_Log(
+			"%8u keys: GPU %8.3f ms (%7.1f Mkeys/s), SDL_qsort %8.3f ms (%7.1f Mkeys/s), %.1fx%s",
+			count,
+			gpuMs,
+			count / (gpuMs * 1000.0),
+			cpuMs,
+			count / (cpuMs * 1000.0),
+			cpuMs / gpuMs,
+			sorted ? "" : " MISSORTED"
+		);
+
+		SDL_free(keys);
+		SDL_free(values);
+		SDL_free(sortedKeys);
+		SDL_free(sortedValues);
+		SDL_free(pairs);
+	}
+
+	ReleaseRadixSorter(&sorter);
+	CommonQuit(&context);
+}
+
+static const struct
+{
+	const char* Name;
+	SDL_GPUTextureFormat Format;
+} DecoderCheckImages[] =
+{
+	{ "bcn/BC1.dds", SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM },
+	{ "bcn/BC2.dds", SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM },
+	{ "bcn/BC3.dds", SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM },
+	{ "bcn/BC4.dds", SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM },
+	{ "bcn/BC5.dds", SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM },
+	{ "bcn/BC6H_S.dds", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT },
+	{ "bcn/BC6H_U.dds", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT },
+	{ "bcn/BC7.dds", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM },
+	{ "bcn/BC1_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB },
+	{ "bcn/BC2_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM_SRGB },
+	{ "bcn/BC3_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB },
+	{ "bcn/BC7_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB },
+	{ "astc/4x4.astc", SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM },
+	{ "astc/5x4.astc", SDL_GPU_TEXTUREFORMAT_ASTC_5x4_UNORM },
+	{ "astc/5x5.astc", SDL_GPU_TEXTUREFORMAT_ASTC_5x5_UNORM },
+	{ "astc/6x5.astc", SDL_GPU_TEXTUREFORMAT_ASTC_6x5_UNORM },
+	{ "astc/6x6.astc", SDL_GPU_TEXTUREFORMAT_ASTC_6x6_UNORM },
+	{ "astc/8x5.astc", SDL_GPU_TEXTUREFORMAT_ASTC_8x5_UNORM },
+	{ "astc/8x6.astc", SDL_GPU_TEXTUREFORMAT_ASTC_8x6_UNORM },
+	{ "astc/8x8.astc", SDL_GPU_TEXTUREFORMAT_ASTC_8x8_UNORM },
+	{ "astc/10x5.astc", SDL_GPU_TEXTUREFORMAT_ASTC_10x5_UNORM },
+	{ "astc/10x6.astc", SDL_GPU_TEXTUREFORMAT_ASTC_10x6_UNORM },
+	{ "astc/10x8.astc", SDL_GPU_TEXTUREFORMAT_ASTC_10x8_UNORM },
+	{ "astc/10x10.astc", SDL_GPU_TEXTUREFORMAT_ASTC_10x10_UNORM },
+	{ "astc/12x10.astc", SDL_GPU_TEXTUREFORMAT_ASTC_12x10_UNORM },
+	{ "astc/12x12.astc", SDL_GPU_TEXTUREFORMAT_ASTC_12x12_UNORM },
+};
+
+/* Known-answer blocks: one per BC7 mode, one per BC6H mode in each signedness and one ASTC 4x4
+ * block per partition count, with the texels they must decode to exactly. The BC7 texels come from
+ * Pillow's BCn decoder. The BC6H halves agree with Pillow's decoder at the 8-bit precision it
+ * returns. The ASTC texels come from a reference decoder written from the Khronos specification,
+ * which covers only these plain-bit encodings.
+ */
+static const struct
+{
+	const char* Name;
+	SDL_GPUTextureFormat Format;
+	Uint8 Block[16];
+	Uint8 Texels[64]; // RGBA, row by row
+} DecoderCheckUnormBlocks[] =
+{
+	{
+		"BC7 mode 0", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x5D, 0x0D, 0xAB, 0xB6, 0xFD, 0x9A, 0xEC, 0x90, 0xB1, 0x53, 0xDB, 0x66, 0x44, 0xB4, 0xAF, 0xA8 },
+		{
+			141, 225, 126, 255, 115, 235, 136, 255,  96, 207, 148, 255, 132, 115, 198, 255,
+			141, 225, 126, 255, 108, 177, 164, 255, 132, 115, 198, 255, 103,  78, 212, 255,
+			120, 145, 182, 255, 114, 160, 174, 255, 181,  99, 148, 255, 128,  85, 191, 255,
+			102, 192, 156, 255,  90,  74, 222, 255, 155,  92, 169, 255, 116,  81, 201, 255
+		}
+	},
+	{
+		"BC7 mode 1", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x4A, 0xB2, 0xB0, 0x1F, 0xEB, 0xE0, 0x4C, 0x41, 0x80, 0x22, 0x3F, 0x74, 0x97, 0xF6, 0x4E, 0xD4 },
+		{
+			122, 107,   6, 255, 122, 107,   6, 255, 203, 175,   6, 255,  64,  59,   6, 255,
+			122, 107,   6, 255,  10,  14,   6, 255, 149, 130,   6, 255, 149, 130,   6, 255,
+			151,  66, 109, 255,  37,  37,   6, 255, 122, 107,   6, 255,  10,  14,   6, 255,
+			118,  70,  88, 255, 239,  58, 163, 255,  89,  72,  70, 255,  37,  37,   6, 255
+		}
+	},
+	{
+		"BC7 mode 2", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x1C, 0x6F, 0xC3, 0x04, 0x34, 0x01, 0x58, 0x9E, 0xB7, 0xC8, 0x31, 0x5C, 0x14, 0x1C, 0x5A, 0x54 },
+		{
+			189,  16,  41, 255, 144, 134,  24, 255,   0, 156, 115, 255, 189,  16,  41, 255,
+			107,   0, 148, 255, 144, 134,  24, 255,   0, 156, 115, 255, 189,  16,  41, 255,
+			162,  11,  76, 255,  33, 206,  24, 255,   0, 156, 115, 255, 162,  11,  76, 255,
+			189,  16,  41, 255, 144, 134,  24, 255,  35, 167, 123, 255, 162,  11,  76, 255
+		}
+	},
+	{
+		"BC7 mode 3", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0xE8, 0xE0, 0x69, 0xD9, 0xB1, 0x8D, 0xC6, 0x53, 0x7D, 0x77, 0x6B, 0x88, 0xC3, 0x32, 0x2D, 0x04 },
+		{
+			240, 108, 190, 255, 240, 108, 190, 255, 149, 106, 142, 255, 196, 107, 167, 255,
+			186, 109, 155, 255, 192,  97,  93, 255, 186, 109, 155, 255, 192,  97,  93, 255,
+			192,  97,  93, 255, 186, 109, 155, 255, 186, 109, 155, 255, 179, 121, 215, 255,
+			192,  97,  93, 255, 179, 121, 215, 255, 179, 121, 215, 255, 179, 121, 215, 255
+		}
+	},
+	{
+		"BC7 mode 4", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x10, 0x9F, 0xDD, 0xCA, 0xC1, 0xB8, 0x2C, 0xC2, 0xD3, 0xA3, 0x7E, 0xB9, 0xE8, 0xAE, 0x05, 0x32 },
+		{
+			204, 184, 155, 101, 204, 184, 155,  44, 204, 184, 155,  72, 255, 189, 231,  85,
+			204, 184, 155, 101, 255, 189, 231, 128, 150, 178,  76, 114,  99, 173,   0,  44,
+			204, 184, 155,  58, 150, 178,  76,  72, 150, 178,  76,  58,  99, 173,   0, 114,
+			204, 184, 155, 142, 255, 189, 231,  85, 204, 184, 155,  85, 204, 184, 155, 128
+		}
+	},
+	{
+		"BC7 mode 5", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x60, 0xE7, 0x4C, 0xD9, 0xA4, 0x63, 0xF7, 0xD7, 0x3E, 0x4F, 0xDF, 0x73, 0x36, 0x23, 0x52, 0x2C },
+		{
+			229, 161, 149, 155, 229,  76, 217,  50, 181, 161, 149, 155, 253, 118, 184, 102,
+			181,  76, 217,  50, 253, 161, 149, 155, 205, 118, 184, 102, 253, 118, 184, 102,
+			205,  76, 217,  50, 253,  76, 217,  50, 229, 118, 184, 102, 229,  76, 217,  50,
+			253, 161, 149, 155, 181, 118, 184, 102, 205,  76, 217,  50, 253, 203, 116, 207
+		}
+	},
+	{
+		"BC7 mode 6", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0xC0, 0x56, 0xD1, 0xC4, 0x17, 0x96, 0x0A, 0xA7, 0x5D, 0x47, 0x22, 0x14, 0xC5, 0xAD, 0x40, 0x07 },
+		{
+			111, 147, 109,  39, 107, 133, 114,  33, 114, 158, 106,  43, 104, 123, 118,  29,
+			 98, 101, 125,  21,  98, 101, 125,  21, 104, 123, 118,  29,  94,  88, 129,  15,
+			107, 133, 114,  33, 129, 214,  87,  65, 132, 225,  83,  69, 123, 193,  94,  57,
+			 91,  77, 133,  11, 104, 123, 118,  29, 114, 158, 106,  43,  91,  77, 133,  11
+		}
+	},
+	{
+		"BC7 mode 7", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+		{ 0x80, 0x9C, 0x7E, 0x32, 0xEC, 0x43, 0xC8, 0x91, 0x0C, 0x38, 0x0F, 0x55, 0x3D, 0xCA, 0x00, 0x56 },
+		{
+			184, 168,  88, 158, 121,  56, 146, 243, 184, 168,  88, 158, 150,  36, 101, 134,
+			184, 168,  88, 158, 103,  35,  68, 117,  55,  33,  33,  98, 103,  35,  68, 117,
+			150,  36, 101, 134, 150,  36, 101, 134, 150,  36, 101, 134, 215, 223,  60, 117,
+			 55,  33,  33,  98, 184, 168,  88, 158, 184, 168,  88, 158, 184, 168,  88, 158
+		}
+	},
+	{
+		"ASTC 4x4 1 partition", SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM,
+		{ 0x53, 0x00, 0x53, 0xF0, 0x0B, 0x25, 0x00, 0x94, 0x00, 0x00, 0x65, 0xC7, 0x98, 0xF3, 0x83, 0xF6 },
+		{
+			248,  18,  74, 255, 190,  50,  53, 255, 190,  50,  53, 255,  41, 133,   0, 255,
+			161,  66,  42, 255, 248,  18,  74, 255, 128,  84,  31, 255, 219,  34,  63, 255,
+			 70, 117,  10, 255, 128,  84,  31, 255, 161,  66,  42, 255,  70, 117,  10, 255,
+			219,  34,  63, 255, 190,  50,  53, 255,  70, 117,  10, 255, 190,  50,  53, 255
+		}
+	},
+	{
+		"ASTC 4x4 2 partitions", SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM,
+		{ 0x42, 0x48, 0x6F, 0x38, 0x12, 0xD6, 0x4A, 0xBC, 0x4B, 0x71, 0xE9, 0x14, 0xCE, 0x76, 0xA8, 0xD2 },
+		{
+			204, 178, 187, 119, 162, 153, 148, 136,  17,   0, 102,  34,  61,  61,  96, 101,
+			 61,  61,  96, 101,  61,  61,  96, 101,  61,  61,  96, 101,  17,   0, 102,  34,
+			162, 153, 148, 136, 204, 178, 187, 119, 162, 153, 148, 136, 118, 127, 107, 153,
+			204, 178, 187, 119,  76, 102,  68, 170, 204, 178, 187, 119,  61,  61,  96, 101
+		}
+	},
+	{
+		"ASTC 4x4 3 partitions", SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM,
+		{ 0x53, 0x30, 0x32, 0x28, 0xA1, 0xFC, 0x8A, 0x72, 0x19, 0x1C, 0xBD, 0x54, 0xED, 0x35, 0x16, 0x39 },
+		{
+			 64,  64,  64, 174, 194, 194, 194, 100, 110, 110, 110, 128,  64,  64,  64, 174,
+			 21,  21,  21, 217, 153, 153, 153,  85,  88,  88,  88, 150,  43,  43,  43, 195,
+			204, 204, 204, 238,  90,  90,  90, 141, 109, 109, 109,  92,  94,  94,  94, 129,
+			109, 109, 109,  92, 109, 109, 109,  92,  85,  85,  85, 153,  94,  94,  94, 129
+		}
+	},
+	{
+		"ASTC 4x4 4 partitions", SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM,
+		{ 0x42, 0x98, 0x14, 0x80, 0xB3, 0x43, 0x5F, 0xD3, 0x58, 0x56, 0xE4, 0x1F, 0xAF, 0x58, 0x22, 0x9D },
+		{
+			106, 106, 106, 255, 183, 183, 183, 255, 154, 154, 154, 255, 186, 186, 186, 255,
+			 34,  34,  34, 255, 106, 106, 106, 255, 250, 250, 250, 255, 219, 219, 219, 255,
+			183, 183, 183, 255, 183, 183, 183, 255, 219, 219, 219, 255, 250, 250, 250, 255,
+			114, 114, 114, 255, 114, 114, 114, 255, 178, 178, 178, 255,  29,  29,  29, 255
+		}
+	}
+};
+
+static const struct
+{
+	const char* Name;
+	SDL_GPUTextureFormat Format;
+	Uint8 Block[16];
+	Uint16 Texels[48]; // RGB halves, row by row; alpha is always 1
+} DecoderCheckFloatBlocks[] =
+{
+	{
+		"BC6H mode 1 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x98, 0x39, 0xBA, 0x2E, 0xBA, 0xD7, 0x07, 0x01, 0x3D, 0x2D, 0x3B, 0x3D, 0x56, 0xBC, 0xEE, 0x66 },
+		{
+			0x3775, 0x2D0A, 0x21E9, 0x374D, 0x2D01, 0x21F2, 0x3775, 0x2D0A, 0x21E9, 0x36AC, 0x2CDD, 0x2216,
+			0x3774, 0x2DFA, 0x20C1, 0x36D3, 0x2CE6, 0x220D, 0x3775, 0x2D0A, 0x21E9, 0x379C, 0x2D12, 0x21E1,
+			0x3762, 0x2D85, 0x20A3, 0x36AC, 0x2CDD, 0x2216, 0x3775, 0x2D0A, 0x21E9, 0x36AC, 0x2CDD, 0x2216,
+			0x371A, 0x2BA1, 0x2026, 0x372C, 0x2C16, 0x2044, 0x379C, 0x2D12, 0x21E1, 0x374D, 0x2D01, 0x21F2
+		}
+	},
+	{
+		"BC6H mode 2 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xA5, 0x06, 0xD9, 0x67, 0xF2, 0xDF, 0xF1, 0x9A, 0x07, 0x77, 0x6A, 0x56, 0xC1, 0xA1, 0x60, 0x34 },
+		{
+			0x3348, 0x34BC, 0x2EE4, 0x2540, 0x3C70, 0x17DB, 0x36BC, 0x2FF4, 0x1E84, 0x2E26, 0x3615, 0x1B3F,
+			0x326F, 0x3AAB, 0x2A3B, 0x3348, 0x34BC, 0x2EE4, 0x36BC, 0x2FF4, 0x1E84, 0x2540, 0x3C70, 0x17DB,
+			0x338E, 0x32D4, 0x3064, 0x32B5, 0x38C3, 0x2BBA, 0x3348, 0x34BC, 0x2EE4, 0x36BC, 0x2FF4, 0x1E84,
+			0x3229, 0x3C93, 0x28BB, 0x33D4, 0x30EC, 0x31E4, 0x326F, 0x3AAB, 0x2A3B, 0x338E, 0x32D4, 0x3064
+		}
+	},
+	{
+		"BC6H mode 3 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xE2, 0xBE, 0x3A, 0x83, 0x05, 0x4C, 0xFD, 0x04, 0xE2, 0xC5, 0x5E, 0x04, 0x71, 0xCC, 0xB4, 0xEB },
+		{
+			0x1E7C, 0x25F6, 0x2A89, 0x1E7C, 0x25DA, 0x2A69, 0x1E7C, 0x261D, 0x2AB7, 0x1E7C, 0x2610, 0x2AA8,
+			0x1E7C, 0x261D, 0x2AB7, 0x1E7C, 0x2610, 0x2AA8, 0x1E7C, 0x25CD, 0x2A5A, 0x1E7C, 0x2610, 0x2AA8,
+			0x1E05, 0x265B, 0x2ACD, 0x1E7C, 0x2610, 0x2AA8, 0x1E7C, 0x25F6, 0x2A89, 0x1E7C, 0x2603, 0x2A98,
+			0x1E3D, 0x264C, 0x2AD8, 0x1F26, 0x260D, 0x2B04, 0x1E7C, 0x2603, 0x2A98, 0x1E7C, 0x25C0, 0x2A4A
+		}
+	},
+	{
+		"BC6H mode 4 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x26, 0xDB, 0x47, 0xE5, 0x06, 0xED, 0x6A, 0x24, 0x0B, 0x26, 0xBF, 0x8B, 0x63, 0xB9, 0x24, 0xB1 },
+		{
+			0x2C2B, 0x2775, 0x353A, 0x2C2B, 0x2775, 0x353A, 0x2C2B, 0x2724, 0x34F2, 0x2C2B, 0x2789, 0x354B,
+			0x2C28, 0x27BC, 0x3541, 0x2C2B, 0x2775, 0x353A, 0x2C2B, 0x275F, 0x3527, 0x2C2B, 0x274B, 0x3515,
+			0x2C78, 0x280D, 0x3502, 0x2C2B, 0x2724, 0x34F2, 0x2C2B, 0x2789, 0x354B, 0x2C2B, 0x2789, 0x354B,
+			0x2C51, 0x27E6, 0x3520, 0x2C51, 0x27E6, 0x3520, 0x2C2B, 0x275F, 0x3527, 0x2C2B, 0x274B, 0x3515
+		}
+	},
+	{
+		"BC6H mode 5 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x4A, 0xD0, 0xDF, 0xD1, 0x4B, 0xA4, 0x65, 0xE2, 0x48, 0xB3, 0x4C, 0x76, 0x44, 0x54, 0xBC, 0x6A },
+		{
+			0x26B9, 0x3A04, 0x1DAD, 0x26A8, 0x39FD, 0x1DB7, 0x2736, 0x3A01, 0x1E36, 0x273B, 0x39F4, 0x1E43,
+			0x26B9, 0x3A04, 0x1DAD, 0x2736, 0x3A01, 0x1E36, 0x2724, 0x3A37, 0x1E00, 0x2729, 0x3A2A, 0x1E0D,
+			0x26C8, 0x3A0B, 0x1DA5, 0x273B, 0x39F4, 0x1E43, 0x2724, 0x3A37, 0x1E00, 0x2743, 0x39DA, 0x1E5D,
+			0x273B, 0x39F4, 0x1E43, 0x272D, 0x3A1D, 0x1E1A, 0x273B, 0x39F4, 0x1E43, 0x2729, 0x3A2A, 0x1E0D
+		}
+	},
+	{
+		"BC6H mode 6 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x4E, 0x1A, 0x4E, 0xA5, 0x71, 0x45, 0x13, 0x85, 0x86, 0xF0, 0x14, 0xAA, 0x66, 0x10, 0x31, 0xC0 },
+		{
+			0x3375, 0x25B2, 0x3352, 0x3375, 0x25B2, 0x3352, 0x34F0, 0x250F, 0x3461, 0x33EF, 0x257E, 0x33A9,
+			0x356A, 0x24DB, 0x34B8, 0x35E4, 0x24A7, 0x350F, 0x34F0, 0x250F, 0x3461, 0x33A3, 0x2283, 0x3415,
+			0x32FB, 0x25E7, 0x32FB, 0x3375, 0x25B2, 0x3352, 0x3392, 0x2283, 0x3438, 0x336D, 0x2283, 0x3482,
+			0x3375, 0x25B2, 0x3352, 0x33B5, 0x2283, 0x33F3, 0x33B5, 0x2283, 0x33F3, 0x3380, 0x2283, 0x345B
+		}
+	},
+	{
+		"BC6H mode 7 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xF2, 0x8C, 0xA6, 0x8D, 0x5A, 0xC8, 0xC4, 0x6D, 0x05, 0xBB, 0x2C, 0xAB, 0x60, 0x1F, 0xDF, 0xE1 },
+		{
+			0x3461, 0x26C3, 0x2120, 0x33A1, 0x265B, 0x2177, 0x2E1B, 0x280D, 0x284F, 0x3177, 0x2273, 0x27BF,
+			0x35F6, 0x27A0, 0x2068, 0x331A, 0x1FBA, 0x277A, 0x2FBD, 0x2553, 0x2809, 0x2EEC, 0x26B0, 0x282C,
+			0x3776, 0x2872, 0x1FBA, 0x3248, 0x2116, 0x279C, 0x2E1B, 0x280D, 0x284F, 0x2D4A, 0x296A, 0x2872,
+			0x2E1B, 0x280D, 0x284F, 0x3248, 0x2116, 0x279C, 0x2FBD, 0x2553, 0x2809, 0x30A6, 0x23D0, 0x27E2
+		}
+	},
+	{
+		"BC6H mode 8 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xF6, 0xED, 0xB7, 0xD5, 0x1E, 0xA8, 0xCC, 0x0A, 0x99, 0x98, 0xBA, 0x7B, 0xDE, 0xFD, 0x4D, 0xF1 },
+		{
+			0x366A, 0x3254, 0x3216, 0x369E, 0x307D, 0x3156, 0x364D, 0x2DF2, 0x2FEA, 0x326B, 0x2C5D, 0x300F,
+			0x3776, 0x28EE, 0x2E42, 0x36D9, 0x2E72, 0x3081, 0x3776, 0x28EE, 0x2E42, 0x3094, 0x2B9D, 0x3020,
+			0x370D, 0x2C9B, 0x2FC1, 0x3776, 0x28EE, 0x2E42, 0x3776, 0x28EE, 0x2E42, 0x3741, 0x2AC4, 0x2F01,
+			0x36D9, 0x2E72, 0x3081, 0x366A, 0x3254, 0x3216, 0x36D9, 0x2E72, 0x3081, 0x3776, 0x28EE, 0x2E42
+		}
+	},
+	{
+		"BC6H mode 9 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x7A, 0x8D, 0x2B, 0xD0, 0xB6, 0x51, 0x53, 0xA8, 0x20, 0x54, 0xD1, 0x14, 0xD9, 0x71, 0x0B, 0x9F },
+		{
+			0x3412, 0x2A62, 0x329E, 0x3096, 0x284B, 0x3830, 0x3363, 0x29F9, 0x33B5, 0x3096, 0x284B, 0x3830,
+			0x3412, 0x2A62, 0x329E, 0x3363, 0x29F9, 0x33B5, 0x3206, 0x2928, 0x35E3, 0x37F2, 0x277A, 0x2EBE,
+			0x3412, 0x2A62, 0x329E, 0x37F2, 0x277A, 0x2EBE, 0x364F, 0x286E, 0x2FA0, 0x2F97, 0x2C59, 0x3344,
+			0x2C52, 0x2E42, 0x350A, 0x37F2, 0x277A, 0x2EBE, 0x3139, 0x2B65, 0x3261, 0x2F97, 0x2C59, 0x3344
+		}
+	},
+	{
+		"BC6H mode 10 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xFE, 0xB1, 0xEA, 0x88, 0xC6, 0x1C, 0x13, 0xBD, 0x39, 0x22, 0xBC, 0x40, 0x12, 0xA2, 0x67, 0x7F },
+		{
+			0x2563, 0x2C1B, 0x34DB, 0x2563, 0x2C1B, 0x34DB, 0x207B, 0x2A79, 0x176E, 0x3738, 0x5A18, 0x5828,
+			0x22EF, 0x2B4A, 0x2625, 0x22EF, 0x2B4A, 0x2625, 0x22EF, 0x2B4A, 0x2625, 0x3738, 0x5A18, 0x5828,
+			0x207B, 0x2A79, 0x176E, 0x22EF, 0x2B4A, 0x2625, 0x2F78, 0x2F78, 0x7158, 0x30AE, 0x56D3, 0x5AE1,
+			0x2563, 0x2C1B, 0x34DB, 0x2F78, 0x2F78, 0x7158, 0x2F78, 0x2F78, 0x7158, 0x30AE, 0x56D3, 0x5AE1
+		}
+	},
+	{
+		"BC6H mode 11 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x63, 0x2C, 0x90, 0x78, 0xDB, 0xC9, 0x9C, 0xAE, 0x1E, 0x57, 0xD3, 0xB9, 0x11, 0x42, 0x31, 0x3E },
+		{
+			0x28C7, 0x1FA4, 0x306F, 0x2ABF, 0x227F, 0x351B, 0x28C7, 0x1FA4, 0x306F, 0x2975, 0x20A1, 0x320D,
+			0x2A10, 0x2182, 0x337D, 0x26E2, 0x1CE6, 0x2BF0, 0x282C, 0x1EC3, 0x2EFE, 0x277D, 0x1DC7, 0x2D60,
+			0x2ABF, 0x227F, 0x351B, 0x2ABF, 0x227F, 0x351B, 0x2A5E, 0x21F2, 0x3435, 0x29C3, 0x2111, 0x32C5,
+			0x2ABF, 0x227F, 0x351B, 0x2A10, 0x2182, 0x337D, 0x2682, 0x1C59, 0x2B0A, 0x2A10, 0x2182, 0x337D
+		}
+	},
+	{
+		"BC6H mode 12 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0x27, 0xE5, 0xFD, 0x22, 0x2E, 0xE3, 0x0A, 0x55, 0x40, 0xB8, 0x53, 0x00, 0xF6, 0x4C, 0x13, 0xB7 },
+		{
+			0x3103, 0x1EBA, 0x2F8F, 0x32A3, 0x2020, 0x324B, 0x3442, 0x2186, 0x3507, 0x3581, 0x2298, 0x371E,
+			0x3241, 0x1FCC, 0x31A6, 0x3305, 0x2074, 0x32EF, 0x3103, 0x1EBA, 0x2F8F, 0x3103, 0x1EBA, 0x2F8F,
+			0x337F, 0x20DE, 0x33BD, 0x3720, 0x23FE, 0x39DA, 0x35E3, 0x22ED, 0x37C3, 0x32A3, 0x2020, 0x324B,
+			0x3241, 0x1FCC, 0x31A6, 0x3165, 0x1F0E, 0x3033, 0x33E1, 0x2132, 0x3462, 0x3581, 0x2298, 0x371E
+		}
+	},
+	{
+		"BC6H mode 13 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xCB, 0xA7, 0x0C, 0x0E, 0xFC, 0x95, 0x43, 0x06, 0xDD, 0x21, 0x42, 0x68, 0x48, 0xE3, 0xC3, 0x81 },
+		{
+			0x27D7, 0x201D, 0x2EDF, 0x26F3, 0x2080, 0x2F0A, 0x2884, 0x1FD3, 0x2EBF, 0x285D, 0x1FE4, 0x2EC7,
+			0x285D, 0x1FE4, 0x2EC7, 0x281E, 0x1FFF, 0x2ED2, 0x2799, 0x2038, 0x2EEB, 0x27D7, 0x201D, 0x2EDF,
+			0x2799, 0x2038, 0x2EEB, 0x281E, 0x1FFF, 0x2ED2, 0x283E, 0x1FF1, 0x2ECD, 0x26CC, 0x2091, 0x2F11,
+			0x283E, 0x1FF1, 0x2ECD, 0x2712, 0x2072, 0x2F04, 0x2884, 0x1FD3, 0x2EBF, 0x2799, 0x2038, 0x2EEB
+		}
+	},
+	{
+		"BC6H mode 14 unsigned", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT,
+		{ 0xCF, 0x9D, 0x8E, 0x41, 0x7B, 0x7E, 0x25, 0x93, 0x61, 0xEC, 0x58, 0xAD, 0xEC, 0xE6, 0x61, 0x5B },
+		{
+			0x1D83, 0x2462, 0x2599, 0x1D83, 0x2461, 0x259A, 0x1D82, 0x2460, 0x259B, 0x1D82, 0x245F, 0x259C,
+			0x1D82, 0x2460, 0x259A, 0x1D83, 0x2461, 0x259A, 0x1D82, 0x2460, 0x259B, 0x1D82, 0x2460, 0x259B,
+			0x1D82, 0x2460, 0x259B, 0x1D82, 0x245F, 0x259C, 0x1D83, 0x2461, 0x259A, 0x1D82, 0x245F, 0x259C,
+			0x1D83, 0x2462, 0x2599, 0x1D83, 0x2461, 0x259A, 0x1D82, 0x2460, 0x259B, 0x1D83, 0x2461, 0x259A
+		}
+	},
+	{
+		"BC6H mode 1 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x1C, 0x0F, 0x3A, 0x3C, 0xF1, 0xFC, 0x05, 0xBA, 0x8D, 0x2B, 0x7C, 0xB7, 0x79, 0xCB, 0xF5, 0x26 },
+		{
+			0x1CFA, 0x1DBF, 0x2529, 0x1CB3, 0x1FD9, 0x237B, 0x1CC4, 0x1F56, 0x23E3, 0x1C06, 0x1C14, 0x23EB,
+			0x1CD5, 0x1ED3, 0x244C, 0x1D1D, 0x1CB9, 0x25FA, 0x1CB3, 0x1FD9, 0x237B, 0x1C06, 0x1C14, 0x23EB,
+			0x1CD5, 0x1ED3, 0x244C, 0x1CE7, 0x1E50, 0x24B4, 0x1CFA, 0x1DBF, 0x2529, 0x1C06, 0x1C14, 0x23EB,
+			0x1CB3, 0x1FD9, 0x237B, 0x1CC4, 0x1F56, 0x23E3, 0x1CE7, 0x1E50, 0x24B4, 0x1EA3, 0x1BBB, 0x25A9
+		}
+	},
+	{
+		"BC6H mode 2 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x89, 0x43, 0x04, 0x4F, 0x02, 0xC0, 0x5F, 0x7A, 0x84, 0xD8, 0x79, 0x9F, 0x49, 0x8C, 0x97, 0xB0 },
+		{
+			0x3738, 0x0F61, 0x45FE, 0x3738, 0x0C98, 0x3548, 0x3738, 0x0D23, 0x388D, 0x3738, 0x0C98, 0x3548,
+			0x280D, 0x3BCA, 0x3837, 0x3676, 0x3277, 0x6372, 0x3676, 0x3277, 0x6372, 0x3676, 0x3277, 0x6372,
+			0x1EC9, 0x41C8, 0x1C6D, 0x3B18, 0x2F78, 0x7158, 0x1A28, 0x44C8, 0x0E88, 0x236B, 0x3EC9, 0x2A52,
+			0x280D, 0x3BCA, 0x3837, 0x3B18, 0x2F78, 0x7158, 0x1EC9, 0x41C8, 0x1C6D, 0x31D4, 0x3576, 0x558D
+		}
+	},
+	{
+		"BC6H mode 3 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0xA2, 0xB6, 0xB9, 0xEC, 0x72, 0xFA, 0x38, 0x22, 0xB7, 0x26, 0xF5, 0x29, 0x98, 0xB9, 0x73, 0x16 },
+		{
+			0x3537, 0x2D1B, 0x2D6A, 0x36AC, 0x2DD5, 0x2DD5, 0x354A, 0x2D22, 0x2CDC, 0x34FC, 0x2CF6, 0x2CBD,
+			0x3537, 0x2D1B, 0x2D6A, 0x345F, 0x2C9F, 0x2C80, 0x354A, 0x2D22, 0x2CDC, 0x363F, 0x2DA9, 0x2D3B,
+			0x35A2, 0x2D52, 0x2CFE, 0x354A, 0x2D22, 0x2CDC, 0x368D, 0x2DD5, 0x2D59, 0x35A2, 0x2D52, 0x2CFE,
+			0x354A, 0x2D22, 0x2CDC, 0x363F, 0x2DA9, 0x2D3B, 0x34FC, 0x2CF6, 0x2CBD, 0x345F, 0x2C9F, 0x2C80
+		}
+	},
+	{
+		"BC6H mode 4 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x06, 0x97, 0xA7, 0x58, 0x22, 0x99, 0x0B, 0x31, 0x79, 0x2F, 0xBF, 0x0A, 0x1C, 0x48, 0xB1, 0x50 },
+		{
+			0x168B, 0x286C, 0x247D, 0x168B, 0x286C, 0x247D, 0x16B0, 0x2847, 0x2490, 0x167A, 0x287D, 0x2474,
+			0x15DB, 0x2824, 0x238A, 0x169F, 0x2858, 0x2487, 0x168B, 0x286C, 0x247D, 0x1657, 0x28A0, 0x2463,
+			0x15DB, 0x2824, 0x238A, 0x1668, 0x288F, 0x246C, 0x16B0, 0x2847, 0x2490, 0x1657, 0x28A0, 0x2463,
+			0x15F5, 0x2795, 0x2441, 0x15E4, 0x27F5, 0x23C7, 0x169F, 0x2858, 0x2487, 0x167A, 0x287D, 0x2474
+		}
+	},
+	{
+		"BC6H mode 5 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x2A, 0xC2, 0xAA, 0x4E, 0x73, 0x81, 0x50, 0xA1, 0xD8, 0xA4, 0xA1, 0xB0, 0xF3, 0x9F, 0x00, 0xE2 },
+		{
+			0x401E, 0x295A, 0x3348, 0x400D, 0x297D, 0x3359, 0x4015, 0x296B, 0x3351, 0x3FFA, 0x29A2, 0x336C,
+			0x3FF1, 0x29B3, 0x3375, 0x4004, 0x298E, 0x3362, 0x3FE9, 0x29C5, 0x337D, 0x3FE0, 0x29D6, 0x3386,
+			0x3F45, 0x28A0, 0x33C4, 0x3F95, 0x2940, 0x3235, 0x3F95, 0x2940, 0x3235, 0x3FA2, 0x295A, 0x31F3,
+			0x3FA2, 0x295A, 0x31F3, 0x3F88, 0x2926, 0x3276, 0x3F6D, 0x28EE, 0x3300, 0x3F7B, 0x290C, 0x32B8
+		}
+	},
+	{
+		"BC6H mode 6 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x2E, 0x89, 0x31, 0xB3, 0xA4, 0x7B, 0x0C, 0x48, 0x40, 0x31, 0x4A, 0xE3, 0x82, 0x34, 0x25, 0x18 },
+		{
+			0x21F7, 0x309A, 0x292C, 0x2429, 0x2B61, 0x2AEB, 0x23DF, 0x2D1B, 0x2BA3, 0x23BC, 0x2DEC, 0x2BFA,
+			0x1E9B, 0x3171, 0x24B1, 0x1F6C, 0x313D, 0x25C8, 0x239A, 0x3032, 0x2B5A, 0x2429, 0x2B61, 0x2AEB,
+			0x203D, 0x3109, 0x26DF, 0x1E9B, 0x3171, 0x24B1, 0x203D, 0x3109, 0x26DF, 0x21F7, 0x309A, 0x292C,
+			0x21F7, 0x309A, 0x292C, 0x239A, 0x3032, 0x2B5A, 0x1E9B, 0x3171, 0x24B1, 0x239A, 0x3032, 0x2B5A
+		}
+	},
+	{
+		"BC6H mode 7 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x12, 0xA4, 0x1C, 0x3A, 0xD6, 0x51, 0x17, 0xD0, 0x7E, 0xCD, 0x1B, 0x4D, 0x6D, 0xB9, 0xAB, 0x8D },
+		{
+			0x1DD9, 0x3611, 0x1C94, 0x2231, 0x3C74, 0x20E4, 0x25DF, 0x3975, 0x1F64, 0x34FE, 0x2D23, 0x193B,
+			0x1C1F, 0x3457, 0x1C94, 0x1DD9, 0x3611, 0x1C94, 0x1D08, 0x3540, 0x1C94, 0x298C, 0x3676, 0x1DE5,
+			0x2231, 0x3C74, 0x20E4, 0x19AC, 0x31E4, 0x1C94, 0x1A7D, 0x32B5, 0x1C94, 0x1B4E, 0x3386, 0x1C94,
+			0x25DF, 0x3975, 0x1F64, 0x298C, 0x3676, 0x1DE5, 0x298C, 0x3676, 0x1DE5, 0x1C1F, 0x3457, 0x1C94
+		}
+	},
+	{
+		"BC6H mode 8 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x96, 0x67, 0x0E, 0x7F, 0x32, 0x0B, 0x61, 0xEB, 0x40, 0xAB, 0x1C, 0x23, 0x3A, 0x63, 0x48, 0xB0 },
+		{
+			0x3D0F, 0x1EE1, 0x396D, 0x3B6D, 0x1CB3, 0x3C27, 0x3248, 0x1B23, 0x4073, 0x3A9C, 0x2FF4, 0x34CC,
+			0x3B6D, 0x1CB3, 0x3C27, 0x37E2, 0x2924, 0x389C, 0x30EC, 0x17BC, 0x425C, 0x3502, 0x21F3, 0x3CA3,
+			0x3B6D, 0x1CB3, 0x3C27, 0x3248, 0x1B23, 0x4073, 0x3A9C, 0x2FF4, 0x34CC, 0x37E2, 0x2924, 0x389C,
+			0x37E2, 0x2924, 0x389C, 0x3A9C, 0x2FF4, 0x34CC, 0x3248, 0x1B23, 0x4073, 0x37E2, 0x2924, 0x389C
+		}
+	},
+	{
+		"BC6H mode 9 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x5A, 0x05, 0x0A, 0x5E, 0x4E, 0x95, 0xC8, 0xDF, 0x18, 0xE0, 0xA8, 0xA4, 0x46, 0xF2, 0x5E, 0x03 },
+		{
+			0x2B9F, 0x14F3, 0x2DBE, 0x2B9F, 0x14F3, 0x2DBE, 0x2A65, 0x1467, 0x2DE1, 0x2A65, 0x1467, 0x2DE1,
+			0x2F70, 0x16A5, 0x2D51, 0x30AA, 0x1730, 0x2D2E, 0x292C, 0x13DC, 0x2E04, 0x3329, 0x1B3B, 0x30D4,
+			0x2A65, 0x1467, 0x2DE1, 0x31E4, 0x17BC, 0x2D0C, 0x2C71, 0x11B5, 0x2482, 0x292C, 0x0D14, 0x1E84,
+			0x2B9F, 0x14F3, 0x2DBE, 0x2FE4, 0x1699, 0x2AD6, 0x34CC, 0x1D8C, 0x33D4, 0x34CC, 0x1D8C, 0x33D4
+		}
+	},
+	{
+		"BC6H mode 10 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0xDE, 0xA8, 0x88, 0xEA, 0x61, 0xAE, 0xD0, 0x4B, 0x9B, 0x83, 0x3E, 0x0C, 0xA9, 0xDB, 0x7D, 0x01 },
+		{
+			0x22FF, 0x3032, 0x0CA7, 0x22FF, 0x3032, 0x0CA7, 0x3450, 0x1D10, 0x28B0, 0x2055, 0x918F, 0x3602,
+			0x1930, 0x43D0, 0xAC90, 0x1FBA, 0x36BC, 0x866B, 0x1FBA, 0x36BC, 0x866B, 0x239A, 0x89EE, 0x33D4,
+			0x22FF, 0x3032, 0x0CA7, 0x22FF, 0x3032, 0x0CA7, 0x3070, 0x1550, 0x5B10, 0x2D2B, 0x1BDA, 0x47FD,
+			0x3070, 0x1550, 0x5B10, 0x1FBA, 0x36BC, 0x866B, 0x1930, 0x43D0, 0xAC90, 0x1930, 0x43D0, 0xAC90
+		}
+	},
+	{
+		"BC6H mode 11 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x83, 0x98, 0xD4, 0x1E, 0xE2, 0x06, 0xDF, 0x21, 0xD0, 0x8B, 0xD4, 0x7C, 0xB9, 0x4A, 0x2B, 0x81 },
+		{
+			0x2F97, 0x670D, 0x41C1, 0x3495, 0xA88F, 0x174B, 0x33DB, 0x93AB, 0x1D78, 0x32AD, 0x0E46, 0x2781,
+			0x3122, 0x3AA9, 0x34A1, 0x3495, 0xA88F, 0x174B, 0x3438, 0x9E1D, 0x1A62, 0x3250, 0x18B7, 0x2A98,
+			0x330A, 0x03D4, 0x246B, 0x33DB, 0x93AB, 0x1D78, 0x337E, 0x8939, 0x208F, 0x3122, 0x3AA9, 0x34A1,
+			0x33DB, 0x93AB, 0x1D78, 0x3068, 0x4F8D, 0x3ACE, 0x2FF4, 0x5C9B, 0x3EAA, 0x32AD, 0x0E46, 0x2781
+		}
+	},
+	{
+		"BC6H mode 12 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0xE7, 0x28, 0xA8, 0xBD, 0xEA, 0x8A, 0xD9, 0x0C, 0xDC, 0xFF, 0x52, 0xCC, 0x1C, 0x52, 0x45, 0x42 },
+		{
+			0x1FA3, 0x8B49, 0x2BAC, 0x16B2, 0x8009, 0x2D0C, 0x13EB, 0x0373, 0x2D78, 0x13EB, 0x0373, 0x2D78,
+			0x24E2, 0x91E1, 0x2ADE, 0x212E, 0x8D39, 0x2B70, 0x17EE, 0x8196, 0x2CDB, 0x17EE, 0x8196, 0x2CDB,
+			0x17EE, 0x8196, 0x2CDB, 0x266C, 0x93D2, 0x2AA1, 0x24E2, 0x91E1, 0x2ADE, 0x212E, 0x8D39, 0x2B70,
+			0x212E, 0x8D39, 0x2B70, 0x226A, 0x8EC6, 0x2B3F, 0x24E2, 0x91E1, 0x2ADE, 0x226A, 0x8EC6, 0x2B3F
+		}
+	},
+	{
+		"BC6H mode 13 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0x6B, 0x5A, 0x31, 0x21, 0x75, 0x46, 0x0A, 0x5B, 0x6C, 0x9F, 0x8A, 0x13, 0xF5, 0xEC, 0x5F, 0xA1 },
+		{
+			0x2A93, 0x26FB, 0x25ED, 0x2A93, 0x26FB, 0x25ED, 0x28C7, 0x29ED, 0x2344, 0x2A02, 0x27E9, 0x2516,
+			0x29C6, 0x284D, 0x24BD, 0x2A32, 0x2799, 0x255E, 0x2B31, 0x25F9, 0x26D7, 0x2B9D, 0x2546, 0x2778,
+			0x2AD0, 0x2698, 0x2647, 0x28C7, 0x29ED, 0x2344, 0x2965, 0x28EC, 0x242E, 0x28F7, 0x299E, 0x238C,
+			0x28C7, 0x29ED, 0x2344, 0x2AD0, 0x2698, 0x2647, 0x2B9D, 0x2546, 0x2778, 0x29C6, 0x284D, 0x24BD
+		}
+	},
+	{
+		"BC6H mode 14 signed", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT,
+		{ 0xCF, 0x08, 0xC2, 0xCD, 0x68, 0x4E, 0x49, 0xE1, 0x82, 0x31, 0xCE, 0xA3, 0x04, 0xD5, 0x3F, 0x7C },
+		{
+			0x3683, 0x2647, 0x36A2, 0x3681, 0x2644, 0x36A3, 0x3683, 0x2647, 0x36A2, 0x3682, 0x2646, 0x36A2,
+			0x3680, 0x2642, 0x36A4, 0x3681, 0x2643, 0x36A4, 0x3682, 0x2646, 0x36A2, 0x3681, 0x2644, 0x36A3,
+			0x3682, 0x2645, 0x36A3, 0x3683, 0x2647, 0x36A2, 0x3682, 0x2645, 0x36A3, 0x3680, 0x2643, 0x36A4,
+			0x3680, 0x2642, 0x36A4, 0x3682, 0x2646, 0x36A2, 0x3681, 0x2643, 0x36A4, 0x3682, 0x2644, 0x36A3
+		}
+	}
+};
+
+// Hardware decoders may interpolate BC1-BC3 palettes with coarser weights, which can move an
+// 8-bit channel by up to about 11 steps, so only larger differences count as mismatches
+#define DECODER_CHECK_UNORM_TOLERANCE (16.0f / 255.0f)
+#define DECODER_CHECK_FLOAT_TOLERANCE (1.0f / 128.0f)
+
+static float HalfToFloat(Uint16 value)
+{
+	int exponent = (value >> 10) & 0x1F;
+	int mantissa = value & 0x3FF;
+	float magnitude;
+	if (exponent == 0)
+	{
+		magnitude = SDL_scalbnf((float) mantissa, -24);
+	}
+	else if (exponent == 31)
+	{
+		magnitude = 65536.0f; // Past the largest half, so infinities and NaNs never match a number
+	}
+	else
+	{
+		magnitude = SDL_scalbnf((float) (mantissa | 0x400), exponent - 25);
+	}
+	return (value & 0x8000) ? -magnitude : magnitude;
+}
+
+// Largest difference between two decodes of the same texels: in [0, 1] units for RGBA8, and
+// relative to the reference (or to 1, whichever is larger) for RGBA16F
+static float GetLargestDecodeError(const Uint8* decoded, const Uint8* reference, Uint32 length, bool isHalf)
+{
+	float largest = 0;
+	if (isHalf)
+	{
+		const Uint16* decodedHalves = (const Uint16*) decoded;
+		const Uint16* referenceHalves = (const Uint16*) reference;
+		for (Uint32 i = 0; i < length / sizeof(Uint16); i += 1)
+		{
+			float expected = HalfToFloat(referenceHalves[i]);
+			float error = SDL_fabsf(HalfToFloat(decodedHalves[i]) - expected) / SDL_max(SDL_fabsf(expected), 1.0f);
+			largest = SDL_max(largest, error);
+		}
+	}
+	else
+	{
+		for (Uint32 i = 0; i < length; i += 1)
+		{
+			largest = SDL_max(largest, SDL_abs(decoded[i] - reference[i]) / 255.0f);
+		}
+	}
+	return largest;
+}
+
+/* Has the GPU decode every subresource by blitting it into a texture of decodedFormat, then reads
+ * the texels back into dst packed in the same order as DecompressImage's output.
+ */
+static bool DecodeImageOnGPU(
+	SDL_GPUDevice* device,
+	const CompressedImage* image,
+	SDL_GPUTextureFormat format,
+	const Uint8* blocks,
+	SDL_GPUTextureFormat decodedFormat,
+	Uint32 texelSize,
+	Uint8* dst,
+	Uint32 dstLength
+) {
+	SDL_GPUTextureCreateInfo createInfo =
+	{
+		.type = GetCompressedImageTextureType(image),
+		.format = format,
+		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+		.width = image->Width,
+		.height = image->Height,
+		.layer_count_or_depth = image->LayerCount,
+		.num_levels = image->MipLevelCount
+	};
+	SDL_GPUTexture* texture = SDL_CreateGPUTexture(device, &createInfo);
+	createInfo.format = decodedFormat;
+	createInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+	SDL_GPUTexture* target = SDL_CreateGPUTexture(device, &createInfo);
+	SDL_GPUTransferBuffer* uploadBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = image->DataLength }
+	);
+	SDL_GPUTransferBuffer* downloadBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD, .size = dstLength }
+	);
+
+	bool decoded = false;
+	void* uploadData = (texture && target && uploadBuffer && downloadBuffer) ? SDL_MapGPUTransferBuffer(device, uploadBuffer, false) : NULL;
+	if (uploadData != NULL)
+	{
+		SDL_memcpy(uploadData, blocks, image->DataLength);
+		SDL_UnmapGPUTransferBuffer(device, uploadBuffer);
+
+		SDL_GPUCommandBuffer* cmdBuf = SDL_AcquireGPUCommandBuffer(device);
+		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+		UploadCompressedImage(copyPass, uploadBuffer, 0, texture, image);
+		SDL_EndGPUCopyPass(copyPass);
+
+		for (int i = 0; i < image->SubresourceCount; i += 1)
+		{
+			const CompressedImageSubresource* subresource = &image->Subresources[i];
+			SDL_GPUBlitRegion region =
+			{
+				.mip_level = subresource->MipLevel,
+				.layer_or_depth_plane = subresource->Layer,
+				.w = subresource->Width,
+				.h = subresource->Height
+			};
+			SDL_GPUBlitInfo blitInfo = { .source = region, .destination = region, .filter = SDL_GPU_FILTER_NEAREST };
+			blitInfo.source.texture = texture;
+			blitInfo.destination.texture = target;
+			SDL_BlitGPUTexture(cmdBuf, &blitInfo);
+		}
+
+		copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+		Uint32 offset = 0;
+		for (int i = 0; i < image->SubresourceCount; i += 1)
+		{
+			const CompressedImageSubresource* subresource = &image->Subresources[i];
+			SDL_DownloadFromGPUTexture(
+				copyPass,
+				&(SDL_GPUTextureRegion) {
+					.texture = target,
+					.mip_level = subresource->MipLevel,
+					.layer = subresource->Layer,
+					.w = subresource->Width,
+					.h = subresource->Height,
+					.d = 1
+				},
+				&(SDL_GPUTextureTransferInfo) { .transfer_buffer = downloadBuffer, .offset = offset }
+			);
+			offset += subresource->Width * subresource->Height * texelSize;
+		}
+		SDL_EndGPUCopyPass(copyPass);
+
+		SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdBuf);
+		if (fence != NULL)
+		{
+			SDL_WaitForGPUFences(device, true, &fence, 1);
+			SDL_ReleaseGPUFence(device, fence);
+
+			const void* downloadData = SDL_MapGPUTransferBuffer(device, downloadBuffer, false);
+			if (downloadData != NULL)
+			{
+				SDL_memcpy(dst, downloadData, dstLength);
+				SDL_UnmapGPUTransferBuffer(device, downloadBuffer);
+				decoded = true;
+			}
+		}
+	}
+
+	SDL_ReleaseGPUTexture(device, texture);
+	SDL_ReleaseGPUTexture(device, target);
+	SDL_ReleaseGPUTransferBuffer(device, uploadBuffer);
+	SDL_ReleaseGPUTransferBuffer(device, downloadBuffer);
+	return decoded;
+}
+
+// Returns the number of known-answer blocks that didn't decode to their expected texels
+static int CheckDecoderBlocks(void)
+{
+	int failures = 0;
+	for (int i = 0; i < SDL_arraysize(DecoderCheckUnormBlocks); i += 1)
+	{
+		Uint8 texels[64];
+		bool matched =
+			DecompressTextureData(DecoderCheckUnormBlocks[i].Format, DecoderCheckUnormBlocks[i].Block, 4, 4, texels) &&
+			SDL_memcmp(texels, DecoderCheckUnormBlocks[i].Texels, sizeof(texels)) == 0;
+		if (!matched)
+		{
+			SDL_Log("%-24s MISMATCH", DecoderCheckUnormBlocks[i].Name);
+			failures += 1;
+		}
+	}
+	for (int i = 0; i < SDL_arraysize(DecoderCheckFloatBlocks); i += 1)
+	{
+		Uint16 texels[64];
+		bool matched = DecompressTextureData(DecoderCheckFloatBlocks[i].Format, DecoderCheckFloatBlocks[i].Block, 4, 4, texels);
+		for (int j = 0; matched && j < 16; j += 1)
+		{
+			matched =
+				SDL_memcmp(&texels[j * 4], &DecoderCheckFloatBlocks[i].Texels[j * 3], 3 * sizeof(Uint16)) == 0 &&
+				texels[j * 4 + 3] == 0x3C00;
+		}
+		if (!matched)
+		{
+			SDL_Log("%-24s MISMATCH", DecoderCheckFloatBlocks[i].Name);
+			failures += 1;
+		}
+	}
+
+	SDL_Log(
+		"Texture decoder check: %d of %d known-answer blocks failed",
+		failures,
+		(int) (SDL_arraysize(DecoderCheckUnormBlocks) + SDL_arraysize(DecoderCheckFloatBlocks))
+	);
+	return failures;
+}
+
+/* Checks the software decoders against the known-answer blocks, then decodes every bundled BCn
+ * and ASTC image in software and compares each mip and layer with the GPU's own decoding of the
+ * same blocks. Images in formats the device can't sample are decoded but have nothing to be
+ * compared with. Returns the number of blocks and images that failed, or -1 if the device
+ * couldn't be created.
+ */
+int CheckTextureDecoders(void)
+{
+	int blockFailures = CheckDecoderBlocks();
+
+	Context context = { 0 };
+	context.ExampleName = "TextureDecoderCheck";
+	if (CommonInit(&context, 0) < 0)
+	{
+		return -1;
+	}
+
+	int failures = 0;
+	int compared = 0;
+	for (int i = 0; i < SDL_arraysize(DecoderCheckImages); i += 1)
+	{
+		const char* name = DecoderCheckImages[i].Name;
+		SDL_GPUTextureFormat format = DecoderCheckImages[i].Format;
+
+		CompressedImage image;
+		bool opened = (SDL_strstr(name, ".dds") != NULL) ? OpenDDSImage(name, format, &image) : OpenASTCImage(name, &image);
+		if (!opened)
+		{
+			SDL_Log("%-16s could not be opened!", name);
+			failures += 1;
+			continue;
+		}
+
+		SDL_GPUTextureFormat decodedFormat = GetDecompressedTextureFormat(format);
+		Uint32 decodedLength = GetDecompressedImageLength(&image, format);
+		Uint32 texelSize = (decodedFormat == SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT) ? 8 : 4;
+		Uint8* blocks = SDL_malloc(image.DataLength);
+		Uint8* decoded = SDL_malloc(decodedLength);
+		Uint8* reference = SDL_malloc(decodedLength);
+		if (blocks == NULL || decoded == NULL || reference == NULL || !ReadCompressedImageData(&image, blocks))
+		{
+			SDL_Log("%-16s could not be read!", name);
+			failures += 1;
+			SDL_free(blocks);
+			SDL_free(decoded);
+			SDL_free(reference);
+			CloseCompressedImage(&image);
+			continue;
+		}
+
+		// The GPU goes first: DecompressImage rewrites the subresources to describe its output
+		SDL_GPUTextureType textureType = GetCompressedImageTextureType(&image);
+		bool hasReference =
+			SDL_GPUTextureSupportsFormat(context.Device, format, textureType, SDL_GPU_TEXTUREUSAGE_SAMPLER) &&
+			SDL_GPUTextureSupportsFormat(context.Device, decodedFormat, textureType, SDL_GPU_TEXTUREUSAGE_COLOR_TARGET);
+		if (hasReference && !DecodeImageOnGPU(context.Device, &image, format, blocks, decodedFormat, texelSize, reference, decodedLength))
+		{
+			SDL_Log("%-16s could not be decoded on the GPU: %s", name, SDL_GetError());
+			hasReference = false;
+			failures += 1;
+		}
+
+		if (!DecompressImage(&image, format, blocks, decoded))
+		{
+			failures += 1;
+		}
+		else if (hasReference)
+		{
+			float largestError = 0;
+			int worstSubresource = 0;
+			for (int j = 0; j < image.SubresourceCount; j += 1)
+			{
+				const CompressedImageSubresource* subresource = &image.Subresources[j];
+				float error = GetLargestDecodeError(
+					decoded + subresource->Offset,
+					reference + subresource->Offset,
+					subresource->Length,
+					texelSize == 8
+				);
+				if (error > largestError)
+				{
+					largestError = error;
+					worstSubresource = j;
+				}
+			}
+
+			float tolerance = (texelSize == 8) ? DECODER_CHECK_FLOAT_TOLERANCE : DECODER_CHECK_UNORM_TOLERANCE;
+			bool matched = largestError <= tolerance;
+			SDL_Log(
+				"%-16s %2d subresources, largest error %.4f (mip %d, layer %d)%s",
+				name,
+				image.SubresourceCount,
+				largestError,
+				image.Subresources[worstSubresource].MipLevel,
+				image.Subresources[worstSubresource].Layer,
+				matched ? "" : " MISMATCH"
+			);
+			compared += 1;
+			failures += matched ? 0 : 1;
+		}
+		else
+		{
+			SDL_Log("%-16s %2d subresources, decoded with no GPU decoder to compare against", name, image.SubresourceCount);
+		}
+
+		SDL_free(blocks);
+		SDL_free(decoded);
+		SDL_free(reference);
+		CloseCompressedImage(&image);
+	}
+
+	SDL_Log(
+		"Texture decoder check: %d of %d images compared with the GPU, %d failed",
+		compared,
+		(int) SDL_arraysize(DecoderCheckImages),
+		failures
+	);
+	CommonQuit(&context);
+	return blockFailures + failures;
+}
+
+typedef struct FrameTimeSummary
+{
+	double Mean;
+	double P50;
+	double P95;
+	double P99;
+	double Max;
+} FrameTimeSummary;
+
+typedef struct ExampleBenchmark
+{
+	const char* Name;
+	const char* Driver;
+	const char* Error; // NULL if every frame ran
+	FrameTimeSummary FrameMs;
+	FrameTimeSummary SubmitMs;
+	double SubmitsPerFrame;
+	Uint64 GPUMemoryPeakBytes;
+	int GPULeaks;
+	CommandStats Commands; // Summed over the measured frames
+} ExampleBenchmark;
+
+static int CompareFrameTimes(const void* a, const void* b)
+{
+	double left = *(const double*) a;
+	double right = *(const double*) b;
+	return (left > right) - (left < right);
+}
+
+// Nearest-rank percentiles of the times, which are sorted in place
+static FrameTimeSummary SummarizeFrameTimes(double* times, int count)
+{
+	SDL_qsort(times, count, sizeof(double), CompareFrameTimes);
+
+	double total = 0;
+	for (int i = 0; i < count; i += 1)
+	{
+		total += times[i];
+	}
+
+	const int percentiles[] = { 50, 95, 99 };
+	double values[3];
+	for (int i = 0; i < 3; i += 1)
+	{
+		int rank = (percentiles[i] * count + 99) / 100;
+		values[i] = times[SDL_clamp(rank, 1, count) - 1];
+	}
+
+	return (FrameTimeSummary) {
+		.Mean = total / count,
+		.P50 = values[0],
+		.P95 = values[1],
+		.P99 = values[2],
+		.Max = times[count - 1]
+	};
+}
+
+/* Runs one example headless for warm-up and measured frames with a fixed time step and random
+ * seed, timing each frame's Update, Draw and readback processing on the CPU, and the submits made
+ * within them.
+ */
+static void BenchmarkExample(Example* example, int warmupFrames, int measuredFrames, Uint64 seed, ExampleBenchmark* result)
+{
+	SDL_zerop(result);
+	result->Name = example->Name;
+
+	Context context = { 0 };
+	context.ExampleName = example->Name;
+	context.DeltaTime = 1.0f / 60.0f;
+	int leaksBefore = GetGPUMemoryStats().Leaks;
+	SDL_srand(seed);
+	if (example->Init(&context) < 0)
+	{
+		result->Error = "init failed";
+		if (context.Device != NULL)
+		{
+			result->Driver = SDL_GetGPUDeviceDriver(context.Device);
+			example->Quit(&context);
+		}
+		return;
+	}
+	result->Driver = SDL_GetGPUDeviceDriver(context.Device);
+	EndCommandStatsFrame(); // Init's uploads aren't part of any frame
+
+	double* frameTimes = SDL_malloc(measuredFrames * sizeof(double));
+	double* submitTimes = SDL_malloc(measuredFrames * sizeof(double));
+	if (frameTimes == NULL || submitTimes == NULL)
+	{
+		result->Error = "out of memory";
+	}
+	Uint64 measuredSubmits = 0;
+	for (int frame = 0; result->Error == NULL && frame < warmupFrames + measuredFrames; frame += 1)
+	{
+		SDL_PumpEvents();
+		SubmitStats submitsBefore = GetSubmitStats();
+		Uint64 start = SDL_GetPerformanceCounter();
+		PROFILE_BEGIN(example->Name);
+		PROFILE_BEGIN("Update");
+		bool failed = example->Update(&context) < 0;
+		PROFILE_END();
+		if (!failed)
+		{
+			PROFILE_BEGIN("Draw");
+			failed = example->Draw(&context) < 0;
+			PROFILE_END();
+		}
+		if (failed)
+		{
+			PROFILE_END();
+			result->Error = "frame failed";
+			break;
+		}
+		UpdateReadbacks(context.Device);
+		PROFILE_END();
+		double frameMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+		SubmitStats submitsAfter = GetSubmitStats();
+		CommandStats commands = EndCommandStatsFrame();
+
+		if (frame >= warmupFrames)
+		{
+			frameTimes[frame - warmupFrames] = frameMs;
+			submitTimes[frame - warmupFrames] = submitsAfter.Milliseconds - submitsBefore.Milliseconds;
+			measuredSubmits += submitsAfter.Submits - submitsBefore.Submits;
+			AddCommandStats(&result->Commands, &commands);
+		}
+	}
+
+	if (result->Error == NULL)
+	{
+		result->FrameMs = SummarizeFrameTimes(frameTimes, measuredFrames);
+		result->SubmitMs = SummarizeFrameTimes(submitTimes, measuredFrames);
+		result->SubmitsPerFrame = (double) measuredSubmits / measuredFrames;
+	}
+
+	SDL_free(frameTimes);
+	SDL_free(submitTimes);
+	example->Quit(&context);
+
+	// The peak covers Init and every frame, Quit reports the leaks
+	GPUMemoryStats memoryStats = GetGPUMemoryStats();
+	result->GPUMemoryPeakBytes = memoryStats.PeakBytes;
+	result->GPULeaks = memoryStats.Leaks - leaksBefore;
+}
+
+static void WriteFrameTimeSummary(SDL_IOStream* file, const char* key, const FrameTimeSummary* summary)
+{
+	SDL_IOprintf(
+		file,
+		"\t\t\t\"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+		key,
+		summary->Mean,
+		summary->P50,
+		summary->P95,
+		summary->P99,
+		summary->Max
+	);
+}
+
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+// The counts written per frame to the JSON, and compared against baselines
+static const struct
+{
+	const char* Key;
+	size_t Offset;
+} CommandStatsFields[] = {
+	{ "render_passes", offsetof(CommandStats, RenderPasses) },
+	{ "compute_passes", offsetof(CommandStats, ComputePasses) },
+	{ "copy_passes", offsetof(CommandStats, CopyPasses) },
+	{ "draws", offsetof(CommandStats, Draws) },
+	{ "dispatches", offsetof(CommandStats, Dispatches) },
+	{ "pipeline_binds", offsetof(CommandStats, PipelineBinds) },
+	{ "vertex_buffer_binds", offsetof(CommandStats, VertexBufferBinds) },
+	{ "index_buffer_binds", offsetof(CommandStats, IndexBufferBinds) },
+	{ "sampler_binds", offsetof(CommandStats, SamplerBinds) },
+	{ "storage_binds", offsetof(CommandStats, StorageBinds) },
+	{ "uniform_pushes", offsetof(CommandStats, UniformPushes) },
+	{ "uploads", offsetof(CommandStats, Uploads) },
+	{ "upload_bytes", offsetof(CommandStats, UploadBytes) },
+	{ "blits", offsetof(CommandStats, Blits) },
+	{ "redundant_binds", offsetof(CommandStats, RedundantBinds) },
+	{ "pass_rebinds", offsetof(CommandStats, PassRebinds) }
+};
+
+static double GetCommandsPerFrame(const CommandStats* commands, int field, int measuredFrames)
+{
+	Uint64 count = *(const Uint64*) ((const Uint8*) commands + CommandStatsFields[field].Offset);
+	return (double) count / measuredFrames;
+}
+
+static void WriteCommandStats(SDL_IOStream* file, const CommandStats* commands, int measuredFrames)
+{
+	SDL_IOprintf(file, ",\n\t\t\t\"commands_per_frame\": {");
+	for (int i = 0; i < SDL_arraysize(CommandStatsFields); i += 1)
+	{
+		SDL_IOprintf(
+			file,
+			"%s \"%s\": %.2f",
+			i > 0 ? "," : "",
+			CommandStatsFields[i].Key,
+			GetCommandsPerFrame(commands, i, measuredFrames)
+		);
+	}
+	SDL_IOprintf(file, " }");
+}
+#endif
+
+static bool WriteBenchmarkJSON(const BenchmarkOptions* options, const ExampleBenchmark* results, int count)
+{
+	SDL_IOStream* file = SDL_IOFromFile(options->JSONPath, "w");
+	if (file == NULL)
+	{
+		SDL_Log("Could not open %s: %s", options->JSONPath, SDL_GetError());
+		return false;
+	}
+
+	SDL_IOprintf(
+		file,
+		"{\n\t\"warmup_frames\": %d,\n\t\"frames\": %d,\n\t\"seed\": %" SDL_PRIu64 ",\n\t\"examples\": [",
+		options->WarmupFrames,
+		options->MeasuredFrames,
+		options->Seed
+	);
+	for (int i = 0; i < count; i += 1)
+	{
+		const ExampleBenchmark* result = &results[i];
+		SDL_IOprintf(
+			file,
+			"%s\n\t\t{\n\t\t\t\"name\": \"%s\",\n\t\t\t\"driver\": \"%s\",\n",
+			i > 0 ? "," : "",
+			result->Name,
+			result->Driver != NULL ? result->Driver : ""
+		);
+		if (result->Error != NULL)
+		{
+			SDL_IOprintf(file, "\t\t\t\"error\": \"%s\"\n\t\t}", result->Error);
+			continue;
+		}
+		WriteFrameTimeSummary(file, "frame_ms", &result->FrameMs);
+		WriteFrameTimeSummary(file, "submit_ms", &result->SubmitMs);
+		SDL_IOprintf(file, "\t\t\t\"submits_per_frame\": %.2f", result->SubmitsPerFrame);
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+		WriteCommandStats(file, &result->Commands, options->MeasuredFrames);
+		SDL_IOprintf(
+			file,
+			",\n\t\t\t\"gpu_memory_peak_bytes\": %" SDL_PRIu64 ",\n\t\t\t\"gpu_leaks\": %d",
+			result->GPUMemoryPeakBytes,
+			result->GPULeaks
+		);
+#endif
+		SDL_IOprintf(file, "\n\t\t}");
+	}
+	SDL_IOprintf(file, "\n\t]\n}\n");
+
+	if (!SDL_CloseIO(file))
+	{
+		SDL_Log("Could not write %s: %s", options->JSONPath, SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+// Baselines are benchmark JSON files written by -json, and the reader only knows that layout:
+// every number of an example is kept under its key, those in nested objects under "object.key"
+// (e.g. "frame_ms.p95" or "commands_per_frame.draws"), and everything else is skipped.
+
+#define BASELINE_KEY_LENGTH 64
+
+// Timings this close to their baseline never regress, whatever the tolerance: at that scale the
+// percentages are timer noise
+#define TIMING_NOISE_MS 0.01
+
+typedef struct BaselineMetric
+{
+	char Key[BASELINE_KEY_LENGTH];
+	double Value;
+} BaselineMetric;
+
+typedef struct BaselineExample
+{
+	char Name[BASELINE_KEY_LENGTH];
+	char Driver[BASELINE_KEY_LENGTH];
+	bool Failed;
+	BaselineMetric* Metrics;
+	int MetricCount;
+	int MetricCapacity;
+} BaselineExample;
+
+typedef struct Baseline
+{
+	int WarmupFrames;
+	int MeasuredFrames;
+	Uint64 Seed;
+	BaselineExample* Examples;
+	int ExampleCount;
+	int ExampleCapacity;
+} Baseline;
+
+typedef struct JSONReader
+{
+	const char* Cursor;
+	const char* End;
+	bool Failed;
+	bool OutOfMemory; // Failed because a realloc did, not because of the JSON
+} JSONReader;
+
+static char PeekJSON(JSONReader* reader)
+{
+	while (reader->Cursor < reader->End && SDL_isspace(*reader->Cursor))
+	{
+		reader->Cursor += 1;
+	}
+	return reader->Cursor < reader->End ? *reader->Cursor : '\0';
+}
+
+static bool ExpectJSON(JSONReader* reader, char c)
+{
+	if (reader->Failed || PeekJSON(reader) != c)
+	{
+		reader->Failed = true;
+		return false;
+	}
+	reader->Cursor += 1;
+	return true;
+}
+
+// Call after the opening bracket, then before each member; false once the closing one is read
+static bool HasJSONMember(JSONReader* reader, char close, bool* first)
+{
+	if (reader->Failed)
+	{
+		return false;
+	}
+	if (PeekJSON(reader) == close)
+	{
+		reader->Cursor += 1;
+		return false;
+	}
+	if (!*first && !ExpectJSON(reader, ','))
+	{
+		return false;
+	}
+	*first = false;
+	return true;
+}
+
+// Escaped characters are kept as they are, names and keys written by -json never need more
+static void ReadJSONString(JSONReader* reader, char* buffer, size_t size)
+{
+	size_t length = 0;
+	if (!ExpectJSON(reader, '"'))
+	{
+		return;
+	}
+	while (reader->Cursor < reader->End && *reader->Cursor != '"')
+	{
+		if (*reader->Cursor == '\\' && reader->Cursor + 1 < reader->End)
+		{
+			reader->Cursor += 1;
+		}
+		if (length + 1 < size)
+		{
+			buffer[length++] = *reader->Cursor;
+		}
+		reader->Cursor += 1;
+	}
+	if (size > 0)
+	{
+		buffer[length] = '\0';
+	}
+	ExpectJSON(reader, '"');
+}
+
+static double ReadJSONNumber(JSONReader* reader)
+{
+	PeekJSON(reader);
+	char* end;
+	double value = SDL_strtod(reader->Cursor, &end);
+	if (end == reader->Cursor)
+	{
+		reader->Failed = true;
+	}
+	reader->Cursor = end;
+	return value;
+}
+
+static void SkipJSONValue(JSONReader* reader)
+{
+	char c = PeekJSON(reader);
+	if (c == '"')
+	{
+		ReadJSONString(reader, NULL, 0);
+	}
+	else if (c == '{' || c == '[')
+	{
+		char close = c == '{' ? '}' : ']';
+		bool first = true;
+		reader->Cursor += 1;
+		while (HasJSONMember(reader, close, &first))
+		{
+			if (c == '{')
+			{
+				ReadJSONString(reader, NULL, 0);
+				ExpectJSON(reader, ':');
+			}
+			SkipJSONValue(reader);
+		}
+	}
+	else if (c == 't' || c == 'f' || c == 'n')
+	{
+		while (reader->Cursor < reader->End && SDL_isalpha(*reader->Cursor))
+		{
+			reader->Cursor += 1;
+		}
+	}
+	else
+	{
+		ReadJSONNumber(reader);
+	}
+}
+
+static void ReadBaselineExample(JSONReader* reader, BaselineExample* example, const char* prefix)
+{
+	bool first = true;
+	ExpectJSON(reader, '{');
+	while (HasJSONMember(reader, '}', &first))
+	{
+		char key[BASELINE_KEY_LENGTH];
+		ReadJSONString(reader, key, sizeof(key));
+		ExpectJSON(reader, ':');
+
+		char c = PeekJSON(reader);
+		if (c == '{')
+		{
+			char nestedPrefix[BASELINE_KEY_LENGTH];
+			SDL_snprintf(nestedPrefix, sizeof(nestedPrefix), "%s%s.", prefix, key);
+			ReadBaselineExample(reader, example, nestedPrefix);
+		}
+		else if (c == '-' || SDL_isdigit(c))
+		{
+			if (example->MetricCount == example->MetricCapacity)
+			{
+				int capacity = SDL_max(example->MetricCapacity * 2, 32);
+				BaselineMetric* metrics = SDL_realloc(example->Metrics, capacity * sizeof(BaselineMetric));
+				if (metrics == NULL)
+				{
+					reader->Failed = true;
+					reader->OutOfMemory = true;
+					return;
+				}
+				example->Metrics = metrics;
+				example->MetricCapacity = capacity;
+			}
+			BaselineMetric* metric = &example->Metrics[example->MetricCount++];
+			SDL_snprintf(metric->Key, sizeof(metric->Key), "%s%s", prefix, key);
+			metric->Value = ReadJSONNumber(reader);
+		}
+		else if (SDL_strcmp(key, "name") == 0)
+		{
+			ReadJSONString(reader, example->Name, sizeof(example->Name));
+		}
+		else if (SDL_strcmp(key, "driver") == 0)
+		{
+			ReadJSONString(reader, example->Driver, sizeof(example->Driver));
+		}
+		else
+		{
+			example->Failed |= SDL_strcmp(key, "error") == 0;
+			SkipJSONValue(reader);
+		}
+	}
+}
+
+static void FreeBaseline(Baseline* baseline)
+{
+	for (int i = 0; i < baseline->ExampleCount; i += 1)
+	{
+		SDL_free(baseline->Examples[i].Metrics);
+	}
+	SDL_free(baseline->Examples);
+	SDL_zerop(baseline);
+}
+
+static bool LoadBaseline(const char* path, Baseline* baseline)
+{
+	SDL_zerop(baseline);
+	size_t size;
+	char* data = SDL_LoadFile(path, &size);
+	if (data == NULL)
+	{
+		SDL_Log("Could not read baseline %s: %s", path, SDL_GetError());
+		return false;
+	}
+
+	JSONReader reader = { .Cursor = data, .End = data + size };
+	bool first = true;
+	ExpectJSON(&reader, '{');
+	while (HasJSONMember(&reader, '}', &first))
+	{
+		char key[BASELINE_KEY_LENGTH];
+		ReadJSONString(&reader, key, sizeof(key));
+		ExpectJSON(&reader, ':');
+
+		if (SDL_strcmp(key, "warmup_frames") == 0)
+		{
+			baseline->WarmupFrames = (int) ReadJSONNumber(&reader);
+		}
+		else if (SDL_strcmp(key, "frames") == 0)
+		{
+			baseline->MeasuredFrames = (int) ReadJSONNumber(&reader);
+		}
+		else if (SDL_strcmp(key, "seed") == 0)
+		{
+			// Read as an integer, a double would round large seeds
+			PeekJSON(&reader);
+			char* end;
+			baseline->Seed = SDL_strtoull(reader.Cursor, &end, 10);
+			reader.Failed |= end == reader.Cursor;
+			reader.Cursor = end;
+		}
+		else if (SDL_strcmp(key, "examples") == 0 && ExpectJSON(&reader, '['))
+		{
+			bool firstExample = true;
+			while (HasJSONMember(&reader, ']', &firstExample))
+			{
+				if (baseline->ExampleCount == baseline->ExampleCapacity)
+				{
+					int capacity = SDL_max(baseline->ExampleCapacity * 2, 64);
+					BaselineExample* examples = SDL_realloc(baseline->Examples, capacity * sizeof(BaselineExample));
+					if (examples == NULL)
+					{
+						reader.Failed = true;
+						reader.OutOfMemory = true;
+						break;
+					}
+					baseline->Examples = examples;
+					baseline->ExampleCapacity = capacity;
+				}
+				BaselineExample* example = &baseline->Examples[baseline->ExampleCount++];
+				SDL_zerop(example);
+				ReadBaselineExample(&reader, example, "");
+			}
+		}
+		else
+		{
+			SkipJSONValue(&reader);
+		}
+	}
+
+	int failedAt = (int) (reader.Cursor - data);
+	SDL_free(data);
+	if (reader.OutOfMemory)
+	{
+		SDL_Log("Out of memory reading baseline %s", path);
+		FreeBaseline(baseline);
+		return false;
+	}
+	if (reader.Failed)
+	{
+		SDL_Log("Could not parse baseline %s near byte %d", path, failedAt);
+		FreeBaseline(baseline);
+		return false;
+	}
+	return true;
+}
+
+static const BaselineExample* FindBaselineExample(const Baseline* baseline, const char* name)
+{
+	for (int i = 0; i < baseline->ExampleCount; i += 1)
+	{
+		if (SDL_strcmp(baseline->Examples[i].Name, name) == 0)
+		{
+			return &baseline->Examples[i];
+		}
+	}
+	return NULL;
+}
+
+static const BaselineMetric* FindBaselineMetric(const BaselineExample* example, const char* key)
+{
+	for (int i = 0; i < example->MetricCount; i += 1)
+	{
+		if (SDL_strcmp(example->Metrics[i].Key, key) == 0)
+		{
+			return &example->Metrics[i];
+		}
+	}
+	return NULL;
+}
+
+typedef struct BenchmarkMetric
+{
+	char Key[BASELINE_KEY_LENGTH];
+	double Value;
+	bool Timing; // Compared with the timing tolerance, otherwise the count tolerance
+} BenchmarkMetric;
+
+#define MAX_BENCHMARK_METRICS 32
+
+// The metrics compared against baselines, keyed as the reader flattens the JSON
+static int GetBenchmarkMetrics(const ExampleBenchmark* result, int measuredFrames, BenchmarkMetric* metrics)
+{
+	int count = 0;
+	const struct
+	{
+		const char* Key;
+		double Value;
+		bool Timing;
+	} fields[] = {
+		{ "frame_ms.mean", result->FrameMs.Mean, true },
+		{ "frame_ms.p50", result->FrameMs.P50, true },
+		{ "frame_ms.p95", result->FrameMs.P95, true },
+		{ "submit_ms.mean", result->SubmitMs.Mean, true },
+		{ "submit_ms.p95", result->SubmitMs.P95, true },
+		{ "submits_per_frame", result->SubmitsPerFrame, false },
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+		{ "gpu_memory_peak_bytes", (double) result->GPUMemoryPeakBytes, false },
+		{ "gpu_leaks", result->GPULeaks, false }
+#endif
+	};
+	for (int i = 0; i < SDL_arraysize(fields); i += 1)
+	{
+		BenchmarkMetric* metric = &metrics[count++];
+		SDL_strlcpy(metric->Key, fields[i].Key, sizeof(metric->Key));
+		metric->Value = fields[i].Value;
+		metric->Timing = fields[i].Timing;
+	}
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+	for (int i = 0; i < SDL_arraysize(CommandStatsFields); i += 1)
+	{
+		BenchmarkMetric* metric = &metrics[count++];
+		SDL_snprintf(metric->Key, sizeof(metric->Key), "commands_per_frame.%s", CommandStatsFields[i].Key);
+		metric->Value = GetCommandsPerFrame(&result->Commands, i, measuredFrames);
+		metric->Timing = false;
+	}
+#endif
+	return count;
+}
+
+static void LogBaselineRow(const char* example, const char* metric, const char* baseline, const char* current, const char* change, const char* status)
+{
+	SDL_Log("%-28s %-38s %14s %14s %9s  %s", example, metric, baseline, current, change, status);
+}
+
+/* Compares the results against the baseline and logs a table of every metric that moved past its
+ * tolerance, returning how many regressed. Only growth regresses; metrics that shrank past their
+ * tolerance are listed as improvements, a sign the baseline is due to be recorded again.
+ */
+static int CompareWithBaseline(const BenchmarkOptions* options, const Baseline* baseline, const ExampleBenchmark* results, int count)
+{
+	if (baseline->MeasuredFrames != options->MeasuredFrames ||
+		baseline->WarmupFrames != options->WarmupFrames ||
+		baseline->Seed != options->Seed)
+	{
+		SDL_Log(
+			"Baseline %s was recorded with %d frames after %d warm-up frames and seed %" SDL_PRIu64 ", run with the same to compare",
+			options->BaselinePath,
+			baseline->MeasuredFrames,
+			baseline->WarmupFrames,
+			baseline->Seed
+		);
+		return 1;
+	}
+
+	int regressions = 0;
+	int rows = 0;
+	SDL_Log("Comparing against baseline %s", options->BaselinePath);
+	LogBaselineRow("Example", "Metric", "Baseline", "Current", "Change", "");
+	for (int i = 0; i < count; i += 1)
+	{
+		const ExampleBenchmark* result = &results[i];
+		const BaselineExample* example = FindBaselineExample(baseline, result->Name);
+		if (example == NULL)
+		{
+			LogBaselineRow(result->Name, "", "", "", "", "new, not in the baseline");
+			rows += 1;
+			continue;
+		}
+		if (result->Error != NULL)
+		{
+			LogBaselineRow(result->Name, "", example->Failed ? "failed" : "ran", "failed", "", example->Failed ? "still failing" : "REGRESSED");
+			regressions += example->Failed ? 0 : 1;
+			rows += 1;
+			continue;
+		}
+		if (example->Failed)
+		{
+			LogBaselineRow(result->Name, "", "failed", "ran", "", "fixed, not compared");
+			rows += 1;
+			continue;
+		}
+		if (result->Driver != NULL && SDL_strcmp(example->Driver, result->Driver) != 0)
+		{
+			SDL_Log("%s ran on %s, but its baseline on %s", result->Name, result->Driver, example->Driver);
+		}
+
+		BenchmarkMetric metrics[MAX_BENCHMARK_METRICS];
+		int metricCount = GetBenchmarkMetrics(result, options->MeasuredFrames, metrics);
+		for (int j = 0; j < metricCount; j += 1)
+		{
+			const BenchmarkMetric* metric = &metrics[j];
+			const BaselineMetric* recorded = FindBaselineMetric(example, metric->Key);
+			if (recorded == NULL)
+			{
+				continue;
+			}
+
+			// Counts are written with two decimals, so they can differ by half of the last one
+			double tolerance = (metric->Timing ? options->TimingTolerance : options->CountTolerance) / 100.0;
+			double slack = SDL_max(recorded->Value * tolerance, metric->Timing ? TIMING_NOISE_MS : 0.005);
+			double difference = metric->Value - recorded->Value;
+			if (SDL_fabs(difference) <= slack)
+			{
+				continue;
+			}
+
+			bool regressed = difference > 0;
+			char recordedText[32];
+			char currentText[32];
+			char changeText[32];
+			SDL_snprintf(recordedText, sizeof(recordedText), metric->Timing ? "%.4f" : "%.2f", recorded->Value);
+			SDL_snprintf(currentText, sizeof(currentText), metric->Timing ? "%.4f" : "%.2f", metric->Value);
+			if (recorded->Value != 0)
+			{
+				SDL_snprintf(changeText, sizeof(changeText), "%+.1f%%", difference * 100.0 / recorded->Value);
+			}
+			else
+			{
+				SDL_strlcpy(changeText, "new", sizeof(changeText));
+			}
+			LogBaselineRow(result->Name, metric->Key, recordedText, currentText, changeText, regressed ? "REGRESSED" : "improved");
+			regressions += regressed ? 1 : 0;
+			rows += 1;
+		}
+	}
+
+	if (rows == 0)
+	{
+		SDL_Log("Every metric is within its tolerance");
+	}
+	SDL_Log(
+		"%d regression(s) against %s (timings may grow %.1f%%, counts %.1f%%)",
+		regressions,
+		options->BaselinePath,
+		options->TimingTolerance,
+		options->CountTolerance
+	);
+	return regressions;
+}
+
+/* Benchmarks one example by name, or every example for "all", and returns how many failed or
+ * regressed against the baseline. Frame times are CPU milliseconds; the GPU only shows up in them
+ * once it falls two frames behind.
+ */
+int RunBenchmarks(const BenchmarkOptions* options, Example** examples, int exampleCount)
+{
+	ExampleBenchmark* results = SDL_malloc(exampleCount * sizeof(ExampleBenchmark));
+	if (results == NULL)
+	{
+		SDL_Log("Out of memory, can't run the benchmark!");
+		return 1;
+	}
+	int count = 0;
+	int failures = 0;
+
+	SDL_Log(
+		"Benchmark: %d frames after %d warm-up frames with seed %" SDL_PRIu64 ", rendering offscreen",
+		options->MeasuredFrames,
+		options->WarmupFrames,
+		options->Seed
+	);
+#ifndef SDL_GPU_EXAMPLES_INSTRUMENTATION
+	SDL_Log("GPU memory and recorded commands aren't tracked, build with SDL_GPU_EXAMPLES_INSTRUMENTATION to measure them");
+#endif
+	for (int i = 0; i < exampleCount; i += 1)
+	{
+		if (SDL_strcmp(options->Name, "all") != 0 && SDL_strcmp(options->Name, examples[i]->Name) != 0)
+		{
+			continue;
+		}
+
+		ExampleBenchmark* result = &results[count++];
+		BenchmarkExample(examples[i], options->WarmupFrames, options->MeasuredFrames, options->Seed, result);
+		if (result->Error != NULL)
+		{
+			SDL_Log("%-28s %s", result->Name, result->Error);
+			failures += 1;
+			continue;
+		}
+
+		char instrumented[128] = "";
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+		SDL_snprintf(
+			instrumented,
+			sizeof(instrumented),
+			", %.1f draws/frame%s, %.1f MiB GPU peak%s",
+			(double) result->Commands.Draws / options->MeasuredFrames,
+			result->Commands.RedundantBinds > 0 ? ", redundant binds" : "",
+			result->GPUMemoryPeakBytes / (1024.0 * 1024.0),
+			result->GPULeaks > 0 ? ", leaked GPU memory" : ""
+		);
+#endif
+		SDL_Log(
+			"%-28s frame %7.3f ms (p50 %7.3f, p95 %7.3f, p99 %7.3f), submit %7.3f ms (p95 %7.3f), %.1f submits/frame%s",
+			result->Name,
+			result->FrameMs.Mean,
+			result->FrameMs.P50,
+			result->FrameMs.P95,
+			result->FrameMs.P99,
+			result->SubmitMs.Mean,
+			result->SubmitMs.P95,
+			result->SubmitsPerFrame,
+			instrumented
+		);
+	}
+
+	if (count == 0)
+	{
+		SDL_Log("No example named '%s' exists.", options->Name);
+		SDL_free(results);
+		return 1;
+	}
+
+	if (options->JSONPath != NULL && !WriteBenchmarkJSON(options, results, count))
+	{
+		failures += 1;
+	}
+
+	if (options->BaselinePath != NULL)
+	{
+		Baseline baseline;
+		if (LoadBaseline(options->BaselinePath, &baseline))
+		{
+			failures += CompareWithBaseline(options, &baseline, results, count);
+			FreeBaseline(&baseline);
+		}
+		else
+		{
+			failures += 1;
+		}
+	}
+	SDL_free(results);
+	return failures;
+}
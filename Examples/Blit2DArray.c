@@ -35,7 +35,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.vertex_input_state = (SDL_GPUVertexInputState){
@@ -64,15 +64,15 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Load the images
 	SDL_Surface *imageData1 = LoadImage("ravioli.bmp", 4);
@@ -142,19 +142,8 @@ static int Init(Context* context)
 	});
 
 	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = (sizeof(PositionTextureVertex) * 8) + (sizeof(Uint16) * 6)
-		}
-	);
-
-	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		bufferTransferBuffer,
-		false
-	);
+	StagingAllocation bufferStaging;
+	PositionTextureVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionTextureVertex) * 8) + (sizeof(Uint16) * 6), 0, &bufferStaging);
 
 	transferData[0] = (PositionTextureVertex) { -1,  1, 0, 0, 0 };
 	transferData[1] = (PositionTextureVertex) {  0,  1, 0, 1, 0 };
@@ -173,26 +162,15 @@ static int Init(Context* context)
 	indexData[4] = 2;
 	indexData[5] = 3;
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	UnmapStagingMemory(context->Device, &bufferStaging);
 
 	// Set up texture data
 	const Uint32 imageSizeInBytes = srcWidth * srcHeight * 4;
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageSizeInBytes * 2
-		}
-	);
-
-	Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferPtr = MapStagingMemory(context->Device, imageSizeInBytes * 2, 0, &textureStaging);
 	SDL_memcpy(textureTransferPtr, imageData1->pixels, imageSizeInBytes);
 	SDL_memcpy(textureTransferPtr + imageSizeInBytes, imageData2->pixels, imageSizeInBytes);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	// Upload the transfer data to the GPU resources
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -201,8 +179,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -215,8 +193,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionTextureVertex) * 8
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionTextureVertex) * 8
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -229,8 +207,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0,
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset,
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = SourceTexture,
@@ -245,8 +223,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = imageSizeInBytes,
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset + imageSizeInBytes,
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = SourceTexture,
@@ -291,9 +269,7 @@ static int Init(Context* context)
 		}
 	);
 
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	return 0;
 }
@@ -313,8 +289,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -339,14 +315,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, SourceTexture);
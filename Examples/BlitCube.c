@@ -37,7 +37,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.vertex_input_state = (SDL_GPUVertexInputState){
@@ -61,10 +61,10 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -113,19 +113,8 @@ static int Init(Context* context)
 	});
 
 	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = (sizeof(PositionVertex) * 24) + (sizeof(Uint16) * 36)
-		}
-	);
-
-	PositionVertex* bufferTransferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		bufferTransferBuffer,
-		false
-	);
+	StagingAllocation bufferStaging;
+	PositionVertex* bufferTransferData = MapStagingMemory(context->Device, (sizeof(PositionVertex) * 24) + (sizeof(Uint16) * 36), 0, &bufferStaging);
 
 	bufferTransferData[0] = (PositionVertex) { -10, -10, -10 };
 	bufferTransferData[1] = (PositionVertex) { 10, -10, -10 };
@@ -168,22 +157,12 @@ static int Init(Context* context)
 	};
 	SDL_memcpy(indexData, indices, sizeof(indices));
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	UnmapStagingMemory(context->Device, &bufferStaging);
 
 	// Set up texture data
 	const Uint32 bytesPerImage = 32 * 32 * 4;
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = bytesPerImage * 6
-		}
-	);
-	Uint8* textureTransferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferData = MapStagingMemory(context->Device, bytesPerImage * 6, 0, &textureStaging);
 
 	const char* imageNames[] = {
 		"cube0.bmp", "cube1.bmp", "cube2.bmp",
@@ -200,7 +179,7 @@ static int Init(Context* context)
 		SDL_memcpy(textureTransferData + (bytesPerImage * i), imageData->pixels, bytesPerImage);
 		SDL_DestroySurface(imageData);
 	}
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	// Upload the transfer data to the GPU buffers
 	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -209,8 +188,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -223,8 +202,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionVertex) * 24
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionVertex) * 24
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -238,8 +217,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUTexture(
 			copyPass,
 			&(SDL_GPUTextureTransferInfo) {
-				.transfer_buffer = textureTransferBuffer,
-				.offset = bytesPerImage * i
+				.transfer_buffer = textureStaging.TransferBuffer,
+				.offset = textureStaging.Offset + bytesPerImage * i
 			},
 			&(SDL_GPUTextureRegion) {
 				.texture = SourceTexture,
@@ -274,10 +253,7 @@ static int Init(Context* context)
 		);
 	}
 
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
-
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitStagingCommandBuffer(context->Device, cmdbuf);
 
 	// Print the instructions
 	SDL_Log("Press Left/Right to view the opposite direction!");
@@ -305,8 +281,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -345,14 +321,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, SourceTexture);
@@ -37,28 +37,18 @@ static int Init(Context* context)
 		}
 	);
 
-	SDL_GPUTransferBuffer* uploadTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
-		}
-	);
-
-	Uint8* uploadTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		uploadTransferBuffer,
-		false
-	);
+	StagingAllocation uploadStaging;
+	Uint8* uploadTransferPtr = MapStagingMemory(context->Device, imageData->w * imageData->h * 4, 0, &uploadStaging);
 	SDL_memcpy(uploadTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, uploadTransferBuffer);
+	UnmapStagingMemory(context->Device, &uploadStaging);
 
 	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = uploadTransferBuffer,
+			.transfer_buffer = uploadStaging.TransferBuffer,
+			.offset = uploadStaging.Offset
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
@@ -69,9 +59,8 @@ static int Init(Context* context)
 		false
 	);
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitStagingCommandBuffer(context->Device, cmdbuf);
 
-	SDL_ReleaseGPUTransferBuffer(context->Device, uploadTransferBuffer);
 	SDL_DestroySurface(imageData);
 
 	return 0;
@@ -93,8 +82,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -182,7 +171,7 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -26,8 +26,7 @@ static int Init(Context* context)
 		return result;
 	}
 
-	int n;
-	float* hdrImageData = LoadHDRImage("memorial.hdr", &img_w, &img_h, &n, 4);
+	Uint16* hdrImageData = LoadHDRImageHalf("memorial.hdr", &img_w, &img_h);
 
 	if (hdrImageData == NULL) {
 		SDL_Log("Could not load HDR image data!");
@@ -93,14 +92,14 @@ static int Init(Context* context)
 			.fragment_shader = fragmentShader
 		};
 
-		SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		SDL_GPUGraphicsPipeline* pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (pipeline == NULL) {
 			SDL_Log("Failed to create pipeline!");
 			return -1;
 		}
 
-		SDL_ReleaseGPUShader(context->Device, vertexShader);
-		SDL_ReleaseGPUShader(context->Device, fragmentShader);
+		ReleaseShader(context->Device, vertexShader);
+		ReleaseShader(context->Device, fragmentShader);
 
 		DownsamplePipeline = pipeline;
 	}
@@ -163,14 +162,14 @@ static int Init(Context* context)
 			.fragment_shader = fragmentShader
 		};
 
-		SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		SDL_GPUGraphicsPipeline* pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (pipeline == NULL) {
 			SDL_Log("Failed to create pipeline!");
 			return -1;
 		}
 
-		SDL_ReleaseGPUShader(context->Device, vertexShader);
-		SDL_ReleaseGPUShader(context->Device, fragmentShader);
+		ReleaseShader(context->Device, vertexShader);
+		ReleaseShader(context->Device, fragmentShader);
 
 		UpsamplePipeline = pipeline;
 	}
@@ -232,14 +231,14 @@ static int Init(Context* context)
 			.fragment_shader = fragmentShader
 		};
 
-		SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		SDL_GPUGraphicsPipeline* pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (pipeline == NULL) {
 			SDL_Log("Failed to create pipeline!");
 			return -1;
 		}
 
-		SDL_ReleaseGPUShader(context->Device, vertexShader);
-		SDL_ReleaseGPUShader(context->Device, fragmentShader);
+		ReleaseShader(context->Device, vertexShader);
+		ReleaseShader(context->Device, fragmentShader);
 
 		BlendPipeline = pipeline;
 	}
@@ -253,41 +252,30 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
 	});
 
-	SDL_PropertiesID props = SDL_CreateProperties();
-	SDL_SetStringProperty(props, SDL_PROP_GPU_BUFFER_CREATE_NAME_STRING, "Bloom Vertex Buffer");
-
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
 			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-			.size = sizeof(PositionTextureVertex) * 4,
-			.props = props
+			.size = sizeof(PositionTextureVertex) * 4
 		}
 	);
 
-	SDL_DestroyProperties(props);
-
 	IndexBuffer = SDL_CreateGPUBuffer(
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
 			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
-			.size = sizeof(Uint16) * 6,
-			.props = props
+			.size = sizeof(Uint16) * 6
 		}
 	);
 
-	props = SDL_CreateProperties();
-	SDL_SetStringProperty(props, SDL_PROP_GPU_TEXTURE_CREATE_NAME_STRING, "Input Texture");
-
 	InputTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
-		.format = SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT,
+		.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
 			.width = img_w,
 			.height = img_h,
 			.layer_count_or_depth = 1,
 			.num_levels = 1,
-			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
-			.props = props
+			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
 	});
 
 
@@ -307,41 +295,26 @@ static int Init(Context* context)
 		});
 	}
 
-	SDL_SetStringProperty(props, SDL_PROP_GPU_TEXTURE_CREATE_NAME_STRING, "Output Texture");
-
 	OutputTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
 		.format = SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT,
 			.width = img_w,
 			.height = img_h,
 			.layer_count_or_depth = 1,
 			.num_levels = 1,
-			.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER,
-			.props = props
+			.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
 	});
 
-	SDL_DestroyProperties(props);
-
-	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6)
-		}
-	);
-
-	PositionTextureVertex* transferData =
-		SDL_MapGPUTransferBuffer(
-			context->Device,
-			bufferTransferBuffer,
-			false);
+	// Queue the buffer and texture data, then upload it all in one copy pass
+	UploadBatch uploads;
+	BeginUploadBatch(&uploads, context->Device);
 
+	PositionTextureVertex* transferData = QueueBufferUpload(&uploads, VertexBuffer, 0, sizeof(PositionTextureVertex) * 4);
 	transferData[0] = (PositionTextureVertex){ -1,  1, 0, 0, 0 };
 	transferData[1] = (PositionTextureVertex){ 1,  1, 0, 1, 0 };
 	transferData[2] = (PositionTextureVertex){ 1, -1, 0, 1, 1 };
 	transferData[3] = (PositionTextureVertex){ -1, -1, 0, 0, 1 };
 
-	Uint16* indexData = (Uint16*)&transferData[4];
+	Uint16* indexData = QueueBufferUpload(&uploads, IndexBuffer, 0, sizeof(Uint16) * 6);
 	indexData[0] = 0;
 	indexData[1] = 1;
 	indexData[2] = 2;
@@ -349,79 +322,20 @@ static int Init(Context* context)
 	indexData[4] = 2;
 	indexData[5] = 3;
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
-
-	// Set up texture data
-	SDL_GPUTransferBuffer* imageDataTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(float) * 4 * img_w * img_h
-		}
-	);
-
-	transferData =
-		SDL_MapGPUTransferBuffer(
-			context->Device,
-			imageDataTransferBuffer,
-			false);
-
-	SDL_memcpy(transferData, hdrImageData, sizeof(float) * 4 * img_w * img_h);
-
-	SDL_UnmapGPUTransferBuffer(context->Device, imageDataTransferBuffer);
-	SDL_free(hdrImageData);
-
-	// Upload the transfer data to the GPU resources
-	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
-	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
-
-	SDL_UploadToGPUBuffer(
-		copyPass,
-		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
-		},
-		&(SDL_GPUBufferRegion) {
-			.buffer = VertexBuffer,
-			.offset = 0,
-			.size = sizeof(PositionTextureVertex) * 4
-		},
-		false
-	);
-
-	SDL_UploadToGPUBuffer(
-		copyPass,
-		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionTextureVertex) * 4
-		},
-		&(SDL_GPUBufferRegion) {
-			.buffer = IndexBuffer,
-			.offset = 0,
-			.size = sizeof(Uint16) * 6
-		},
-		false
-	);
-
-	SDL_UploadToGPUTexture(
-		copyPass,
-		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = imageDataTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
-		},
+	void* imageTransferData = QueueTextureUpload(
+		&uploads,
+		SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
 		&(SDL_GPUTextureRegion) {
 			.texture = InputTexture,
 			.w = img_w,
 			.h = img_h,
 			.d = 1
-		},
-		false
+		}
 	);
+	SDL_memcpy(imageTransferData, hdrImageData, sizeof(Uint16) * 4 * img_w * img_h);
+	SDL_free(hdrImageData);
 
-	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, imageDataTransferBuffer);
+	FlushUploadBatch(&uploads);
 
 	SDL_Log("Press Left/Right to increase/decrease the blur radius (Current: %f)", FilterRadius);
 	SDL_Log("Press Up/Down to increase/decrease the final blend weight (Current: %f)", Weight);
@@ -464,13 +378,13 @@ static int Draw(Context* context) {
 
 	Uint32 swapchainWidth, swapchainHeight;
 	SDL_GPUTexture *swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &swapchainWidth, &swapchainHeight)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &swapchainWidth, &swapchainHeight)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
 	if (swapchainTexture == NULL) {
-		SDL_SubmitGPUCommandBuffer(cmdbuf);
+		SubmitCommandBuffer(cmdbuf);
 		return 0;
 	}
 
@@ -561,7 +475,7 @@ static int Draw(Context* context) {
 		}
 	);
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -571,9 +485,9 @@ static void Quit(Context* context) {
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUSampler(context->Device, Sampler);
 
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, DownsamplePipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, UpsamplePipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, BlendPipeline);
+	ReleaseGraphicsPipeline(context->Device, DownsamplePipeline);
+	ReleaseGraphicsPipeline(context->Device, UpsamplePipeline);
+	ReleaseGraphicsPipeline(context->Device, BlendPipeline);
 
 	SDL_ReleaseGPUTexture(context->Device, InputTexture);
 	for (int i = 0; i < SDL_arraysize(IntermediateTextures); i++) {
@@ -10,7 +10,7 @@ static int Init(Context* context)
 		return result;
 	}
 
-	SDL_GPUTextureFormat swapchainFormat = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window);
+	SDL_GPUTextureFormat swapchainFormat = GetFrameTextureFormat(context->Device, context->Window);
 
 	Texture3D = SDL_CreateGPUTexture(
 		context->Device,
@@ -44,8 +44,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -133,7 +133,7 @@ static int Draw(Context* context)
 		}
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -17,7 +17,8 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	if (!SDL_ClaimWindowForGPUDevice(context->Device, SecondWindow))
+	// Headless, both windows render into the same offscreen texture
+	if (!context->Headless && !SDL_ClaimWindowForGPUDevice(context->Device, SecondWindow))
 	{
 		SDL_Log("GPUClaimWindow failed");
 		return -1;
@@ -41,8 +42,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("AcquireGpuSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -58,8 +59,8 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, SecondWindow, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, SecondWindow, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -75,14 +76,17 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseWindowFromGPUDevice(context->Device, SecondWindow);
+	if (!context->Headless)
+	{
+		SDL_ReleaseWindowFromGPUDevice(context->Device, SecondWindow);
+	}
 	SDL_DestroyWindow(SecondWindow);
 	SecondWindow = NULL;
 
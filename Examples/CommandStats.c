@@ -0,0 +1,437 @@
+#include "Common.h"
+
+// Command Statistics
+// A bind is redundant when every binding it makes is already in place in the current pass. SDL
+// doesn't carry bindings over from one pass to the next, so a bind that repeats what the previous
+// pass of the same type had bound is needed, and is counted separately as a pass rebind: a high
+// count there means passes that could be merged. Only the first TRACKED_BINDING_SLOTS slots of
+// each kind are compared; binds beyond them are still counted, but never flagged. Each pass is
+// also a profile scope, from its begin to its end.
+
+#define TRACKED_BINDING_SLOTS 8
+
+typedef enum BindingKind
+{
+	BINDING_PIPELINE,
+	BINDING_VERTEX_BUFFER,
+	BINDING_INDEX_BUFFER,
+	BINDING_VERTEX_SAMPLER,
+	BINDING_FRAGMENT_SAMPLER,
+	BINDING_COMPUTE_SAMPLER,
+	BINDING_VERTEX_STORAGE_BUFFER,
+	BINDING_FRAGMENT_STORAGE_BUFFER,
+	BINDING_COMPUTE_STORAGE_BUFFER,
+	BINDING_VERTEX_STORAGE_TEXTURE,
+	BINDING_FRAGMENT_STORAGE_TEXTURE,
+	BINDING_COMPUTE_STORAGE_TEXTURE,
+	BINDING_KIND_COUNT
+} BindingKind;
+
+typedef enum PassType
+{
+	PASS_NONE,
+	PASS_RENDER,
+	PASS_COMPUTE,
+	PASS_COPY,
+	PASS_TYPE_COUNT
+} PassType;
+
+typedef struct BindingValue
+{
+	const void* Resource;
+	const void* Sampler;
+	Uint32 Offset;
+	Uint32 Format; // The index element size
+} BindingValue;
+
+typedef struct BindingState
+{
+	BindingValue Values[BINDING_KIND_COUNT][TRACKED_BINDING_SLOTS];
+	Uint32 BoundSlots[BINDING_KIND_COUNT];
+} BindingState;
+
+static CommandStats FrameCommands;
+static PassType CurrentPassType;
+static BindingState CurrentBindings;
+static BindingState PreviousBindings[PASS_TYPE_COUNT];
+
+static void BeginPassBindings(PassType type)
+{
+	PreviousBindings[CurrentPassType] = CurrentBindings;
+	SDL_zero(CurrentBindings);
+	CurrentPassType = type;
+}
+
+static bool MatchBindings(const BindingState* state, BindingKind kind, Uint32 firstSlot, const BindingValue* values, Uint32 count)
+{
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		const BindingValue* bound = &state->Values[kind][firstSlot + i];
+		if ((state->BoundSlots[kind] & (1u << (firstSlot + i))) == 0 ||
+			bound->Resource != values[i].Resource ||
+			bound->Sampler != values[i].Sampler ||
+			bound->Offset != values[i].Offset ||
+			bound->Format != values[i].Format)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void RecordBindings(BindingKind kind, Uint32 firstSlot, const BindingValue* values, Uint32 count)
+{
+	if (count == 0 || firstSlot + count > TRACKED_BINDING_SLOTS)
+	{
+		return;
+	}
+
+	if (MatchBindings(&CurrentBindings, kind, firstSlot, values, count))
+	{
+		FrameCommands.RedundantBinds += 1;
+		return;
+	}
+	if (MatchBindings(&PreviousBindings[CurrentPassType], kind, firstSlot, values, count))
+	{
+		FrameCommands.PassRebinds += 1;
+	}
+
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		CurrentBindings.Values[kind][firstSlot + i] = values[i];
+		CurrentBindings.BoundSlots[kind] |= 1u << (firstSlot + i);
+	}
+}
+
+static void RecordSamplerBindings(BindingKind kind, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 count)
+{
+	BindingValue values[TRACKED_BINDING_SLOTS];
+	for (Uint32 i = 0; i < count && i < TRACKED_BINDING_SLOTS; i += 1)
+	{
+		values[i] = (BindingValue) { .Resource = bindings[i].texture, .Sampler = bindings[i].sampler };
+	}
+	FrameCommands.SamplerBinds += 1;
+	RecordBindings(kind, firstSlot, values, count);
+}
+
+static void RecordStorageBufferBindings(BindingKind kind, Uint32 firstSlot, SDL_GPUBuffer* const* buffers, Uint32 count)
+{
+	BindingValue values[TRACKED_BINDING_SLOTS];
+	for (Uint32 i = 0; i < count && i < TRACKED_BINDING_SLOTS; i += 1)
+	{
+		values[i] = (BindingValue) { .Resource = buffers[i] };
+	}
+	FrameCommands.StorageBinds += 1;
+	RecordBindings(kind, firstSlot, values, count);
+}
+
+static void RecordStorageTextureBindings(BindingKind kind, Uint32 firstSlot, SDL_GPUTexture* const* textures, Uint32 count)
+{
+	BindingValue values[TRACKED_BINDING_SLOTS];
+	for (Uint32 i = 0; i < count && i < TRACKED_BINDING_SLOTS; i += 1)
+	{
+		values[i] = (BindingValue) { .Resource = textures[i] };
+	}
+	FrameCommands.StorageBinds += 1;
+	RecordBindings(kind, firstSlot, values, count);
+}
+
+SDL_GPURenderPass* BeginGPURenderPass(
+	SDL_GPUCommandBuffer* commandBuffer,
+	const SDL_GPUColorTargetInfo* colorTargetInfos,
+	Uint32 numColorTargets,
+	const SDL_GPUDepthStencilTargetInfo* depthStencilTargetInfo
+) {
+	FrameCommands.RenderPasses += 1;
+	BeginPassBindings(PASS_RENDER);
+	SDL_GPURenderPass* renderPass = (SDL_BeginGPURenderPass)(commandBuffer, colorTargetInfos, numColorTargets, depthStencilTargetInfo);
+	if (renderPass != NULL)
+	{
+		PROFILE_BEGIN("Render Pass");
+	}
+	return renderPass;
+}
+
+SDL_GPUComputePass* BeginGPUComputePass(
+	SDL_GPUCommandBuffer* commandBuffer,
+	const SDL_GPUStorageTextureReadWriteBinding* storageTextureBindings,
+	Uint32 numStorageTextureBindings,
+	const SDL_GPUStorageBufferReadWriteBinding* storageBufferBindings,
+	Uint32 numStorageBufferBindings
+) {
+	FrameCommands.ComputePasses += 1;
+	BeginPassBindings(PASS_COMPUTE);
+	SDL_GPUComputePass* computePass = (SDL_BeginGPUComputePass)(commandBuffer, storageTextureBindings, numStorageTextureBindings, storageBufferBindings, numStorageBufferBindings);
+	if (computePass != NULL)
+	{
+		PROFILE_BEGIN("Compute Pass");
+	}
+	return computePass;
+}
+
+SDL_GPUCopyPass* BeginGPUCopyPass(SDL_GPUCommandBuffer* commandBuffer)
+{
+	FrameCommands.CopyPasses += 1;
+	BeginPassBindings(PASS_COPY);
+	SDL_GPUCopyPass* copyPass = (SDL_BeginGPUCopyPass)(commandBuffer);
+	if (copyPass != NULL)
+	{
+		PROFILE_BEGIN("Copy Pass");
+	}
+	return copyPass;
+}
+
+void EndGPURenderPass(SDL_GPURenderPass* renderPass)
+{
+	(SDL_EndGPURenderPass)(renderPass);
+	PROFILE_END();
+}
+
+void EndGPUComputePass(SDL_GPUComputePass* computePass)
+{
+	(SDL_EndGPUComputePass)(computePass);
+	PROFILE_END();
+}
+
+void EndGPUCopyPass(SDL_GPUCopyPass* copyPass)
+{
+	(SDL_EndGPUCopyPass)(copyPass);
+	PROFILE_END();
+}
+
+void BindGPUGraphicsPipeline(SDL_GPURenderPass* renderPass, SDL_GPUGraphicsPipeline* pipeline)
+{
+	FrameCommands.PipelineBinds += 1;
+	RecordBindings(BINDING_PIPELINE, 0, &(BindingValue) { .Resource = pipeline }, 1);
+	(SDL_BindGPUGraphicsPipeline)(renderPass, pipeline);
+}
+
+void BindGPUComputePipeline(SDL_GPUComputePass* computePass, SDL_GPUComputePipeline* pipeline)
+{
+	FrameCommands.PipelineBinds += 1;
+	RecordBindings(BINDING_PIPELINE, 0, &(BindingValue) { .Resource = pipeline }, 1);
+	(SDL_BindGPUComputePipeline)(computePass, pipeline);
+}
+
+void BindGPUVertexBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUBufferBinding* bindings, Uint32 numBindings)
+{
+	BindingValue values[TRACKED_BINDING_SLOTS];
+	for (Uint32 i = 0; i < numBindings && i < TRACKED_BINDING_SLOTS; i += 1)
+	{
+		values[i] = (BindingValue) { .Resource = bindings[i].buffer, .Offset = bindings[i].offset };
+	}
+	FrameCommands.VertexBufferBinds += 1;
+	RecordBindings(BINDING_VERTEX_BUFFER, firstSlot, values, numBindings);
+	(SDL_BindGPUVertexBuffers)(renderPass, firstSlot, bindings, numBindings);
+}
+
+void BindGPUIndexBuffer(SDL_GPURenderPass* renderPass, const SDL_GPUBufferBinding* binding, SDL_GPUIndexElementSize indexElementSize)
+{
+	FrameCommands.IndexBufferBinds += 1;
+	RecordBindings(
+		BINDING_INDEX_BUFFER,
+		0,
+		&(BindingValue) { .Resource = binding->buffer, .Offset = binding->offset, .Format = indexElementSize },
+		1
+	);
+	(SDL_BindGPUIndexBuffer)(renderPass, binding, indexElementSize);
+}
+
+void BindGPUVertexSamplers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings)
+{
+	RecordSamplerBindings(BINDING_VERTEX_SAMPLER, firstSlot, bindings, numBindings);
+	(SDL_BindGPUVertexSamplers)(renderPass, firstSlot, bindings, numBindings);
+}
+
+void BindGPUFragmentSamplers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings)
+{
+	RecordSamplerBindings(BINDING_FRAGMENT_SAMPLER, firstSlot, bindings, numBindings);
+	(SDL_BindGPUFragmentSamplers)(renderPass, firstSlot, bindings, numBindings);
+}
+
+void BindGPUComputeSamplers(SDL_GPUComputePass* computePass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings)
+{
+	RecordSamplerBindings(BINDING_COMPUTE_SAMPLER, firstSlot, bindings, numBindings);
+	(SDL_BindGPUComputeSamplers)(computePass, firstSlot, bindings, numBindings);
+}
+
+void BindGPUVertexStorageBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings)
+{
+	RecordStorageBufferBindings(BINDING_VERTEX_STORAGE_BUFFER, firstSlot, storageBuffers, numBindings);
+	(SDL_BindGPUVertexStorageBuffers)(renderPass, firstSlot, storageBuffers, numBindings);
+}
+
+void BindGPUFragmentStorageBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings)
+{
+	RecordStorageBufferBindings(BINDING_FRAGMENT_STORAGE_BUFFER, firstSlot, storageBuffers, numBindings);
+	(SDL_BindGPUFragmentStorageBuffers)(renderPass, firstSlot, storageBuffers, numBindings);
+}
+
+void BindGPUComputeStorageBuffers(SDL_GPUComputePass* computePass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings)
+{
+	RecordStorageBufferBindings(BINDING_COMPUTE_STORAGE_BUFFER, firstSlot, storageBuffers, numBindings);
+	(SDL_BindGPUComputeStorageBuffers)(computePass, firstSlot, storageBuffers, numBindings);
+}
+
+void BindGPUVertexStorageTextures(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings)
+{
+	RecordStorageTextureBindings(BINDING_VERTEX_STORAGE_TEXTURE, firstSlot, storageTextures, numBindings);
+	(SDL_BindGPUVertexStorageTextures)(renderPass, firstSlot, storageTextures, numBindings);
+}
+
+void BindGPUFragmentStorageTextures(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings)
+{
+	RecordStorageTextureBindings(BINDING_FRAGMENT_STORAGE_TEXTURE, firstSlot, storageTextures, numBindings);
+	(SDL_BindGPUFragmentStorageTextures)(renderPass, firstSlot, storageTextures, numBindings);
+}
+
+void BindGPUComputeStorageTextures(SDL_GPUComputePass* computePass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings)
+{
+	RecordStorageTextureBindings(BINDING_COMPUTE_STORAGE_TEXTURE, firstSlot, storageTextures, numBindings);
+	(SDL_BindGPUComputeStorageTextures)(computePass, firstSlot, storageTextures, numBindings);
+}
+
+void DrawGPUPrimitives(SDL_GPURenderPass* renderPass, Uint32 numVertices, Uint32 numInstances, Uint32 firstVertex, Uint32 firstInstance)
+{
+	FrameCommands.Draws += 1;
+	(SDL_DrawGPUPrimitives)(renderPass, numVertices, numInstances, firstVertex, firstInstance);
+}
+
+void DrawGPUIndexedPrimitives(
+	SDL_GPURenderPass* renderPass,
+	Uint32 numIndices,
+	Uint32 numInstances,
+	Uint32 firstIndex,
+	Sint32 vertexOffset,
+	Uint32 firstInstance
+) {
+	FrameCommands.Draws += 1;
+	(SDL_DrawGPUIndexedPrimitives)(renderPass, numIndices, numInstances, firstIndex, vertexOffset, firstInstance);
+}
+
+void DrawGPUPrimitivesIndirect(SDL_GPURenderPass* renderPass, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 drawCount)
+{
+	FrameCommands.Draws += 1;
+	(SDL_DrawGPUPrimitivesIndirect)(renderPass, buffer, offset, drawCount);
+}
+
+void DrawGPUIndexedPrimitivesIndirect(SDL_GPURenderPass* renderPass, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 drawCount)
+{
+	FrameCommands.Draws += 1;
+	(SDL_DrawGPUIndexedPrimitivesIndirect)(renderPass, buffer, offset, drawCount);
+}
+
+void DispatchGPUCompute(SDL_GPUComputePass* computePass, Uint32 groupCountX, Uint32 groupCountY, Uint32 groupCountZ)
+{
+	FrameCommands.Dispatches += 1;
+	(SDL_DispatchGPUCompute)(computePass, groupCountX, groupCountY, groupCountZ);
+}
+
+void DispatchGPUComputeIndirect(SDL_GPUComputePass* computePass, SDL_GPUBuffer* buffer, Uint32 offset)
+{
+	FrameCommands.Dispatches += 1;
+	(SDL_DispatchGPUComputeIndirect)(computePass, buffer, offset);
+}
+
+void PushGPUVertexUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length)
+{
+	FrameCommands.UniformPushes += 1;
+	(SDL_PushGPUVertexUniformData)(commandBuffer, slotIndex, data, length);
+}
+
+void PushGPUFragmentUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length)
+{
+	FrameCommands.UniformPushes += 1;
+	(SDL_PushGPUFragmentUniformData)(commandBuffer, slotIndex, data, length);
+}
+
+void PushGPUComputeUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length)
+{
+	FrameCommands.UniformPushes += 1;
+	(SDL_PushGPUComputeUniformData)(commandBuffer, slotIndex, data, length);
+}
+
+void UploadToGPUBuffer(SDL_GPUCopyPass* copyPass, const SDL_GPUTransferBufferLocation* source, const SDL_GPUBufferRegion* destination, bool cycle)
+{
+	FrameCommands.Uploads += 1;
+	FrameCommands.UploadBytes += destination->size;
+	(SDL_UploadToGPUBuffer)(copyPass, source, destination, cycle);
+}
+
+void UploadToGPUTexture(SDL_GPUCopyPass* copyPass, const SDL_GPUTextureTransferInfo* source, const SDL_GPUTextureRegion* destination, bool cycle)
+{
+	// Textures created before tracking started have no known format and count no bytes
+	SDL_GPUTextureFormat format = GetTrackedTextureFormat(destination->texture);
+	FrameCommands.Uploads += 1;
+	if (format != SDL_GPU_TEXTUREFORMAT_INVALID)
+	{
+		FrameCommands.UploadBytes += SDL_CalculateGPUTextureFormatSize(format, destination->w, destination->h, SDL_max(destination->d, 1));
+	}
+	(SDL_UploadToGPUTexture)(copyPass, source, destination, cycle);
+}
+
+void BlitGPUTexture(SDL_GPUCommandBuffer* commandBuffer, const SDL_GPUBlitInfo* info)
+{
+	FrameCommands.Blits += 1;
+	(SDL_BlitGPUTexture)(commandBuffer, info);
+}
+
+CommandStats EndCommandStatsFrame()
+{
+	CommandStats stats = FrameCommands;
+	SDL_zero(FrameCommands);
+
+	// Bindings never outlive a frame's command buffers
+	SDL_zero(PreviousBindings);
+	CurrentPassType = PASS_NONE;
+	return stats;
+}
+
+void AddCommandStats(CommandStats* total, const CommandStats* stats)
+{
+	total->RenderPasses += stats->RenderPasses;
+	total->ComputePasses += stats->ComputePasses;
+	total->CopyPasses += stats->CopyPasses;
+	total->Draws += stats->Draws;
+	total->Dispatches += stats->Dispatches;
+	total->PipelineBinds += stats->PipelineBinds;
+	total->VertexBufferBinds += stats->VertexBufferBinds;
+	total->IndexBufferBinds += stats->IndexBufferBinds;
+	total->SamplerBinds += stats->SamplerBinds;
+	total->StorageBinds += stats->StorageBinds;
+	total->UniformPushes += stats->UniformPushes;
+	total->Uploads += stats->Uploads;
+	total->UploadBytes += stats->UploadBytes;
+	total->Blits += stats->Blits;
+	total->RedundantBinds += stats->RedundantBinds;
+	total->PassRebinds += stats->PassRebinds;
+}
+
+void LogCommandStats(const CommandStats* stats)
+{
+	SDL_Log(
+		"Commands: %" SDL_PRIu64 " render, %" SDL_PRIu64 " compute and %" SDL_PRIu64 " copy pass(es), %" SDL_PRIu64 " draw(s), %" SDL_PRIu64 " dispatch(es), %" SDL_PRIu64 " blit(s)",
+		stats->RenderPasses,
+		stats->ComputePasses,
+		stats->CopyPasses,
+		stats->Draws,
+		stats->Dispatches,
+		stats->Blits
+	);
+	SDL_Log(
+		"  Binds: %" SDL_PRIu64 " pipeline, %" SDL_PRIu64 " vertex buffer, %" SDL_PRIu64 " index buffer, %" SDL_PRIu64 " sampler, %" SDL_PRIu64 " storage; %" SDL_PRIu64 " redundant, %" SDL_PRIu64 " repeated from the previous pass",
+		stats->PipelineBinds,
+		stats->VertexBufferBinds,
+		stats->IndexBufferBinds,
+		stats->SamplerBinds,
+		stats->StorageBinds,
+		stats->RedundantBinds,
+		stats->PassRebinds
+	);
+	SDL_Log(
+		"  %" SDL_PRIu64 " uniform push(es), %" SDL_PRIu64 " upload(s) of %" SDL_PRIu64 " bytes",
+		stats->UniformPushes,
+		stats->Uploads,
+		stats->UploadBytes
+	);
+}
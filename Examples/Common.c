@@ -7,8 +7,33 @@
 #define STBI_ONLY_HDR
 #include "../stb_image.h"
 
+// The usual SDR swapchain format, so pipelines match what they would render to on screen
+#define HEADLESS_FRAME_FORMAT SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM
+
+static bool HeadlessRendering;
+static struct
+{
+	SDL_GPUDevice* Device;
+	SDL_GPUTexture* Texture;
+	Uint32 Width;
+	Uint32 Height;
+	Uint64 FrameSerial; // The last staging submission as of the previous frame's acquire
+} Headless;
+static SubmitStats SubmitCounters;
+
+static void ReleaseHeadlessTarget();
+
+void CountSubmit(Uint64 start)
+{
+	SubmitCounters.Submits += 1;
+	SubmitCounters.Milliseconds += (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
 int CommonInit(Context* context, SDL_WindowFlags windowFlags)
 {
+	SetGPUMemoryTag(context->ExampleName);
+	ResetGPUMemoryPeak();
+
 	context->Device = SDL_CreateGPUDevice(
 		SDL_GPU_SHADERFORMAT_SPIRV | SDL_GPU_SHADERFORMAT_DXIL | SDL_GPU_SHADERFORMAT_MSL,
 		true,
@@ -27,7 +52,12 @@ int CommonInit(Context* context, SDL_WindowFlags windowFlags)
 		return -1;
 	}
 
-	if (!SDL_ClaimWindowForGPUDevice(context->Device, context->Window))
+	context->Headless = HeadlessRendering;
+	if (HeadlessRendering)
+	{
+		Headless.Device = context->Device;
+	}
+	else if (!SDL_ClaimWindowForGPUDevice(context->Device, context->Window))
 	{
 		SDL_Log("GPUClaimWindow failed");
 		return -1;
@@ -38,15 +68,309 @@ int CommonInit(Context* context, SDL_WindowFlags windowFlags)
 
 void CommonQuit(Context* context)
 {
-	SDL_ReleaseWindowFromGPUDevice(context->Device, context->Window);
+	FinishReadbacks(context->Device);
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+	PipelineRegistryStats stats = GetPipelineRegistryStats();
+	SDL_Log("Pipeline registry: %d hits, %d misses", stats.Hits, stats.Misses);
+	StagingStats stagingStats = GetStagingStats();
+	if (stagingStats.Allocations > 0)
+	{
+		SDL_Log(
+			"Staging memory: %" SDL_PRIu64 " bytes in %" SDL_PRIu64 " allocations from %d page(s), %d fence wait(s)",
+			stagingStats.AllocatedBytes,
+			stagingStats.Allocations,
+			stagingStats.PageCount,
+			stagingStats.FenceWaits
+		);
+	}
+	ReadbackStats readbackStats = GetReadbackStats();
+	if (readbackStats.Delivered > 0)
+	{
+		SDL_Log(
+			"Readbacks: %" SDL_PRIu64 " delivered after %.1f frame(s) on average, %d stall(s)",
+			readbackStats.Delivered,
+			(double) readbackStats.TotalLatencyFrames / readbackStats.Delivered,
+			readbackStats.Stalls
+		);
+	}
+	GPUMemoryStats memoryStats = GetGPUMemoryStats();
+	SDL_Log("GPU memory: %.2f MiB at peak", memoryStats.PeakBytes / (1024.0 * 1024.0));
+#endif
+	ReleaseReadbacks(context->Device);
+	ReleaseStagingMemory(context->Device);
+	ReleasePipelineRegistry(context->Device);
+	ReleaseShaderCache(context->Device);
+	if (HeadlessRendering)
+	{
+		ReleaseHeadlessTarget();
+	}
+	else
+	{
+		SDL_ReleaseWindowFromGPUDevice(context->Device, context->Window);
+	}
+	// Everything the example and Common created on the device should be released by now
+	ReportGPUMemoryLeaks(context->Device);
+	SetGPUMemoryTag(NULL);
 	SDL_DestroyWindow(context->Window);
 	SDL_DestroyGPUDevice(context->Device);
 }
 
+// Frame Targets
+void SetHeadlessRendering(bool enabled)
+{
+	HeadlessRendering = enabled;
+}
+
+// Waits for the GPU to finish the frame before last. Every frame is a staging submission, so
+// the last one made before this acquire is the previous frame, and the one remembered at the
+// previous acquire is the frame before it.
+static void ThrottleHeadlessFrames()
+{
+	WaitForStagingSerial(Headless.Device, Headless.FrameSerial);
+	Headless.FrameSerial = GetNextStagingSerial(Headless.Device) - 1;
+}
+
+static bool AcquireHeadlessTexture(SDL_Window* window, SDL_GPUTexture** texture, Uint32* width, Uint32* height)
+{
+	int windowWidth, windowHeight;
+	SDL_GetWindowSizeInPixels(window, &windowWidth, &windowHeight);
+	if (Headless.Texture == NULL || Headless.Width != (Uint32) windowWidth || Headless.Height != (Uint32) windowHeight)
+	{
+		// Released textures stay alive until the GPU is done with them
+		SDL_ReleaseGPUTexture(Headless.Device, Headless.Texture);
+		Headless.Width = windowWidth;
+		Headless.Height = windowHeight;
+		Headless.Texture = SDL_CreateGPUTexture(
+			Headless.Device,
+			&(SDL_GPUTextureCreateInfo) {
+				.type = SDL_GPU_TEXTURETYPE_2D,
+				.format = HEADLESS_FRAME_FORMAT,
+				.width = Headless.Width,
+				.height = Headless.Height,
+				.layer_count_or_depth = 1,
+				.num_levels = 1,
+				.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+			}
+		);
+		if (Headless.Texture == NULL)
+		{
+			SDL_Log("Failed to create the headless frame texture: %s", SDL_GetError());
+			return false;
+		}
+	}
+
+	ThrottleHeadlessFrames();
+
+	*texture = Headless.Texture;
+	if (width != NULL)
+	{
+		*width = Headless.Width;
+	}
+	if (height != NULL)
+	{
+		*height = Headless.Height;
+	}
+	return true;
+}
+
+bool AcquireFrameTexture(
+	SDL_GPUCommandBuffer* commandBuffer,
+	SDL_Window* window,
+	SDL_GPUTexture** texture,
+	Uint32* width,
+	Uint32* height
+) {
+	// Usually where the CPU waits for the GPU or the display, so it's worth its own scope
+	PROFILE_BEGIN("Acquire Frame Texture");
+	bool acquired = HeadlessRendering ?
+		AcquireHeadlessTexture(window, texture, width, height) :
+		SDL_WaitAndAcquireGPUSwapchainTexture(commandBuffer, window, texture, width, height);
+	PROFILE_END();
+	return acquired;
+}
+
+SDL_GPUTextureFormat GetFrameTextureFormat(SDL_GPUDevice* device, SDL_Window* window)
+{
+	return HeadlessRendering ? HEADLESS_FRAME_FORMAT : SDL_GetGPUSwapchainTextureFormat(device, window);
+}
+
+bool SubmitCommandBuffer(SDL_GPUCommandBuffer* commandBuffer)
+{
+	if (HeadlessRendering)
+	{
+		return SubmitStagingCommandBuffer(Headless.Device, commandBuffer);
+	}
+
+	PROFILE_BEGIN("Submit");
+	Uint64 start = SDL_GetPerformanceCounter();
+	bool submitted = SDL_SubmitGPUCommandBuffer(commandBuffer);
+	CountSubmit(start);
+	PROFILE_END();
+	return submitted;
+}
+
+SubmitStats GetSubmitStats()
+{
+	return SubmitCounters;
+}
+
+// Staging memory has been released by now, which waited for the last frame
+static void ReleaseHeadlessTarget()
+{
+	SDL_ReleaseGPUTexture(Headless.Device, Headless.Texture);
+	SDL_zero(Headless);
+}
+
 static const char* BasePath = NULL;
 void InitializeAssetLoader()
 {
 	BasePath = SDL_GetBasePath();
+	SetAssetLoaderThreadCount(SDL_GetNumLogicalCPUCores());
+	MountAssetArchive("Content.pak");
+}
+
+// Shader bytecode stays resident for the lifetime of the program, so switching
+// examples (and recreating the device) never has to go back to disk.
+typedef struct ShaderBlob
+{
+	char* Path;
+	void* Code;
+	size_t CodeSize;
+	bool IsArchived;
+} ShaderBlob;
+
+static ShaderBlob* ShaderBlobs;
+static int ShaderBlobCount;
+static int ShaderBlobCapacity;
+
+// Compiled shader modules are scoped to the device that created them
+typedef struct ShaderCacheEntry
+{
+	SDL_GPUDevice* Device;
+	char* Name;
+	SDL_GPUShaderStage Stage;
+	SDL_GPUShaderFormat Format;
+	Uint32 SamplerCount;
+	Uint32 UniformBufferCount;
+	Uint32 StorageBufferCount;
+	Uint32 StorageTextureCount;
+	SDL_GPUShader* Shader;
+	int RefCount;
+} ShaderCacheEntry;
+
+static ShaderCacheEntry* ShaderCache;
+static int ShaderCacheCount;
+static int ShaderCacheCapacity;
+
+static bool SelectShaderFormat(
+	SDL_GPUDevice* device,
+	const char* shaderFilename,
+	char* assetName,
+	size_t assetNameLength,
+	SDL_GPUShaderFormat* pFormat,
+	const char** pEntrypoint
+) {
+	SDL_GPUShaderFormat backendFormats = SDL_GetGPUShaderFormats(device);
+
+	if (backendFormats & SDL_GPU_SHADERFORMAT_SPIRV) {
+		SDL_snprintf(assetName, assetNameLength, "Shaders/Compiled/SPIRV/%s.spv", shaderFilename);
+		*pFormat = SDL_GPU_SHADERFORMAT_SPIRV;
+		*pEntrypoint = "main";
+	} else if (backendFormats & SDL_GPU_SHADERFORMAT_MSL) {
+		SDL_snprintf(assetName, assetNameLength, "Shaders/Compiled/MSL/%s.msl", shaderFilename);
+		*pFormat = SDL_GPU_SHADERFORMAT_MSL;
+		*pEntrypoint = "main0";
+	} else if (backendFormats & SDL_GPU_SHADERFORMAT_DXIL) {
+		SDL_snprintf(assetName, assetNameLength, "Shaders/Compiled/DXIL/%s.dxil", shaderFilename);
+		*pFormat = SDL_GPU_SHADERFORMAT_DXIL;
+		*pEntrypoint = "main";
+	} else {
+		SDL_Log("%s", "Unrecognized backend shader format!");
+		return false;
+	}
+
+	return true;
+}
+
+static const ShaderBlob* LoadShaderBlob(const char* assetName)
+{
+	for (int i = 0; i < ShaderBlobCount; i += 1)
+	{
+		if (SDL_strcmp(ShaderBlobs[i].Path, assetName) == 0)
+		{
+			return &ShaderBlobs[i];
+		}
+	}
+
+	// Archived bytecode is used in place
+	ArchivedAssetInfo info;
+	size_t codeSize;
+	void* code = (void*)GetArchivedAsset(assetName, &info);
+	if (code != NULL)
+	{
+		codeSize = info.Size;
+	}
+	else
+	{
+		char fullPath[256];
+		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/%s", BasePath, assetName);
+		code = SDL_LoadFile(fullPath, &codeSize);
+		if (code == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	bool isArchived = GetArchivedAsset(assetName, NULL) == code;
+	char* path = SDL_strdup(assetName);
+	if (path != NULL && ShaderBlobCount == ShaderBlobCapacity)
+	{
+		int capacity = SDL_max(ShaderBlobCapacity * 2, 16);
+		ShaderBlob* blobs = SDL_realloc(ShaderBlobs, capacity * sizeof(ShaderBlob));
+		if (blobs == NULL)
+		{
+			SDL_free(path);
+			path = NULL;
+		}
+		else
+		{
+			ShaderBlobs = blobs;
+			ShaderBlobCapacity = capacity;
+		}
+	}
+	if (path == NULL)
+	{
+		if (!isArchived)
+		{
+			SDL_free(code);
+		}
+		return NULL;
+	}
+
+	ShaderBlob* blob = &ShaderBlobs[ShaderBlobCount++];
+	blob->Path = path;
+	blob->Code = code;
+	blob->CodeSize = codeSize;
+	blob->IsArchived = isArchived;
+	return blob;
+}
+
+// Archived bytecode points into the mapping, so it has to be dropped along with it
+void ReleaseArchivedShaderBlobs()
+{
+	int keptCount = 0;
+	for (int i = 0; i < ShaderBlobCount; i += 1)
+	{
+		if (ShaderBlobs[i].IsArchived)
+		{
+			SDL_free(ShaderBlobs[i].Path);
+		}
+		else
+		{
+			ShaderBlobs[keptCount++] = ShaderBlobs[i];
+		}
+	}
+	ShaderBlobCount = keptCount;
 }
 
 SDL_GPUShader* LoadShader(
@@ -74,38 +398,40 @@ SDL_GPUShader* LoadShader(
 	}
 
 	char fullPath[256];
-	SDL_GPUShaderFormat backendFormats = SDL_GetGPUShaderFormats(device);
 	SDL_GPUShaderFormat format = SDL_GPU_SHADERFORMAT_INVALID;
 	const char *entrypoint;
-
-	if (backendFormats & SDL_GPU_SHADERFORMAT_SPIRV) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/SPIRV/%s.spv", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_SPIRV;
-		entrypoint = "main";
-	} else if (backendFormats & SDL_GPU_SHADERFORMAT_MSL) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/MSL/%s.msl", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_MSL;
-		entrypoint = "main0";
-	} else if (backendFormats & SDL_GPU_SHADERFORMAT_DXIL) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/DXIL/%s.dxil", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_DXIL;
-		entrypoint = "main";
-	} else {
-		SDL_Log("%s", "Unrecognized backend shader format!");
+	if (!SelectShaderFormat(device, shaderFilename, fullPath, sizeof(fullPath), &format, &entrypoint))
+	{
 		return NULL;
 	}
 
-	size_t codeSize;
-	void* code = SDL_LoadFile(fullPath, &codeSize);
-	if (code == NULL)
+	for (int i = 0; i < ShaderCacheCount; i += 1)
+	{
+		ShaderCacheEntry* entry = &ShaderCache[i];
+		if (entry->Device == device &&
+			entry->Stage == stage &&
+			entry->Format == format &&
+			entry->SamplerCount == samplerCount &&
+			entry->UniformBufferCount == uniformBufferCount &&
+			entry->StorageBufferCount == storageBufferCount &&
+			entry->StorageTextureCount == storageTextureCount &&
+			SDL_strcmp(entry->Name, shaderFilename) == 0)
+		{
+			entry->RefCount += 1;
+			return entry->Shader;
+		}
+	}
+
+	const ShaderBlob* blob = LoadShaderBlob(fullPath);
+	if (blob == NULL)
 	{
 		SDL_Log("Failed to load shader from disk! %s", fullPath);
 		return NULL;
 	}
 
 	SDL_GPUShaderCreateInfo shaderInfo = {
-		.code = code,
-		.code_size = codeSize,
+		.code = blob->Code,
+		.code_size = blob->CodeSize,
 		.entrypoint = entrypoint,
 		.format = format,
 		.stage = stage,
@@ -118,44 +444,97 @@ SDL_GPUShader* LoadShader(
 	if (shader == NULL)
 	{
 		SDL_Log("Failed to create shader!");
-		SDL_free(code);
 		return NULL;
 	}
 
-	SDL_free(code);
+	// Left uncached if the cache can't hold it, ReleaseShader then releases it right away
+	char* name = SDL_strdup(shaderFilename);
+	if (name == NULL)
+	{
+		return shader;
+	}
+	if (ShaderCacheCount == ShaderCacheCapacity)
+	{
+		int capacity = SDL_max(ShaderCacheCapacity * 2, 16);
+		ShaderCacheEntry* cache = SDL_realloc(ShaderCache, capacity * sizeof(ShaderCacheEntry));
+		if (cache == NULL)
+		{
+			SDL_free(name);
+			return shader;
+		}
+		ShaderCache = cache;
+		ShaderCacheCapacity = capacity;
+	}
+
+	ShaderCache[ShaderCacheCount++] = (ShaderCacheEntry) {
+		.Device = device,
+		.Name = name,
+		.Stage = stage,
+		.Format = format,
+		.SamplerCount = samplerCount,
+		.UniformBufferCount = uniformBufferCount,
+		.StorageBufferCount = storageBufferCount,
+		.StorageTextureCount = storageTextureCount,
+		.Shader = shader,
+		.RefCount = 1
+	};
+
 	return shader;
 }
 
+void ReleaseShader(SDL_GPUDevice* device, SDL_GPUShader* shader)
+{
+	for (int i = 0; i < ShaderCacheCount; i += 1)
+	{
+		if (ShaderCache[i].Device == device && ShaderCache[i].Shader == shader)
+		{
+			// The module itself stays cached until the device goes away
+			SDL_assert(ShaderCache[i].RefCount > 0);
+			ShaderCache[i].RefCount -= 1;
+			return;
+		}
+	}
+
+	SDL_ReleaseGPUShader(device, shader);
+}
+
+void ReleaseShaderCache(SDL_GPUDevice* device)
+{
+	int kept = 0;
+	for (int i = 0; i < ShaderCacheCount; i += 1)
+	{
+		ShaderCacheEntry* entry = &ShaderCache[i];
+		if (entry->Device != device)
+		{
+			ShaderCache[kept++] = *entry;
+			continue;
+		}
+
+		if (entry->RefCount > 0)
+		{
+			SDL_Log("Shader %s still has %d reference(s) at device teardown!", entry->Name, entry->RefCount);
+		}
+		SDL_ReleaseGPUShader(device, entry->Shader);
+		SDL_free(entry->Name);
+	}
+	ShaderCacheCount = kept;
+}
+
 SDL_GPUComputePipeline* CreateComputePipelineFromShader(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
 	SDL_GPUComputePipelineCreateInfo *createInfo
 ) {
 	char fullPath[256];
-	SDL_GPUShaderFormat backendFormats = SDL_GetGPUShaderFormats(device);
 	SDL_GPUShaderFormat format = SDL_GPU_SHADERFORMAT_INVALID;
 	const char *entrypoint;
-
-	if (backendFormats & SDL_GPU_SHADERFORMAT_SPIRV) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/SPIRV/%s.spv", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_SPIRV;
-		entrypoint = "main";
-	} else if (backendFormats & SDL_GPU_SHADERFORMAT_MSL) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/MSL/%s.msl", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_MSL;
-		entrypoint = "main0";
-	} else if (backendFormats & SDL_GPU_SHADERFORMAT_DXIL) {
-		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/DXIL/%s.dxil", BasePath, shaderFilename);
-		format = SDL_GPU_SHADERFORMAT_DXIL;
-		entrypoint = "main";
-	} else {
-		SDL_Log("%s", "Unrecognized backend shader format!");
+	if (!SelectShaderFormat(device, shaderFilename, fullPath, sizeof(fullPath), &format, &entrypoint))
+	{
 		return NULL;
 	}
 
-	size_t codeSize;
-	void* code = SDL_LoadFile(fullPath, &codeSize);
-	if (code == NULL)
+	const ShaderBlob* blob = LoadShaderBlob(fullPath);
+	if (blob == NULL)
 	{
 		SDL_Log("Failed to load compute shader from disk! %s", fullPath);
 		return NULL;
@@ -163,20 +542,18 @@ SDL_GPUComputePipeline* CreateComputePipelineFromShader(
 
 	// Make a copy of the create data, then overwrite the parts we need
 	SDL_GPUComputePipelineCreateInfo newCreateInfo = *createInfo;
-	newCreateInfo.code = code;
-	newCreateInfo.code_size = codeSize;
+	newCreateInfo.code = blob->Code;
+	newCreateInfo.code_size = blob->CodeSize;
 	newCreateInfo.entrypoint = entrypoint;
 	newCreateInfo.format = format;
 
-	SDL_GPUComputePipeline* pipeline = SDL_CreateGPUComputePipeline(device, &newCreateInfo);
+	SDL_GPUComputePipeline* pipeline = AcquireComputePipeline(device, &newCreateInfo);
 	if (pipeline == NULL)
 	{
 		SDL_Log("Failed to create compute pipeline!");
-		SDL_free(code);
 		return NULL;
 	}
 
-	SDL_free(code);
 	return pipeline;
 }
 
@@ -186,6 +563,16 @@ SDL_Surface* LoadImage(const char* imageFilename, int desiredChannels)
 	SDL_Surface *result;
 	SDL_PixelFormat format;
 
+	SDL_snprintf(fullPath, sizeof(fullPath), "Images/%s", imageFilename);
+
+	// Archived images are already decoded, so wrap the mapped pixels without copying (read-only, see Common.h)
+	ArchivedAssetInfo info;
+	void* pixels = (void*)GetArchivedAsset(fullPath, &info);
+	if (pixels != NULL && info.Type == ARCHIVEDASSET_IMAGE && desiredChannels == 4)
+	{
+		return SDL_CreateSurfaceFrom(info.Width, info.Height, SDL_PIXELFORMAT_ABGR8888, pixels, info.Pitch);
+	}
+
 	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
 
 	result = SDL_LoadBMP(fullPath);
@@ -218,125 +605,67 @@ SDL_Surface* LoadImage(const char* imageFilename, int desiredChannels)
 float* LoadHDRImage(const char* imageFilename, int* pWidth, int* pHeight, int* pChannels, int desiredChannels)
 {
 	char fullPath[256];
+	SDL_snprintf(fullPath, sizeof(fullPath), "Images/%s", imageFilename);
+
+	// Archived HDR images are stored as RGBA32F; callers own (and free) the result, so copy it out
+	ArchivedAssetInfo info;
+	const void* data = GetArchivedAsset(fullPath, &info);
+	if (data != NULL && info.Type == ARCHIVEDASSET_HDR_IMAGE && desiredChannels == 4)
+	{
+		float* result = SDL_malloc(info.Size);
+		if (result != NULL)
+		{
+			SDL_memcpy(result, data, info.Size);
+			*pWidth = info.Width;
+			*pHeight = info.Height;
+			*pChannels = 4;
+		}
+		return result;
+	}
+
 	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
 	return stbi_loadf(fullPath, pWidth, pHeight, pChannels, desiredChannels);
 }
 
-typedef struct ASTCHeader
-{
-	Uint8 magic[4];
-	Uint8 blockX;
-	Uint8 blockY;
-	Uint8 blockZ;
-	Uint8 dimX[3];
-	Uint8 dimY[3];
-	Uint8 dimZ[3];
-} ASTCHeader;
-
-typedef struct DDS_PIXELFORMAT {
-	int dwSize;
-	int dwFlags;
-	int dwFourCC;
-	int dwRGBBitCount;
-	int dwRBitMask;
-	int dwGBitMask;
-	int dwBBitMask;
-	int dwABitMask;
-} DDS_PIXELFORMAT;
-
-typedef struct DDS_HEADER {
-	int dwMagic;
-	int dwSize;
-	int dwFlags;
-	int dwHeight;
-	int dwWidth;
-	int dwPitchOrLinearSize;
-	int dwDepth;
-	int dwMipMapCount;
-	int dwReserved1[11];
-	DDS_PIXELFORMAT ddspf;
-	int dwCaps;
-	int dwCaps2;
-	int dwCaps3;
-	int dwCaps4;
-	int dwReserved2;
-} DDS_HEADER;
-
-typedef struct DDS_HEADER_DXT10 {
-  int dxgiFormat;
-  int resourceDimension;
-  unsigned int miscFlag;
-  unsigned int arraySize;
-  unsigned int miscFlags2;
-} DDS_HEADER_DXT10;
-
-void* LoadASTCImage(const char* imageFilename, int* pWidth, int* pHeight, int* pImageDataLength)
+static void* ReadCompressedImageAndClose(CompressedImage* image, int* pWidth, int* pHeight, int* pImageDataLength)
 {
-	char fullPath[256];
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
+	// These entry points only return the top-level surface, which always comes first in the file
+	image->DataLength = image->Subresources[0].Length;
 
-	size_t fileSize;
-	void* fileContents = SDL_LoadFile(fullPath, &fileSize);
-	if (fileContents == NULL)
+	void* data = SDL_malloc(image->DataLength);
+	if (data != NULL && !ReadCompressedImageData(image, data))
 	{
-		SDL_assert(!"Could not load ASTC image!");
-		return NULL;
+		SDL_free(data);
+		data = NULL;
 	}
+	CloseCompressedImage(image);
 
-	ASTCHeader* header = (ASTCHeader*)fileContents;
-	if (header->magic[0] != 0x13 || header->magic[1] != 0xAB || header->magic[2] != 0xA1 || header->magic[3] != 0x5C)
-	{
-		SDL_assert(!"Bad magic number!");
-		return NULL;
-	}
-
-	// Get the image dimensions in texels
-	*pWidth = header->dimX[0] + (header->dimX[1] << 8) + (header->dimX[2] << 16);
-	*pHeight = header->dimY[0] + (header->dimY[1] << 8) + (header->dimY[2] << 16);
-
-	// Get the size of the texture data
-	unsigned int block_count_x = (*pWidth + header->blockX - 1) / header->blockX;
-	unsigned int block_count_y = (*pHeight + header->blockY - 1) / header->blockY;
-	*pImageDataLength = block_count_x * block_count_y * 16;
-
-	void* data = SDL_malloc(*pImageDataLength);
-	SDL_memcpy(data, (char*)fileContents + sizeof(ASTCHeader), *pImageDataLength);
-	SDL_free(fileContents);
-
+	*pWidth = image->Width;
+	*pHeight = image->Height;
+	*pImageDataLength = image->DataLength;
 	return data;
 }
 
-void* LoadDDSImage(const char* imageFilename, SDL_GPUTextureFormat format, int* pWidth, int* pHeight, int* pImageDataLength)
+void* LoadASTCImage(const char* imageFilename, int* pWidth, int* pHeight, int* pImageDataLength)
 {
-	char fullPath[256];
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
-
-	size_t fileSize;
-	void* fileContents = SDL_LoadFile(fullPath, &fileSize);
-	if (fileContents == NULL)
+	CompressedImage image;
+	if (!OpenASTCImage(imageFilename, &image))
 	{
-		SDL_assert(!"Could not load DDS image!");
 		return NULL;
 	}
 
-	DDS_HEADER* header = (DDS_HEADER*)fileContents;
-	if (header->dwMagic != 0x20534444)
+	return ReadCompressedImageAndClose(&image, pWidth, pHeight, pImageDataLength);
+}
+
+void* LoadDDSImage(const char* imageFilename, SDL_GPUTextureFormat format, int* pWidth, int* pHeight, int* pImageDataLength)
+{
+	CompressedImage image;
+	if (!OpenDDSImage(imageFilename, format, &image))
 	{
-		SDL_assert(!"Bad magic number!");
 		return NULL;
 	}
 
-	bool hasDX10Header = header->ddspf.dwFlags == 0x4 && header->ddspf.dwFourCC == 0x30315844;
-
-	*pWidth = header->dwWidth;
-	*pHeight = header->dwHeight;
-	*pImageDataLength = header->dwPitchOrLinearSize;
-
-	void* data = SDL_malloc(*pImageDataLength);
-	SDL_memcpy(data, (char*)fileContents + sizeof(DDS_HEADER) + (hasDX10Header ? sizeof(DDS_HEADER_DXT10) : 0), *pImageDataLength);
-	SDL_free(fileContents);
-
-	return data;
+	return ReadCompressedImageAndClose(&image, pWidth, pHeight, pImageDataLength);
 }
 
 // Matrix Math
@@ -9,6 +9,7 @@ typedef struct Context
 	const char* BasePath;
 	SDL_Window* Window;
 	SDL_GPUDevice* Device;
+	bool Headless; // The window has no swapchain, see SetHeadlessRendering
 	bool LeftPressed;
 	bool RightPressed;
 	bool DownPressed;
@@ -19,12 +20,267 @@ typedef struct Context
 int CommonInit(Context* context, SDL_WindowFlags windowFlags);
 void CommonQuit(Context* context);
 
+// Frame Targets
+// Examples acquire the texture they present, create pipelines for its format and submit their
+// command buffers through these. Normally they forward to the window's swapchain. With headless
+// rendering enabled before CommonInit, the window is never claimed and every frame renders into
+// an offscreen texture of the window's size instead, with the CPU held to two frames ahead of
+// the GPU as a swapchain would. Headless frames are submitted as staging submissions, whose
+// fences do the throttling.
+typedef struct SubmitStats
+{
+	Uint64 Submits;
+	double Milliseconds; // Spent inside SDL's submit calls
+} SubmitStats;
+
+void SetHeadlessRendering(bool enabled);
+bool AcquireFrameTexture(
+	SDL_GPUCommandBuffer* commandBuffer,
+	SDL_Window* window,
+	SDL_GPUTexture** texture,
+	Uint32* width,
+	Uint32* height
+);
+SDL_GPUTextureFormat GetFrameTextureFormat(SDL_GPUDevice* device, SDL_Window* window);
+bool SubmitCommandBuffer(SDL_GPUCommandBuffer* commandBuffer);
+// Adds a submit call that began at start, a performance counter value, to the submit stats
+void CountSubmit(Uint64 start);
+SubmitStats GetSubmitStats();
+
+// Profiling
+// CPU scopes timed with SDL_GetPerformanceCounter. PROFILE_BEGIN opens a scope and PROFILE_END
+// closes the innermost open one; each thread records into its own ring of the most recent
+// PROFILE_RING_SIZE scopes, so recording takes no locks. While profiling is disabled a marker
+// is a single branch, and defining SDL_GPU_EXAMPLES_NO_PROFILING compiles them out entirely.
+// WriteProfileTrace writes the Chrome trace event format, which ui.perfetto.dev and
+// chrome://tracing open.
+#define PROFILE_RING_SIZE 65536
+#define PROFILE_MAX_DEPTH 32
+
+extern bool ProfilingEnabled;
+void SetProfilingEnabled(bool enabled);
+// Names aren't copied, so they must outlive the trace (string literals or example names)
+void BeginProfileScope(const char* name);
+void EndProfileScope();
+// Call while no other thread is recording, e.g. after the frame loop and the worker pools quit
+bool WriteProfileTrace(const char* filename);
+void QuitProfiler();
+
+#ifdef SDL_GPU_EXAMPLES_NO_PROFILING
+#define PROFILE_BEGIN(name) do { } while (0)
+#define PROFILE_END() do { } while (0)
+#else
+#define PROFILE_BEGIN(name) do { if (ProfilingEnabled) { BeginProfileScope(name); } } while (0)
+#define PROFILE_END() do { if (ProfilingEnabled) { EndProfileScope(); } } while (0)
+#endif
+
+// GPU Memory Accounting
+// In builds with SDL_GPU_EXAMPLES_INSTRUMENTATION, buffers, textures and transfer buffers are
+// tracked from SDL's create calls to its release calls (see Instrumentation.h); otherwise these
+// report nothing. Texture sizes come from the format, dimensions, layers or depth, mip levels and
+// sample count, the least the driver has to allocate. Each allocation is tagged with the example
+// that made it and named after its SDL name, or the call site when it has none. CommonInit tags
+// the example and restarts the peak, and CommonQuit reports anything it left allocated as leaked.
+typedef enum GPUMemoryKind
+{
+	GPU_MEMORY_BUFFER,
+	GPU_MEMORY_TEXTURE,
+	GPU_MEMORY_TRANSFER_BUFFER,
+	GPU_MEMORY_KIND_COUNT
+} GPUMemoryKind;
+
+typedef struct GPUMemoryStats
+{
+	Uint64 CurrentBytes[GPU_MEMORY_KIND_COUNT];
+	Uint64 TotalBytes;
+	Uint64 PeakBytes; // Of TotalBytes, since the last reset
+	int LiveAllocations;
+	int Leaks;
+} GPUMemoryStats;
+
+Uint64 GetGPUTextureSize(const SDL_GPUTextureCreateInfo* createInfo);
+// SDL_GPU_TEXTUREFORMAT_INVALID for textures that aren't tracked
+SDL_GPUTextureFormat GetTrackedTextureFormat(SDL_GPUTexture* texture);
+// Tags later allocations, the tag isn't copied
+void SetGPUMemoryTag(const char* tag);
+// Restarts the peak from the current total
+void ResetGPUMemoryPeak();
+// Logs the totals, then every live allocation from largest to smallest
+void LogGPUMemory();
+// Logs and stops tracking the allocations still alive on the device, returning how many
+int ReportGPUMemoryLeaks(SDL_GPUDevice* device);
+GPUMemoryStats GetGPUMemoryStats();
+
+// Command Statistics
+// In the instrumentation build, Instrumentation.h routes passes, binds, draws, dispatches, uniform
+// pushes, uploads and blits through counting wrappers. A bind that only repeats what is already
+// bound in the current pass is counted as redundant. Counters accumulate until
+// EndCommandStatsFrame, which the frame loop calls once per frame, and stay zero otherwise.
+// Not thread-safe: commands are expected to be recorded on one thread.
+typedef struct CommandStats
+{
+	Uint64 RenderPasses;
+	Uint64 ComputePasses;
+	Uint64 CopyPasses;
+	Uint64 Draws; // An indirect draw counts once, whatever its draw count
+	Uint64 Dispatches;
+	Uint64 PipelineBinds;
+	Uint64 VertexBufferBinds;
+	Uint64 IndexBufferBinds;
+	Uint64 SamplerBinds;
+	Uint64 StorageBinds;
+	Uint64 UniformPushes;
+	Uint64 Uploads;
+	Uint64 UploadBytes; // Texture uploads count only for tracked textures
+	Uint64 Blits;
+	Uint64 RedundantBinds; // Binds that changed nothing in their pass
+	Uint64 PassRebinds; // Binds that repeated the previous pass of the same type
+} CommandStats;
+
+// Returns the counts since the previous call and starts over
+CommandStats EndCommandStatsFrame();
+void AddCommandStats(CommandStats* total, const CommandStats* stats);
+void LogCommandStats(const CommandStats* stats);
+
 void InitializeAssetLoader();
+// Surfaces of archived images point straight into the read-only archive mapping: don't write
+// to their pixels, and destroy them before the archive is unmounted.
 SDL_Surface* LoadImage(const char* imageFilename, int desiredChannels);
 float* LoadHDRImage(const char* imageFilename, int* pWidth, int* pHeight, int* pChannels, int desiredChannels);
+// Decodes to RGBA16F (alpha = 1) with SIMD, splitting the rows across threads. Free with SDL_free.
+Uint16* LoadHDRImageHalf(const char* imageFilename, int* pWidth, int* pHeight);
+Uint16 FloatToHalf(float value); // Rounds to nearest even
 void* LoadASTCImage(const char* imageFilename, int* pWidth, int* pHeight, int* pImageDataLength);
 void* LoadDDSImage(const char* imageFilename, SDL_GPUTextureFormat format, int* pWidth, int* pHeight, int* pImageDataLength);
 
+// Packed asset archive: every loadable asset in one file, mapped into memory and
+// looked up by its path relative to Content/ (e.g. "Images/ravioli.bmp"). While an
+// archive is mounted the loaders above resolve through it before touching the
+// loose files. InitializeAssetLoader mounts Content.pak automatically if present.
+typedef enum ArchivedAssetType
+{
+	ARCHIVEDASSET_IMAGE,		// Decoded ABGR8888 pixels
+	ARCHIVEDASSET_HDR_IMAGE,	// Decoded RGBA32F pixels
+	ARCHIVEDASSET_FILE			// The file as it is on disk (DDS, ASTC, shader bytecode)
+} ArchivedAssetType;
+
+typedef struct ArchivedAssetInfo
+{
+	ArchivedAssetType Type;
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 Pitch;
+	size_t Size;
+} ArchivedAssetInfo;
+
+bool MountAssetArchive(const char* archiveFilename);
+void UnmountAssetArchive();
+const void* GetArchivedAsset(const char* name, ArchivedAssetInfo* pInfo);
+bool WriteAssetArchive(const char* archivePath);
+
+// Streaming access to compressed images: open the file and decode the header,
+// then read the block payload directly into caller-owned memory (e.g. a mapped transfer buffer).
+typedef struct CompressedImageSubresource
+{
+	int MipLevel;
+	int Layer;
+	int Width;
+	int Height;
+	int Offset; // Relative to the start of the payload
+	int Length;
+} CompressedImageSubresource;
+
+typedef struct CompressedImage
+{
+	SDL_IOStream* Stream;
+	int Width;
+	int Height;
+	int MipLevelCount;
+	int LayerCount; // Includes the 6 faces of each cube
+	bool IsCubemap;
+	int DataOffset;
+	int DataLength; // The whole mip/array/cube chain
+	int SubresourceCount;
+	CompressedImageSubresource* Subresources;
+} CompressedImage;
+
+bool OpenASTCImage(const char* imageFilename, CompressedImage* image);
+bool OpenDDSImage(const char* imageFilename, SDL_GPUTextureFormat format, CompressedImage* image);
+bool ReadCompressedImageData(CompressedImage* image, void* dst);
+void UploadCompressedImage(
+	SDL_GPUCopyPass* copyPass,
+	SDL_GPUTransferBuffer* transferBuffer,
+	Uint32 transferOffset,
+	SDL_GPUTexture* texture,
+	const CompressedImage* image
+);
+void CloseCompressedImage(CompressedImage* image);
+SDL_GPUTextureType GetCompressedImageTextureType(const CompressedImage* image);
+
+// Software Texture Decoding
+// CPU fallbacks for block-compressed formats the device can't sample (BC1-BC7 and LDR ASTC).
+// Rows of blocks are decoded in parallel into RGBA8 (keeping sRGB) or, for BC6H, RGBA16F.
+SDL_GPUTextureFormat GetDecompressedTextureFormat(SDL_GPUTextureFormat format); // INVALID if there's no decoder
+bool DecompressTextureData(SDL_GPUTextureFormat format, const void* src, int width, int height, void* dst);
+Uint32 GetDecompressedImageLength(const CompressedImage* image, SDL_GPUTextureFormat format);
+// Decodes every subresource into dst and rewrites the image's offsets and lengths to describe dst
+bool DecompressImage(CompressedImage* image, SDL_GPUTextureFormat format, const void* src, void* dst);
+
+// Software Texture Encoding
+// BC1, BC3 and BC7 (modes 5 and 6) from RGBA8, rows of blocks in parallel with SIMD index selection.
+bool CompressTextureData(SDL_GPUTextureFormat format, const void* src, int width, int height, void* dst);
+Uint32 GetCompressedTextureLength(SDL_GPUTextureFormat format, int width, int height); // 0 if format isn't block-compressed
+// Load-time compression of uncompressed images, off unless enabled (-compresstextures).
+void SetImageCompressionEnabled(bool enabled);
+// BC1 for opaque images and BC7/BC3 otherwise when enabled and supported, else R8G8B8A8_UNORM
+SDL_GPUTextureFormat SelectImageTextureFormat(SDL_GPUDevice* device, const SDL_Surface* image);
+// Returns the RGBA8 image's blocks in format, read from the texture cache when the same pixels
+// were encoded before. Free with SDL_free.
+void* EncodeImage(const SDL_Surface* image, SDL_GPUTextureFormat format, Uint32* pLength);
+
+// Async Asset Loading
+// Jobs run on a pool of worker threads. The AsyncAsset is owned by the caller and acts as
+// the future: once IsAssetReady() returns true (or WaitForAsset() returns), the outputs are valid.
+typedef enum AssetType
+{
+	ASSETTYPE_IMAGE,		// LoadImage -> Surface
+	ASSETTYPE_HDR_IMAGE,	// LoadHDRImage -> HDRData
+	ASSETTYPE_HDR_IMAGE_HALF,	// LoadHDRImageHalf -> Data
+	ASSETTYPE_DDS_IMAGE,	// OpenDDSImage + full payload -> Image, Data
+	ASSETTYPE_ASTC_IMAGE,	// OpenASTCImage + full payload -> Image, Data
+	ASSETTYPE_COMPRESSED_IMAGE_DATA,	// ReadCompressedImageData of an opened Image into Data
+	ASSETTYPE_DECOMPRESSED_IMAGE_DATA	// As above, then DecompressImage from Format into Data
+} AssetType;
+
+typedef struct AsyncAsset
+{
+	// Inputs
+	AssetType Type;
+	const char* Filename;
+	int DesiredChannels;
+	SDL_GPUTextureFormat Format;
+
+	// Outputs
+	bool Succeeded;
+	SDL_Surface* Surface;
+	float* HDRData;
+	int Width;
+	int Height;
+	int Channels;
+	CompressedImage Image; // The stream is closed once a DDS/ASTC job finishes
+	void* Data; // Caller-supplied destination for the *_IMAGE_DATA jobs
+
+	// Internal
+	SDL_AtomicInt Done;
+	struct AsyncAsset* Next;
+} AsyncAsset;
+
+void SetAssetLoaderThreadCount(int threadCount);
+void QuitAssetLoader();
+void LoadAssetAsync(AsyncAsset* asset);
+bool IsAssetReady(AsyncAsset* asset);
+void WaitForAsset(AsyncAsset* asset);
+
 SDL_GPUShader* LoadShader(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
@@ -33,12 +289,343 @@ SDL_GPUShader* LoadShader(
 	Uint32 storageBufferCount,
 	Uint32 storageTextureCount
 );
+// Shaders returned by LoadShader are shared per device; release them with ReleaseShader
+void ReleaseShader(SDL_GPUDevice* device, SDL_GPUShader* shader);
+void ReleaseShaderCache(SDL_GPUDevice* device);
+// Drops the bytecode that points into the mounted asset archive, before it is unmapped
+void ReleaseArchivedShaderBlobs();
 SDL_GPUComputePipeline* CreateComputePipelineFromShader(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
 	SDL_GPUComputePipelineCreateInfo* createInfo
 );
 
+// Pipelines are shared per device: identical create-infos return the same pipeline.
+// Released pipelines stay resident until the device is destroyed, so acquiring and
+// immediately releasing a pipeline prewarms it.
+typedef struct PipelineRegistryStats
+{
+	int Hits;
+	int Misses;
+	int LivePipelines;
+} PipelineRegistryStats;
+
+SDL_GPUGraphicsPipeline* AcquireGraphicsPipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* createInfo);
+// Examples get compute pipelines from CreateComputePipelineFromShader, which comes through here
+SDL_GPUComputePipeline* AcquireComputePipeline(SDL_GPUDevice* device, const SDL_GPUComputePipelineCreateInfo* createInfo);
+void ReleaseGraphicsPipeline(SDL_GPUDevice* device, SDL_GPUGraphicsPipeline* pipeline);
+void ReleaseComputePipeline(SDL_GPUDevice* device, SDL_GPUComputePipeline* pipeline);
+void ReleasePipelineRegistry(SDL_GPUDevice* device);
+PipelineRegistryStats GetPipelineRegistryStats();
+
+// Staging Memory
+// Uploads are written into aligned sub-ranges of a few large transfer buffers that live as
+// long as the device. A range is handed out again once the fence of the submission that read
+// it has signaled, so command buffers that upload from staging memory must be submitted with
+// SubmitStagingCommandBuffer.
+typedef struct StagingAllocation
+{
+	SDL_GPUTransferBuffer* TransferBuffer;
+	Uint32 Offset;
+	Uint32 Size;
+} StagingAllocation;
+
+typedef struct StagingStats
+{
+	int PageCount;
+	Uint64 PageBytes;
+	Uint64 Allocations;
+	Uint64 AllocatedBytes;
+	int InFlightSubmissions;
+	int FenceWaits; // Allocations that had to block until the GPU was done with a page
+} StagingStats;
+
+// Returns the mapped range; unmap it before recording the upload. An alignment of 0 means 16.
+void* MapStagingMemory(SDL_GPUDevice* device, Uint32 size, Uint32 alignment, StagingAllocation* allocation);
+void UnmapStagingMemory(SDL_GPUDevice* device, const StagingAllocation* allocation);
+// Grows or shrinks the most recent allocation in place when its page has room
+bool ResizeStagingMemory(SDL_GPUDevice* device, StagingAllocation* allocation, Uint32 size);
+bool StageData(SDL_GPUDevice* device, const void* data, Uint32 size, Uint32 alignment, StagingAllocation* allocation);
+bool SubmitStagingCommandBuffer(SDL_GPUDevice* device, SDL_GPUCommandBuffer* commandBuffer);
+// Blocks until every staging submission so far has completed
+void WaitForStagingSubmissions(SDL_GPUDevice* device);
+// Submissions are numbered from 1, in order. Work recorded into a command buffer goes out with
+// the next serial, which readbacks and frame rings remember so they know what to wait on.
+// Tracking starts with the first staging allocation, readback or submission on a device.
+void BindStagingDevice(SDL_GPUDevice* device);
+Uint64 GetNextStagingSerial(SDL_GPUDevice* device);
+// Polls the fences in flight, returning the newest serial known to have completed (0 if none)
+Uint64 GetCompletedStagingSerial(SDL_GPUDevice* device);
+// Blocks until the submission with this serial, and every one before it, has completed
+void WaitForStagingSerial(SDL_GPUDevice* device, Uint64 serial);
+void ReleaseStagingMemory(SDL_GPUDevice* device);
+StagingStats GetStagingStats();
+
+// Upload Batching
+// Uploads are queued up front and then recorded together in one copy pass. Payloads are
+// packed back to back into a single staging range for as long as its page has room, texture
+// payloads start on 512-byte boundaries (D3D12's placement alignment, which is also a multiple
+// of every texel block size), and adjacent copies into the same buffer are merged.
+typedef struct UploadBatchStats
+{
+	int Uploads;
+	int Copies; // Recorded after merging
+	int StagingRanges;
+	Uint64 Bytes;
+} UploadBatchStats;
+
+typedef struct UploadBatch
+{
+	SDL_GPUDevice* Device;
+	struct QueuedUpload* Uploads;
+	int UploadCount;
+	int UploadCapacity;
+	struct UploadRange* Ranges;
+	int RangeCount;
+	int RangeCapacity;
+	UploadBatchStats Stats;
+} UploadBatch;
+
+void BeginUploadBatch(UploadBatch* batch, SDL_GPUDevice* device);
+// These return where to write the payload, which stays mapped until the batch is recorded
+void* QueueBufferUpload(UploadBatch* batch, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 size);
+void* QueueTextureUpload(UploadBatch* batch, SDL_GPUTextureFormat format, const SDL_GPUTextureRegion* region);
+// Reserved data can be the source of any number of texture uploads, e.g. a whole compressed image payload
+void* ReserveUploadData(UploadBatch* batch, Uint32 size);
+void QueueReservedTextureUpload(UploadBatch* batch, const void* data, const SDL_GPUTextureRegion* region);
+void QueueCompressedImageUpload(UploadBatch* batch, const void* data, SDL_GPUTexture* texture, const CompressedImage* image);
+void RecordUploadBatch(UploadBatch* batch, SDL_GPUCopyPass* copyPass);
+bool FlushUploadBatch(UploadBatch* batch); // Records into a copy pass of its own and submits it
+void CancelUploadBatch(UploadBatch* batch);
+
+// Readback Queue
+// Downloads are recorded into a copy pass and their results handed to a callback once the GPU
+// is done with them, instead of waiting on a fence right after submitting. The command buffer
+// must be submitted with SubmitStagingCommandBuffer. UpdateReadbacks runs once per frame and
+// only blocks on readbacks that are older than the latency (in frames, 2 by default).
+typedef Uint32 ReadbackTicket; // 0 if the request failed
+typedef void (*ReadbackCallback)(void* userdata, const void* data, Uint32 size);
+
+typedef struct ReadbackStats
+{
+	Uint64 Requested;
+	Uint64 Delivered;
+	Uint64 TotalLatencyFrames;
+	int Stalls; // Readbacks that hit the latency limit and had to be waited on
+	int Pending;
+} ReadbackStats;
+
+ReadbackTicket ReadbackTexture(
+	SDL_GPUDevice* device,
+	SDL_GPUCopyPass* copyPass,
+	SDL_GPUTextureFormat format,
+	const SDL_GPUTextureRegion* region,
+	ReadbackCallback callback,
+	void* userdata
+);
+ReadbackTicket ReadbackBuffer(
+	SDL_GPUDevice* device,
+	SDL_GPUCopyPass* copyPass,
+	const SDL_GPUBufferRegion* region,
+	ReadbackCallback callback,
+	void* userdata
+);
+bool IsReadbackComplete(ReadbackTicket ticket);
+void SetReadbackLatency(int frames);
+void UpdateReadbacks(SDL_GPUDevice* device);
+void FinishReadbacks(SDL_GPUDevice* device); // Blocks until every submitted readback is delivered
+void ReleaseReadbacks(SDL_GPUDevice* device);
+ReadbackStats GetReadbackStats();
+
+// Frame Rings
+// Per-frame data written by the CPU and read by the GPU, with one transfer region and one GPU
+// buffer per frame in flight, all created up front. The device's allowed frames in flight is set
+// to the ring's slot count, so acquiring the swapchain normally guarantees the current slot is
+// free again; the ring still checks the slot's fence and counts a stall if it has to wait.
+#define MAX_FRAME_RING_SLOTS 3
+
+typedef struct FrameRingStats
+{
+	Uint64 Frames;
+	int Stalls; // Frames whose slot was still in use by the GPU
+	double StallMilliseconds;
+	Uint64 MemoryBytes; // Transfer and GPU buffer memory for all slots
+} FrameRingStats;
+
+typedef struct FrameRing
+{
+	SDL_GPUDevice* Device;
+	SDL_GPUTransferBuffer* TransferBuffer; // SlotCount regions of SlotSize bytes
+	SDL_GPUBuffer* Buffers[MAX_FRAME_RING_SLOTS];
+	Uint64 SlotSerials[MAX_FRAME_RING_SLOTS]; // Staging submission that last read each slot
+	SDL_GPUBufferUsageFlags Usage;
+	Uint32 SlotSize;
+	int SlotCount;
+	int Slot;
+	bool Mapped;
+	bool Uploaded;
+	FrameRingStats Stats;
+} FrameRing;
+
+bool CreateFrameRing(FrameRing* ring, SDL_GPUDevice* device, Uint32 slotSize, SDL_GPUBufferUsageFlags usage, int framesInFlight);
+// Returns the current slot's transfer region, waiting for the GPU if it is still reading it
+void* MapFrameRing(FrameRing* ring);
+// Unmaps and uploads the first size bytes of the slot, returning the slot's buffer to bind
+SDL_GPUBuffer* UploadFrameRing(FrameRing* ring, SDL_GPUCopyPass* copyPass, Uint32 size);
+// Submits the frame's command buffer and moves on to the next slot
+bool SubmitFrameRing(FrameRing* ring, SDL_GPUCommandBuffer* commandBuffer);
+// Replaces every slot with one of slotSize bytes. Call between frames, not while mapped.
+bool ResizeFrameRing(FrameRing* ring, Uint32 slotSize);
+void ReleaseFrameRing(FrameRing* ring);
+
+// Sprite Building
+// Fills sprite instance arrays with randomly placed sprites from a 2x2 atlas, split across a
+// pool of worker threads and written with SIMD. The same seed always builds the same sprites,
+// regardless of the thread count.
+typedef struct SpriteInstance
+{
+	float x, y, z;
+	float rotation;
+	float w, h, padding_a, padding_b;
+	float tex_u, tex_v, tex_w, tex_h;
+	float r, g, b, a;
+} SpriteInstance;
+
+// A quarter of the size: the atlas rect is looked up by region index and z is always 0
+typedef struct CompactSpriteInstance
+{
+	Uint16 x, y; // Half floats
+	Uint16 w, h; // Half floats
+	Uint16 rotation; // In 1/65536ths of a full turn
+	Uint16 region; // Atlas regions are numbered left to right, then top to bottom
+	Uint32 color; // RGBA8, red in the lowest byte
+} CompactSpriteInstance;
+
+typedef struct SpriteBuildInfo
+{
+	Uint32 Seed;
+	float AreaWidth; // Positions are whole numbers in [0, AreaWidth) x [0, AreaHeight)
+	float AreaHeight;
+	float SpriteSize;
+} SpriteBuildInfo;
+
+// Counts the calling thread; started with one thread per core on first use otherwise
+void SetSpriteBuilderThreadCount(int threadCount);
+void QuitSpriteBuilder();
+void BuildSprites(SpriteInstance* sprites, Uint32 count, const SpriteBuildInfo* info);
+void BuildCompactSprites(CompactSpriteInstance* sprites, Uint32 count, const SpriteBuildInfo* info);
+
+// Sprite Simulation
+// Sprite state that stays on the GPU: SpriteSimulate.comp moves, spins and recolors every
+// sprite by the frame's delta time, bouncing off the edges of the area, and the CPU only
+// uploads the sprites spawned since the last update. Despawning moves the last sprites into the
+// freed slots, so indices are only stable until the next update.
+typedef struct SpriteMotion
+{
+	float vx, vy; // Pixels per second
+	float spin; // Radians per second
+	float hue; // 0 to 1, cycled once every four seconds
+} SpriteMotion;
+
+typedef struct SpriteSimulationStats
+{
+	Uint64 Steps;
+	Uint64 Spawned;
+	Uint64 Despawned;
+	Uint64 Dropped; // Spawns that did not fit in the capacity
+	Uint64 UploadedBytes;
+} SpriteSimulationStats;
+
+typedef struct SpriteSimulation
+{
+	SDL_GPUDevice* Device;
+	SDL_GPUComputePipeline* Pipeline;
+	SDL_GPUBuffer* InstanceBuffer; // Count SpriteInstance records, readable by compute and vertex shaders
+	SDL_GPUBuffer* MotionBuffer;
+	Uint32 Capacity;
+	Uint32 Count; // Sprites on the GPU as of the last update
+	SpriteInstance* SpawnInstances;
+	SpriteMotion* SpawnMotions;
+	Uint32 SpawnCount;
+	Uint32 SpawnCapacity;
+	Uint32* Despawns;
+	Uint32 DespawnCount;
+	Uint32 DespawnCapacity;
+	SpriteSimulationStats Stats;
+} SpriteSimulation;
+
+bool CreateSpriteSimulation(SpriteSimulation* simulation, SDL_GPUDevice* device, Uint32 capacity);
+// Queues count sprites for the next update and returns their records to fill in, which stay
+// valid until the next spawn. Returns NULL, counting the sprites as dropped, if they can't be queued.
+SpriteInstance* SpawnSprites(SpriteSimulation* simulation, Uint32 count, SpriteMotion** motions);
+// Spawns sprites from BuildSprites with random velocities, spins and hues
+void SpawnRandomSprites(SpriteSimulation* simulation, Uint32 count, const SpriteBuildInfo* info);
+void DespawnSprite(SpriteSimulation* simulation, Uint32 index);
+// Applies the queued despawns, then the spawns, then steps the simulation. The command buffer
+// must be submitted with SubmitStagingCommandBuffer, as spawns are uploaded from staging memory.
+void UpdateSpriteSimulation(SpriteSimulation* simulation, SDL_GPUCommandBuffer* commandBuffer, float deltaTime, float areaWidth, float areaHeight);
+void ReleaseSpriteSimulation(SpriteSimulation* simulation);
+
+// GPU Radix Sort
+// Stable key/value sort of 32-bit keys and values in compute shaders. Fill Keys[0] and
+// Values[0], then SortRadix records the passes into a command buffer and returns which of the
+// two buffers holds the result. Only the low keyBits of each key are sorted on, 4 per pass.
+typedef struct RadixSorter
+{
+	SDL_GPUDevice* Device;
+	SDL_GPUComputePipeline* CountPipeline;
+	SDL_GPUComputePipeline* ScanPipeline;
+	SDL_GPUComputePipeline* ScatterPipeline;
+	SDL_GPUBuffer* Keys[2];
+	SDL_GPUBuffer* Values[2];
+	SDL_GPUBuffer* Histograms; // 16 digit counts per block of 1024 keys
+	Uint32 Capacity;
+} RadixSorter;
+
+bool CreateRadixSorter(RadixSorter* sorter, SDL_GPUDevice* device, Uint32 capacity);
+// Recreates the buffers if they hold fewer than capacity keys, discarding their contents
+bool ReserveRadixSorter(RadixSorter* sorter, Uint32 capacity);
+int SortRadix(RadixSorter* sorter, SDL_GPUCommandBuffer* commandBuffer, Uint32 count, int keyBits);
+void ReleaseRadixSorter(RadixSorter* sorter);
+
+// Sprite Batches
+// The vertex buffer that compute shaders expand sprites into, sized by the sprites actually
+// drawn: ReserveSpriteBatch at least doubles the capacity whenever it has to grow. Every quad
+// shares one 16-bit index buffer holding the pattern for a single chunk of sprites, and larger
+// batches are drawn a chunk at a time, each draw moving vertex_offset on by a chunk.
+//
+// Compute shaders that cull can count into DrawCommandBuffer instead: the visible sprite count,
+// then one SDL_GPUIndexedIndirectDrawCommand per chunk. ResetSpriteBatchDraws zeroes it.
+#define SPRITE_BATCH_CHUNK_SIZE 16384 // Sprites per draw, 65536 vertices
+
+typedef struct SpriteBatchStats
+{
+	int Grows;
+	Uint64 MemoryBytes; // Vertex, index and draw command buffers
+} SpriteBatchStats;
+
+typedef struct SpriteBatch
+{
+	SDL_GPUDevice* Device;
+	SDL_GPUBuffer* VertexBuffer; // 4 vertices per sprite
+	SDL_GPUBuffer* IndexBuffer;
+	SDL_GPUBuffer* DrawCommandBuffer;
+	SDL_GPUTransferBuffer* DrawCommandResetBuffer;
+	Uint32 VertexSize;
+	Uint32 Capacity;
+	SpriteBatchStats Stats;
+} SpriteBatch;
+
+bool CreateSpriteBatch(SpriteBatch* batch, SDL_GPUDevice* device, Uint32 vertexSize, Uint32 capacity);
+// Growing replaces the vertex and draw command buffers, discarding their contents. On failure
+// the batch keeps its old buffers.
+bool ReserveSpriteBatch(SpriteBatch* batch, Uint32 count);
+void ResetSpriteBatchDraws(SpriteBatch* batch, SDL_GPUCopyPass* copyPass);
+// Both bind the vertex and index buffers themselves
+void DrawSpriteBatch(SpriteBatch* batch, SDL_GPURenderPass* renderPass, Uint32 count);
+void DrawSpriteBatchIndirect(SpriteBatch* batch, SDL_GPURenderPass* renderPass, Uint32 maxCount);
+void ReleaseSpriteBatch(SpriteBatch* batch);
+
 // Vertex Formats
 typedef struct PositionVertex
 {
@@ -126,4 +713,46 @@ extern Example TextureTypeTest_Example;
 extern Example CompressedTextures_Example;
 extern Example Bloom_Example;
 
+// Sprite upload modes of PullSpriteBatch, switched by the -spritebench benchmark
+typedef enum PullSpriteSource
+{
+	PULLSPRITESOURCE_CPU,				// BuildSprites every frame
+	PULLSPRITESOURCE_CPU_COMPACT,		// BuildCompactSprites every frame
+	PULLSPRITESOURCE_GPU_SIMULATION,	// SpriteSimulation, uploading spawns only
+	PULLSPRITESOURCE_COUNT
+} PullSpriteSource;
+
+void SetPullSpriteBatchMode(Uint32 spriteCount, bool useFrameRing, PullSpriteSource source);
+FrameRingStats GetPullSpriteBatchRingStats();
+SpriteSimulationStats GetPullSpriteBatchSimulationStats();
+// The source in use, which falls back to PULLSPRITESOURCE_CPU when its shaders are missing
+PullSpriteSource GetPullSpriteBatchSource();
+
+// Benchmarks: the -bench, -loaderbench, -spritebench, -radixbench and -decodercheck modes
+typedef struct BenchmarkOptions
+{
+	const char* Name; // An example, or "all"
+	int WarmupFrames;
+	int MeasuredFrames;
+	Uint64 Seed; // Given to SDL_srand before each example's Init
+	const char* JSONPath;
+	const char* BaselinePath;
+	double TimingTolerance; // Percent a timing may grow over its baseline
+	double CountTolerance; // Percent a count may grow over its baseline
+} BenchmarkOptions;
+
+// Returns how many examples failed or regressed against the baseline
+int RunBenchmarks(const BenchmarkOptions* options, Example** examples, int exampleCount);
+void BenchmarkAssetLoader();
+void BenchmarkHDRDecode();
+void BenchmarkSpriteBuilder();
+void BenchmarkSpriteUploads();
+void BenchmarkRadixSort();
+// Returns how many images failed, or -1 if the device couldn't be created
+int CheckTextureDecoders();
+
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+#include "Instrumentation.h"
+#endif
+
 #endif
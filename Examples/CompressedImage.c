@@ -0,0 +1,347 @@
+#include "Common.h"
+
+// Compressed Images
+// DDS and ASTC headers are parsed up front into a list of subresources and where each sits
+// in the payload, so the whole payload can then be read in one go into whatever memory the
+// caller has ready. Archived files are read straight out of the archive's mapping.
+
+typedef struct ASTCHeader
+{
+	Uint8 magic[4];
+	Uint8 blockX;
+	Uint8 blockY;
+	Uint8 blockZ;
+	Uint8 dimX[3];
+	Uint8 dimY[3];
+	Uint8 dimZ[3];
+} ASTCHeader;
+
+typedef struct DDS_PIXELFORMAT {
+	int dwSize;
+	int dwFlags;
+	int dwFourCC;
+	int dwRGBBitCount;
+	int dwRBitMask;
+	int dwGBitMask;
+	int dwBBitMask;
+	int dwABitMask;
+} DDS_PIXELFORMAT;
+
+typedef struct DDS_HEADER {
+	int dwMagic;
+	int dwSize;
+	int dwFlags;
+	int dwHeight;
+	int dwWidth;
+	int dwPitchOrLinearSize;
+	int dwDepth;
+	int dwMipMapCount;
+	int dwReserved1[11];
+	DDS_PIXELFORMAT ddspf;
+	int dwCaps;
+	int dwCaps2;
+	int dwCaps3;
+	int dwCaps4;
+	int dwReserved2;
+} DDS_HEADER;
+
+typedef struct DDS_HEADER_DXT10 {
+  int dxgiFormat;
+  int resourceDimension;
+  unsigned int miscFlag;
+  unsigned int arraySize;
+  unsigned int miscFlags2;
+} DDS_HEADER_DXT10;
+
+static bool IsASTCBlockSize(Uint8 blockX, Uint8 blockY)
+{
+	static const Uint8 blockSizes[][2] = {
+		{ 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+		{ 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+	};
+	for (int i = 0; i < SDL_arraysize(blockSizes); i += 1)
+	{
+		if (blockSizes[i][0] == blockX && blockSizes[i][1] == blockY)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static SDL_IOStream* OpenImageStream(const char* imageFilename, Sint64* pFileSize)
+{
+	char fullPath[256];
+	SDL_snprintf(fullPath, sizeof(fullPath), "Images/%s", imageFilename);
+
+	// Archived files are read straight out of the mapping
+	ArchivedAssetInfo info;
+	const void* data = GetArchivedAsset(fullPath, &info);
+	if (data != NULL && info.Type == ARCHIVEDASSET_FILE)
+	{
+		*pFileSize = (Sint64)info.Size;
+		return SDL_IOFromConstMem(data, info.Size);
+	}
+
+	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", SDL_GetBasePath(), imageFilename);
+
+	SDL_IOStream* stream = SDL_IOFromFile(fullPath, "rb");
+	if (stream == NULL)
+	{
+		SDL_Log("Failed to open image: %s", SDL_GetError());
+		return NULL;
+	}
+
+	*pFileSize = SDL_GetIOSize(stream);
+	return stream;
+}
+
+bool OpenASTCImage(const char* imageFilename, CompressedImage* image)
+{
+	SDL_zerop(image);
+
+	Sint64 fileSize;
+	image->Stream = OpenImageStream(imageFilename, &fileSize);
+	if (image->Stream == NULL)
+	{
+		SDL_assert(!"Could not load ASTC image!");
+		return false;
+	}
+
+	ASTCHeader header;
+	if (SDL_ReadIO(image->Stream, &header, sizeof(header)) != sizeof(header))
+	{
+		SDL_assert(!"Truncated ASTC header!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	if (header.magic[0] != 0x13 || header.magic[1] != 0xAB || header.magic[2] != 0xA1 || header.magic[3] != 0x5C)
+	{
+		SDL_assert(!"Bad magic number!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	// Only the 2D footprints the GPU formats cover, which also keeps the divisions below safe
+	if (!IsASTCBlockSize(header.blockX, header.blockY) || header.blockZ != 1)
+	{
+		SDL_assert(!"Unsupported ASTC block size!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	// Get the image dimensions in texels
+	image->Width = header.dimX[0] + (header.dimX[1] << 8) + (header.dimX[2] << 16);
+	image->Height = header.dimY[0] + (header.dimY[1] << 8) + (header.dimY[2] << 16);
+	int depth = header.dimZ[0] + (header.dimZ[1] << 8) + (header.dimZ[2] << 16);
+	if (image->Width == 0 || image->Height == 0 || depth != 1)
+	{
+		SDL_assert(!"Unsupported ASTC image dimensions!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	// Get the size of the texture data
+	unsigned int block_count_x = (image->Width + header.blockX - 1) / header.blockX;
+	unsigned int block_count_y = (image->Height + header.blockY - 1) / header.blockY;
+	image->MipLevelCount = 1;
+	image->LayerCount = 1;
+	image->DataOffset = sizeof(ASTCHeader);
+	image->DataLength = block_count_x * block_count_y * 16;
+
+	image->SubresourceCount = 1;
+	image->Subresources = SDL_calloc(1, sizeof(CompressedImageSubresource));
+	if (image->Subresources == NULL)
+	{
+		CloseCompressedImage(image);
+		return false;
+	}
+	image->Subresources[0].Width = image->Width;
+	image->Subresources[0].Height = image->Height;
+	image->Subresources[0].Length = image->DataLength;
+
+	if (image->DataOffset + image->DataLength > fileSize)
+	{
+		SDL_assert(!"Truncated ASTC payload!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	return true;
+}
+
+bool OpenDDSImage(const char* imageFilename, SDL_GPUTextureFormat format, CompressedImage* image)
+{
+	SDL_zerop(image);
+
+	Sint64 fileSize;
+	image->Stream = OpenImageStream(imageFilename, &fileSize);
+	if (image->Stream == NULL)
+	{
+		SDL_assert(!"Could not load DDS image!");
+		return false;
+	}
+
+	DDS_HEADER header;
+	if (SDL_ReadIO(image->Stream, &header, sizeof(header)) != sizeof(header))
+	{
+		SDL_assert(!"Truncated DDS header!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	if (header.dwMagic != 0x20534444)
+	{
+		SDL_assert(!"Bad magic number!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	bool hasDX10Header = header.ddspf.dwFlags == 0x4 && header.ddspf.dwFourCC == 0x30315844;
+	DDS_HEADER_DXT10 headerDX10 = { 0 };
+	if (hasDX10Header && SDL_ReadIO(image->Stream, &headerDX10, sizeof(headerDX10)) != sizeof(headerDX10))
+	{
+		SDL_assert(!"Truncated DDS DX10 header!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	if (header.dwWidth <= 0 || header.dwHeight <= 0)
+	{
+		SDL_assert(!"Unsupported DDS image dimensions!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	image->Width = header.dwWidth;
+	image->Height = header.dwHeight;
+	image->DataOffset = sizeof(DDS_HEADER) + (hasDX10Header ? sizeof(DDS_HEADER_DXT10) : 0);
+
+	// Mip count is only meaningful when DDSD_MIPMAPCOUNT is set
+	image->MipLevelCount = (header.dwFlags & 0x20000) ? header.dwMipMapCount : 1;
+	if (image->MipLevelCount < 1)
+	{
+		image->MipLevelCount = 1;
+	}
+
+	if ((header.dwCaps2 & 0x200000) || headerDX10.resourceDimension == 4)
+	{
+		SDL_assert(!"Volume DDS textures are not supported!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	// DX10 headers store the cube flag in miscFlag, legacy headers in DDSCAPS2_CUBEMAP
+	image->IsCubemap = hasDX10Header ? (headerDX10.miscFlag & 0x4) != 0 : (header.dwCaps2 & 0x200) != 0;
+	image->LayerCount = (hasDX10Header && headerDX10.arraySize > 0) ? headerDX10.arraySize : 1;
+	if (image->IsCubemap)
+	{
+		image->LayerCount *= 6;
+	}
+
+	// DDS stores every mip of a layer contiguously, one layer (or cube face) after another
+	image->SubresourceCount = image->LayerCount * image->MipLevelCount;
+	image->Subresources = SDL_calloc(image->SubresourceCount, sizeof(CompressedImageSubresource));
+	if (image->Subresources == NULL)
+	{
+		CloseCompressedImage(image);
+		return false;
+	}
+	image->DataLength = 0;
+	for (int layer = 0; layer < image->LayerCount; layer += 1)
+	{
+		for (int level = 0; level < image->MipLevelCount; level += 1)
+		{
+			CompressedImageSubresource* subresource = &image->Subresources[layer * image->MipLevelCount + level];
+			subresource->MipLevel = level;
+			subresource->Layer = layer;
+			subresource->Width = SDL_max(image->Width >> level, 1);
+			subresource->Height = SDL_max(image->Height >> level, 1);
+			subresource->Offset = image->DataLength;
+			subresource->Length = SDL_CalculateGPUTextureFormatSize(format, subresource->Width, subresource->Height, 1);
+			image->DataLength += subresource->Length;
+		}
+	}
+
+	if (image->DataOffset + image->DataLength > fileSize)
+	{
+		SDL_assert(!"Truncated DDS payload!");
+		CloseCompressedImage(image);
+		return false;
+	}
+
+	return true;
+}
+
+bool ReadCompressedImageData(CompressedImage* image, void* dst)
+{
+	// Stream the payload straight into the destination (usually a mapped transfer buffer),
+	// so the block data is only touched once on its way to the GPU.
+	if (SDL_SeekIO(image->Stream, image->DataOffset, SDL_IO_SEEK_SET) < 0)
+	{
+		SDL_Log("Failed to seek image data: %s", SDL_GetError());
+		return false;
+	}
+
+	if (SDL_ReadIO(image->Stream, dst, image->DataLength) != (size_t)image->DataLength)
+	{
+		SDL_Log("Failed to read image data: %s", SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
+
+void UploadCompressedImage(
+	SDL_GPUCopyPass* copyPass,
+	SDL_GPUTransferBuffer* transferBuffer,
+	Uint32 transferOffset,
+	SDL_GPUTexture* texture,
+	const CompressedImage* image
+) {
+	// The transfer buffer holds the payload exactly as it was read, so each
+	// subresource can be placed straight from its offset in the file.
+	for (int i = 0; i < image->SubresourceCount; i += 1)
+	{
+		const CompressedImageSubresource* subresource = &image->Subresources[i];
+		SDL_UploadToGPUTexture(
+			copyPass,
+			&(SDL_GPUTextureTransferInfo) {
+				.transfer_buffer = transferBuffer,
+				.offset = transferOffset + subresource->Offset,
+			},
+			&(SDL_GPUTextureRegion){
+				.texture = texture,
+				.mip_level = subresource->MipLevel,
+				.layer = subresource->Layer,
+				.w = subresource->Width,
+				.h = subresource->Height,
+				.d = 1
+			},
+			false
+		);
+	}
+}
+
+void CloseCompressedImage(CompressedImage* image)
+{
+	if (image->Stream != NULL)
+	{
+		SDL_CloseIO(image->Stream);
+		image->Stream = NULL;
+	}
+	SDL_free(image->Subresources);
+	image->Subresources = NULL;
+	image->SubresourceCount = 0;
+}
+
+// Cube faces count as layers, six to a cube
+SDL_GPUTextureType GetCompressedImageTextureType(const CompressedImage* image)
+{
+	if (image->IsCubemap)
+	{
+		return image->LayerCount > 6 ? SDL_GPU_TEXTURETYPE_CUBE_ARRAY : SDL_GPU_TEXTURETYPE_CUBE;
+	}
+	return image->LayerCount > 1 ? SDL_GPU_TEXTURETYPE_2D_ARRAY : SDL_GPU_TEXTURETYPE_2D;
+}
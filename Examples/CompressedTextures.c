@@ -71,8 +71,41 @@ static const char* TextureNames[BC_IMAGE_COUNT + ASTC_IMAGE_COUNT] =
 	"astc/12x12.astc",
 };
 
+// Formats the device can't sample are expanded on the CPU when a decoder exists
+static bool IsSoftwareDecoded[BC_IMAGE_COUNT + ASTC_IMAGE_COUNT];
+
 static int CurrentTextureIndex;
 
+static void CancelImageLoads(AsyncAsset* imageLoads, UploadBatch* uploads, Uint8* firstTextureData)
+{
+	// Pending jobs write into imageLoads and the batch's staging memory, so they have to finish first
+	for (int i = 0; i < SDL_arraysize(SrcTextures); i += 1)
+	{
+		if (imageLoads[i].Data != NULL)
+		{
+			WaitForAsset(&imageLoads[i]);
+		}
+		CloseCompressedImage(&imageLoads[i].Image);
+	}
+	CancelUploadBatch(uploads);
+	SDL_free(firstTextureData);
+}
+
+// Called once the download of the first texture has landed, a few frames after Init
+static void CompareDownloadedTexture(void* userdata, const void* data, Uint32 size)
+{
+	Uint8* originalData = userdata;
+	if (SDL_memcmp(data, originalData, size) == 0)
+	{
+		SDL_Log("Success: Downloaded bytes match original texture bytes!");
+	}
+	else
+	{
+		SDL_Log("Failure: Downloaded bytes match original texture bytes!");
+	}
+	SDL_free(originalData);
+}
+
 static int Init(Context* context)
 {
 	int result = CommonInit(context, 0);
@@ -81,163 +114,205 @@ static int Init(Context* context)
 		return result;
 	}
 
-	SDL_GPUTransferBuffer* downloadTransferBuffer = NULL;
+	// The first texture is read into CPU memory and copied into staging from there, so the
+	// download can be checked against it: mapped upload memory may be write-combined, and
+	// reading it back is slow at best
 	Uint8* firstTextureData = NULL;
-	size_t firstTextureDataLength = 0;
+	Uint8* firstTextureUpload = NULL;
+	Uint32 firstTextureLength = 0;
 
-	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
-	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+	AsyncAsset imageLoads[SDL_arraysize(SrcTextures)];
+	SDL_zeroa(imageLoads);
+
+	UploadBatch uploads;
+	BeginUploadBatch(&uploads, context->Device);
 
-	// Upload texture data
+	Uint64 loadStart = SDL_GetPerformanceCounter();
+
+	// Parse every header up front, then read all of the payloads in parallel
+	// straight into staging memory
 	for (int i = 0; i < SDL_arraysize(SrcTextures); i += 1)
 	{
-		if (!SDL_GPUTextureSupportsFormat(context->Device, TextureFormats[i], SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_SAMPLER))
-		{
-			SrcTextures[i] = NULL;
-			DstTextures[i] = NULL;
-			continue;
-		}
-
-		// Load the image
-		int imageWidth, imageHeight, imageDataLength;
-		void* imageData;
+		CompressedImage* image = &imageLoads[i].Image;
+		bool opened;
 		if (i < BC_IMAGE_COUNT)
 		{
-			imageData = LoadDDSImage(TextureNames[i], TextureFormats[i], &imageWidth, &imageHeight, &imageDataLength);
+			opened = OpenDDSImage(TextureNames[i], TextureFormats[i], image);
 		}
 		else
 		{
-			imageData = LoadASTCImage(TextureNames[i], &imageWidth, &imageHeight, &imageDataLength);
+			opened = OpenASTCImage(TextureNames[i], image);
 		}
-		if (imageData == NULL)
+		if (!opened)
 		{
 			SDL_Log("Failed to load image data! %s", TextureNames[i]);
+			CancelImageLoads(imageLoads, &uploads, firstTextureData);
 			return 1;
 		}
 
-		// Create the texture
+		SDL_GPUTextureType textureType = GetCompressedImageTextureType(image);
+		SDL_GPUTextureFormat textureFormat = TextureFormats[i];
+		IsSoftwareDecoded[i] = false;
+		if (!SDL_GPUTextureSupportsFormat(context->Device, textureFormat, textureType, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+		{
+			textureFormat = GetDecompressedTextureFormat(TextureFormats[i]);
+			if (textureFormat == SDL_GPU_TEXTUREFORMAT_INVALID ||
+				!SDL_GPUTextureSupportsFormat(context->Device, textureFormat, textureType, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+			{
+				CloseCompressedImage(image);
+				SrcTextures[i] = NULL;
+				DstTextures[i] = NULL;
+				continue;
+			}
+			IsSoftwareDecoded[i] = true;
+		}
+
+		// Create the texture with every layer and face the file holds
 		SDL_GPUTextureCreateInfo createInfo =
 		{
-			.format = TextureFormats[i],
-			.width = imageWidth,
-			.height = imageHeight,
-			.layer_count_or_depth = 1,
-			.type = SDL_GPU_TEXTURETYPE_2D,
+			.format = textureFormat,
+			.width = image->Width,
+			.height = image->Height,
+			.layer_count_or_depth = image->LayerCount,
+			.type = textureType,
 			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
-			.num_levels = 1,
+			.num_levels = image->MipLevelCount,
 		};
 		SrcTextures[i] = SDL_CreateGPUTexture(context->Device, &createInfo);
 		if (!SrcTextures[i])
 		{
 			SDL_Log("Failed to create texture: %s", SDL_GetError());
+			CancelImageLoads(imageLoads, &uploads, firstTextureData);
 			return -1;
 		}
 		DstTextures[i] = SDL_CreateGPUTexture(context->Device, &createInfo);
 		if (!DstTextures[i])
 		{
 			SDL_Log("Failed to create texture: %s", SDL_GetError());
+			CancelImageLoads(imageLoads, &uploads, firstTextureData);
 			return -1;
 		}
 
 		// Set up texture transfer data
-		SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-			context->Device,
-			&(SDL_GPUTransferBufferCreateInfo) {
-				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-				.size = imageDataLength
+		imageLoads[i].Type = IsSoftwareDecoded[i] ? ASSETTYPE_DECOMPRESSED_IMAGE_DATA : ASSETTYPE_COMPRESSED_IMAGE_DATA;
+		imageLoads[i].Format = TextureFormats[i];
+		Uint32 dataLength = IsSoftwareDecoded[i] ? GetDecompressedImageLength(image, TextureFormats[i]) : image->DataLength;
+		Uint8* uploadData = ReserveUploadData(&uploads, dataLength);
+		if (uploadData == NULL)
+		{
+			CancelImageLoads(imageLoads, &uploads, firstTextureData);
+			return -1;
+		}
+		if (i == 0)
+		{
+			firstTextureData = SDL_malloc(dataLength);
+			if (firstTextureData == NULL)
+			{
+				CancelImageLoads(imageLoads, &uploads, firstTextureData);
+				return -1;
 			}
-		);
-
-		Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
-			context->Device,
-			textureTransferBuffer,
-			false
-		);
-		SDL_memcpy(textureTransferPtr, imageData, imageDataLength);
-		SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+			firstTextureUpload = uploadData;
+			firstTextureLength = dataLength;
+		}
+		imageLoads[i].Data = (i == 0) ? firstTextureData : uploadData;
+		LoadAssetAsync(&imageLoads[i]);
+	}
 
-		// Upload the texture data
-		SDL_UploadToGPUTexture(
-			copyPass,
-			&(SDL_GPUTextureTransferInfo) {
-				.transfer_buffer = textureTransferBuffer,
-				.offset = 0, /* Zeros out the rest */
-			},
-			&(SDL_GPUTextureRegion){
-				.texture = SrcTextures[i],
-				.w = imageWidth,
-				.h = imageHeight,
-				.d = 1
-			},
-			false
-		);
+	// Queue each upload as soon as its payload has landed
+	for (int i = 0; i < SDL_arraysize(SrcTextures); i += 1)
+	{
+		if (SrcTextures[i] == NULL)
+		{
+			continue;
+		}
 
-		SDL_CopyGPUTextureToTexture(
-			copyPass,
-			&(SDL_GPUTextureLocation){
-				.texture = SrcTextures[i]
-			},
-			&(SDL_GPUTextureLocation){
-				.texture = DstTextures[i]
-			},
-			256,
-			256,
-			1,
-			false
-		);
+		CompressedImage* image = &imageLoads[i].Image;
 
-		SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+		WaitForAsset(&imageLoads[i]);
+		if (!imageLoads[i].Succeeded)
+		{
+			SDL_Log("Failed to read image data! %s", TextureNames[i]);
+			CancelImageLoads(imageLoads, &uploads, firstTextureData);
+			return 1;
+		}
 
-		// Testing if downloads work...
+		// Decoding rewrites the subresources, so only look at them once the job is done
+		Uint8* uploadData = imageLoads[i].Data;
 		if (i == 0)
 		{
-			downloadTransferBuffer = SDL_CreateGPUTransferBuffer(
-				context->Device,
-				&(SDL_GPUTransferBufferCreateInfo){
-					.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
-					.size = imageDataLength
-				}
-			);
+			SDL_memcpy(firstTextureUpload, firstTextureData, firstTextureLength);
+			uploadData = firstTextureUpload;
+		}
+
+		// Upload the whole mip chain, every layer and face
+		QueueCompressedImageUpload(&uploads, uploadData, SrcTextures[i], image);
+	}
+
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	RecordUploadBatch(&uploads, copyPass);
+
+	for (int i = 0; i < SDL_arraysize(SrcTextures); i += 1)
+	{
+		if (SrcTextures[i] == NULL)
+		{
+			continue;
+		}
 
-			SDL_DownloadFromGPUTexture(
+		CompressedImage* image = &imageLoads[i].Image;
+		for (int j = 0; j < image->SubresourceCount; j += 1)
+		{
+			SDL_CopyGPUTextureToTexture(
 				copyPass,
-				&(SDL_GPUTextureRegion){
+				&(SDL_GPUTextureLocation){
 					.texture = SrcTextures[i],
-					.w = 256,
-					.h = 256,
-					.d = 1,
+					.mip_level = image->Subresources[j].MipLevel,
+					.layer = image->Subresources[j].Layer
 				},
-				&(SDL_GPUTextureTransferInfo){
-					.transfer_buffer = downloadTransferBuffer
-				}
+				&(SDL_GPUTextureLocation){
+					.texture = DstTextures[i],
+					.mip_level = image->Subresources[j].MipLevel,
+					.layer = image->Subresources[j].Layer
+				},
+				image->Subresources[j].Width,
+				image->Subresources[j].Height,
+				1,
+				false
 			);
-
-			firstTextureData = SDL_malloc(imageDataLength);
-			firstTextureDataLength = imageDataLength;
-			SDL_memcpy(firstTextureData, imageData, imageDataLength);
 		}
-
-		SDL_free(imageData);
+		CloseCompressedImage(image);
 	}
 
-	SDL_EndGPUCopyPass(copyPass);
-	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(uploadCmdBuf);
-
-	// Read the downloaded data
-	SDL_WaitForGPUFences(context->Device, true, &fence, 1);
-	SDL_ReleaseGPUFence(context->Device, fence);
-	Uint8* downloadPtr = SDL_MapGPUTransferBuffer(context->Device, downloadTransferBuffer, false);
-	if (SDL_memcmp(downloadPtr, firstTextureData, firstTextureDataLength) == 0)
-	{
-		SDL_Log("Success: Downloaded bytes match original texture bytes!");
-	}
-	else
+	// Testing if downloads work...
+	if (firstTextureData != NULL)
 	{
-		SDL_Log("Failure: Downloaded bytes match original texture bytes!");
+		ReadbackTicket ticket = ReadbackTexture(
+			context->Device,
+			copyPass,
+			TextureFormats[0],
+			&(SDL_GPUTextureRegion){
+				.texture = SrcTextures[0],
+				.w = 256,
+				.h = 256,
+				.d = 1,
+			},
+			CompareDownloadedTexture,
+			firstTextureData
+		);
+		if (ticket == 0)
+		{
+			SDL_free(firstTextureData);
+		}
 	}
-	SDL_UnmapGPUTransferBuffer(context->Device, downloadTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, downloadTransferBuffer);
-	SDL_free(firstTextureData);
+
+	SDL_Log(
+		"Loaded and recorded texture uploads in %.2f ms",
+		(SDL_GetPerformanceCounter() - loadStart) * 1000.0 / SDL_GetPerformanceFrequency()
+	);
+
+	SDL_EndGPUCopyPass(copyPass);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	// Finally, print instructions!
 	SDL_Log("Press Left/Right to switch between textures");
@@ -273,7 +348,11 @@ static int Update(Context* context)
 		}
 		else
 		{
-			SDL_Log("Setting texture to: %s", TextureNames[CurrentTextureIndex]);
+			SDL_Log(
+				"Setting texture to: %s%s",
+				TextureNames[CurrentTextureIndex],
+				IsSoftwareDecoded[CurrentTextureIndex] ? " (decoded on the CPU)" : ""
+			);
 		}
 	}
 
@@ -290,8 +369,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -341,7 +420,7 @@ static int Draw(Context* context)
 		}
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
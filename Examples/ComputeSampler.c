@@ -131,21 +131,10 @@ static int Init(Context* context)
 	});
 
 	// Set up texture data
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
-		}
-	);
-
-	Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferPtr = MapStagingMemory(context->Device, imageData->w * imageData->h * 4, 0, &textureStaging);
 	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	// Upload the transfer data to the GPU resources
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -154,8 +143,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0, /* Zeros out the rest */
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset, /* Zeros out the rest */
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
@@ -167,9 +156,8 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
 	SDL_DestroySurface(imageData);
 
 	// Finally, print instructions!
@@ -211,8 +199,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -260,14 +248,14 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUComputePipeline(context->Device, Pipeline);
+	ReleaseComputePipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
 	SDL_ReleaseGPUTexture(context->Device, WriteTexture);
 
@@ -4,13 +4,24 @@
 #include "Common.h"
 
 static SDL_GPUComputePipeline* ComputePipeline;
+static SDL_GPUComputePipeline* CompactComputePipeline;
+static SDL_GPUComputePipeline* CullComputePipeline;
+static SDL_GPUComputePipeline* CompactCullComputePipeline;
 static SDL_GPUGraphicsPipeline* RenderPipeline;
 static SDL_GPUSampler* Sampler;
 static SDL_GPUTexture* Texture;
-static SDL_GPUTransferBuffer* SpriteComputeTransferBuffer;
-static SDL_GPUBuffer* SpriteComputeBuffer;
-static SDL_GPUBuffer* SpriteVertexBuffer;
-static SDL_GPUBuffer* SpriteIndexBuffer;
+static FrameRing SpriteComputeRing;
+static SpriteBatch Batch;
+static SDL_GPUBuffer* AtlasRegionBuffer;
+static SpriteSimulation Simulation;
+static bool UseSimulation;
+static bool UseCulling;
+static Uint32 FrameCount;
+static SDL_GPUComputePipeline* SortKeysPipeline;
+static SDL_GPUComputePipeline* GatherPipeline;
+static RadixSorter Sorter;
+static SDL_GPUBuffer* SortedSpriteBuffer;
+static bool UseSorting;
 
 typedef struct PositionTextureColorVertex
 {
@@ -19,49 +30,139 @@ typedef struct PositionTextureColorVertex
 	float r, g, b, a;
 } PositionTextureColorVertex;
 
-typedef struct ComputeSpriteInstance
+// Right cycles through these, and the buffers grow to fit. The compiled SpriteBatch.comp predates
+// its bounds check against the uniform count, so until it's rebuilt every buffer a dispatch
+// touches holds whole 64-thread groups: capacities and built sprite counts are padded to them.
+static const Uint32 SpriteCounts[] = { 1000, 8192, 100000 };
+static int SpriteCountIndex = 1;
+
+static Uint32 PadToSpriteGroups(Uint32 count)
 {
-	float x, y, z;
-	float rotation;
-	float w, h, padding_a, padding_b;
-	float tex_u, tex_v, tex_w, tex_h;
-	float r, g, b, a;
-} ComputeSpriteInstance;
+	return (count + 63) / 64 * 64;
+}
+
+static Uint32 GetSpriteCount()
+{
+	return PadToSpriteGroups(SpriteCounts[SpriteCountIndex]);
+}
 
-static const Uint32 SPRITE_COUNT = 8192;
+// The sprites are spread over a world nine times the size of the view, which shows its middle
+static const float WORLD_WIDTH = 1920;
+static const float WORLD_HEIGHT = 1440;
 
-static int Init(Context* context)
+typedef struct SpriteCullUniforms
 {
-	int result = CommonInit(context, 0);
-	if (result < 0)
+	Matrix4x4 ViewProjection;
+	Uint32 SpriteCount;
+	Uint32 CullSprites; // Only read by SpriteSortKeys.comp
+	Uint32 Padding[2];
+} SpriteCullUniforms;
+
+typedef struct SpriteCountUniforms
+{
+	Uint32 SpriteCount;
+	Uint32 Padding[3];
+} SpriteCountUniforms;
+
+// The sort keys are 21 bits of depth, 2 of atlas cell and a culled bit
+static const int SPRITE_SORT_KEY_BITS = 24;
+
+// The four ravioli in the atlas as { u, v, width, height }, indexed by CompactSpriteInstance.region
+static const float AtlasRegions[4][4] = {
+	{ 0.0f, 0.0f, 0.5f, 0.5f },
+	{ 0.5f, 0.0f, 0.5f, 0.5f },
+	{ 0.0f, 0.5f, 0.5f, 0.5f },
+	{ 0.5f, 0.5f, 0.5f, 0.5f }
+};
+
+// Uploaded sprites use the compact format unless they may need sorting
+static Uint32 GetUploadedSpriteSize()
+{
+	return CompactComputePipeline != NULL && SortedSpriteBuffer == NULL ? sizeof(CompactSpriteInstance) : sizeof(SpriteInstance);
+}
+
+static SDL_GPUBuffer* CreateSortedSpriteBuffer(SDL_GPUDevice* device, Uint32 capacity)
+{
+	return SDL_CreateGPUBuffer(
+		device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = capacity * sizeof(SpriteInstance)
+		}
+	);
+}
+
+// Everything sized by the sprite count follows the batch's capacity, growing with it
+static bool ReserveSprites(SDL_GPUDevice* device, Uint32 count)
+{
+	Uint32 oldCapacity = Batch.Capacity;
+	if (!ReserveSpriteBatch(&Batch, PadToSpriteGroups(count)))
 	{
-		return result;
+		return false;
+	}
+	if (Batch.Capacity == oldCapacity)
+	{
+		return true;
 	}
 
-	SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
-	if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_IMMEDIATE
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+	if (!ResizeFrameRing(&SpriteComputeRing, Batch.Capacity * GetUploadedSpriteSize()))
+	{
+		return false;
 	}
-	else if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_MAILBOX
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+
+	if (SortedSpriteBuffer != NULL)
+	{
+		SDL_ReleaseGPUBuffer(device, SortedSpriteBuffer);
+		SortedSpriteBuffer = CreateSortedSpriteBuffer(device, Batch.Capacity);
+		if (SortedSpriteBuffer == NULL || !ReserveRadixSorter(&Sorter, Batch.Capacity))
+		{
+			SDL_Log("Could not grow the sprite sorting buffers!");
+			return false;
+		}
 	}
 
-	SDL_SetGPUSwapchainParameters(
-		context->Device,
-		context->Window,
-		SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
-		presentMode
+	SDL_Log(
+		"Sprite capacity grew to %u (%.1f MiB of vertex and draw buffers)",
+		Batch.Capacity,
+		Batch.Stats.MemoryBytes / (1024.0 * 1024.0)
 	);
+	return true;
+}
 
-	SDL_srand(0);
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Offscreen rendering has no swapchain to configure
+	if (!context->Headless)
+	{
+		SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
+		if (SDL_WindowSupportsGPUPresentMode(
+			context->Device,
+			context->Window,
+			SDL_GPU_PRESENTMODE_IMMEDIATE
+		)) {
+			presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+		}
+		else if (SDL_WindowSupportsGPUPresentMode(
+			context->Device,
+			context->Window,
+			SDL_GPU_PRESENTMODE_MAILBOX
+		)) {
+			presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+		}
+
+		SDL_SetGPUSwapchainParameters(
+			context->Device,
+			context->Window,
+			SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
+			presentMode
+		);
+	}
 
 	// Create the shaders
 	SDL_GPUShader* vertShader = LoadShader(
@@ -83,13 +184,13 @@ static int Init(Context* context)
 	);
 
 	// Create the sprite render pipeline
-	RenderPipeline = SDL_CreateGPUGraphicsPipeline(
+	RenderPipeline = AcquireGraphicsPipeline(
 		context->Device,
 		&(SDL_GPUGraphicsPipelineCreateInfo){
 			.target_info = (SDL_GPUGraphicsPipelineTargetInfo){
 				.num_color_targets = 1,
 				.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-					.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+					.format = GetFrameTextureFormat(context->Device, context->Window),
 					.blend_state = {
 						.enable_blend = true,
 						.color_blend_op = SDL_GPU_BLENDOP_ADD,
@@ -133,22 +234,112 @@ static int Init(Context* context)
 		}
 	);
 
-	SDL_ReleaseGPUShader(context->Device, vertShader);
-	SDL_ReleaseGPUShader(context->Device, fragShader);
+	ReleaseShader(context->Device, vertShader);
+	ReleaseShader(context->Device, fragShader);
 
-	// Create the sprite batch compute pipeline
+	// Create the sprite batch compute pipelines. Uploaded sprites prefer the compact 16-byte
+	// instance format, while simulated sprites are always read in the 64-byte format.
 	ComputePipeline = CreateComputePipelineFromShader(
 		context->Device,
 		"SpriteBatch.comp",
 		&(SDL_GPUComputePipelineCreateInfo){
 			.num_readonly_storage_buffers = 1,
 			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	CompactComputePipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SpriteBatchCompact.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 2,
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+	if (CompactComputePipeline == NULL)
+	{
+		SDL_Log("Compact sprite shaders are unavailable, run compile.sh to build them. Using 64-byte instances.");
+	}
+
+	// The culling variants also compact the visible sprites and count them into an indirect draw
+	CullComputePipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SpriteBatchCull.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 1,
+			.num_readwrite_storage_buffers = 2,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	CompactCullComputePipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SpriteBatchCompactCull.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 2,
+			.num_readwrite_storage_buffers = 2,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	UseCulling = CullComputePipeline != NULL;
+	if (!UseCulling)
+	{
+		SDL_Log("Sprite culling shaders are unavailable, run compile.sh to build them. Drawing every sprite.");
+	}
+
+	// Sorting keys the sprites by depth and atlas cell, radix sorts the keys and gathers the
+	// sprites into that order before expanding them, so they are always read in the 64-byte format
+	SortKeysPipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SpriteSortKeys.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 1,
+			.num_readwrite_storage_buffers = 3,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	GatherPipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SpriteGather.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 2,
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
 			.threadcount_x = 64,
 			.threadcount_y = 1,
 			.threadcount_z = 1
 		}
 	);
 
+	Uint32 spriteCount = GetSpriteCount();
+	if (SortKeysPipeline != NULL && GatherPipeline != NULL && CreateRadixSorter(&Sorter, context->Device, spriteCount))
+	{
+		SortedSpriteBuffer = CreateSortedSpriteBuffer(context->Device, spriteCount);
+	}
+	else
+	{
+		SDL_Log("Sprite sorting shaders are unavailable, run compile.sh to build them. Sorting is disabled.");
+	}
+
 	// Load the image data
 	SDL_Surface *imageData = LoadImage("ravioli_atlas.bmp", 4);
 	if (imageData == NULL)
@@ -157,28 +348,37 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
+	// Block-compress the atlas when -compresstextures is passed and the device supports it
+	SDL_GPUTextureFormat textureFormat = SelectImageTextureFormat(context->Device, imageData);
+	const void* texturePixels = imageData->pixels;
+	Uint32 textureLength = imageData->w * imageData->h * 4;
+	void* encodedPixels = NULL;
+	if (textureFormat != SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM)
+	{
+		encodedPixels = EncodeImage(imageData, textureFormat, &textureLength);
+		if (encodedPixels != NULL)
+		{
+			texturePixels = encodedPixels;
 		}
-	);
+		else
+		{
+			textureFormat = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+			textureLength = imageData->w * imageData->h * 4;
+		}
+	}
 
-	Uint8 *textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
-	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	StagingAllocation textureStaging;
+	Uint8 *textureTransferPtr = MapStagingMemory(context->Device, textureLength, 0, &textureStaging);
+	SDL_memcpy(textureTransferPtr, texturePixels, textureLength);
+	UnmapStagingMemory(context->Device, &textureStaging);
+	SDL_free(encodedPixels);
 
 	// Create the GPU resources
 	Texture = SDL_CreateGPUTexture(
 		context->Device,
 		&(SDL_GPUTextureCreateInfo){
 			.type = SDL_GPU_TEXTURETYPE_2D,
-			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.format = textureFormat,
 			.width = imageData->w,
 			.height = imageData->h,
 			.layer_count_or_depth = 1,
@@ -199,67 +399,38 @@ static int Init(Context* context)
 		}
 	);
 
-	SpriteComputeTransferBuffer = SDL_CreateGPUTransferBuffer(
+	// Instance data gets its own region per frame in flight instead of cycling
+	if (!CreateFrameRing(
+		&SpriteComputeRing,
 		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = SPRITE_COUNT * sizeof(ComputeSpriteInstance)
-		}
-	);
-
-	SpriteComputeBuffer = SDL_CreateGPUBuffer(
-		context->Device,
-		&(SDL_GPUBufferCreateInfo) {
-			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ,
-			.size = SPRITE_COUNT * sizeof(ComputeSpriteInstance)
-		}
-	);
+		spriteCount * GetUploadedSpriteSize(),
+		SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ,
+		2
+	)) {
+		SDL_Log("Could not create the sprite instance ring!");
+		return -1;
+	}
 
-	SpriteVertexBuffer = SDL_CreateGPUBuffer(
-		context->Device,
-		&(SDL_GPUBufferCreateInfo) {
-			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_BUFFERUSAGE_VERTEX,
-			.size = SPRITE_COUNT * 4 * sizeof(PositionTextureColorVertex)
-		}
-	);
+	// The vertex buffer starts at the first scene's count, with a 16-bit index chunk shared by all
+	if (!CreateSpriteBatch(&Batch, context->Device, sizeof(PositionTextureColorVertex), spriteCount))
+	{
+		SDL_Log("Could not create the sprite batch!");
+		return -1;
+	}
 
-	SpriteIndexBuffer = SDL_CreateGPUBuffer(
+	AtlasRegionBuffer = SDL_CreateGPUBuffer(
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
-			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
-			.size = SPRITE_COUNT * 6 * sizeof(Uint32)
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ,
+			.size = sizeof(AtlasRegions)
 		}
 	);
 
 	// Transfer the up-front data
-	SDL_GPUTransferBuffer* indexBufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = SPRITE_COUNT * 6 * sizeof(Uint32)
-		}
-	);
-
-	Uint32* indexTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		indexBufferTransferBuffer,
-		false
-	);
-
-	for (Uint32 i = 0, j = 0; i < SPRITE_COUNT * 6; i += 6, j += 4)
-	{
-		indexTransferPtr[i]     =  j;
-		indexTransferPtr[i + 1] =  j + 1;
-		indexTransferPtr[i + 2] =  j + 2;
-		indexTransferPtr[i + 3] =  j + 3;
-		indexTransferPtr[i + 4] =  j + 2;
-		indexTransferPtr[i + 5] =  j + 1;
-	}
-
-	SDL_UnmapGPUTransferBuffer(
-		context->Device,
-		indexBufferTransferBuffer
-	);
+	StagingAllocation regionStaging;
+	void* regionTransferPtr = MapStagingMemory(context->Device, sizeof(AtlasRegions), 0, &regionStaging);
+	SDL_memcpy(regionTransferPtr, AtlasRegions, sizeof(AtlasRegions));
+	UnmapStagingMemory(context->Device, &regionStaging);
 
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
@@ -267,8 +438,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset, /* Zeroes out the rest */
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
@@ -282,42 +453,138 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = indexBufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = regionStaging.TransferBuffer,
+			.offset = regionStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
-			.buffer = SpriteIndexBuffer,
+			.buffer = AtlasRegionBuffer,
 			.offset = 0,
-			.size = SPRITE_COUNT * 6 * sizeof(Uint32)
+			.size = sizeof(AtlasRegions)
 		},
 		false
 	);
 
 	SDL_DestroySurface(imageData);
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, indexBufferTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
+
+	SDL_Log("Press Left to switch between CPU-built and GPU-simulated sprites");
+	SDL_Log("Press Right to cycle the sprite count");
+	if (SortedSpriteBuffer != NULL)
+	{
+		SDL_Log("Press Up to toggle sorting sprites back to front and by atlas cell");
+	}
+	if (CullComputePipeline != NULL)
+	{
+		SDL_Log("Press Down to toggle culling sprites outside the view");
+	}
 
 	return 0;
 }
 
+static Uint32 FrameSeed;
+
+static SpriteBuildInfo GetSpriteBuildInfo()
+{
+	return (SpriteBuildInfo){
+		.Seed = FrameSeed++,
+		.AreaWidth = WORLD_WIDTH,
+		.AreaHeight = WORLD_HEIGHT,
+		.SpriteSize = 32
+	};
+}
+
+// Gives every sprite a random layer, so that the sorted draw order is visible
+static void AssignSpriteLayers(SpriteInstance* sprites, Uint32 count, Uint64 seed)
+{
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		sprites[i].z = SDL_randf_r(&seed);
+	}
+}
+
+// Uploads the whole crowd once, after which only the per-frame churn is uploaded
+static bool StartSimulation(SDL_GPUDevice* device)
+{
+	Uint32 spriteCount = GetSpriteCount();
+	if (!CreateSpriteSimulation(&Simulation, device, spriteCount))
+	{
+		SDL_Log("Could not create the sprite simulation!");
+		return false;
+	}
+	SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+	SpawnRandomSprites(&Simulation, spriteCount, &buildInfo);
+	return true;
+}
+
+static void StopSimulation()
+{
+	SpriteSimulationStats stats = Simulation.Stats;
+	SDL_Log(
+		"Sprite simulation: %" SDL_PRIu64 " steps, %" SDL_PRIu64 " spawned, %" SDL_PRIu64 " despawned, %" SDL_PRIu64 " bytes uploaded",
+		stats.Steps,
+		stats.Spawned,
+		stats.Despawned,
+		stats.UploadedBytes
+	);
+	ReleaseSpriteSimulation(&Simulation);
+}
+
 static int Update(Context* context)
 {
+	if (context->LeftPressed)
+	{
+		UseSimulation = !UseSimulation;
+		if (UseSimulation)
+		{
+			UseSimulation = StartSimulation(context->Device);
+		}
+		else
+		{
+			StopSimulation();
+		}
+		SDL_Log("Sprite mode: %s", UseSimulation ? "GPU simulation" : "CPU build");
+	}
+
+	if (context->RightPressed)
+	{
+		SpriteCountIndex = (SpriteCountIndex + 1) % SDL_arraysize(SpriteCounts);
+		SDL_Log("Sprite count: %u", GetSpriteCount());
+		if (UseSimulation)
+		{
+			StopSimulation();
+			UseSimulation = StartSimulation(context->Device);
+		}
+	}
+
+	if (context->UpPressed && SortedSpriteBuffer != NULL)
+	{
+		UseSorting = !UseSorting;
+		SDL_Log("Sorting: %s", UseSorting ? "on" : "off");
+	}
+
+	if (context->DownPressed && CullComputePipeline != NULL)
+	{
+		UseCulling = !UseCulling;
+		SDL_Log("Culling: %s", UseCulling ? "on" : "off");
+	}
+
 	return 0;
 }
 
-static float uCoords[4] = { 0.0f, 0.5f, 0.0f, 0.5f };
-static float vCoords[4] = { 0.0f, 0.0f, 0.5f, 0.5f };
+static void LogVisibleSprites(void* userdata, const void* data, Uint32 size)
+{
+	SDL_Log("Visible sprites: %u of %u", *(const Uint32*) data, (Uint32)(uintptr_t) userdata);
+}
 
 static int Draw(Context* context)
 {
 	Matrix4x4 cameraMatrix = Matrix4x4_CreateOrthographicOffCenter(
-		0,
 		640,
+		1280,
+		960,
 		480,
 		0,
-		0,
 		-1
 	);
 
@@ -329,80 +596,178 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdBuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdBuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
+	// The simulation keeps running while there is nothing to draw to, replacing a few sprites
+	// every frame so that spawns and despawns are part of the cost
+	if (UseSimulation)
+	{
+		Uint32 churn = SDL_max(Simulation.Capacity / 256, 1);
+		for (Uint32 i = 0; i < churn; i += 1)
+		{
+			DespawnSprite(&Simulation, SDL_rand(Simulation.Count));
+		}
+		SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+		SpawnRandomSprites(&Simulation, churn, &buildInfo);
+		UpdateSpriteSimulation(&Simulation, cmdBuf, context->DeltaTime, WORLD_WIDTH, WORLD_HEIGHT);
+	}
+
 	if (swapchainTexture != NULL)
 	{
-		// Build sprite instance transfer
-		ComputeSpriteInstance* dataPtr = SDL_MapGPUTransferBuffer(
-			context->Device,
-			SpriteComputeTransferBuffer,
-			true
-		);
+		SDL_GPUBuffer* spriteComputeBuffer = NULL;
+		// The simulation's count varies, but its capacity is padded, so the last group stays in bounds
+		Uint32 spriteCount = UseSimulation ? Simulation.Count : GetSpriteCount();
+		bool useSorting = UseSorting;
+		bool useCompactSprites = !UseSimulation && !useSorting && CompactComputePipeline != NULL;
+		bool useCulling = UseCulling && (useSorting || (useCompactSprites ? CompactCullComputePipeline : CullComputePipeline) != NULL);
+
+		// When sorting, culling happens while keying the sprites, so that it cannot reorder them
+		bool cullWhileExpanding = useCulling && !useSorting;
+		SDL_GPUComputePipeline* computePipeline = useCompactSprites ?
+			(cullWhileExpanding ? CompactCullComputePipeline : CompactComputePipeline) :
+			(cullWhileExpanding ? CullComputePipeline : ComputePipeline);
+
+		if (!ReserveSprites(context->Device, spriteCount))
+		{
+			SubmitFrameRing(&SpriteComputeRing, cmdBuf);
+			return -1;
+		}
 
-		for (Uint32 i = 0; i < SPRITE_COUNT; i += 1)
+		void* dataPtr = NULL;
+		if (UseSimulation)
 		{
-			Sint32 ravioli = SDL_rand(4);
-			dataPtr[i].x = (float)(SDL_rand(640));
-			dataPtr[i].y = (float)(SDL_rand(480));
-			dataPtr[i].z = 0;
-			dataPtr[i].rotation = SDL_randf() * SDL_PI_F * 2;
-			dataPtr[i].w = 32;
-			dataPtr[i].h = 32;
-			dataPtr[i].tex_u = uCoords[ravioli];
-			dataPtr[i].tex_v = vCoords[ravioli];
-			dataPtr[i].tex_w = 0.5f;
-			dataPtr[i].tex_h = 0.5f;
-			dataPtr[i].r = 1.0f;
-			dataPtr[i].g = 1.0f;
-			dataPtr[i].b = 1.0f;
-			dataPtr[i].a = 1.0f;
+			// The simulated sprites are already on the GPU
+			spriteComputeBuffer = Simulation.InstanceBuffer;
+		}
+		else
+		{
+			// Build sprite instance transfer
+			dataPtr = MapFrameRing(&SpriteComputeRing);
+			if (dataPtr == NULL)
+			{
+				SubmitFrameRing(&SpriteComputeRing, cmdBuf);
+				return -1;
+			}
+
+			SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+			if (useCompactSprites)
+			{
+				BuildCompactSprites(dataPtr, spriteCount, &buildInfo);
+			}
+			else
+			{
+				BuildSprites(dataPtr, spriteCount, &buildInfo);
+				if (useSorting)
+				{
+					AssignSpriteLayers(dataPtr, spriteCount, buildInfo.Seed);
+				}
+			}
 		}
 
-		SDL_UnmapGPUTransferBuffer(context->Device, SpriteComputeTransferBuffer);
+		// Upload instance data and reset the indirect draw
+		if (dataPtr != NULL || useCulling)
+		{
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+			if (dataPtr != NULL)
+			{
+				spriteComputeBuffer = UploadFrameRing(
+					&SpriteComputeRing,
+					copyPass,
+					spriteCount * (useCompactSprites ? sizeof(CompactSpriteInstance) : sizeof(SpriteInstance))
+				);
+			}
+			if (useCulling)
+			{
+				ResetSpriteBatchDraws(&Batch, copyPass);
+			}
+			SDL_EndGPUCopyPass(copyPass);
+		}
 
-		// Upload instance data
-		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
-		SDL_UploadToGPUBuffer(
-			copyPass,
-			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = SpriteComputeTransferBuffer,
-				.offset = 0
-			},
-			&(SDL_GPUBufferRegion) {
-				.buffer = SpriteComputeBuffer,
-				.offset = 0,
-				.size = SPRITE_COUNT * sizeof(ComputeSpriteInstance)
-			},
-			true
-		);
-		SDL_EndGPUCopyPass(copyPass);
+		if (useSorting)
+		{
+			SpriteCullUniforms keyUniforms = {
+				.ViewProjection = cameraMatrix,
+				.SpriteCount = spriteCount,
+				.CullSprites = useCulling
+			};
+			SDL_GPUComputePass* keyPass = SDL_BeginGPUComputePass(
+				cmdBuf,
+				NULL,
+				0,
+				(SDL_GPUStorageBufferReadWriteBinding[]){
+					{ .buffer = Sorter.Keys[0], .cycle = false },
+					{ .buffer = Sorter.Values[0], .cycle = false },
+					{ .buffer = Batch.DrawCommandBuffer, .cycle = false }
+				},
+				3
+			);
+			SDL_BindGPUComputePipeline(keyPass, SortKeysPipeline);
+			SDL_BindGPUComputeStorageBuffers(keyPass, 0, &spriteComputeBuffer, 1);
+			SDL_PushGPUComputeUniformData(cmdBuf, 0, &keyUniforms, sizeof(keyUniforms));
+			SDL_DispatchGPUCompute(keyPass, (spriteCount + 63) / 64, 1, 1);
+			SDL_EndGPUComputePass(keyPass);
+
+			int sorted = SortRadix(&Sorter, cmdBuf, spriteCount, SPRITE_SORT_KEY_BITS);
+
+			SpriteCountUniforms gatherUniforms = { .SpriteCount = spriteCount };
+			SDL_GPUComputePass* gatherPass = SDL_BeginGPUComputePass(
+				cmdBuf,
+				NULL,
+				0,
+				&(SDL_GPUStorageBufferReadWriteBinding){ .buffer = SortedSpriteBuffer, .cycle = true },
+				1
+			);
+			SDL_BindGPUComputePipeline(gatherPass, GatherPipeline);
+			SDL_BindGPUComputeStorageBuffers(
+				gatherPass,
+				0,
+				(SDL_GPUBuffer*[]){ spriteComputeBuffer, Sorter.Values[sorted] },
+				2
+			);
+			SDL_PushGPUComputeUniformData(cmdBuf, 0, &gatherUniforms, sizeof(gatherUniforms));
+			SDL_DispatchGPUCompute(gatherPass, (spriteCount + 63) / 64, 1, 1);
+			SDL_EndGPUComputePass(gatherPass);
+
+			// Culled sprites sorted to the end, past what the indirect draw covers
+			spriteComputeBuffer = SortedSpriteBuffer;
+		}
 
 		// Set up compute pass to build vertex buffer
 		SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
 			cmdBuf,
 			NULL,
 			0,
-			&(SDL_GPUStorageBufferReadWriteBinding){
-				.buffer = SpriteVertexBuffer,
-				.cycle = true
+			(SDL_GPUStorageBufferReadWriteBinding[]){
+				{ .buffer = Batch.VertexBuffer, .cycle = true },
+				{ .buffer = Batch.DrawCommandBuffer, .cycle = false }
 			},
-			1
+			cullWhileExpanding ? 2 : 1
 		);
 
-		SDL_BindGPUComputePipeline(computePass, ComputePipeline);
+		SDL_BindGPUComputePipeline(computePass, computePipeline);
 		SDL_BindGPUComputeStorageBuffers(
 			computePass,
 			0,
-			&(SDL_GPUBuffer*){
-				SpriteComputeBuffer,
-			},
-			1
+			(SDL_GPUBuffer*[]){ spriteComputeBuffer, AtlasRegionBuffer },
+			useCompactSprites ? 2 : 1
 		);
-		SDL_DispatchGPUCompute(computePass, SPRITE_COUNT / 64, 1, 1);
+		if (cullWhileExpanding)
+		{
+			SpriteCullUniforms uniforms = {
+				.ViewProjection = cameraMatrix,
+				.SpriteCount = spriteCount
+			};
+			SDL_PushGPUComputeUniformData(cmdBuf, 0, &uniforms, sizeof(uniforms));
+		}
+		else
+		{
+			SpriteCountUniforms uniforms = { .SpriteCount = spriteCount };
+			SDL_PushGPUComputeUniformData(cmdBuf, 0, &uniforms, sizeof(uniforms));
+		}
+		SDL_DispatchGPUCompute(computePass, (spriteCount + 63) / 64, 1, 1);
 
 		SDL_EndGPUComputePass(computePass);
 
@@ -421,21 +786,6 @@ static int Draw(Context* context)
 		);
 
 		SDL_BindGPUGraphicsPipeline(renderPass, RenderPipeline);
-		SDL_BindGPUVertexBuffers(
-			renderPass,
-			0,
-			&(SDL_GPUBufferBinding){
-				.buffer = SpriteVertexBuffer
-			},
-			1
-		);
-		SDL_BindGPUIndexBuffer(
-			renderPass,
-			&(SDL_GPUBufferBinding){
-				.buffer = SpriteIndexBuffer
-			},
-			SDL_GPU_INDEXELEMENTSIZE_32BIT
-		);
 		SDL_BindGPUFragmentSamplers(
 			renderPass,
 			0,
@@ -451,33 +801,82 @@ static int Draw(Context* context)
 			&cameraMatrix,
 			sizeof(Matrix4x4)
 		);
-		SDL_DrawGPUIndexedPrimitives(
-			renderPass,
-			SPRITE_COUNT * 6,
-			1,
-			0,
-			0,
-			0
-		);
+		if (useCulling)
+		{
+			DrawSpriteBatchIndirect(&Batch, renderPass, spriteCount);
+		}
+		else
+		{
+			DrawSpriteBatch(&Batch, renderPass, spriteCount);
+		}
 
 		SDL_EndGPURenderPass(renderPass);
+
+		// Report how many sprites survived culling every few seconds, without waiting on the GPU
+		if (useCulling && FrameCount % 300 == 0)
+		{
+			SDL_GPUCopyPass* readbackPass = SDL_BeginGPUCopyPass(cmdBuf);
+			ReadbackBuffer(
+				context->Device,
+				readbackPass,
+				&(SDL_GPUBufferRegion) {
+					.buffer = Batch.DrawCommandBuffer,
+					.offset = 0,
+					.size = sizeof(Uint32)
+				},
+				LogVisibleSprites,
+				(void*)(uintptr_t) spriteCount
+			);
+			SDL_EndGPUCopyPass(readbackPass);
+		}
+		FrameCount += 1;
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdBuf);
+	SubmitFrameRing(&SpriteComputeRing, cmdBuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUComputePipeline(context->Device, ComputePipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, RenderPipeline);
+	ReleaseComputePipeline(context->Device, ComputePipeline);
+	if (CompactComputePipeline != NULL)
+	{
+		ReleaseComputePipeline(context->Device, CompactComputePipeline);
+		CompactComputePipeline = NULL;
+	}
+	if (CullComputePipeline != NULL)
+	{
+		ReleaseComputePipeline(context->Device, CullComputePipeline);
+		CullComputePipeline = NULL;
+	}
+	if (CompactCullComputePipeline != NULL)
+	{
+		ReleaseComputePipeline(context->Device, CompactCullComputePipeline);
+		CompactCullComputePipeline = NULL;
+	}
+	if (SortKeysPipeline != NULL)
+	{
+		ReleaseComputePipeline(context->Device, SortKeysPipeline);
+		SortKeysPipeline = NULL;
+	}
+	if (GatherPipeline != NULL)
+	{
+		ReleaseComputePipeline(context->Device, GatherPipeline);
+		GatherPipeline = NULL;
+	}
+	ReleaseRadixSorter(&Sorter);
+	SDL_ReleaseGPUBuffer(context->Device, SortedSpriteBuffer);
+	SortedSpriteBuffer = NULL;
+	UseSorting = false;
+	ReleaseSpriteSimulation(&Simulation);
+	UseSimulation = false;
+	ReleaseGraphicsPipeline(context->Device, RenderPipeline);
 	SDL_ReleaseGPUSampler(context->Device, Sampler);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
-	SDL_ReleaseGPUTransferBuffer(context->Device, SpriteComputeTransferBuffer);
-	SDL_ReleaseGPUBuffer(context->Device, SpriteComputeBuffer);
-	SDL_ReleaseGPUBuffer(context->Device, SpriteVertexBuffer);
-	SDL_ReleaseGPUBuffer(context->Device, SpriteIndexBuffer);
+	ReleaseFrameRing(&SpriteComputeRing);
+	ReleaseSpriteBatch(&Batch);
+	SDL_ReleaseGPUBuffer(context->Device, AtlasRegionBuffer);
 
 	CommonQuit(context);
 }
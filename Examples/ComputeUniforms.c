@@ -65,8 +65,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -104,14 +104,14 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUComputePipeline(context->Device, GradientPipeline);
+	ReleaseComputePipeline(context->Device, GradientPipeline);
 	SDL_ReleaseGPUTexture(context->Device, GradientRenderTexture);
 
 	CommonQuit(context);
@@ -9,6 +9,35 @@ static SDL_GPUBuffer* BufferCopy;
 
 static Uint32 TextureWidth, TextureHeight;
 
+static const Uint32 ExpectedBufferData[8] = { 2, 4, 8, 16, 32, 64, 128 };
+
+static void CompareTextureReadback(void* userdata, const void* data, Uint32 size)
+{
+	SDL_Surface* imageData = userdata;
+	if (SDL_memcmp(data, imageData->pixels, imageData->w * imageData->h * 4) == 0)
+	{
+		SDL_Log("SUCCESS! Original texture bytes and the downloaded bytes match!");
+	}
+	else
+	{
+		SDL_Log("FAILURE! Original texture bytes do not match downloaded bytes!");
+	}
+
+	SDL_DestroySurface(imageData);
+}
+
+static void CompareBufferReadback(void* userdata, const void* data, Uint32 size)
+{
+	if (SDL_memcmp(data, ExpectedBufferData, sizeof(ExpectedBufferData)) == 0)
+	{
+		SDL_Log("SUCCESS! Original buffer bytes and the downloaded bytes match!");
+	}
+	else
+	{
+		SDL_Log("FAILURE! Original buffer bytes do not match downloaded bytes!");
+	}
+}
+
 static int Init(Context* context)
 {
 	int result = CommonInit(context, 0);
@@ -68,13 +97,11 @@ static int Init(Context* context)
 		}
 	);
 
-	Uint32 bufferData[8] = { 2, 4, 8, 16, 32, 64, 128 };
-
 	OriginalBuffer = SDL_CreateGPUBuffer(
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
 			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, /* arbitrary */
-			.size = sizeof(bufferData)
+			.size = sizeof(ExpectedBufferData)
 		}
 	);
 
@@ -82,34 +109,20 @@ static int Init(Context* context)
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
 			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, /* arbitrary */
-			.size = sizeof(bufferData)
-		}
-	);
-
-	SDL_GPUTransferBuffer* downloadTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
-			.size = imageData->w * imageData->h * 4 + sizeof(bufferData)
-		}
-	);
-
-	SDL_GPUTransferBuffer* uploadTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4 + sizeof(bufferData)
+			.size = sizeof(ExpectedBufferData)
 		}
 	);
 
-	Uint8* uploadTransferPtr = SDL_MapGPUTransferBuffer(
+	StagingAllocation uploadStaging;
+	Uint8* uploadTransferPtr = MapStagingMemory(
 		context->Device,
-		uploadTransferBuffer,
-		false
+		imageData->w * imageData->h * 4 + sizeof(ExpectedBufferData),
+		0,
+		&uploadStaging
 	);
 	SDL_memcpy(uploadTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
-	SDL_memcpy(uploadTransferPtr + (imageData->w * imageData->h * 4), bufferData, sizeof(bufferData));
-	SDL_UnmapGPUTransferBuffer(context->Device, uploadTransferBuffer);
+	SDL_memcpy(uploadTransferPtr + (imageData->w * imageData->h * 4), ExpectedBufferData, sizeof(ExpectedBufferData));
+	UnmapStagingMemory(context->Device, &uploadStaging);
 
 	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
@@ -118,8 +131,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = uploadTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
+			.transfer_buffer = uploadStaging.TransferBuffer,
+			.offset = uploadStaging.Offset
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = OriginalTexture,
@@ -155,13 +168,13 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = uploadTransferBuffer,
-			.offset = imageData->w * imageData->h * 4,
+			.transfer_buffer = uploadStaging.TransferBuffer,
+			.offset = uploadStaging.Offset + imageData->w * imageData->h * 4
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = OriginalBuffer,
 			.offset = 0,
-			.size = sizeof(bufferData)
+			.size = sizeof(ExpectedBufferData)
 		},
 		false
 	);
@@ -177,7 +190,7 @@ static int Init(Context* context)
 			.buffer = BufferCopy,
 			.offset = 0
 		},
-		sizeof(bufferData),
+		sizeof(ExpectedBufferData),
 		false
 	);
 
@@ -198,74 +211,44 @@ static int Init(Context* context)
 		}
 	);
 
-	// Download the original bytes from the copy
+	// Download the original bytes from the copy. The results are compared once the GPU is done
+	// with them, without stalling here. The image is freed by the texture comparison.
 	copyPass = SDL_BeginGPUCopyPass(cmdbuf);
 
-	SDL_DownloadFromGPUTexture(
+	ReadbackTicket textureTicket = ReadbackTexture(
+		context->Device,
 		copyPass,
+		SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
 		&(SDL_GPUTextureRegion){
 			.texture = TextureCopy,
 			.w = imageData->w,
 			.h = imageData->h,
 			.d = 1
 		},
-		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = downloadTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
-		}
+		CompareTextureReadback,
+		imageData
 	);
 
-	SDL_DownloadFromGPUBuffer(
+	ReadbackBuffer(
+		context->Device,
 		copyPass,
 		&(SDL_GPUBufferRegion) {
 			.buffer = BufferCopy,
 			.offset = 0,
-			.size = sizeof(bufferData)
+			.size = sizeof(ExpectedBufferData)
 		},
-		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = downloadTransferBuffer,
-			.offset = imageData->w * imageData->h * 4
-		}
+		CompareBufferReadback,
+		NULL
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
 
-	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
-	SDL_WaitForGPUFences(context->Device, true, &fence, 1);
-	SDL_ReleaseGPUFence(context->Device, fence);
-
-	// Compare the original bytes to the copied bytes
-	Uint8 *downloadedData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		downloadTransferBuffer,
-		false
-	);
-
-	if (SDL_memcmp(downloadedData, imageData->pixels, imageData->w * imageData->h * 4) == 0)
-	{
-		SDL_Log("SUCCESS! Original texture bytes and the downloaded bytes match!");
-	}
-	else
-	{
-		SDL_Log("FAILURE! Original texture bytes do not match downloaded bytes!");
-	}
+	SubmitStagingCommandBuffer(context->Device, cmdbuf);
 
-	if (SDL_memcmp(downloadedData + (imageData->w * imageData->h * 4), bufferData, sizeof(bufferData)) == 0)
+	if (textureTicket == 0)
 	{
-		SDL_Log("SUCCESS! Original buffer bytes and the downloaded bytes match!");
+		SDL_DestroySurface(imageData);
 	}
-	else
-	{
-		SDL_Log("FAILURE! Original buffer bytes do not match downloaded bytes!");
-	}
-
-	SDL_UnmapGPUTransferBuffer(context->Device, downloadTransferBuffer);
-
-	// Cleanup
-	SDL_ReleaseGPUTransferBuffer(context->Device, downloadTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, uploadTransferBuffer);
-
-	SDL_DestroySurface(imageData);
 
 	return 0;
 }
@@ -286,8 +269,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -353,7 +336,7 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -367,6 +350,7 @@ static void Quit(Context* context)
 	SDL_ReleaseGPUBuffer(context->Device, OriginalBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, BufferCopy);
 
+	// Delivers any readbacks that are still in flight
 	CommonQuit(context);
 }
 
@@ -38,7 +38,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+				.format = GetFrameTextureFormat(context->Device, context->Window),
 				.blend_state = {
 					.enable_blend = true,
 					.alpha_blend_op = SDL_GPU_BLENDOP_ADD,
@@ -76,15 +76,15 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader,
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the textures
 	SDL_GPUTextureCreateInfo textureCreateInfo = {
@@ -159,19 +159,8 @@ static int Init(Context* context)
 	);
 
 	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(PositionTextureVertex) * 8 + sizeof(Uint16) * 6
-		}
-	);
-
-	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		bufferTransferBuffer,
-		false
-	);
+	StagingAllocation bufferStaging;
+	PositionTextureVertex* transferData = MapStagingMemory(context->Device, sizeof(PositionTextureVertex) * 8 + sizeof(Uint16) * 6, 0, &bufferStaging);
 
 	transferData[0] = (PositionTextureVertex){ -1.0f,  1.0f, 0, 0, 0 };
 	transferData[1] = (PositionTextureVertex){  0.0f,  1.0f, 0, 1, 0 };
@@ -191,25 +180,14 @@ static int Init(Context* context)
 	indexData[4] = 2;
 	indexData[5] = 3;
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	UnmapStagingMemory(context->Device, &bufferStaging);
 
 	// Set up texture data
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = leftImageData->w * leftImageData->h * 8
-		}
-	);
-
-	Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferPtr = MapStagingMemory(context->Device, leftImageData->w * leftImageData->h * 8, 0, &textureStaging);
 	SDL_memcpy(textureTransferPtr, leftImageData->pixels, leftImageData->w * leftImageData->h * 4);
 	SDL_memcpy(textureTransferPtr + (leftImageData->w * leftImageData->h * 4), rightImageData->pixels, rightImageData->w * rightImageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	// Upload the transfer data to the GPU resources
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -218,8 +196,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = LeftVertexBuffer,
@@ -232,8 +210,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionTextureVertex) * 4
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionTextureVertex) * 4
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = RightVertexBuffer,
@@ -246,8 +224,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionTextureVertex) * 8
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionTextureVertex) * 8
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -260,8 +238,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0,
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset,
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = LeftTexture,
@@ -275,8 +253,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = leftImageData->w * leftImageData->w * 4,
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset + leftImageData->w * leftImageData->w * 4,
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = RightTexture,
@@ -290,9 +268,7 @@ static int Init(Context* context)
 	SDL_DestroySurface(leftImageData);
 	SDL_DestroySurface(rightImageData);
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	return 0;
 }
@@ -312,8 +288,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -404,14 +380,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, LeftVertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, RightVertexBuffer);
@@ -46,7 +46,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.vertex_input_state = (SDL_GPUVertexInputState){
@@ -70,10 +70,10 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -112,19 +112,8 @@ static int Init(Context* context)
 	});
 
 	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = (sizeof(PositionVertex) * 24) + (sizeof(Uint16) * 36)
-		}
-	);
-
-	PositionVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		bufferTransferBuffer,
-		false
-	);
+	StagingAllocation bufferStaging;
+	PositionVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionVertex) * 24) + (sizeof(Uint16) * 36), 0, &bufferStaging);
 
 	transferData[0] = (PositionVertex) { -10, -10, -10 };
 	transferData[1] = (PositionVertex) { 10, -10, -10 };
@@ -167,7 +156,7 @@ static int Init(Context* context)
 	};
 	SDL_memcpy(indexData, indices, sizeof(indices));
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	UnmapStagingMemory(context->Device, &bufferStaging);
 
 	// Upload the transfer data to the GPU buffers
 	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -176,8 +165,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -190,8 +179,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionVertex) * 24
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionVertex) * 24
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -202,7 +191,6 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
 
 	// Clear the faces of the cube texture
 	for (int i = 0; i < 6; i += 1)
@@ -222,7 +210,7 @@ static int Init(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitStagingCommandBuffer(context->Device, cmdbuf);
 
 	// Print the instructions
 	SDL_Log("Press Left/Right to view the opposite direction!");
@@ -250,8 +238,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -290,14 +278,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
@@ -44,7 +44,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.vertex_input_state = (SDL_GPUVertexInputState){
@@ -80,7 +80,7 @@ static int Init(Context* context)
 			SDL_GPU_FRONTFACE_CLOCKWISE :
 			SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE;
 
-		Pipelines[i] = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		Pipelines[i] = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (Pipelines[i] == NULL)
 		{
 			SDL_Log("Failed to create pipeline!");
@@ -89,8 +89,8 @@ static int Init(Context* context)
 	}
 
 	// Clean up shader resources
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the vertex buffers. They're the same except for the vertex order.
 	// FIXME: Needs error handling!
@@ -110,19 +110,8 @@ static int Init(Context* context)
 	);
 
 	// Set up the transfer buffer
-	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(PositionColorVertex) * 6
-		}
-	);
-
-	PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		transferBuffer,
-		false
-	);
+	StagingAllocation staging;
+	PositionColorVertex* transferData = MapStagingMemory(context->Device, sizeof(PositionColorVertex) * 6, 0, &staging);
 
 	transferData[0] = (PositionColorVertex) {    -1,    -1, 0, 255,   0,   0, 255 };
 	transferData[1] = (PositionColorVertex) {     1,    -1, 0,   0, 255,   0, 255 };
@@ -131,7 +120,7 @@ static int Init(Context* context)
 	transferData[4] = (PositionColorVertex) {     1,    -1, 0,   0, 255,   0, 255 };
 	transferData[5] = (PositionColorVertex) {    -1,    -1, 0,   0,   0, 255, 255 };
 
-	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+	UnmapStagingMemory(context->Device, &staging);
 
 	// Upload the transfer data to the vertex buffer
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -140,8 +129,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = 0
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBufferCW,
@@ -153,8 +142,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = sizeof(PositionColorVertex) * 3
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset + sizeof(PositionColorVertex) * 3
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBufferCCW,
@@ -165,8 +154,7 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	// Finally, print instructions!
 	SDL_Log("Press Left/Right to switch between modes");
@@ -206,8 +194,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -230,7 +218,7 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -239,7 +227,7 @@ static void Quit(Context* context)
 {
 	for (int i = 0; i < SDL_arraysize(Pipelines); i += 1)
 	{
-		SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[i]);
+		ReleaseGraphicsPipeline(context->Device, Pipelines[i]);
 	}
 
 	SDL_ReleaseGPUBuffer(context->Device, VertexBufferCW);
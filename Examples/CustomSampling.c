@@ -43,7 +43,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		.vertex_input_state = (SDL_GPUVertexInputState){
@@ -72,15 +72,15 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -110,19 +110,8 @@ static int Init(Context* context)
 	});
 
 	// Set up buffer data
-	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6)
-		}
-	);
-
-	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		bufferTransferBuffer,
-		false
-	);
+	StagingAllocation bufferStaging;
+	PositionTextureVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6), 0, &bufferStaging);
 
 	transferData[0] = (PositionTextureVertex) { -1,  1, 0, 0, 0 };
 	transferData[1] = (PositionTextureVertex) {  1,  1, 0, 1, 0 };
@@ -137,24 +126,13 @@ static int Init(Context* context)
 	indexData[4] = 2;
 	indexData[5] = 3;
 
-	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	UnmapStagingMemory(context->Device, &bufferStaging);
 
 	// Set up texture data
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
-		}
-	);
-
-	Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferPtr = MapStagingMemory(context->Device, imageData->w * imageData->h * 4, 0, &textureStaging);
 	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w* imageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	// Upload the transfer data to the GPU resources
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -163,8 +141,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = 0
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -177,8 +155,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = bufferTransferBuffer,
-			.offset = sizeof(PositionTextureVertex) * 4
+			.transfer_buffer = bufferStaging.TransferBuffer,
+			.offset = bufferStaging.Offset + sizeof(PositionTextureVertex) * 4
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -191,8 +169,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset, /* Zeroes out the rest */
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
@@ -205,9 +183,7 @@ static int Init(Context* context)
 
 	SDL_DestroySurface(imageData);
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	SDL_Log("Press Left/Right to switch sampler modes");
 	SDL_Log("Setting sampler mode to: %d", SamplerMode);
@@ -236,8 +212,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -261,14 +237,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
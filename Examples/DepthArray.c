@@ -95,7 +95,7 @@ static int Init(Context* context)
 			.fragment_shader = sceneFragmentShader
 		};
 
-		DepthPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		DepthPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (DepthPipeline == NULL)
 		{
 			SDL_Log("Failed to create Depth pipeline!");
@@ -106,7 +106,7 @@ static int Init(Context* context)
 			.target_info = {
 				.num_color_targets = 1,
 				.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-					.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+					.format = GetFrameTextureFormat(context->Device, context->Window),
 					.blend_state = (SDL_GPUColorTargetBlendState) {
 						.enable_blend = true,
 						.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
@@ -128,17 +128,17 @@ static int Init(Context* context)
 			.fragment_shader = depthFragmentShader
 		};
 
-		DepthSamplePipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &depthSamplerPipelineCreateInfo);
+		DepthSamplePipeline = AcquireGraphicsPipeline(context->Device, &depthSamplerPipelineCreateInfo);
 		if (DepthSamplePipeline == NULL)
 		{
 			SDL_Log("Failed to create Depth Sample pipeline!");
 			return -1;
 		}
 
-		SDL_ReleaseGPUShader(context->Device, sceneVertexShader);
-		SDL_ReleaseGPUShader(context->Device, sceneFragmentShader);
-		SDL_ReleaseGPUShader(context->Device, fullscreenVertexShader);
-		SDL_ReleaseGPUShader(context->Device, depthFragmentShader);
+		ReleaseShader(context->Device, sceneVertexShader);
+		ReleaseShader(context->Device, sceneFragmentShader);
+		ReleaseShader(context->Device, fullscreenVertexShader);
+		ReleaseShader(context->Device, depthFragmentShader);
 	}
 
 	// Create the Scene Textures
@@ -182,19 +182,8 @@ static int Init(Context* context)
 			}
 		);
 
-		SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-			context->Device,
-			&(SDL_GPUTransferBufferCreateInfo) {
-				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-				.size = (sizeof(PositionColorVertex) * 24) + (sizeof(Uint16) * 36)
-			}
-		);
-
-		PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-			context->Device,
-			bufferTransferBuffer,
-			false
-		);
+		StagingAllocation bufferStaging;
+		PositionColorVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionColorVertex) * 24) + (sizeof(Uint16) * 36), 0, &bufferStaging);
 
 		transferData[0] = (PositionColorVertex) { -10, -10, -10, 255, 0, 0, 255 };
 		transferData[1] = (PositionColorVertex) { 10, -10, -10, 255, 0, 0, 255 };
@@ -237,7 +226,7 @@ static int Init(Context* context)
 		};
 		SDL_memcpy(indexData, indices, sizeof(indices));
 
-		SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		UnmapStagingMemory(context->Device, &bufferStaging);
 
 		// Upload the transfer data to the GPU buffers
 		SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -246,8 +235,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = 0
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = SceneVertexBuffer,
@@ -260,8 +249,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = sizeof(PositionColorVertex) * 24
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset + sizeof(PositionColorVertex) * 24
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = SceneIndexBuffer,
@@ -272,8 +261,7 @@ static int Init(Context* context)
 		);
 
 		SDL_EndGPUCopyPass(copyPass);
-		SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-		SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 	}
 
 	// Create Outline Effect Sampler
@@ -306,8 +294,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -404,15 +392,15 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, DepthPipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, DepthSamplePipeline);
+	ReleaseGraphicsPipeline(context->Device, DepthPipeline);
+	ReleaseGraphicsPipeline(context->Device, DepthSamplePipeline);
 	SDL_ReleaseGPUTexture(context->Device, SceneDepthTexture);
 	SDL_ReleaseGPUBuffer(context->Device, SceneVertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, SceneIndexBuffer);
@@ -99,7 +99,7 @@ static int Init(Context* context)
 			.fragment_shader = sceneFragmentShader
 		};
 
-		ScenePipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		ScenePipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (ScenePipeline == NULL)
 		{
 			SDL_Log("Failed to create Scene pipeline!");
@@ -110,7 +110,7 @@ static int Init(Context* context)
 			.target_info = {
 				.num_color_targets = 1,
 				.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-					.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+					.format = GetFrameTextureFormat(context->Device, context->Window),
 					.blend_state = (SDL_GPUColorTargetBlendState) {
 						.enable_blend = true,
 						.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
@@ -148,18 +148,18 @@ static int Init(Context* context)
 			.fragment_shader = effectFragmentShader
 		};
 
-		EffectPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		EffectPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (EffectPipeline == NULL)
 		{
 			SDL_Log("Failed to create Outline Effect pipeline!");
 			return -1;
 		}
 
-		SDL_ReleaseGPUShader(context->Device, effectVertexShader);
-		SDL_ReleaseGPUShader(context->Device, effectFragmentShader);
+		ReleaseShader(context->Device, effectVertexShader);
+		ReleaseShader(context->Device, effectFragmentShader);
 
-		SDL_ReleaseGPUShader(context->Device, sceneVertexShader);
-		SDL_ReleaseGPUShader(context->Device, sceneFragmentShader);
+		ReleaseShader(context->Device, sceneVertexShader);
+		ReleaseShader(context->Device, sceneFragmentShader);
 	}
 
 	// Create the Scene Textures
@@ -227,19 +227,8 @@ static int Init(Context* context)
 			}
 		);
 
-		SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-			context->Device,
-			&(SDL_GPUTransferBufferCreateInfo) {
-				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-				.size = (sizeof(PositionColorVertex) * 24) + (sizeof(Uint16) * 36)
-			}
-		);
-
-		PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-			context->Device,
-			bufferTransferBuffer,
-			false
-		);
+		StagingAllocation bufferStaging;
+		PositionColorVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionColorVertex) * 24) + (sizeof(Uint16) * 36), 0, &bufferStaging);
 
 		transferData[0] = (PositionColorVertex) { -10, -10, -10, 255, 0, 0, 255 };
 		transferData[1] = (PositionColorVertex) { 10, -10, -10, 255, 0, 0, 255 };
@@ -282,7 +271,7 @@ static int Init(Context* context)
 		};
 		SDL_memcpy(indexData, indices, sizeof(indices));
 
-		SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		UnmapStagingMemory(context->Device, &bufferStaging);
 
 		// Upload the transfer data to the GPU buffers
 		SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -291,8 +280,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = 0
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = SceneVertexBuffer,
@@ -305,8 +294,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = sizeof(PositionColorVertex) * 24
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset + sizeof(PositionColorVertex) * 24
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = SceneIndexBuffer,
@@ -317,8 +306,7 @@ static int Init(Context* context)
 		);
 
 		SDL_EndGPUCopyPass(copyPass);
-		SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-		SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 	}
 
 	// Create & Upload Outline Effect Vertex and Index buffers
@@ -339,19 +327,8 @@ static int Init(Context* context)
 			}
 		);
 
-		SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
-			context->Device,
-			&(SDL_GPUTransferBufferCreateInfo) {
-				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-				.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6)
-			}
-		);
-
-		PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
-			context->Device,
-			bufferTransferBuffer,
-			false
-		);
+		StagingAllocation bufferStaging;
+		PositionTextureVertex* transferData = MapStagingMemory(context->Device, (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6), 0, &bufferStaging);
 
 		transferData[0] = (PositionTextureVertex) { -1,  1, 0, 0, 0 };
 		transferData[1] = (PositionTextureVertex) {  1,  1, 0, 1, 0 };
@@ -366,7 +343,7 @@ static int Init(Context* context)
 		indexData[4] = 2;
 		indexData[5] = 3;
 
-		SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		UnmapStagingMemory(context->Device, &bufferStaging);
 
 		SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
 		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
@@ -374,8 +351,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = 0
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = EffectVertexBuffer,
@@ -388,8 +365,8 @@ static int Init(Context* context)
 		SDL_UploadToGPUBuffer(
 			copyPass,
 			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = bufferTransferBuffer,
-				.offset = sizeof(PositionTextureVertex) * 4
+				.transfer_buffer = bufferStaging.TransferBuffer,
+				.offset = bufferStaging.Offset + sizeof(PositionTextureVertex) * 4
 			},
 			&(SDL_GPUBufferRegion) {
 				.buffer = EffectIndexBuffer,
@@ -400,8 +377,7 @@ static int Init(Context* context)
 		);
 
 		SDL_EndGPUCopyPass(copyPass);
-		SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-		SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+		SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 	}
 
 	Time = 0;
@@ -424,8 +400,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -494,20 +470,20 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, ScenePipeline);
+	ReleaseGraphicsPipeline(context->Device, ScenePipeline);
 	SDL_ReleaseGPUTexture(context->Device, SceneColorTexture);
 	SDL_ReleaseGPUTexture(context->Device, SceneDepthTexture);
 	SDL_ReleaseGPUBuffer(context->Device, SceneVertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, SceneIndexBuffer);
 
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, EffectPipeline);
+	ReleaseGraphicsPipeline(context->Device, EffectPipeline);
 	SDL_ReleaseGPUBuffer(context->Device, EffectVertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, EffectIndexBuffer);
 	SDL_ReleaseGPUSampler(context->Device, EffectSampler);
@@ -33,7 +33,7 @@ static int Init(Context* context)
 		.target_info = {
 			.num_color_targets = 1,
 			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+				.format = GetFrameTextureFormat(context->Device, context->Window)
 			}},
 		},
 		// This is set up to match the vertex shader layout!
@@ -63,15 +63,15 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
 		return -1;
 	}
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Create the buffers
 	const Uint32 vertexBufferSize = sizeof(PositionColorVertex) * 10;
@@ -102,19 +102,8 @@ static int Init(Context* context)
 	);
 
 	// Set the buffer data
-	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = vertexBufferSize + indexBufferSize + drawBufferSize
-		}
-	);
-
-	PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		transferBuffer,
-		false
-	);
+	StagingAllocation staging;
+	PositionColorVertex* transferData = MapStagingMemory(context->Device, vertexBufferSize + indexBufferSize + drawBufferSize, 0, &staging);
 
 	transferData[0] = (PositionColorVertex) {    -1, -1, 0,	 255,   0,   0, 255 };
 	transferData[1] = (PositionColorVertex) {     1, -1, 0,	   0, 255,   0, 255 };
@@ -143,7 +132,7 @@ static int Init(Context* context)
 	drawCommands[0] = (SDL_GPUIndirectDrawCommand) { 3, 1, 4, 0 };
 	drawCommands[1] = (SDL_GPUIndirectDrawCommand) { 3, 1, 7, 0 };
 
-	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+	UnmapStagingMemory(context->Device, &staging);
 
 	// Upload the transfer data to the GPU buffers
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
@@ -152,8 +141,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = 0
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = VertexBuffer,
@@ -166,8 +155,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = vertexBufferSize
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset + vertexBufferSize
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = IndexBuffer,
@@ -180,8 +169,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUBuffer(
 		copyPass,
 		&(SDL_GPUTransferBufferLocation) {
-			.transfer_buffer = transferBuffer,
-			.offset = vertexBufferSize + indexBufferSize
+			.transfer_buffer = staging.TransferBuffer,
+			.offset = staging.Offset + vertexBufferSize + indexBufferSize
 		},
 		&(SDL_GPUBufferRegion) {
 			.buffer = DrawBuffer,
@@ -192,8 +181,7 @@ static int Init(Context* context)
 	);
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	return 0;
 }
@@ -213,8 +201,8 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -237,14 +225,14 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	ReleaseGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, DrawBuffer);
@@ -0,0 +1,178 @@
+#include "Common.h"
+
+// Frame Rings
+// Slots are handed out in turn. A slot remembers the staging serial of the frame that last
+// uploaded from it, so mapping it again only has to wait when the GPU is behind by more than
+// the ring's length.
+
+static bool CreateFrameRingBuffers(FrameRing* ring)
+{
+	ring->TransferBuffer = SDL_CreateGPUTransferBuffer(
+		ring->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = ring->SlotSize * ring->SlotCount
+		}
+	);
+	if (ring->TransferBuffer == NULL)
+	{
+		SDL_Log("Failed to create frame ring transfer buffer: %s", SDL_GetError());
+		return false;
+	}
+
+	for (int i = 0; i < ring->SlotCount; i += 1)
+	{
+		ring->Buffers[i] = SDL_CreateGPUBuffer(
+			ring->Device,
+			&(SDL_GPUBufferCreateInfo) {
+				.usage = ring->Usage,
+				.size = ring->SlotSize
+			}
+		);
+		if (ring->Buffers[i] == NULL)
+		{
+			SDL_Log("Failed to create frame ring buffer: %s", SDL_GetError());
+			return false;
+		}
+	}
+
+	ring->Stats.MemoryBytes = (Uint64) ring->SlotSize * ring->SlotCount * 2;
+	return true;
+}
+
+// Releasing is deferred by SDL until the GPU is done, so there is no need to wait here
+static void ReleaseFrameRingBuffers(FrameRing* ring)
+{
+	if (ring->TransferBuffer != NULL)
+	{
+		SDL_ReleaseGPUTransferBuffer(ring->Device, ring->TransferBuffer);
+		ring->TransferBuffer = NULL;
+	}
+	for (int i = 0; i < ring->SlotCount; i += 1)
+	{
+		if (ring->Buffers[i] != NULL)
+		{
+			SDL_ReleaseGPUBuffer(ring->Device, ring->Buffers[i]);
+			ring->Buffers[i] = NULL;
+		}
+	}
+}
+
+bool CreateFrameRing(FrameRing* ring, SDL_GPUDevice* device, Uint32 slotSize, SDL_GPUBufferUsageFlags usage, int framesInFlight)
+{
+	SDL_zerop(ring);
+	ring->Device = device;
+	ring->Usage = usage;
+	ring->SlotSize = slotSize;
+	ring->SlotCount = SDL_clamp(framesInFlight, 1, MAX_FRAME_RING_SLOTS);
+
+	if (!SDL_SetGPUAllowedFramesInFlight(device, ring->SlotCount))
+	{
+		SDL_Log("Failed to set %d allowed frames in flight: %s", ring->SlotCount, SDL_GetError());
+		return false;
+	}
+
+	if (!CreateFrameRingBuffers(ring))
+	{
+		ReleaseFrameRing(ring);
+		return false;
+	}
+
+	// Slots are guarded by staging submission serials
+	BindStagingDevice(device);
+	return true;
+}
+
+void* MapFrameRing(FrameRing* ring)
+{
+	Uint64 serial = ring->SlotSerials[ring->Slot];
+	if (serial > GetCompletedStagingSerial(ring->Device))
+	{
+		PROFILE_BEGIN("Frame Ring Stall");
+		Uint64 waitStart = SDL_GetPerformanceCounter();
+		WaitForStagingSerial(ring->Device, serial);
+		ring->Stats.Stalls += 1;
+		ring->Stats.StallMilliseconds += (SDL_GetPerformanceCounter() - waitStart) * 1000.0 / SDL_GetPerformanceFrequency();
+		PROFILE_END();
+	}
+
+	Uint8* data = SDL_MapGPUTransferBuffer(ring->Device, ring->TransferBuffer, false);
+	if (data == NULL)
+	{
+		SDL_Log("Failed to map frame ring: %s", SDL_GetError());
+		return NULL;
+	}
+	ring->Mapped = true;
+	return data + ring->Slot * ring->SlotSize;
+}
+
+SDL_GPUBuffer* UploadFrameRing(FrameRing* ring, SDL_GPUCopyPass* copyPass, Uint32 size)
+{
+	if (ring->Mapped)
+	{
+		SDL_UnmapGPUTransferBuffer(ring->Device, ring->TransferBuffer);
+		ring->Mapped = false;
+	}
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = ring->TransferBuffer,
+			.offset = ring->Slot * ring->SlotSize
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = ring->Buffers[ring->Slot],
+			.offset = 0,
+			.size = SDL_min(size, ring->SlotSize)
+		},
+		false
+	);
+	ring->Uploaded = true;
+	return ring->Buffers[ring->Slot];
+}
+
+bool SubmitFrameRing(FrameRing* ring, SDL_GPUCommandBuffer* commandBuffer)
+{
+	if (ring->Mapped)
+	{
+		SDL_UnmapGPUTransferBuffer(ring->Device, ring->TransferBuffer);
+		ring->Mapped = false;
+	}
+
+	// Frames that never used their slot (e.g. no swapchain texture) don't advance the ring
+	if (ring->Uploaded)
+	{
+		ring->SlotSerials[ring->Slot] = GetNextStagingSerial(ring->Device);
+		ring->Slot = (ring->Slot + 1) % ring->SlotCount;
+		ring->Uploaded = false;
+		ring->Stats.Frames += 1;
+	}
+	return SubmitStagingCommandBuffer(ring->Device, commandBuffer);
+}
+
+bool ResizeFrameRing(FrameRing* ring, Uint32 slotSize)
+{
+	SDL_assert(!ring->Mapped);
+
+	// The new buffers have never been read, so none of the slots need to be waited on
+	ReleaseFrameRingBuffers(ring);
+	ring->SlotSize = slotSize;
+	SDL_zeroa(ring->SlotSerials);
+	if (!CreateFrameRingBuffers(ring))
+	{
+		ReleaseFrameRingBuffers(ring);
+		return false;
+	}
+	return true;
+}
+
+void ReleaseFrameRing(FrameRing* ring)
+{
+	if (ring->Device == NULL)
+	{
+		return;
+	}
+
+	ReleaseFrameRingBuffers(ring);
+	SDL_zerop(ring);
+}
@@ -0,0 +1,285 @@
+#include "Common.h"
+
+// GPU Memory Accounting
+// Only builds with SDL_GPU_EXAMPLES_INSTRUMENTATION route SDL's create and release calls through
+// here (see Instrumentation.h). The wrappers call SDL by its parenthesized names, which the
+// function-like macros there leave alone. Live allocations are kept in an array searched
+// linearly, like the pipeline registry: examples hold tens of resources, not thousands, and they
+// are created and released at init and quit. Only resources created on the main thread are
+// expected, so nothing here takes a lock.
+
+typedef struct GPUAllocation
+{
+	SDL_GPUDevice* Device;
+	void* Resource;
+	GPUMemoryKind Kind;
+	Uint64 Size;
+	SDL_GPUTextureFormat Format; // Textures only
+	char* Name; // Owned, NULL when the resource has none
+	const char* Tag;
+} GPUAllocation;
+
+static GPUAllocation* GPUAllocations;
+static int GPUAllocationCount;
+static int GPUAllocationCapacity;
+static const char* GPUMemoryTag;
+static GPUMemoryStats GPUMemoryCounters;
+
+static const char* GPUMemoryKindNames[GPU_MEMORY_KIND_COUNT] = {
+	"buffer",
+	"texture",
+	"transfer buffer"
+};
+
+static double ToMiB(Uint64 bytes)
+{
+	return bytes / (1024.0 * 1024.0);
+}
+
+static void TrackGPUAllocation(
+	SDL_GPUDevice* device,
+	void* resource,
+	GPUMemoryKind kind,
+	Uint64 size,
+	SDL_GPUTextureFormat format,
+	const char* name
+) {
+	if (GPUAllocationCount == GPUAllocationCapacity)
+	{
+		int capacity = SDL_max(GPUAllocationCapacity * 2, 64);
+		GPUAllocation* allocations = SDL_realloc(GPUAllocations, capacity * sizeof(GPUAllocation));
+		if (allocations == NULL)
+		{
+			SDL_Log("Out of memory, GPU allocation %s won't be tracked", name != NULL ? name : "unnamed");
+			return;
+		}
+		GPUAllocations = allocations;
+		GPUAllocationCapacity = capacity;
+	}
+
+	GPUAllocations[GPUAllocationCount++] = (GPUAllocation) {
+		.Device = device,
+		.Resource = resource,
+		.Kind = kind,
+		.Size = size,
+		.Format = format,
+		.Name = name != NULL ? SDL_strdup(name) : NULL,
+		.Tag = GPUMemoryTag
+	};
+
+	GPUMemoryCounters.CurrentBytes[kind] += size;
+	GPUMemoryCounters.TotalBytes += size;
+	GPUMemoryCounters.PeakBytes = SDL_max(GPUMemoryCounters.PeakBytes, GPUMemoryCounters.TotalBytes);
+	GPUMemoryCounters.LiveAllocations += 1;
+}
+
+static void ForgetGPUAllocation(int index)
+{
+	GPUAllocation* allocation = &GPUAllocations[index];
+	GPUMemoryCounters.CurrentBytes[allocation->Kind] -= allocation->Size;
+	GPUMemoryCounters.TotalBytes -= allocation->Size;
+	GPUMemoryCounters.LiveAllocations -= 1;
+	SDL_free(allocation->Name);
+	GPUAllocations[index] = GPUAllocations[--GPUAllocationCount];
+}
+
+static void UntrackGPUAllocation(void* resource)
+{
+	if (resource == NULL)
+	{
+		return;
+	}
+
+	for (int i = 0; i < GPUAllocationCount; i += 1)
+	{
+		if (GPUAllocations[i].Resource == resource)
+		{
+			ForgetGPUAllocation(i);
+			return;
+		}
+	}
+}
+
+Uint64 GetGPUTextureSize(const SDL_GPUTextureCreateInfo* createInfo)
+{
+	Uint64 size = 0;
+	for (Uint32 level = 0; level < SDL_max(createInfo->num_levels, 1); level += 1)
+	{
+		// Array and cube layers keep their count down the chain, 3D depth halves like the rest
+		Uint32 depthOrLayers = createInfo->type == SDL_GPU_TEXTURETYPE_3D ?
+			SDL_max(createInfo->layer_count_or_depth >> level, 1) :
+			createInfo->layer_count_or_depth;
+		size += SDL_CalculateGPUTextureFormatSize(
+			createInfo->format,
+			SDL_max(createInfo->width >> level, 1),
+			SDL_max(createInfo->height >> level, 1),
+			SDL_max(depthOrLayers, 1)
+		);
+	}
+
+	// SDL_GPU_SAMPLECOUNT_1 is 0, each step up doubles the samples
+	return size << createInfo->sample_count;
+}
+
+// Resources are listed under their SDL name when the create-info has one, else the call site
+static const char* GetGPUResourceName(SDL_PropertiesID props, const char* nameProperty, const char* site)
+{
+	const char* name = (props != 0) ? SDL_GetStringProperty(props, nameProperty, NULL) : NULL;
+	if (name != NULL)
+	{
+		return name;
+	}
+
+	// __FILE__ may be a full path
+	for (const char* c = site; *c != '\0'; c += 1)
+	{
+		if (*c == '/' || *c == '\\')
+		{
+			site = c + 1;
+		}
+	}
+	return site;
+}
+
+SDL_GPUBuffer* CreateGPUBuffer(SDL_GPUDevice* device, const SDL_GPUBufferCreateInfo* createInfo, const char* site)
+{
+	SDL_GPUBuffer* buffer = (SDL_CreateGPUBuffer)(device, createInfo);
+	if (buffer != NULL)
+	{
+		const char* name = GetGPUResourceName(createInfo->props, SDL_PROP_GPU_BUFFER_CREATE_NAME_STRING, site);
+		TrackGPUAllocation(device, buffer, GPU_MEMORY_BUFFER, createInfo->size, SDL_GPU_TEXTUREFORMAT_INVALID, name);
+	}
+	return buffer;
+}
+
+SDL_GPUTexture* CreateGPUTexture(SDL_GPUDevice* device, const SDL_GPUTextureCreateInfo* createInfo, const char* site)
+{
+	SDL_GPUTexture* texture = (SDL_CreateGPUTexture)(device, createInfo);
+	if (texture != NULL)
+	{
+		const char* name = GetGPUResourceName(createInfo->props, SDL_PROP_GPU_TEXTURE_CREATE_NAME_STRING, site);
+		TrackGPUAllocation(device, texture, GPU_MEMORY_TEXTURE, GetGPUTextureSize(createInfo), createInfo->format, name);
+	}
+	return texture;
+}
+
+SDL_GPUTransferBuffer* CreateGPUTransferBuffer(SDL_GPUDevice* device, const SDL_GPUTransferBufferCreateInfo* createInfo, const char* site)
+{
+	SDL_GPUTransferBuffer* transferBuffer = (SDL_CreateGPUTransferBuffer)(device, createInfo);
+	if (transferBuffer != NULL)
+	{
+		const char* name = GetGPUResourceName(createInfo->props, SDL_PROP_GPU_TRANSFERBUFFER_CREATE_NAME_STRING, site);
+		TrackGPUAllocation(device, transferBuffer, GPU_MEMORY_TRANSFER_BUFFER, createInfo->size, SDL_GPU_TEXTUREFORMAT_INVALID, name);
+	}
+	return transferBuffer;
+}
+
+void ReleaseGPUBuffer(SDL_GPUDevice* device, SDL_GPUBuffer* buffer)
+{
+	UntrackGPUAllocation(buffer);
+	(SDL_ReleaseGPUBuffer)(device, buffer);
+}
+
+void ReleaseGPUTexture(SDL_GPUDevice* device, SDL_GPUTexture* texture)
+{
+	UntrackGPUAllocation(texture);
+	(SDL_ReleaseGPUTexture)(device, texture);
+}
+
+void ReleaseGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer)
+{
+	UntrackGPUAllocation(transferBuffer);
+	(SDL_ReleaseGPUTransferBuffer)(device, transferBuffer);
+}
+
+SDL_GPUTextureFormat GetTrackedTextureFormat(SDL_GPUTexture* texture)
+{
+	for (int i = 0; i < GPUAllocationCount; i += 1)
+	{
+		if (GPUAllocations[i].Resource == texture)
+		{
+			return GPUAllocations[i].Format;
+		}
+	}
+	return SDL_GPU_TEXTUREFORMAT_INVALID;
+}
+
+void SetGPUMemoryTag(const char* tag)
+{
+	GPUMemoryTag = tag;
+}
+
+void ResetGPUMemoryPeak()
+{
+	GPUMemoryCounters.PeakBytes = GPUMemoryCounters.TotalBytes;
+}
+
+static int CompareGPUAllocationSizes(const void* a, const void* b)
+{
+	Uint64 left = ((const GPUAllocation*) a)->Size;
+	Uint64 right = ((const GPUAllocation*) b)->Size;
+	return (left < right) - (left > right);
+}
+
+void LogGPUMemory()
+{
+	SDL_Log(
+		"GPU memory: %.2f MiB (%.2f MiB peak) in %d allocation(s): %.2f MiB of buffers, %.2f MiB of textures, %.2f MiB of transfer buffers",
+		ToMiB(GPUMemoryCounters.TotalBytes),
+		ToMiB(GPUMemoryCounters.PeakBytes),
+		GPUMemoryCounters.LiveAllocations,
+		ToMiB(GPUMemoryCounters.CurrentBytes[GPU_MEMORY_BUFFER]),
+		ToMiB(GPUMemoryCounters.CurrentBytes[GPU_MEMORY_TEXTURE]),
+		ToMiB(GPUMemoryCounters.CurrentBytes[GPU_MEMORY_TRANSFER_BUFFER])
+	);
+
+	SDL_qsort(GPUAllocations, GPUAllocationCount, sizeof(GPUAllocation), CompareGPUAllocationSizes);
+	for (int i = 0; i < GPUAllocationCount; i += 1)
+	{
+		const GPUAllocation* allocation = &GPUAllocations[i];
+		SDL_Log(
+			"  %10.3f MiB  %-15s  %s (%s)",
+			ToMiB(allocation->Size),
+			GPUMemoryKindNames[allocation->Kind],
+			allocation->Name != NULL ? allocation->Name : "unnamed",
+			allocation->Tag != NULL ? allocation->Tag : "untagged"
+		);
+	}
+}
+
+int ReportGPUMemoryLeaks(SDL_GPUDevice* device)
+{
+	int leaks = 0;
+	Uint64 leakedBytes = 0;
+	for (int i = GPUAllocationCount - 1; i >= 0; i -= 1)
+	{
+		const GPUAllocation* allocation = &GPUAllocations[i];
+		if (allocation->Device != device)
+		{
+			continue;
+		}
+
+		SDL_Log(
+			"Leaked %s '%s' of %.3f MiB, allocated by %s",
+			GPUMemoryKindNames[allocation->Kind],
+			allocation->Name != NULL ? allocation->Name : "unnamed",
+			ToMiB(allocation->Size),
+			allocation->Tag != NULL ? allocation->Tag : "untagged code"
+		);
+		leaks += 1;
+		leakedBytes += allocation->Size;
+		ForgetGPUAllocation(i);
+	}
+
+	if (leaks > 0)
+	{
+		SDL_Log("%d GPU allocation(s) leaked, %.3f MiB in total", leaks, ToMiB(leakedBytes));
+		GPUMemoryCounters.Leaks += leaks;
+	}
+	return leaks;
+}
+
+GPUMemoryStats GetGPUMemoryStats()
+{
+	return GPUMemoryCounters;
+}
@@ -0,0 +1,567 @@
+#include "Common.h"
+#include "../stb_image.h"
+
+// HDR Image Decoding
+// Radiance RGBE decoding straight to RGBA16F. Scanlines are variable length once run-length
+// encoded, so they are located serially first; expanding and converting them then happens in
+// parallel bands of rows.
+
+#define HDR_MAX_HALF 65504.0f
+#define HDR_HALF_ONE 0x3C00
+
+// The conversion is memory bound well before it runs out of cores, and loads often already
+// run on the asset loader's threads, so only a few bands are worth a thread of their own
+#define MIN_ROWS_PER_DECODE_THREAD 64
+#define MAX_DECODE_THREADS 8
+
+// Round-to-nearest-even, after Fabian Giesen's float_to_half_fast3_rtne
+Uint16 FloatToHalf(float value)
+{
+	Uint32 bits;
+	SDL_memcpy(&bits, &value, sizeof(bits));
+
+	Uint32 sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	Uint16 result;
+	if (bits >= (127 + 16) << 23)
+	{
+		result = (bits > 255u << 23) ? 0x7E00 : 0x7C00; // NaN stays NaN, everything else becomes Inf
+	}
+	else if (bits < 113 << 23)
+	{
+		// Subnormal (or zero): let the FPU do the rounding by adding a magic number
+		Uint32 magicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+		float magic;
+		float sum;
+		SDL_memcpy(&magic, &magicBits, sizeof(magic));
+		SDL_memcpy(&value, &bits, sizeof(value));
+		sum = value + magic;
+		SDL_memcpy(&bits, &sum, sizeof(bits));
+		result = (Uint16)(bits - magicBits);
+	}
+	else
+	{
+		Uint32 mantissaOdd = (bits >> 13) & 1;
+		bits += 0xC8000FFFu + mantissaOdd; // Rebias the exponent (15 - 127) and round
+		result = (Uint16)(bits >> 13);
+	}
+
+	return result | (Uint16)(sign >> 16);
+}
+
+static void ConvertFloatToHalf(const float* src, Uint16* dst, size_t count)
+{
+	for (size_t i = 0; i < count; i += 1)
+	{
+		dst[i] = FloatToHalf(src[i]);
+	}
+}
+
+// Stored mantissas are scaled by 2^(exponent - 136). Exponents below 10 give values far
+// below the smallest half, so they (and the exponent 0 "zero" pixel) are flushed to 0.
+static void ConvertRGBERowScalar(const Uint8* planes, int width, int first, Uint16* dst)
+{
+	const Uint8* r = planes;
+	const Uint8* g = planes + width;
+	const Uint8* b = planes + width * 2;
+	const Uint8* e = planes + width * 3;
+
+	for (int x = first; x < width; x += 1)
+	{
+		float scale = 0.0f;
+		if (e[x] > 9)
+		{
+			Uint32 scaleBits = (Uint32)(e[x] - 9) << 23;
+			SDL_memcpy(&scale, &scaleBits, sizeof(scale));
+		}
+
+		dst[x * 4 + 0] = FloatToHalf(SDL_min(r[x] * scale, HDR_MAX_HALF));
+		dst[x * 4 + 1] = FloatToHalf(SDL_min(g[x] * scale, HDR_MAX_HALF));
+		dst[x * 4 + 2] = FloatToHalf(SDL_min(b[x] * scale, HDR_MAX_HALF));
+		dst[x * 4 + 3] = HDR_HALF_ONE;
+	}
+}
+
+#if defined(SDL_SSE2_INTRINSICS)
+// Four lanes of FloatToHalf for values already clamped to [0, HDR_MAX_HALF]
+static inline __m128i FloatToHalfSSE2(__m128 value)
+{
+	const __m128i magicBits = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+	__m128i bits = _mm_castps_si128(value);
+	__m128i isSubnormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23));
+	__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(value, _mm_castsi128_ps(magicBits))), magicBits);
+	__m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+	__m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32((int)0xC8000FFFu)), mantissaOdd), 13);
+	return _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+}
+
+static inline __m128 RGBEScaleSSE2(__m128i exponent)
+{
+	__m128i scaleBits = _mm_slli_epi32(_mm_sub_epi32(exponent, _mm_set1_epi32(9)), 23);
+	return _mm_castsi128_ps(_mm_and_si128(scaleBits, _mm_cmpgt_epi32(exponent, _mm_set1_epi32(9))));
+}
+
+static inline __m128i RGBEChannelToHalfSSE2(__m128i mantissa, __m128 scale)
+{
+	__m128 value = _mm_mul_ps(_mm_cvtepi32_ps(mantissa), scale);
+	return FloatToHalfSSE2(_mm_min_ps(value, _mm_set1_ps(HDR_MAX_HALF)));
+}
+
+// Interleaves eight pixels' worth of packed halves into RGBA
+static inline void StoreRGBAHalfSSE2(Uint16* dst, __m128i r, __m128i g, __m128i b)
+{
+	__m128i a = _mm_set1_epi16(HDR_HALF_ONE);
+	__m128i rgLow = _mm_unpacklo_epi16(r, g);
+	__m128i rgHigh = _mm_unpackhi_epi16(r, g);
+	__m128i baLow = _mm_unpacklo_epi16(b, a);
+	__m128i baHigh = _mm_unpackhi_epi16(b, a);
+	_mm_storeu_si128((__m128i*)(dst + 0), _mm_unpacklo_epi32(rgLow, baLow));
+	_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi32(rgLow, baLow));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpacklo_epi32(rgHigh, baHigh));
+	_mm_storeu_si128((__m128i*)(dst + 24), _mm_unpackhi_epi32(rgHigh, baHigh));
+}
+
+static int ConvertRGBERowSSE2(const Uint8* planes, int width, Uint16* dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8)
+	{
+		__m128i r = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(planes + x)), zero);
+		__m128i g = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(planes + width + x)), zero);
+		__m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(planes + width * 2 + x)), zero);
+		__m128i e = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(planes + width * 3 + x)), zero);
+
+		__m128 scaleLow = RGBEScaleSSE2(_mm_unpacklo_epi16(e, zero));
+		__m128 scaleHigh = RGBEScaleSSE2(_mm_unpackhi_epi16(e, zero));
+
+		// Halves of non-negative values never exceed 0x7C00, so signed saturation is lossless
+		StoreRGBAHalfSSE2(
+			dst + x * 4,
+			_mm_packs_epi32(RGBEChannelToHalfSSE2(_mm_unpacklo_epi16(r, zero), scaleLow), RGBEChannelToHalfSSE2(_mm_unpackhi_epi16(r, zero), scaleHigh)),
+			_mm_packs_epi32(RGBEChannelToHalfSSE2(_mm_unpacklo_epi16(g, zero), scaleLow), RGBEChannelToHalfSSE2(_mm_unpackhi_epi16(g, zero), scaleHigh)),
+			_mm_packs_epi32(RGBEChannelToHalfSSE2(_mm_unpacklo_epi16(b, zero), scaleLow), RGBEChannelToHalfSSE2(_mm_unpackhi_epi16(b, zero), scaleHigh))
+		);
+	}
+
+	return x;
+}
+#endif
+
+#if defined(SDL_SSE2_INTRINSICS) && defined(SDL_AVX2_INTRINSICS)
+static inline __m256i SDL_TARGETING("avx2") RGBEChannelToHalfAVX2(const Uint8* mantissas, __m256 scale)
+{
+	const __m256i magicBits = _mm256_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+	__m256 value = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)mantissas))), scale);
+	value = _mm256_min_ps(value, _mm256_set1_ps(HDR_MAX_HALF));
+
+	__m256i bits = _mm256_castps_si256(value);
+	__m256i isSubnormal = _mm256_cmpgt_epi32(_mm256_set1_epi32(113 << 23), bits);
+	__m256i subnormal = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(value, _mm256_castsi256_ps(magicBits))), magicBits);
+	__m256i mantissaOdd = _mm256_and_si256(_mm256_srli_epi32(bits, 13), _mm256_set1_epi32(1));
+	__m256i normal = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32((int)0xC8000FFFu)), mantissaOdd), 13);
+	return _mm256_blendv_epi8(normal, subnormal, isSubnormal);
+}
+
+static inline __m128i SDL_TARGETING("avx2") PackHalvesAVX2(__m256i halves)
+{
+	return _mm_packs_epi32(_mm256_castsi256_si128(halves), _mm256_extracti128_si256(halves, 1));
+}
+
+static int SDL_TARGETING("avx2") ConvertRGBERowAVX2(const Uint8* planes, int width, Uint16* dst)
+{
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8)
+	{
+		__m256i e = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(planes + width * 3 + x)));
+		__m256i scaleBits = _mm256_slli_epi32(_mm256_sub_epi32(e, _mm256_set1_epi32(9)), 23);
+		__m256 scale = _mm256_castsi256_ps(_mm256_and_si256(scaleBits, _mm256_cmpgt_epi32(e, _mm256_set1_epi32(9))));
+
+		StoreRGBAHalfSSE2(
+			dst + x * 4,
+			PackHalvesAVX2(RGBEChannelToHalfAVX2(planes + x, scale)),
+			PackHalvesAVX2(RGBEChannelToHalfAVX2(planes + width + x, scale)),
+			PackHalvesAVX2(RGBEChannelToHalfAVX2(planes + width * 2 + x, scale))
+		);
+	}
+
+	return x;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+static inline float16x4_t RGBEChannelToHalfNEON(uint16x4_t mantissa, float32x4_t scale)
+{
+	float32x4_t value = vmulq_f32(vcvtq_f32_u32(vmovl_u16(mantissa)), scale);
+	return vcvt_f16_f32(vminq_f32(value, vdupq_n_f32(HDR_MAX_HALF)));
+}
+
+static inline float32x4_t RGBEScaleNEON(uint16x4_t exponent)
+{
+	uint32x4_t e = vmovl_u16(exponent);
+	uint32x4_t scaleBits = vshlq_n_u32(vsubq_u32(e, vdupq_n_u32(9)), 23);
+	return vreinterpretq_f32_u32(vandq_u32(scaleBits, vcgtq_u32(e, vdupq_n_u32(9))));
+}
+
+static int ConvertRGBERowNEON(const Uint8* planes, int width, Uint16* dst)
+{
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8)
+	{
+		uint16x8_t r = vmovl_u8(vld1_u8(planes + x));
+		uint16x8_t g = vmovl_u8(vld1_u8(planes + width + x));
+		uint16x8_t b = vmovl_u8(vld1_u8(planes + width * 2 + x));
+		uint16x8_t e = vmovl_u8(vld1_u8(planes + width * 3 + x));
+
+		float32x4_t scaleLow = RGBEScaleNEON(vget_low_u16(e));
+		float32x4_t scaleHigh = RGBEScaleNEON(vget_high_u16(e));
+
+		uint16x8x4_t rgba;
+		rgba.val[0] = vreinterpretq_u16_f16(vcombine_f16(RGBEChannelToHalfNEON(vget_low_u16(r), scaleLow), RGBEChannelToHalfNEON(vget_high_u16(r), scaleHigh)));
+		rgba.val[1] = vreinterpretq_u16_f16(vcombine_f16(RGBEChannelToHalfNEON(vget_low_u16(g), scaleLow), RGBEChannelToHalfNEON(vget_high_u16(g), scaleHigh)));
+		rgba.val[2] = vreinterpretq_u16_f16(vcombine_f16(RGBEChannelToHalfNEON(vget_low_u16(b), scaleLow), RGBEChannelToHalfNEON(vget_high_u16(b), scaleHigh)));
+		rgba.val[3] = vdupq_n_u16(HDR_HALF_ONE);
+		vst4q_u16(dst + x * 4, rgba);
+	}
+
+	return x;
+}
+#endif
+
+static void ConvertRGBERow(const Uint8* planes, int width, Uint16* dst)
+{
+	int converted = 0;
+
+#if defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+	converted = ConvertRGBERowNEON(planes, width, dst);
+#else
+#if defined(SDL_SSE2_INTRINSICS) && defined(SDL_AVX2_INTRINSICS)
+	if (SDL_HasAVX2())
+	{
+		converted = ConvertRGBERowAVX2(planes, width, dst);
+	}
+	else
+#endif
+	{
+#if defined(SDL_SSE2_INTRINSICS)
+		converted = ConvertRGBERowSSE2(planes, width, dst);
+#endif
+	}
+#endif
+
+	ConvertRGBERowScalar(planes, width, converted, dst);
+}
+
+static bool IsRLEScanline(const Uint8* src, const Uint8* end, int width)
+{
+	return width >= 8 && width < 32768 && end - src >= 4 &&
+		src[0] == 2 && src[1] == 2 && ((src[2] << 8) | src[3]) == width;
+}
+
+// Returns the start of the next scanline, or NULL if this one runs past the end of the file
+static const Uint8* SkipHDRScanline(const Uint8* src, const Uint8* end, int width)
+{
+	if (!IsRLEScanline(src, end, width))
+	{
+		return (end - src >= (ptrdiff_t)width * 4) ? src + width * 4 : NULL;
+	}
+
+	src += 4;
+	for (int channel = 0; channel < 4; channel += 1)
+	{
+		for (int x = 0; x < width;)
+		{
+			if (src >= end)
+			{
+				return NULL;
+			}
+
+			int count = *src++;
+			if (count > 128)
+			{
+				count -= 128;
+				src += 1;
+			}
+			else
+			{
+				src += count;
+			}
+
+			if (count == 0 || x + count > width || src > end)
+			{
+				return NULL;
+			}
+			x += count;
+		}
+	}
+
+	return src;
+}
+
+// Expands a scanline into four planes (R, G, B, E) of width bytes each
+static void ExpandHDRScanline(const Uint8* src, const Uint8* end, int width, Uint8* planes)
+{
+	if (!IsRLEScanline(src, end, width))
+	{
+		for (int x = 0; x < width; x += 1)
+		{
+			planes[x] = src[x * 4 + 0];
+			planes[width + x] = src[x * 4 + 1];
+			planes[width * 2 + x] = src[x * 4 + 2];
+			planes[width * 3 + x] = src[x * 4 + 3];
+		}
+		return;
+	}
+
+	src += 4;
+	for (int channel = 0; channel < 4; channel += 1)
+	{
+		Uint8* dst = planes + width * channel;
+		for (int x = 0; x < width;)
+		{
+			int count = *src++;
+			if (count > 128)
+			{
+				count -= 128;
+				SDL_memset(dst + x, *src++, count);
+			}
+			else
+			{
+				SDL_memcpy(dst + x, src, count);
+				src += count;
+			}
+			x += count;
+		}
+	}
+}
+
+typedef struct HDRDecodeBand
+{
+	const Uint8** Scanlines; // Height + 1 entries; the last marks the end of the data
+	int Width;
+	int FirstRow;
+	int RowCount;
+	Uint8* Planes; // Width * 4 bytes of scratch for one expanded scanline
+	Uint16* Pixels;
+} HDRDecodeBand;
+
+static int DecodeHDRBand(void* data)
+{
+	HDRDecodeBand* band = data;
+
+	for (int row = band->FirstRow; row < band->FirstRow + band->RowCount; row += 1)
+	{
+		ExpandHDRScanline(band->Scanlines[row], band->Scanlines[row + 1], band->Width, band->Planes);
+		ConvertRGBERow(band->Planes, band->Width, band->Pixels + (size_t)row * band->Width * 4);
+	}
+
+	return 0;
+}
+
+static const char* FindHDRLineEnd(const char* text, size_t offset, size_t size)
+{
+	for (; offset < size; offset += 1)
+	{
+		if (text[offset] == '\n')
+		{
+			return text + offset;
+		}
+	}
+	return NULL;
+}
+
+// Only the common "-Y height +X width" orientation of 32-bit_rle_rgbe is handled here
+static bool ParseHDRHeader(const Uint8* data, size_t size, int* pWidth, int* pHeight, size_t* pDataOffset)
+{
+	const char* text = (const char*)data;
+	size_t offset;
+
+	if (size >= 11 && SDL_memcmp(text, "#?RADIANCE\n", 11) == 0)
+	{
+		offset = 11;
+	}
+	else if (size >= 7 && SDL_memcmp(text, "#?RGBE\n", 7) == 0)
+	{
+		offset = 7;
+	}
+	else
+	{
+		return false;
+	}
+
+	// Header lines run until an empty one
+	while (offset < size && text[offset] != '\n')
+	{
+		const char* line = text + offset;
+		const char* lineEnd = FindHDRLineEnd(text, offset, size);
+		if (lineEnd == NULL)
+		{
+			return false;
+		}
+		if (lineEnd - line >= 7 && SDL_memcmp(line, "FORMAT=", 7) == 0 &&
+			!(lineEnd - line == 22 && SDL_memcmp(line, "FORMAT=32-bit_rle_rgbe", 22) == 0))
+		{
+			return false;
+		}
+		offset = lineEnd + 1 - text;
+	}
+	offset += 1;
+
+	const char* resolution = text + offset;
+	const char* resolutionEnd = FindHDRLineEnd(text, offset, size);
+	char line[64];
+	if (resolutionEnd == NULL || resolutionEnd - resolution >= (ptrdiff_t)sizeof(line))
+	{
+		return false;
+	}
+	SDL_memcpy(line, resolution, resolutionEnd - resolution);
+	line[resolutionEnd - resolution] = '\0';
+
+	if (SDL_sscanf(line, "-Y %d +X %d", pHeight, pWidth) != 2 ||
+		*pWidth <= 0 || *pHeight <= 0 || *pWidth > (1 << 24) || *pHeight > (1 << 24))
+	{
+		return false;
+	}
+
+	*pDataOffset = resolutionEnd + 1 - text;
+	return true;
+}
+
+static Uint16* DecodeHDRImageHalf(const Uint8* data, size_t size, int* pWidth, int* pHeight)
+{
+	int width, height;
+	size_t dataOffset;
+
+	if (!ParseHDRHeader(data, size, &width, &height, &dataOffset))
+	{
+		// Anything unusual goes through stb_image and gets converted afterwards
+		float* floats = stbi_loadf_from_memory(data, (int)size, &width, &height, NULL, 4);
+		if (floats == NULL)
+		{
+			SDL_Log("Failed to decode HDR image: %s", stbi_failure_reason());
+			return NULL;
+		}
+
+		Uint16* result = SDL_malloc((size_t)width * height * 4 * sizeof(Uint16));
+		if (result == NULL)
+		{
+			SDL_Log("Failed to allocate a %dx%d HDR image!", width, height);
+			stbi_image_free(floats);
+			return NULL;
+		}
+		ConvertFloatToHalf(floats, result, (size_t)width * height * 4);
+		stbi_image_free(floats);
+		*pWidth = width;
+		*pHeight = height;
+		return result;
+	}
+
+	const Uint8* end = data + size;
+	const Uint8** scanlines = SDL_malloc((height + 1) * sizeof(const Uint8*));
+	if (scanlines == NULL)
+	{
+		SDL_Log("Failed to allocate the scanline table for a %dx%d HDR image!", width, height);
+		return NULL;
+	}
+	scanlines[0] = data + dataOffset;
+	for (int row = 0; row < height; row += 1)
+	{
+		scanlines[row + 1] = SkipHDRScanline(scanlines[row], end, width);
+		if (scanlines[row + 1] == NULL)
+		{
+			SDL_Log("HDR image is truncated or corrupt at row %d!", row);
+			SDL_free(scanlines);
+			return NULL;
+		}
+	}
+
+	// Split the rows into one band per core, but keep bands big enough to be worth a thread
+	HDRDecodeBand bands[MAX_DECODE_THREADS];
+	SDL_Thread* threads[MAX_DECODE_THREADS];
+	int bandCount = SDL_clamp(SDL_min(SDL_GetNumLogicalCPUCores(), height / MIN_ROWS_PER_DECODE_THREAD), 1, MAX_DECODE_THREADS);
+
+	Uint16* pixels = SDL_malloc((size_t)width * height * 4 * sizeof(Uint16));
+	Uint8* planes = SDL_malloc((size_t)bandCount * width * 4);
+	if (pixels == NULL || planes == NULL)
+	{
+		SDL_Log("Failed to allocate a %dx%d HDR image!", width, height);
+		SDL_free(planes);
+		SDL_free(pixels);
+		SDL_free(scanlines);
+		return NULL;
+	}
+
+	for (int i = 0; i < bandCount; i += 1)
+	{
+		bands[i].Scanlines = scanlines;
+		bands[i].Width = width;
+		bands[i].FirstRow = height * i / bandCount;
+		bands[i].RowCount = height * (i + 1) / bandCount - bands[i].FirstRow;
+		bands[i].Planes = planes + (size_t)i * width * 4;
+		bands[i].Pixels = pixels;
+	}
+
+	// The calling thread takes the first band itself
+	for (int i = 1; i < bandCount; i += 1)
+	{
+		threads[i] = SDL_CreateThread(DecodeHDRBand, "HDRDecode", &bands[i]);
+		if (threads[i] == NULL)
+		{
+			DecodeHDRBand(&bands[i]);
+		}
+	}
+	DecodeHDRBand(&bands[0]);
+	for (int i = 1; i < bandCount; i += 1)
+	{
+		if (threads[i] != NULL)
+		{
+			SDL_WaitThread(threads[i], NULL);
+		}
+	}
+
+	SDL_free(planes);
+	SDL_free(scanlines);
+	*pWidth = width;
+	*pHeight = height;
+	return pixels;
+}
+
+Uint16* LoadHDRImageHalf(const char* imageFilename, int* pWidth, int* pHeight)
+{
+	char fullPath[256];
+	SDL_snprintf(fullPath, sizeof(fullPath), "Images/%s", imageFilename);
+
+	ArchivedAssetInfo info;
+	const void* archived = GetArchivedAsset(fullPath, &info);
+	if (archived != NULL && info.Type == ARCHIVEDASSET_HDR_IMAGE)
+	{
+		Uint16* result = SDL_malloc(info.Size / 2);
+		if (result != NULL)
+		{
+			ConvertFloatToHalf(archived, result, info.Size / sizeof(float));
+			*pWidth = info.Width;
+			*pHeight = info.Height;
+		}
+		return result;
+	}
+
+	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", SDL_GetBasePath(), imageFilename);
+
+	size_t fileSize;
+	void* fileData = SDL_LoadFile(fullPath, &fileSize);
+	if (fileData == NULL)
+	{
+		SDL_Log("Failed to load HDR image: %s", SDL_GetError());
+		return NULL;
+	}
+
+	Uint16* result = DecodeHDRImageHalf(fileData, fileSize, pWidth, pHeight);
+	SDL_free(fileData);
+	return result;
+}
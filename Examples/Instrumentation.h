@@ -0,0 +1,122 @@
+#ifndef SDL_GPU_EXAMPLES_INSTRUMENTATION_H
+#define SDL_GPU_EXAMPLES_INSTRUMENTATION_H
+
+// Instrumentation
+// Common.h includes this when SDL_GPU_EXAMPLES_INSTRUMENTATION is defined (the CMake option of
+// the same name). It redirects the SDL calls below to wrappers that take the same arguments and
+// record what they do before forwarding them, so the examples themselves stay plain SDL code.
+// The macros are variadic since create-infos are often compound literals, whose commas would
+// otherwise split them into several macro arguments. The wrappers reach SDL through the
+// parenthesized names, e.g. (SDL_CreateGPUBuffer)(...), which a function-like macro doesn't expand.
+
+#define INSTRUMENTATION_STRINGIFY(x) #x
+#define INSTRUMENTATION_SITE_LINE(line) INSTRUMENTATION_STRINGIFY(line)
+#define INSTRUMENTATION_SITE __FILE__ ":" INSTRUMENTATION_SITE_LINE(__LINE__)
+
+// GPU Memory Accounting, see GPUMemory.c
+SDL_GPUBuffer* CreateGPUBuffer(SDL_GPUDevice* device, const SDL_GPUBufferCreateInfo* createInfo, const char* site);
+SDL_GPUTexture* CreateGPUTexture(SDL_GPUDevice* device, const SDL_GPUTextureCreateInfo* createInfo, const char* site);
+SDL_GPUTransferBuffer* CreateGPUTransferBuffer(SDL_GPUDevice* device, const SDL_GPUTransferBufferCreateInfo* createInfo, const char* site);
+void ReleaseGPUBuffer(SDL_GPUDevice* device, SDL_GPUBuffer* buffer);
+void ReleaseGPUTexture(SDL_GPUDevice* device, SDL_GPUTexture* texture);
+void ReleaseGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer);
+
+#define SDL_CreateGPUBuffer(...) CreateGPUBuffer(__VA_ARGS__, INSTRUMENTATION_SITE)
+#define SDL_CreateGPUTexture(...) CreateGPUTexture(__VA_ARGS__, INSTRUMENTATION_SITE)
+#define SDL_CreateGPUTransferBuffer(...) CreateGPUTransferBuffer(__VA_ARGS__, INSTRUMENTATION_SITE)
+#define SDL_ReleaseGPUBuffer(...) ReleaseGPUBuffer(__VA_ARGS__)
+#define SDL_ReleaseGPUTexture(...) ReleaseGPUTexture(__VA_ARGS__)
+#define SDL_ReleaseGPUTransferBuffer(...) ReleaseGPUTransferBuffer(__VA_ARGS__)
+
+// Command Statistics, see CommandStats.c
+SDL_GPURenderPass* BeginGPURenderPass(
+	SDL_GPUCommandBuffer* commandBuffer,
+	const SDL_GPUColorTargetInfo* colorTargetInfos,
+	Uint32 numColorTargets,
+	const SDL_GPUDepthStencilTargetInfo* depthStencilTargetInfo
+);
+SDL_GPUComputePass* BeginGPUComputePass(
+	SDL_GPUCommandBuffer* commandBuffer,
+	const SDL_GPUStorageTextureReadWriteBinding* storageTextureBindings,
+	Uint32 numStorageTextureBindings,
+	const SDL_GPUStorageBufferReadWriteBinding* storageBufferBindings,
+	Uint32 numStorageBufferBindings
+);
+SDL_GPUCopyPass* BeginGPUCopyPass(SDL_GPUCommandBuffer* commandBuffer);
+// The passes are profile scopes from their begin to their end
+void EndGPURenderPass(SDL_GPURenderPass* renderPass);
+void EndGPUComputePass(SDL_GPUComputePass* computePass);
+void EndGPUCopyPass(SDL_GPUCopyPass* copyPass);
+void BindGPUGraphicsPipeline(SDL_GPURenderPass* renderPass, SDL_GPUGraphicsPipeline* pipeline);
+void BindGPUComputePipeline(SDL_GPUComputePass* computePass, SDL_GPUComputePipeline* pipeline);
+void BindGPUVertexBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUBufferBinding* bindings, Uint32 numBindings);
+void BindGPUIndexBuffer(SDL_GPURenderPass* renderPass, const SDL_GPUBufferBinding* binding, SDL_GPUIndexElementSize indexElementSize);
+void BindGPUVertexSamplers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings);
+void BindGPUFragmentSamplers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings);
+void BindGPUComputeSamplers(SDL_GPUComputePass* computePass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding* bindings, Uint32 numBindings);
+void BindGPUVertexStorageBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings);
+void BindGPUFragmentStorageBuffers(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings);
+void BindGPUComputeStorageBuffers(SDL_GPUComputePass* computePass, Uint32 firstSlot, SDL_GPUBuffer* const* storageBuffers, Uint32 numBindings);
+void BindGPUVertexStorageTextures(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings);
+void BindGPUFragmentStorageTextures(SDL_GPURenderPass* renderPass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings);
+void BindGPUComputeStorageTextures(SDL_GPUComputePass* computePass, Uint32 firstSlot, SDL_GPUTexture* const* storageTextures, Uint32 numBindings);
+void DrawGPUPrimitives(SDL_GPURenderPass* renderPass, Uint32 numVertices, Uint32 numInstances, Uint32 firstVertex, Uint32 firstInstance);
+void DrawGPUIndexedPrimitives(
+	SDL_GPURenderPass* renderPass,
+	Uint32 numIndices,
+	Uint32 numInstances,
+	Uint32 firstIndex,
+	Sint32 vertexOffset,
+	Uint32 firstInstance
+);
+void DrawGPUPrimitivesIndirect(SDL_GPURenderPass* renderPass, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 drawCount);
+void DrawGPUIndexedPrimitivesIndirect(SDL_GPURenderPass* renderPass, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 drawCount);
+void DispatchGPUCompute(SDL_GPUComputePass* computePass, Uint32 groupCountX, Uint32 groupCountY, Uint32 groupCountZ);
+void DispatchGPUComputeIndirect(SDL_GPUComputePass* computePass, SDL_GPUBuffer* buffer, Uint32 offset);
+void PushGPUVertexUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length);
+void PushGPUFragmentUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length);
+void PushGPUComputeUniformData(SDL_GPUCommandBuffer* commandBuffer, Uint32 slotIndex, const void* data, Uint32 length);
+void UploadToGPUBuffer(SDL_GPUCopyPass* copyPass, const SDL_GPUTransferBufferLocation* source, const SDL_GPUBufferRegion* destination, bool cycle);
+void UploadToGPUTexture(SDL_GPUCopyPass* copyPass, const SDL_GPUTextureTransferInfo* source, const SDL_GPUTextureRegion* destination, bool cycle);
+void BlitGPUTexture(SDL_GPUCommandBuffer* commandBuffer, const SDL_GPUBlitInfo* info);
+
+#define SDL_BeginGPURenderPass(...) BeginGPURenderPass(__VA_ARGS__)
+#define SDL_BeginGPUComputePass(...) BeginGPUComputePass(__VA_ARGS__)
+#define SDL_BeginGPUCopyPass(...) BeginGPUCopyPass(__VA_ARGS__)
+#define SDL_EndGPURenderPass(...) EndGPURenderPass(__VA_ARGS__)
+#define SDL_EndGPUComputePass(...) EndGPUComputePass(__VA_ARGS__)
+#define SDL_EndGPUCopyPass(...) EndGPUCopyPass(__VA_ARGS__)
+#define SDL_BindGPUGraphicsPipeline(...) BindGPUGraphicsPipeline(__VA_ARGS__)
+#define SDL_BindGPUComputePipeline(...) BindGPUComputePipeline(__VA_ARGS__)
+#define SDL_BindGPUVertexBuffers(...) BindGPUVertexBuffers(__VA_ARGS__)
+#define SDL_BindGPUIndexBuffer(...) BindGPUIndexBuffer(__VA_ARGS__)
+#define SDL_BindGPUVertexSamplers(...) BindGPUVertexSamplers(__VA_ARGS__)
+#define SDL_BindGPUFragmentSamplers(...) BindGPUFragmentSamplers(__VA_ARGS__)
+#define SDL_BindGPUComputeSamplers(...) BindGPUComputeSamplers(__VA_ARGS__)
+#define SDL_BindGPUVertexStorageBuffers(...) BindGPUVertexStorageBuffers(__VA_ARGS__)
+#define SDL_BindGPUFragmentStorageBuffers(...) BindGPUFragmentStorageBuffers(__VA_ARGS__)
+#define SDL_BindGPUComputeStorageBuffers(...) BindGPUComputeStorageBuffers(__VA_ARGS__)
+#define SDL_BindGPUVertexStorageTextures(...) BindGPUVertexStorageTextures(__VA_ARGS__)
+#define SDL_BindGPUFragmentStorageTextures(...) BindGPUFragmentStorageTextures(__VA_ARGS__)
+#define SDL_BindGPUComputeStorageTextures(...) BindGPUComputeStorageTextures(__VA_ARGS__)
+#define SDL_DrawGPUPrimitives(...) DrawGPUPrimitives(__VA_ARGS__)
+#define SDL_DrawGPUIndexedPrimitives(...) DrawGPUIndexedPrimitives(__VA_ARGS__)
+#define SDL_DrawGPUPrimitivesIndirect(...) DrawGPUPrimitivesIndirect(__VA_ARGS__)
+#define SDL_DrawGPUIndexedPrimitivesIndirect(...) DrawGPUIndexedPrimitivesIndirect(__VA_ARGS__)
+#define SDL_DispatchGPUCompute(...) DispatchGPUCompute(__VA_ARGS__)
+#define SDL_DispatchGPUComputeIndirect(...) DispatchGPUComputeIndirect(__VA_ARGS__)
+#define SDL_PushGPUVertexUniformData(...) PushGPUVertexUniformData(__VA_ARGS__)
+#define SDL_PushGPUFragmentUniformData(...) PushGPUFragmentUniformData(__VA_ARGS__)
+#define SDL_PushGPUComputeUniformData(...) PushGPUComputeUniformData(__VA_ARGS__)
+#define SDL_UploadToGPUBuffer(...) UploadToGPUBuffer(__VA_ARGS__)
+#define SDL_UploadToGPUTexture(...) UploadToGPUTexture(__VA_ARGS__)
+#define SDL_BlitGPUTexture(...) BlitGPUTexture(__VA_ARGS__)
+
+// Profiling, see Profiler.c
+void* MapGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer, bool cycle);
+void UnmapGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer);
+
+#define SDL_MapGPUTransferBuffer(...) MapGPUTransferBuffer(__VA_ARGS__)
+#define SDL_UnmapGPUTransferBuffer(...) UnmapGPUTransferBuffer(__VA_ARGS__)
+
+#endif
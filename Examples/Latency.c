@@ -28,18 +28,8 @@ static int Init(Context* context)
 	);
 
 	Uint32 byteCount = 8 * 32 * 4;
-	SDL_GPUTransferBuffer *textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = byteCount
-		}
-	);
-	Uint8* textureTransferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
+	StagingAllocation textureStaging;
+	Uint8* textureTransferData = MapStagingMemory(context->Device, byteCount, 0, &textureStaging);
 
 	SDL_Surface* imageData = LoadImage("latency.bmp", 4);
 	if (imageData == NULL)
@@ -50,14 +40,15 @@ static int Init(Context* context)
 	SDL_memcpy(textureTransferData, imageData->pixels, byteCount);
 	SDL_DestroySurface(imageData);
 
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	UnmapStagingMemory(context->Device, &textureStaging);
 
 	SDL_GPUCommandBuffer *cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdbuf);
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo){
-			.transfer_buffer = textureTransferBuffer
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset
 		},
 		&(SDL_GPUTextureRegion) {
 			.texture = LagTexture,
@@ -69,9 +60,7 @@ static int Init(Context* context)
 	);
 	SDL_EndGPUCopyPass(copyPass);
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
-
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, cmdbuf);
 
 	SDL_Log("Press Left/Right to toggle capturing the mouse cursor.");
 	SDL_Log("Press Down to change the number of allowed frames in flight.");
@@ -130,8 +119,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -192,7 +181,7 @@ static int Draw(Context* context)
 		}
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -0,0 +1,410 @@
+#include "Common.h"
+
+// Pipeline Registry
+// Pipelines are keyed on a canonical serialization of their create-info, so two
+// create-infos that describe the same state share one pipeline object.
+
+typedef struct PipelineKeyWriter
+{
+	Uint32* Words;
+	int Count;
+	int Capacity;
+	bool Failed; // Out of memory, the key is incomplete
+} PipelineKeyWriter;
+
+static void WriteKeyWord(PipelineKeyWriter* writer, Uint32 word)
+{
+	if (writer->Failed)
+	{
+		return;
+	}
+	if (writer->Count == writer->Capacity)
+	{
+		int capacity = SDL_max(writer->Capacity * 2, 64);
+		Uint32* words = SDL_realloc(writer->Words, capacity * sizeof(Uint32));
+		if (words == NULL)
+		{
+			writer->Failed = true;
+			return;
+		}
+		writer->Words = words;
+		writer->Capacity = capacity;
+	}
+	writer->Words[writer->Count++] = word;
+}
+
+static void WriteKeyPointer(PipelineKeyWriter* writer, const void* pointer)
+{
+	Uint64 value = (Uint64)(uintptr_t)pointer;
+	WriteKeyWord(writer, (Uint32)value);
+	WriteKeyWord(writer, (Uint32)(value >> 32));
+}
+
+static void WriteKeyFloat(PipelineKeyWriter* writer, float value)
+{
+	Uint32 word;
+	SDL_memcpy(&word, &value, sizeof(word));
+	WriteKeyWord(writer, word);
+}
+
+static void WriteKeyStencilState(PipelineKeyWriter* writer, const SDL_GPUStencilOpState* state)
+{
+	WriteKeyWord(writer, state->fail_op);
+	WriteKeyWord(writer, state->pass_op);
+	WriteKeyWord(writer, state->depth_fail_op);
+	WriteKeyWord(writer, state->compare_op);
+}
+
+static void WriteGraphicsPipelineKey(PipelineKeyWriter* writer, const SDL_GPUGraphicsPipelineCreateInfo* createInfo)
+{
+	WriteKeyPointer(writer, createInfo->vertex_shader);
+	WriteKeyPointer(writer, createInfo->fragment_shader);
+
+	const SDL_GPUVertexInputState* vertexInput = &createInfo->vertex_input_state;
+	WriteKeyWord(writer, vertexInput->num_vertex_buffers);
+	for (Uint32 i = 0; i < vertexInput->num_vertex_buffers; i += 1)
+	{
+		const SDL_GPUVertexBufferDescription* description = &vertexInput->vertex_buffer_descriptions[i];
+		WriteKeyWord(writer, description->slot);
+		WriteKeyWord(writer, description->pitch);
+		WriteKeyWord(writer, description->input_rate);
+		WriteKeyWord(writer, description->instance_step_rate);
+	}
+	WriteKeyWord(writer, vertexInput->num_vertex_attributes);
+	for (Uint32 i = 0; i < vertexInput->num_vertex_attributes; i += 1)
+	{
+		const SDL_GPUVertexAttribute* attribute = &vertexInput->vertex_attributes[i];
+		WriteKeyWord(writer, attribute->location);
+		WriteKeyWord(writer, attribute->buffer_slot);
+		WriteKeyWord(writer, attribute->format);
+		WriteKeyWord(writer, attribute->offset);
+	}
+
+	WriteKeyWord(writer, createInfo->primitive_type);
+
+	const SDL_GPURasterizerState* rasterizer = &createInfo->rasterizer_state;
+	WriteKeyWord(writer, rasterizer->fill_mode);
+	WriteKeyWord(writer, rasterizer->cull_mode);
+	WriteKeyWord(writer, rasterizer->front_face);
+	WriteKeyFloat(writer, rasterizer->depth_bias_constant_factor);
+	WriteKeyFloat(writer, rasterizer->depth_bias_clamp);
+	WriteKeyFloat(writer, rasterizer->depth_bias_slope_factor);
+	WriteKeyWord(writer, rasterizer->enable_depth_bias);
+	WriteKeyWord(writer, rasterizer->enable_depth_clip);
+
+	const SDL_GPUMultisampleState* multisample = &createInfo->multisample_state;
+	WriteKeyWord(writer, multisample->sample_count);
+	WriteKeyWord(writer, multisample->sample_mask);
+	WriteKeyWord(writer, multisample->enable_mask);
+	WriteKeyWord(writer, multisample->enable_alpha_to_coverage);
+
+	const SDL_GPUDepthStencilState* depthStencil = &createInfo->depth_stencil_state;
+	WriteKeyWord(writer, depthStencil->compare_op);
+	WriteKeyStencilState(writer, &depthStencil->back_stencil_state);
+	WriteKeyStencilState(writer, &depthStencil->front_stencil_state);
+	WriteKeyWord(writer, depthStencil->compare_mask);
+	WriteKeyWord(writer, depthStencil->write_mask);
+	WriteKeyWord(writer, depthStencil->enable_depth_test);
+	WriteKeyWord(writer, depthStencil->enable_depth_write);
+	WriteKeyWord(writer, depthStencil->enable_stencil_test);
+
+	const SDL_GPUGraphicsPipelineTargetInfo* targetInfo = &createInfo->target_info;
+	WriteKeyWord(writer, targetInfo->num_color_targets);
+	for (Uint32 i = 0; i < targetInfo->num_color_targets; i += 1)
+	{
+		const SDL_GPUColorTargetDescription* target = &targetInfo->color_target_descriptions[i];
+		WriteKeyWord(writer, target->format);
+		WriteKeyWord(writer, target->blend_state.src_color_blendfactor);
+		WriteKeyWord(writer, target->blend_state.dst_color_blendfactor);
+		WriteKeyWord(writer, target->blend_state.color_blend_op);
+		WriteKeyWord(writer, target->blend_state.src_alpha_blendfactor);
+		WriteKeyWord(writer, target->blend_state.dst_alpha_blendfactor);
+		WriteKeyWord(writer, target->blend_state.alpha_blend_op);
+		WriteKeyWord(writer, target->blend_state.color_write_mask);
+		WriteKeyWord(writer, target->blend_state.enable_blend);
+		WriteKeyWord(writer, target->blend_state.enable_color_write_mask);
+	}
+	WriteKeyWord(writer, targetInfo->depth_stencil_format);
+	WriteKeyWord(writer, targetInfo->has_depth_stencil_target);
+}
+
+static void WriteComputePipelineKey(PipelineKeyWriter* writer, const SDL_GPUComputePipelineCreateInfo* createInfo)
+{
+	// Bytecode comes from the resident blob cache, so its address identifies it
+	WriteKeyPointer(writer, createInfo->code);
+	WriteKeyWord(writer, (Uint32)createInfo->code_size);
+	WriteKeyWord(writer, createInfo->format);
+	WriteKeyWord(writer, createInfo->num_samplers);
+	WriteKeyWord(writer, createInfo->num_readonly_storage_textures);
+	WriteKeyWord(writer, createInfo->num_readonly_storage_buffers);
+	WriteKeyWord(writer, createInfo->num_readwrite_storage_textures);
+	WriteKeyWord(writer, createInfo->num_readwrite_storage_buffers);
+	WriteKeyWord(writer, createInfo->num_uniform_buffers);
+	WriteKeyWord(writer, createInfo->threadcount_x);
+	WriteKeyWord(writer, createInfo->threadcount_y);
+	WriteKeyWord(writer, createInfo->threadcount_z);
+}
+
+static Uint32 HashPipelineKey(const PipelineKeyWriter* writer)
+{
+	// FNV-1a
+	Uint32 hash = 2166136261u;
+	const Uint8* bytes = (const Uint8*)writer->Words;
+	for (size_t i = 0; i < writer->Count * sizeof(Uint32); i += 1)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+typedef struct PipelineRegistryEntry
+{
+	SDL_GPUDevice* Device;
+	bool IsCompute;
+	Uint32 Hash;
+	Uint32* Key;
+	int KeyLength;
+	void* Pipeline;
+	int RefCount;
+} PipelineRegistryEntry;
+
+static PipelineRegistryEntry* PipelineRegistry;
+static int PipelineRegistryCount;
+static int PipelineRegistryCapacity;
+static PipelineRegistryStats RegistryStats;
+
+// Open addressing on the key hash with linear probing. Each bucket holds an entry index + 1,
+// or 0 when empty; the bucket count is a power of two and stays at least twice the entry count.
+static int* PipelineBuckets;
+static int PipelineBucketCount;
+
+static void InsertPipelineBucket(int index)
+{
+	Uint32 mask = (Uint32)PipelineBucketCount - 1;
+	Uint32 slot = PipelineRegistry[index].Hash & mask;
+	while (PipelineBuckets[slot] != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	PipelineBuckets[slot] = index + 1;
+}
+
+static void RehashPipelineBuckets()
+{
+	SDL_memset(PipelineBuckets, 0, PipelineBucketCount * sizeof(int));
+	for (int i = 0; i < PipelineRegistryCount; i += 1)
+	{
+		InsertPipelineBucket(i);
+	}
+}
+
+static PipelineRegistryEntry* FindPipeline(SDL_GPUDevice* device, bool isCompute, const PipelineKeyWriter* key, Uint32 hash)
+{
+	if (PipelineBucketCount == 0)
+	{
+		return NULL;
+	}
+
+	Uint32 mask = (Uint32)PipelineBucketCount - 1;
+	for (Uint32 slot = hash & mask; PipelineBuckets[slot] != 0; slot = (slot + 1) & mask)
+	{
+		PipelineRegistryEntry* entry = &PipelineRegistry[PipelineBuckets[slot] - 1];
+		if (entry->Hash == hash &&
+			entry->Device == device &&
+			entry->IsCompute == isCompute &&
+			entry->KeyLength == key->Count &&
+			SDL_memcmp(entry->Key, key->Words, key->Count * sizeof(Uint32)) == 0)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static void RegisterPipeline(SDL_GPUDevice* device, bool isCompute, PipelineKeyWriter* key, Uint32 hash, void* pipeline)
+{
+	if (PipelineRegistryCount == PipelineRegistryCapacity)
+	{
+		int capacity = SDL_max(PipelineRegistryCapacity * 2, 16);
+		PipelineRegistryEntry* registry = SDL_realloc(PipelineRegistry, capacity * sizeof(PipelineRegistryEntry));
+		if (registry == NULL)
+		{
+			// Left unregistered, its release destroys it right away
+			SDL_free(key->Words);
+			return;
+		}
+		PipelineRegistry = registry;
+		PipelineRegistryCapacity = capacity;
+	}
+	if ((PipelineRegistryCount + 1) * 2 > PipelineBucketCount)
+	{
+		int bucketCount = SDL_max(PipelineBucketCount * 2, 32);
+		int* buckets = SDL_realloc(PipelineBuckets, bucketCount * sizeof(int));
+		if (buckets == NULL)
+		{
+			SDL_free(key->Words);
+			return;
+		}
+		PipelineBuckets = buckets;
+		PipelineBucketCount = bucketCount;
+		RehashPipelineBuckets();
+	}
+
+	// The entry takes ownership of the serialized key
+	PipelineRegistry[PipelineRegistryCount++] = (PipelineRegistryEntry) {
+		.Device = device,
+		.IsCompute = isCompute,
+		.Hash = hash,
+		.Key = key->Words,
+		.KeyLength = key->Count,
+		.Pipeline = pipeline,
+		.RefCount = 1
+	};
+	InsertPipelineBucket(PipelineRegistryCount - 1);
+	RegistryStats.LivePipelines += 1;
+}
+
+SDL_GPUGraphicsPipeline* AcquireGraphicsPipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* createInfo)
+{
+	// Properties can carry arbitrary extra state, so don't try to share those pipelines
+	if (createInfo->props != 0)
+	{
+		return SDL_CreateGPUGraphicsPipeline(device, createInfo);
+	}
+
+	PipelineKeyWriter key = { 0 };
+	WriteGraphicsPipelineKey(&key, createInfo);
+	if (key.Failed)
+	{
+		SDL_free(key.Words);
+		return SDL_CreateGPUGraphicsPipeline(device, createInfo);
+	}
+	Uint32 hash = HashPipelineKey(&key);
+
+	PipelineRegistryEntry* entry = FindPipeline(device, false, &key, hash);
+	if (entry != NULL)
+	{
+		SDL_free(key.Words);
+		RegistryStats.Hits += 1;
+		entry->RefCount += 1;
+		return entry->Pipeline;
+	}
+
+	RegistryStats.Misses += 1;
+	SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(device, createInfo);
+	if (pipeline == NULL)
+	{
+		SDL_free(key.Words);
+		return NULL;
+	}
+
+	RegisterPipeline(device, false, &key, hash, pipeline);
+	return pipeline;
+}
+
+SDL_GPUComputePipeline* AcquireComputePipeline(SDL_GPUDevice* device, const SDL_GPUComputePipelineCreateInfo* createInfo)
+{
+	if (createInfo->props != 0)
+	{
+		return SDL_CreateGPUComputePipeline(device, createInfo);
+	}
+
+	PipelineKeyWriter key = { 0 };
+	WriteComputePipelineKey(&key, createInfo);
+	if (key.Failed)
+	{
+		SDL_free(key.Words);
+		return SDL_CreateGPUComputePipeline(device, createInfo);
+	}
+	Uint32 hash = HashPipelineKey(&key);
+
+	PipelineRegistryEntry* entry = FindPipeline(device, true, &key, hash);
+	if (entry != NULL)
+	{
+		SDL_free(key.Words);
+		RegistryStats.Hits += 1;
+		entry->RefCount += 1;
+		return entry->Pipeline;
+	}
+
+	RegistryStats.Misses += 1;
+	SDL_GPUComputePipeline* pipeline = SDL_CreateGPUComputePipeline(device, createInfo);
+	if (pipeline == NULL)
+	{
+		SDL_free(key.Words);
+		return NULL;
+	}
+
+	RegisterPipeline(device, true, &key, hash, pipeline);
+	return pipeline;
+}
+
+static bool ReleaseRegisteredPipeline(SDL_GPUDevice* device, void* pipeline)
+{
+	for (int i = 0; i < PipelineRegistryCount; i += 1)
+	{
+		if (PipelineRegistry[i].Device == device && PipelineRegistry[i].Pipeline == pipeline)
+		{
+			// Stays resident (prewarmed) until the device goes away
+			SDL_assert(PipelineRegistry[i].RefCount > 0);
+			PipelineRegistry[i].RefCount -= 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ReleaseGraphicsPipeline(SDL_GPUDevice* device, SDL_GPUGraphicsPipeline* pipeline)
+{
+	if (!ReleaseRegisteredPipeline(device, pipeline))
+	{
+		SDL_ReleaseGPUGraphicsPipeline(device, pipeline);
+	}
+}
+
+void ReleaseComputePipeline(SDL_GPUDevice* device, SDL_GPUComputePipeline* pipeline)
+{
+	if (!ReleaseRegisteredPipeline(device, pipeline))
+	{
+		SDL_ReleaseGPUComputePipeline(device, pipeline);
+	}
+}
+
+void ReleasePipelineRegistry(SDL_GPUDevice* device)
+{
+	int kept = 0;
+	for (int i = 0; i < PipelineRegistryCount; i += 1)
+	{
+		PipelineRegistryEntry* entry = &PipelineRegistry[i];
+		if (entry->Device != device)
+		{
+			PipelineRegistry[kept++] = *entry;
+			continue;
+		}
+
+		if (entry->RefCount > 0)
+		{
+			SDL_Log("Pipeline %p still has %d reference(s) at device teardown!", entry->Pipeline, entry->RefCount);
+		}
+		if (entry->IsCompute)
+		{
+			SDL_ReleaseGPUComputePipeline(device, entry->Pipeline);
+		}
+		else
+		{
+			SDL_ReleaseGPUGraphicsPipeline(device, entry->Pipeline);
+		}
+		SDL_free(entry->Key);
+		RegistryStats.LivePipelines -= 1;
+	}
+	PipelineRegistryCount = kept;
+	if (PipelineBucketCount > 0)
+	{
+		RehashPipelineBuckets();
+	}
+}
+
+PipelineRegistryStats GetPipelineRegistryStats()
+{
+	return RegistryStats;
+}
@@ -0,0 +1,190 @@
+#include "Common.h"
+
+// Profiling
+// A scope's start is kept on its thread's stack of open scopes until PROFILE_END, and only then
+// is the finished scope written to the thread's ring, so the ring never holds a half-open scope
+// that the trace would have to match up. Rings are created on a thread's first scope and stay
+// registered until QuitProfiler, so threads that have already exited still show in the trace.
+
+typedef struct ProfileScope
+{
+	const char* Name;
+	Uint64 Start;
+	Uint64 End;
+} ProfileScope;
+
+typedef struct ProfileRing
+{
+	SDL_ThreadID ThreadID;
+	ProfileScope Scopes[PROFILE_RING_SIZE];
+	Uint64 Count; // Every scope recorded, the ring holds the most recent PROFILE_RING_SIZE
+	ProfileScope Open[PROFILE_MAX_DEPTH];
+	int Depth; // Can exceed PROFILE_MAX_DEPTH, scopes that deep aren't recorded
+	struct ProfileRing* Next;
+} ProfileRing;
+
+bool ProfilingEnabled = false;
+static Uint64 ProfileEpoch;
+static SDL_TLSID ProfileRingSlot;
+static SDL_SpinLock ProfileRingLock;
+static ProfileRing* ProfileRings;
+
+void SetProfilingEnabled(bool enabled)
+{
+	if (enabled && ProfileEpoch == 0)
+	{
+		ProfileEpoch = SDL_GetPerformanceCounter();
+	}
+	ProfilingEnabled = enabled;
+}
+
+static ProfileRing* GetProfileRing()
+{
+	ProfileRing* ring = SDL_GetTLS(&ProfileRingSlot);
+	if (ring == NULL)
+	{
+		ring = SDL_calloc(1, sizeof(ProfileRing));
+		if (ring == NULL)
+		{
+			return NULL;
+		}
+		ring->ThreadID = SDL_GetCurrentThreadID();
+
+		SDL_LockSpinlock(&ProfileRingLock);
+		ring->Next = ProfileRings;
+		ProfileRings = ring;
+		SDL_UnlockSpinlock(&ProfileRingLock);
+
+		SDL_SetTLS(&ProfileRingSlot, ring, NULL);
+	}
+	return ring;
+}
+
+void BeginProfileScope(const char* name)
+{
+	ProfileRing* ring = GetProfileRing();
+	if (ring == NULL)
+	{
+		return;
+	}
+
+	if (ring->Depth < PROFILE_MAX_DEPTH)
+	{
+		ring->Open[ring->Depth].Name = name;
+		ring->Open[ring->Depth].Start = SDL_GetPerformanceCounter();
+	}
+	ring->Depth += 1;
+}
+
+void EndProfileScope()
+{
+	Uint64 end = SDL_GetPerformanceCounter();
+	ProfileRing* ring = SDL_GetTLS(&ProfileRingSlot);
+
+	// Profiling may have been enabled while the scope was already open
+	if (ring == NULL || ring->Depth == 0)
+	{
+		return;
+	}
+
+	ring->Depth -= 1;
+	if (ring->Depth < PROFILE_MAX_DEPTH)
+	{
+		ProfileScope* scope = &ring->Scopes[ring->Count % PROFILE_RING_SIZE];
+		*scope = ring->Open[ring->Depth];
+		scope->End = end;
+		ring->Count += 1;
+	}
+}
+
+static double ProfileMicroseconds(Uint64 counter)
+{
+	return (double) (counter - ProfileEpoch) * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+bool WriteProfileTrace(const char* filename)
+{
+	SDL_IOStream* file = SDL_IOFromFile(filename, "w");
+	if (file == NULL)
+	{
+		SDL_Log("Could not open %s: %s", filename, SDL_GetError());
+		return false;
+	}
+
+	Uint64 scopeCount = 0;
+	Uint64 droppedCount = 0;
+	bool first = true;
+
+	SDL_LockSpinlock(&ProfileRingLock);
+	SDL_IOprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	for (ProfileRing* ring = ProfileRings; ring != NULL; ring = ring->Next)
+	{
+		// Complete ("X") events nest by time, which the viewers draw as a flame graph per thread
+		Uint64 count = SDL_min(ring->Count, PROFILE_RING_SIZE);
+		for (Uint64 i = ring->Count - count; i < ring->Count; i += 1)
+		{
+			const ProfileScope* scope = &ring->Scopes[i % PROFILE_RING_SIZE];
+			SDL_IOprintf(
+				file,
+				"%s\n{\"name\":\"%s\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":%" SDL_PRIu64 ",\"ts\":%.3f,\"dur\":%.3f}",
+				first ? "" : ",",
+				scope->Name,
+				(Uint64) ring->ThreadID,
+				ProfileMicroseconds(scope->Start),
+				ProfileMicroseconds(scope->End) - ProfileMicroseconds(scope->Start)
+			);
+			first = false;
+		}
+		scopeCount += count;
+		droppedCount += ring->Count - count;
+	}
+	SDL_UnlockSpinlock(&ProfileRingLock);
+	SDL_IOprintf(file, "\n]}\n");
+
+	if (!SDL_CloseIO(file))
+	{
+		SDL_Log("Could not write %s: %s", filename, SDL_GetError());
+		return false;
+	}
+
+	SDL_Log("Wrote %" SDL_PRIu64 " profile scopes to %s", scopeCount, filename);
+	if (droppedCount > 0)
+	{
+		SDL_Log("%" SDL_PRIu64 " older scopes were overwritten, the trace only covers the end of the run", droppedCount);
+	}
+	return true;
+}
+
+void QuitProfiler()
+{
+	ProfilingEnabled = false;
+
+	SDL_LockSpinlock(&ProfileRingLock);
+	ProfileRing* ring = ProfileRings;
+	ProfileRings = NULL;
+	SDL_UnlockSpinlock(&ProfileRingLock);
+
+	while (ring != NULL)
+	{
+		ProfileRing* next = ring->Next;
+		SDL_free(ring);
+		ring = next;
+	}
+	SDL_SetTLS(&ProfileRingSlot, NULL, NULL);
+	ProfileEpoch = 0;
+}
+
+void* MapGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer, bool cycle)
+{
+	PROFILE_BEGIN("Map Transfer Buffer");
+	void* data = (SDL_MapGPUTransferBuffer)(device, transferBuffer, cycle);
+	PROFILE_END();
+	return data;
+}
+
+void UnmapGPUTransferBuffer(SDL_GPUDevice* device, SDL_GPUTransferBuffer* transferBuffer)
+{
+	PROFILE_BEGIN("Unmap Transfer Buffer");
+	(SDL_UnmapGPUTransferBuffer)(device, transferBuffer);
+	PROFILE_END();
+}
@@ -1,54 +1,205 @@
 #include "Common.h"
 
 static SDL_GPUGraphicsPipeline* RenderPipeline;
+static SDL_GPUGraphicsPipeline* CompactRenderPipeline;
 static SDL_GPUSampler* Sampler;
 static SDL_GPUTexture* Texture;
 static SDL_GPUTransferBuffer* SpriteDataTransferBuffer;
 static SDL_GPUBuffer* SpriteDataBuffer;
+static FrameRing SpriteDataRing;
+static SDL_GPUBuffer* AtlasRegionBuffer;
+static SpriteSimulation Simulation;
+
+static Uint32 SpriteCount = 8192;
+static bool UseFrameRing = true;
+static PullSpriteSource SpriteSource = PULLSPRITESOURCE_CPU;
+static bool SimulationAvailable = true; // Until SpriteSimulate.comp fails to load
+
+// The four ravioli in the atlas as { u, v, width, height }, indexed by CompactSpriteInstance.region
+static const float AtlasRegions[4][4] = {
+	{ 0.0f, 0.0f, 0.5f, 0.5f },
+	{ 0.5f, 0.0f, 0.5f, 0.5f },
+	{ 0.0f, 0.5f, 0.5f, 0.5f },
+	{ 0.5f, 0.5f, 0.5f, 0.5f }
+};
+
+void SetPullSpriteBatchMode(Uint32 spriteCount, bool useFrameRing, PullSpriteSource source)
+{
+	SpriteCount = spriteCount;
+	UseFrameRing = useFrameRing;
+	SpriteSource = source;
+}
 
-typedef struct SpriteInstance
+FrameRingStats GetPullSpriteBatchRingStats()
 {
-	float x, y, z;
-	float rotation;
-	float w, h, padding_a, padding_b;
-	float tex_u, tex_v, tex_w, tex_h;
-	float r, g, b, a;
-} SpriteInstance;
+	return SpriteDataRing.Stats;
+}
 
-static const Uint32 SPRITE_COUNT = 8192;
+SpriteSimulationStats GetPullSpriteBatchSimulationStats()
+{
+	return Simulation.Stats;
+}
 
-static int Init(Context* context)
+PullSpriteSource GetPullSpriteBatchSource()
 {
-	int result = CommonInit(context, 0);
-	if (result < 0)
+	return SpriteSource;
+}
+
+static Uint32 GetSpriteDataSize()
+{
+	return SpriteCount * (SpriteSource == PULLSPRITESOURCE_CPU_COMPACT ? sizeof(CompactSpriteInstance) : sizeof(SpriteInstance));
+}
+
+static void LogSpriteMode()
+{
+	if (SpriteSource == PULLSPRITESOURCE_GPU_SIMULATION)
 	{
-		return result;
+		SDL_Log("Sprite mode: GPU simulation, uploading spawns only");
+		return;
 	}
 
-	SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
-	if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_IMMEDIATE
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+	SDL_Log(
+		"Sprite mode: %s upload, %s instances",
+		UseFrameRing ? "frame ring" : "cycle",
+		SpriteSource == PULLSPRITESOURCE_CPU_COMPACT ? "16-byte compact" : "64-byte"
+	);
+}
+
+static bool IsSpriteSourceAvailable(PullSpriteSource source)
+{
+	return (source != PULLSPRITESOURCE_CPU_COMPACT || CompactRenderPipeline != NULL) &&
+		(source != PULLSPRITESOURCE_GPU_SIMULATION || SimulationAvailable);
+}
+
+static Uint32 FrameSeed;
+
+static SpriteBuildInfo GetSpriteBuildInfo()
+{
+	return (SpriteBuildInfo){
+		.Seed = FrameSeed++,
+		.AreaWidth = 640,
+		.AreaHeight = 480,
+		.SpriteSize = 32
+	};
+}
+
+static bool CreateSpriteData(Context* context)
+{
+	if (SpriteSource == PULLSPRITESOURCE_GPU_SIMULATION)
+	{
+		// The whole crowd is uploaded once, with the first update
+		if (CreateSpriteSimulation(&Simulation, context->Device, SpriteCount))
+		{
+			SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+			SpawnRandomSprites(&Simulation, SpriteCount, &buildInfo);
+			return true;
+		}
+
+		// Like the compact shaders, the simulation shader may not have been compiled yet
+		SDL_Log("The GPU sprite simulation is unavailable, run compile.sh to build SpriteSimulate.comp. Using CPU-built sprites.");
+		SimulationAvailable = false;
+		SpriteSource = PULLSPRITESOURCE_CPU;
 	}
-	else if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_MAILBOX
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+
+	if (UseFrameRing)
+	{
+		// One region per frame in flight, so the backend never has to cycle behind our back
+		return CreateFrameRing(
+			&SpriteDataRing,
+			context->Device,
+			GetSpriteDataSize(),
+			SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			2
+		);
 	}
 
-	SDL_SetGPUSwapchainParameters(
+	SpriteDataTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = GetSpriteDataSize()
+		}
+	);
+
+	SpriteDataBuffer = SDL_CreateGPUBuffer(
 		context->Device,
-		context->Window,
-		SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
-		presentMode
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			.size = GetSpriteDataSize()
+		}
 	);
 
-	SDL_srand(0);
+	return SpriteDataTransferBuffer != NULL && SpriteDataBuffer != NULL;
+}
+
+static void ReleaseSpriteData(Context* context)
+{
+	if (Simulation.Device != NULL)
+	{
+		SpriteSimulationStats stats = Simulation.Stats;
+		SDL_Log(
+			"Sprite simulation: %" SDL_PRIu64 " steps, %" SDL_PRIu64 " spawned, %" SDL_PRIu64 " despawned, %" SDL_PRIu64 " bytes uploaded",
+			stats.Steps,
+			stats.Spawned,
+			stats.Despawned,
+			stats.UploadedBytes
+		);
+		ReleaseSpriteSimulation(&Simulation);
+	}
+
+	if (SpriteDataRing.Device != NULL)
+	{
+		FrameRingStats stats = SpriteDataRing.Stats;
+		SDL_Log(
+			"Sprite ring: %" SDL_PRIu64 " frames, %d stall(s) (%.2f ms), %" SDL_PRIu64 " bytes",
+			stats.Frames,
+			stats.Stalls,
+			stats.StallMilliseconds,
+			stats.MemoryBytes
+		);
+		ReleaseFrameRing(&SpriteDataRing);
+	}
+
+	SDL_ReleaseGPUTransferBuffer(context->Device, SpriteDataTransferBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, SpriteDataBuffer);
+	SpriteDataTransferBuffer = NULL;
+	SpriteDataBuffer = NULL;
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Offscreen rendering has no swapchain to configure
+	if (!context->Headless)
+	{
+		SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
+		if (SDL_WindowSupportsGPUPresentMode(
+			context->Device,
+			context->Window,
+			SDL_GPU_PRESENTMODE_IMMEDIATE
+		)) {
+			presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+		}
+		else if (SDL_WindowSupportsGPUPresentMode(
+			context->Device,
+			context->Window,
+			SDL_GPU_PRESENTMODE_MAILBOX
+		)) {
+			presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+		}
+
+		SDL_SetGPUSwapchainParameters(
+			context->Device,
+			context->Window,
+			SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
+			presentMode
+		);
+	}
 
 	// Create the shaders
 	SDL_GPUShader* vertShader = LoadShader(
@@ -60,6 +211,15 @@ static int Init(Context* context)
 		0
 	);
 
+	SDL_GPUShader* compactVertShader = LoadShader(
+		context->Device,
+		"PullSpriteBatchCompact.vert",
+		0,
+		1,
+		2,
+		0
+	);
+
 	SDL_GPUShader* fragShader = LoadShader(
 		context->Device,
 		"TexturedQuadColor.frag",
@@ -69,33 +229,44 @@ static int Init(Context* context)
 		0
 	);
 
-	// Create the sprite render pipeline
-	RenderPipeline = SDL_CreateGPUGraphicsPipeline(
-		context->Device,
-		&(SDL_GPUGraphicsPipelineCreateInfo){
-			.target_info = (SDL_GPUGraphicsPipelineTargetInfo){
-				.num_color_targets = 1,
-				.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
-					.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
-					.blend_state = {
-						.enable_blend = true,
-						.color_blend_op = SDL_GPU_BLENDOP_ADD,
-						.alpha_blend_op = SDL_GPU_BLENDOP_ADD,
-						.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
-						.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
-						.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
-						.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
-					}
-				}}
-			},
-			.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
-			.vertex_shader = vertShader,
-			.fragment_shader = fragShader
-		}
-	);
+	// Create the sprite render pipelines, which only differ in how the vertex shader reads instances
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = (SDL_GPUGraphicsPipelineTargetInfo){
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = GetFrameTextureFormat(context->Device, context->Window),
+				.blend_state = {
+					.enable_blend = true,
+					.color_blend_op = SDL_GPU_BLENDOP_ADD,
+					.alpha_blend_op = SDL_GPU_BLENDOP_ADD,
+					.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+					.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+				}
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertShader,
+		.fragment_shader = fragShader
+	};
+	RenderPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
+
+	// The compact variant is optional until its shader has been compiled for every backend
+	if (compactVertShader != NULL)
+	{
+		pipelineCreateInfo.vertex_shader = compactVertShader;
+		CompactRenderPipeline = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		ReleaseShader(context->Device, compactVertShader);
+	}
+	if (CompactRenderPipeline == NULL && SpriteSource == PULLSPRITESOURCE_CPU_COMPACT)
+	{
+		SDL_Log("Compact sprite shaders are unavailable, run compile.sh to build them. Using 64-byte instances.");
+		SpriteSource = PULLSPRITESOURCE_CPU;
+	}
 
-	SDL_ReleaseGPUShader(context->Device, vertShader);
-	SDL_ReleaseGPUShader(context->Device, fragShader);
+	ReleaseShader(context->Device, vertShader);
+	ReleaseShader(context->Device, fragShader);
 
 	// Load the image data
 	SDL_Surface *imageData = LoadImage("ravioli_atlas.bmp", 4);
@@ -105,28 +276,37 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
+	// Block-compress the atlas when -compresstextures is passed and the device supports it
+	SDL_GPUTextureFormat textureFormat = SelectImageTextureFormat(context->Device, imageData);
+	const void* texturePixels = imageData->pixels;
+	Uint32 textureLength = imageData->w * imageData->h * 4;
+	void* encodedPixels = NULL;
+	if (textureFormat != SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM)
+	{
+		encodedPixels = EncodeImage(imageData, textureFormat, &textureLength);
+		if (encodedPixels != NULL)
+		{
+			texturePixels = encodedPixels;
 		}
-	);
+		else
+		{
+			textureFormat = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+			textureLength = imageData->w * imageData->h * 4;
+		}
+	}
 
-	Uint8 *textureTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
-	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+	StagingAllocation textureStaging;
+	Uint8 *textureTransferPtr = MapStagingMemory(context->Device, textureLength, 0, &textureStaging);
+	SDL_memcpy(textureTransferPtr, texturePixels, textureLength);
+	UnmapStagingMemory(context->Device, &textureStaging);
+	SDL_free(encodedPixels);
 
 	// Create the GPU resources
 	Texture = SDL_CreateGPUTexture(
 		context->Device,
 		&(SDL_GPUTextureCreateInfo){
 			.type = SDL_GPU_TEXTURETYPE_2D,
-			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.format = textureFormat,
 			.width = imageData->w,
 			.height = imageData->h,
 			.layer_count_or_depth = 1,
@@ -147,22 +327,25 @@ static int Init(Context* context)
 		}
 	);
 
-	SpriteDataTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = SPRITE_COUNT * sizeof(SpriteInstance)
-		}
-	);
-
-	SpriteDataBuffer = SDL_CreateGPUBuffer(
+	AtlasRegionBuffer = SDL_CreateGPUBuffer(
 		context->Device,
 		&(SDL_GPUBufferCreateInfo) {
 			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
-			.size = SPRITE_COUNT * sizeof(SpriteInstance)
+			.size = sizeof(AtlasRegions)
 		}
 	);
 
+	StagingAllocation regionStaging;
+	void* regionTransferPtr = MapStagingMemory(context->Device, sizeof(AtlasRegions), 0, &regionStaging);
+	SDL_memcpy(regionTransferPtr, AtlasRegions, sizeof(AtlasRegions));
+	UnmapStagingMemory(context->Device, &regionStaging);
+
+	if (!CreateSpriteData(context))
+	{
+		SDL_Log("Could not create sprite data!");
+		return -1;
+	}
+
 	// Transfer the up-front data
 	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
@@ -170,8 +353,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = textureTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
+			.transfer_buffer = textureStaging.TransferBuffer,
+			.offset = textureStaging.Offset, /* Zeroes out the rest */
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
@@ -182,23 +365,57 @@ static int Init(Context* context)
 		false
 	);
 
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = regionStaging.TransferBuffer,
+			.offset = regionStaging.Offset
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = AtlasRegionBuffer,
+			.offset = 0,
+			.size = sizeof(AtlasRegions)
+		},
+		false
+	);
+
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	SDL_DestroySurface(imageData);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+
+	SDL_Log("Press Left/Right to switch between the frame ring and cycled buffer uploads");
+	SDL_Log("Press Up/Down to switch between 64-byte, 16-byte compact and GPU-simulated sprites");
+	LogSpriteMode();
 
 	return 0;
 }
 
 static int Update(Context* context)
 {
+	int sourceStep = context->UpPressed ? 1 : context->DownPressed ? PULLSPRITESOURCE_COUNT - 1 : 0;
+	bool toggleRing = context->LeftPressed || context->RightPressed;
+	if (toggleRing || sourceStep != 0)
+	{
+		// Every mode has its own buffers
+		ReleaseSpriteData(context);
+		UseFrameRing ^= toggleRing;
+		// CPU-built sprites are always available, so this stops
+		do
+		{
+			SpriteSource = (SpriteSource + sourceStep) % PULLSPRITESOURCE_COUNT;
+		} while (!IsSpriteSourceAvailable(SpriteSource));
+		if (!CreateSpriteData(context))
+		{
+			SDL_Log("Could not create sprite data!");
+			return -1;
+		}
+		LogSpriteMode();
+	}
+
 	return 0;
 }
 
-static float uCoords[4] = { 0.0f, 0.5f, 0.0f, 0.5f };
-static float vCoords[4] = { 0.0f, 0.0f, 0.5f, 0.5f };
-
 static int Draw(Context* context)
 {
 	Matrix4x4 cameraMatrix = Matrix4x4_CreateOrthographicOffCenter(
@@ -218,57 +435,84 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdBuf, context->Window, &swapchainTexture, NULL, NULL)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdBuf, context->Window, &swapchainTexture, NULL, NULL)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
-	if (swapchainTexture != NULL)
+	// The simulation keeps running while there is nothing to draw to, replacing a few sprites
+	// every frame so that spawns and despawns are part of the cost
+	bool useSimulation = SpriteSource == PULLSPRITESOURCE_GPU_SIMULATION;
+	if (useSimulation)
 	{
-		// Build sprite instance transfer
-		SpriteInstance* dataPtr = SDL_MapGPUTransferBuffer(
-			context->Device,
-			SpriteDataTransferBuffer,
-			true
-		);
-
-		for (Uint32 i = 0; i < SPRITE_COUNT; i += 1)
+		for (Uint32 i = 0; i < SpriteCount / 256; i += 1)
 		{
-			Sint32 ravioli = SDL_rand(4);
-			dataPtr[i].x = (float)(SDL_rand(640));
-			dataPtr[i].y = (float)(SDL_rand(480));
-			dataPtr[i].z = 0;
-			dataPtr[i].rotation = SDL_randf() * SDL_PI_F * 2;
-			dataPtr[i].w = 32;
-			dataPtr[i].h = 32;
-			dataPtr[i].tex_u = uCoords[ravioli];
-			dataPtr[i].tex_v = vCoords[ravioli];
-			dataPtr[i].tex_w = 0.5f;
-			dataPtr[i].tex_h = 0.5f;
-			dataPtr[i].r = 1.0f;
-			dataPtr[i].g = 1.0f;
-			dataPtr[i].b = 1.0f;
-			dataPtr[i].a = 1.0f;
+			DespawnSprite(&Simulation, SDL_rand(Simulation.Count));
 		}
+		SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+		SpawnRandomSprites(&Simulation, SpriteCount / 256, &buildInfo);
+		UpdateSpriteSimulation(&Simulation, cmdBuf, context->DeltaTime, 640, 480);
+	}
 
-		SDL_UnmapGPUTransferBuffer(context->Device, SpriteDataTransferBuffer);
-
-		// Upload instance data
-		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
-		SDL_UploadToGPUBuffer(
-			copyPass,
-			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = SpriteDataTransferBuffer,
-				.offset = 0
-			},
-			&(SDL_GPUBufferRegion) {
-				.buffer = SpriteDataBuffer,
-				.offset = 0,
-				.size = SPRITE_COUNT * sizeof(SpriteInstance)
-			},
-			true
-		);
-		SDL_EndGPUCopyPass(copyPass);
+	bool useCompactSprites = SpriteSource == PULLSPRITESOURCE_CPU_COMPACT;
+	bool useFrameRing = UseFrameRing && !useSimulation;
+	if (swapchainTexture != NULL)
+	{
+		SDL_GPUBuffer* spriteDataBuffer = SpriteDataBuffer;
+		Uint32 spriteCount = SpriteCount;
+		if (useSimulation)
+		{
+			// The simulated sprites are already on the GPU
+			spriteDataBuffer = Simulation.InstanceBuffer;
+			spriteCount = Simulation.Count;
+		}
+		else
+		{
+			// Build sprite instance transfer
+			void* dataPtr = useFrameRing ?
+				MapFrameRing(&SpriteDataRing) :
+				SDL_MapGPUTransferBuffer(context->Device, SpriteDataTransferBuffer, true);
+			if (dataPtr == NULL)
+			{
+				SubmitCommandBuffer(cmdBuf);
+				return -1;
+			}
+
+			SpriteBuildInfo buildInfo = GetSpriteBuildInfo();
+			if (useCompactSprites)
+			{
+				BuildCompactSprites(dataPtr, SpriteCount, &buildInfo);
+			}
+			else
+			{
+				BuildSprites(dataPtr, SpriteCount, &buildInfo);
+			}
+
+			// Upload instance data
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+			if (useFrameRing)
+			{
+				spriteDataBuffer = UploadFrameRing(&SpriteDataRing, copyPass, GetSpriteDataSize());
+			}
+			else
+			{
+				SDL_UnmapGPUTransferBuffer(context->Device, SpriteDataTransferBuffer);
+				SDL_UploadToGPUBuffer(
+					copyPass,
+					&(SDL_GPUTransferBufferLocation) {
+						.transfer_buffer = SpriteDataTransferBuffer,
+						.offset = 0
+					},
+					&(SDL_GPUBufferRegion) {
+						.buffer = SpriteDataBuffer,
+						.offset = 0,
+						.size = GetSpriteDataSize()
+					},
+					true
+				);
+			}
+			SDL_EndGPUCopyPass(copyPass);
+		}
 
 		// Render sprites
 		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
@@ -284,12 +528,12 @@ static int Draw(Context* context)
 			NULL
 		);
 
-		SDL_BindGPUGraphicsPipeline(renderPass, RenderPipeline);
+		SDL_BindGPUGraphicsPipeline(renderPass, useCompactSprites ? CompactRenderPipeline : RenderPipeline);
 		SDL_BindGPUVertexStorageBuffers(
 			renderPass,
 			0,
-			&SpriteDataBuffer,
-			1
+			(SDL_GPUBuffer*[]){ spriteDataBuffer, AtlasRegionBuffer },
+			useCompactSprites ? 2 : 1
 		);
 		SDL_BindGPUFragmentSamplers(
 			renderPass,
@@ -308,7 +552,7 @@ static int Draw(Context* context)
 		);
 		SDL_DrawGPUPrimitives(
 			renderPass,
-			SPRITE_COUNT * 6,
+			spriteCount * 6,
 			1,
 			0,
 			0
@@ -317,18 +561,34 @@ static int Draw(Context* context)
 		SDL_EndGPURenderPass(renderPass);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdBuf);
+	if (useFrameRing)
+	{
+		SubmitFrameRing(&SpriteDataRing, cmdBuf);
+	}
+	else if (useSimulation)
+	{
+		SubmitStagingCommandBuffer(context->Device, cmdBuf);
+	}
+	else
+	{
+		SubmitCommandBuffer(cmdBuf);
+	}
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, RenderPipeline);
+	ReleaseGraphicsPipeline(context->Device, RenderPipeline);
+	if (CompactRenderPipeline != NULL)
+	{
+		ReleaseGraphicsPipeline(context->Device, CompactRenderPipeline);
+		CompactRenderPipeline = NULL;
+	}
+	SDL_ReleaseGPUBuffer(context->Device, AtlasRegionBuffer);
 	SDL_ReleaseGPUSampler(context->Device, Sampler);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
-	SDL_ReleaseGPUTransferBuffer(context->Device, SpriteDataTransferBuffer);
-	SDL_ReleaseGPUBuffer(context->Device, SpriteDataBuffer);
+	ReleaseSpriteData(context);
 
 	CommonQuit(context);
 }
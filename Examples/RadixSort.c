@@ -0,0 +1,240 @@
+#include "Common.h"
+
+// GPU Radix Sort
+// A least-significant-digit sort over 4 bits per pass. Every pass is three dispatches, each in
+// its own compute pass so the previous one's writes are visible: RadixSortCount.comp counts the
+// digits of each block of keys, RadixSortScan.comp turns the counts into output offsets, and
+// RadixSortScatter.comp moves the keys and values there, ping-ponging between the two buffers.
+
+#define RADIX_SORT_BLOCK_SIZE 1024 // Keys per group, 256 threads of 4
+#define RADIX_SORT_DIGIT_COUNT 16
+
+typedef struct RadixSortUniforms
+{
+	Uint32 KeyCount;
+	Uint32 Shift;
+	Uint32 GroupCount;
+	Uint32 Padding;
+} RadixSortUniforms;
+
+static void ReleaseRadixSortBuffers(RadixSorter* sorter)
+{
+	for (int i = 0; i < 2; i += 1)
+	{
+		SDL_ReleaseGPUBuffer(sorter->Device, sorter->Keys[i]);
+		SDL_ReleaseGPUBuffer(sorter->Device, sorter->Values[i]);
+		sorter->Keys[i] = NULL;
+		sorter->Values[i] = NULL;
+	}
+	SDL_ReleaseGPUBuffer(sorter->Device, sorter->Histograms);
+	sorter->Histograms = NULL;
+	sorter->Capacity = 0;
+}
+
+static bool CreateRadixSortBuffers(RadixSorter* sorter, Uint32 capacity)
+{
+	for (int i = 0; i < 2; i += 1)
+	{
+		sorter->Keys[i] = SDL_CreateGPUBuffer(
+			sorter->Device,
+			&(SDL_GPUBufferCreateInfo) {
+				.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+				.size = capacity * sizeof(Uint32)
+			}
+		);
+		sorter->Values[i] = SDL_CreateGPUBuffer(
+			sorter->Device,
+			&(SDL_GPUBufferCreateInfo) {
+				.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+				.size = capacity * sizeof(Uint32)
+			}
+		);
+	}
+
+	Uint32 groupCount = (capacity + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE;
+	sorter->Histograms = SDL_CreateGPUBuffer(
+		sorter->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = SDL_max(groupCount, 1) * RADIX_SORT_DIGIT_COUNT * sizeof(Uint32)
+		}
+	);
+
+	if (sorter->Keys[0] == NULL || sorter->Keys[1] == NULL ||
+		sorter->Values[0] == NULL || sorter->Values[1] == NULL ||
+		sorter->Histograms == NULL)
+	{
+		SDL_Log("Failed to create radix sort buffers: %s", SDL_GetError());
+		ReleaseRadixSortBuffers(sorter);
+		return false;
+	}
+
+	sorter->Capacity = capacity;
+	return true;
+}
+
+bool CreateRadixSorter(RadixSorter* sorter, SDL_GPUDevice* device, Uint32 capacity)
+{
+	SDL_zerop(sorter);
+	sorter->Device = device;
+
+	sorter->CountPipeline = CreateComputePipelineFromShader(
+		device,
+		"RadixSortCount.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 1,
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 256,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	sorter->ScanPipeline = CreateComputePipelineFromShader(
+		device,
+		"RadixSortScan.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 256,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	sorter->ScatterPipeline = CreateComputePipelineFromShader(
+		device,
+		"RadixSortScatter.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readonly_storage_buffers = 3,
+			.num_readwrite_storage_buffers = 2,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 256,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+
+	if (sorter->CountPipeline == NULL || sorter->ScanPipeline == NULL || sorter->ScatterPipeline == NULL)
+	{
+		SDL_Log("Radix sort shaders are unavailable, run compile.sh to build them.");
+		ReleaseRadixSorter(sorter);
+		return false;
+	}
+
+	if (!CreateRadixSortBuffers(sorter, capacity))
+	{
+		ReleaseRadixSorter(sorter);
+		return false;
+	}
+
+	return true;
+}
+
+bool ReserveRadixSorter(RadixSorter* sorter, Uint32 capacity)
+{
+	if (capacity <= sorter->Capacity)
+	{
+		return true;
+	}
+
+	ReleaseRadixSortBuffers(sorter);
+	return CreateRadixSortBuffers(sorter, capacity);
+}
+
+int SortRadix(RadixSorter* sorter, SDL_GPUCommandBuffer* commandBuffer, Uint32 count, int keyBits)
+{
+	SDL_assert(count <= sorter->Capacity);
+
+	int passCount = (SDL_clamp(keyBits, 1, 32) + 3) / 4;
+	Uint32 groupCount = (count + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE;
+	if (groupCount == 0)
+	{
+		return 0;
+	}
+
+	PROFILE_BEGIN("Sort Radix");
+	for (int pass = 0; pass < passCount; pass += 1)
+	{
+		int source = pass % 2;
+		int destination = 1 - source;
+		RadixSortUniforms uniforms = {
+			.KeyCount = count,
+			.Shift = pass * 4,
+			.GroupCount = groupCount
+		};
+
+		SDL_GPUComputePass* countPass = SDL_BeginGPUComputePass(
+			commandBuffer,
+			NULL,
+			0,
+			&(SDL_GPUStorageBufferReadWriteBinding){ .buffer = sorter->Histograms, .cycle = false },
+			1
+		);
+		SDL_BindGPUComputePipeline(countPass, sorter->CountPipeline);
+		SDL_BindGPUComputeStorageBuffers(countPass, 0, &sorter->Keys[source], 1);
+		SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+		SDL_DispatchGPUCompute(countPass, groupCount, 1, 1);
+		SDL_EndGPUComputePass(countPass);
+
+		SDL_GPUComputePass* scanPass = SDL_BeginGPUComputePass(
+			commandBuffer,
+			NULL,
+			0,
+			&(SDL_GPUStorageBufferReadWriteBinding){ .buffer = sorter->Histograms, .cycle = false },
+			1
+		);
+		SDL_BindGPUComputePipeline(scanPass, sorter->ScanPipeline);
+		SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+		SDL_DispatchGPUCompute(scanPass, 1, 1, 1);
+		SDL_EndGPUComputePass(scanPass);
+
+		SDL_GPUComputePass* scatterPass = SDL_BeginGPUComputePass(
+			commandBuffer,
+			NULL,
+			0,
+			(SDL_GPUStorageBufferReadWriteBinding[]){
+				{ .buffer = sorter->Keys[destination], .cycle = false },
+				{ .buffer = sorter->Values[destination], .cycle = false }
+			},
+			2
+		);
+		SDL_BindGPUComputePipeline(scatterPass, sorter->ScatterPipeline);
+		SDL_BindGPUComputeStorageBuffers(
+			scatterPass,
+			0,
+			(SDL_GPUBuffer*[]){ sorter->Keys[source], sorter->Values[source], sorter->Histograms },
+			3
+		);
+		SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+		SDL_DispatchGPUCompute(scatterPass, groupCount, 1, 1);
+		SDL_EndGPUComputePass(scatterPass);
+	}
+	PROFILE_END();
+
+	return passCount % 2;
+}
+
+void ReleaseRadixSorter(RadixSorter* sorter)
+{
+	if (sorter->Device == NULL)
+	{
+		return;
+	}
+
+	if (sorter->CountPipeline != NULL)
+	{
+		ReleaseComputePipeline(sorter->Device, sorter->CountPipeline);
+	}
+	if (sorter->ScanPipeline != NULL)
+	{
+		ReleaseComputePipeline(sorter->Device, sorter->ScanPipeline);
+	}
+	if (sorter->ScatterPipeline != NULL)
+	{
+		ReleaseComputePipeline(sorter->Device, sorter->ScatterPipeline);
+	}
+	ReleaseRadixSortBuffers(sorter);
+	SDL_zerop(sorter);
+}
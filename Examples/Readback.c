@@ -0,0 +1,297 @@
+#include "Common.h"
+
+// Readback Queue
+// A readback belongs to the staging submission its download was recorded into, so it is
+// ready once that submission's fence has signaled. Download buffers are pooled and reused.
+
+#define READBACK_MIN_BUFFER_SIZE (64 * 1024)
+
+typedef struct ReadbackSlot
+{
+	SDL_GPUTransferBuffer* TransferBuffer;
+	Uint32 Size;
+	bool InUse;
+} ReadbackSlot;
+
+typedef struct PendingReadback
+{
+	ReadbackTicket Ticket;
+	int Buffer;
+	Uint32 Size;
+	Uint64 Serial;
+	Uint64 Frame;
+	ReadbackCallback Callback;
+	void* Userdata;
+} PendingReadback;
+
+static ReadbackSlot* ReadbackBuffers;
+static int ReadbackBufferCount;
+static int ReadbackBufferCapacity;
+static PendingReadback* PendingReadbacks; // Oldest first
+static int PendingReadbackCount;
+static int PendingReadbackCapacity;
+static ReadbackTicket NextReadbackTicket = 1;
+static Uint64 ReadbackFrame;
+static int ReadbackLatency = 2;
+static ReadbackStats ReadbackCounters;
+
+static int AcquireReadbackBuffer(SDL_GPUDevice* device, Uint32 size)
+{
+	int best = -1;
+	for (int i = 0; i < ReadbackBufferCount; i += 1)
+	{
+		ReadbackSlot* buffer = &ReadbackBuffers[i];
+		if (!buffer->InUse && buffer->Size >= size && (best < 0 || buffer->Size < ReadbackBuffers[best].Size))
+		{
+			best = i;
+		}
+	}
+	if (best >= 0)
+	{
+		ReadbackBuffers[best].InUse = true;
+		return best;
+	}
+
+	Uint32 bufferSize = READBACK_MIN_BUFFER_SIZE;
+	while (bufferSize < size)
+	{
+		bufferSize *= 2;
+	}
+
+	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
+			.size = bufferSize
+		}
+	);
+	if (transferBuffer == NULL)
+	{
+		SDL_Log("Failed to create a %u byte readback buffer: %s", bufferSize, SDL_GetError());
+		return -1;
+	}
+
+	if (ReadbackBufferCount == ReadbackBufferCapacity)
+	{
+		int capacity = SDL_max(ReadbackBufferCapacity * 2, 8);
+		ReadbackSlot* buffers = SDL_realloc(ReadbackBuffers, capacity * sizeof(ReadbackSlot));
+		if (buffers == NULL)
+		{
+			SDL_Log("Out of memory, can't add a readback buffer!");
+			SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+			return -1;
+		}
+		ReadbackBuffers = buffers;
+		ReadbackBufferCapacity = capacity;
+	}
+	ReadbackBuffers[ReadbackBufferCount] = (ReadbackSlot) {
+		.TransferBuffer = transferBuffer,
+		.Size = bufferSize,
+		.InUse = true
+	};
+	return ReadbackBufferCount++;
+}
+
+// Grows the pending list before a download is recorded, so adding it afterwards can't fail
+static bool ReservePendingReadback()
+{
+	if (PendingReadbackCount == PendingReadbackCapacity)
+	{
+		int capacity = SDL_max(PendingReadbackCapacity * 2, 8);
+		PendingReadback* readbacks = SDL_realloc(PendingReadbacks, capacity * sizeof(PendingReadback));
+		if (readbacks == NULL)
+		{
+			SDL_Log("Out of memory, can't queue another readback!");
+			return false;
+		}
+		PendingReadbacks = readbacks;
+		PendingReadbackCapacity = capacity;
+	}
+	return true;
+}
+
+static ReadbackTicket AddPendingReadback(SDL_GPUDevice* device, int buffer, Uint32 size, ReadbackCallback callback, void* userdata)
+{
+	PendingReadbacks[PendingReadbackCount++] = (PendingReadback) {
+		.Ticket = NextReadbackTicket,
+		.Buffer = buffer,
+		.Size = size,
+		.Serial = GetNextStagingSerial(device),
+		.Frame = ReadbackFrame,
+		.Callback = callback,
+		.Userdata = userdata
+	};
+	ReadbackCounters.Requested += 1;
+	return NextReadbackTicket++;
+}
+
+ReadbackTicket ReadbackTexture(
+	SDL_GPUDevice* device,
+	SDL_GPUCopyPass* copyPass,
+	SDL_GPUTextureFormat format,
+	const SDL_GPUTextureRegion* region,
+	ReadbackCallback callback,
+	void* userdata
+) {
+	BindStagingDevice(device);
+	if (!ReservePendingReadback())
+	{
+		return 0;
+	}
+
+	Uint32 size = SDL_CalculateGPUTextureFormatSize(format, region->w, region->h, region->d);
+	int buffer = AcquireReadbackBuffer(device, size);
+	if (buffer < 0)
+	{
+		return 0;
+	}
+
+	SDL_DownloadFromGPUTexture(
+		copyPass,
+		region,
+		&(SDL_GPUTextureTransferInfo) {
+			.transfer_buffer = ReadbackBuffers[buffer].TransferBuffer
+		}
+	);
+	return AddPendingReadback(device, buffer, size, callback, userdata);
+}
+
+ReadbackTicket ReadbackBuffer(
+	SDL_GPUDevice* device,
+	SDL_GPUCopyPass* copyPass,
+	const SDL_GPUBufferRegion* region,
+	ReadbackCallback callback,
+	void* userdata
+) {
+	BindStagingDevice(device);
+	if (!ReservePendingReadback())
+	{
+		return 0;
+	}
+
+	int buffer = AcquireReadbackBuffer(device, region->size);
+	if (buffer < 0)
+	{
+		return 0;
+	}
+
+	SDL_DownloadFromGPUBuffer(
+		copyPass,
+		region,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = ReadbackBuffers[buffer].TransferBuffer
+		}
+	);
+	return AddPendingReadback(device, buffer, region->size, callback, userdata);
+}
+
+bool IsReadbackComplete(ReadbackTicket ticket)
+{
+	for (int i = 0; i < PendingReadbackCount; i += 1)
+	{
+		if (PendingReadbacks[i].Ticket == ticket)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void SetReadbackLatency(int frames)
+{
+	ReadbackLatency = SDL_max(frames, 0);
+}
+
+static void DeliverReadback(SDL_GPUDevice* device, const PendingReadback* readback)
+{
+	ReadbackSlot* buffer = &ReadbackBuffers[readback->Buffer];
+	void* data = SDL_MapGPUTransferBuffer(device, buffer->TransferBuffer, false);
+	if (data == NULL)
+	{
+		SDL_Log("Failed to map readback buffer: %s", SDL_GetError());
+	}
+	else if (readback->Callback != NULL)
+	{
+		readback->Callback(readback->Userdata, data, readback->Size);
+	}
+	if (data != NULL)
+	{
+		SDL_UnmapGPUTransferBuffer(device, buffer->TransferBuffer);
+	}
+
+	buffer->InUse = false;
+	ReadbackCounters.Delivered += 1;
+	ReadbackCounters.TotalLatencyFrames += ReadbackFrame - readback->Frame;
+}
+
+// Delivers readbacks in order, blocking on any that have been pending for more than maxFrames
+static void ProcessReadbacks(SDL_GPUDevice* device, Uint64 maxFrames)
+{
+	Uint64 completedSerial = GetCompletedStagingSerial(device);
+	Uint64 nextSerial = GetNextStagingSerial(device);
+
+	int delivered = 0;
+	while (delivered < PendingReadbackCount)
+	{
+		const PendingReadback* readback = &PendingReadbacks[delivered];
+		if (readback->Serial > completedSerial)
+		{
+			// Downloads that were never submitted can't be waited on
+			if (ReadbackFrame - readback->Frame < maxFrames || readback->Serial >= nextSerial)
+			{
+				break;
+			}
+			WaitForStagingSerial(device, readback->Serial);
+			completedSerial = readback->Serial;
+			ReadbackCounters.Stalls += 1;
+		}
+
+		DeliverReadback(device, readback);
+		delivered += 1;
+	}
+
+	if (delivered > 0)
+	{
+		PendingReadbackCount -= delivered;
+		SDL_memmove(PendingReadbacks, PendingReadbacks + delivered, PendingReadbackCount * sizeof(PendingReadback));
+	}
+}
+
+void UpdateReadbacks(SDL_GPUDevice* device)
+{
+	PROFILE_BEGIN("Update Readbacks");
+	ReadbackFrame += 1;
+	ProcessReadbacks(device, ReadbackLatency);
+	PROFILE_END();
+}
+
+void FinishReadbacks(SDL_GPUDevice* device)
+{
+	ProcessReadbacks(device, 0);
+}
+
+void ReleaseReadbacks(SDL_GPUDevice* device)
+{
+	FinishReadbacks(device);
+	if (PendingReadbackCount > 0)
+	{
+		SDL_Log("%d readback(s) were never submitted!", PendingReadbackCount);
+		PendingReadbackCount = 0;
+	}
+
+	for (int i = 0; i < ReadbackBufferCount; i += 1)
+	{
+		SDL_ReleaseGPUTransferBuffer(device, ReadbackBuffers[i].TransferBuffer);
+	}
+	SDL_free(ReadbackBuffers);
+	ReadbackBuffers = NULL;
+	ReadbackBufferCount = ReadbackBufferCapacity = 0;
+	SDL_zero(ReadbackCounters);
+}
+
+ReadbackStats GetReadbackStats()
+{
+	ReadbackStats stats = ReadbackCounters;
+	stats.Pending = PendingReadbackCount;
+	return stats;
+}
@@ -0,0 +1,260 @@
+#include "Common.h"
+
+// Sprite Batches
+// The index buffer holds the quad pattern for one chunk, 6 indices per sprite. A chunk's quads
+// start SPRITE_BATCH_CHUNK_VERTICES after the previous chunk's, which vertex_offset adds to
+// every index, so the index buffer stays at 192 KiB however many sprites are drawn.
+
+#define SPRITE_BATCH_CHUNK_VERTICES (SPRITE_BATCH_CHUNK_SIZE * 4)
+
+static Uint32 GetSpriteChunkCount(Uint32 count)
+{
+	return (count + SPRITE_BATCH_CHUNK_SIZE - 1) / SPRITE_BATCH_CHUNK_SIZE;
+}
+
+// The visible sprite count, then a draw per chunk
+static Uint32 GetDrawCommandSize(Uint32 capacity)
+{
+	return sizeof(Uint32) + GetSpriteChunkCount(capacity) * sizeof(SDL_GPUIndexedIndirectDrawCommand);
+}
+
+static void ReleaseSpriteBatchBuffers(SpriteBatch* batch)
+{
+	SDL_ReleaseGPUBuffer(batch->Device, batch->VertexBuffer);
+	SDL_ReleaseGPUBuffer(batch->Device, batch->DrawCommandBuffer);
+	SDL_ReleaseGPUTransferBuffer(batch->Device, batch->DrawCommandResetBuffer);
+	batch->VertexBuffer = NULL;
+	batch->DrawCommandBuffer = NULL;
+	batch->DrawCommandResetBuffer = NULL;
+}
+
+// Creates the buffers for capacity sprites, only replacing the batch's once they all exist
+static bool CreateSpriteBatchBuffers(SpriteBatch* batch, Uint32 capacity)
+{
+	SpriteBatch resized = *batch;
+	Uint32 drawCommandSize = GetDrawCommandSize(capacity);
+
+	resized.VertexBuffer = SDL_CreateGPUBuffer(
+		batch->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = capacity * 4 * batch->VertexSize
+		}
+	);
+
+	resized.DrawCommandBuffer = SDL_CreateGPUBuffer(
+		batch->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = drawCommandSize
+		}
+	);
+
+	resized.DrawCommandResetBuffer = SDL_CreateGPUTransferBuffer(
+		batch->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = drawCommandSize
+		}
+	);
+
+	if (resized.VertexBuffer == NULL || resized.DrawCommandBuffer == NULL || resized.DrawCommandResetBuffer == NULL)
+	{
+		SDL_Log("Failed to create buffers for %u sprites: %s", capacity, SDL_GetError());
+		ReleaseSpriteBatchBuffers(&resized);
+		return false;
+	}
+
+	// Every chunk's draw starts out empty, reading its own range of vertices
+	Uint8* reset = SDL_MapGPUTransferBuffer(batch->Device, resized.DrawCommandResetBuffer, false);
+	if (reset == NULL)
+	{
+		SDL_Log("Failed to map the draw command reset buffer: %s", SDL_GetError());
+		ReleaseSpriteBatchBuffers(&resized);
+		return false;
+	}
+	*(Uint32*) reset = 0;
+	SDL_GPUIndexedIndirectDrawCommand* commands = (SDL_GPUIndexedIndirectDrawCommand*) (reset + sizeof(Uint32));
+	for (Uint32 chunk = 0; chunk < GetSpriteChunkCount(capacity); chunk += 1)
+	{
+		commands[chunk] = (SDL_GPUIndexedIndirectDrawCommand) {
+			.num_indices = 0,
+			.num_instances = 1,
+			.first_index = 0,
+			.vertex_offset = chunk * SPRITE_BATCH_CHUNK_VERTICES,
+			.first_instance = 0
+		};
+	}
+	SDL_UnmapGPUTransferBuffer(batch->Device, resized.DrawCommandResetBuffer);
+
+	// Releasing is deferred by SDL until the GPU is done with the old buffers
+	ReleaseSpriteBatchBuffers(batch);
+	*batch = resized;
+	batch->Capacity = capacity;
+	batch->Stats.MemoryBytes =
+		(Uint64) capacity * 4 * batch->VertexSize +
+		SPRITE_BATCH_CHUNK_SIZE * 6 * sizeof(Uint16) +
+		drawCommandSize * 2;
+	return true;
+}
+
+bool CreateSpriteBatch(SpriteBatch* batch, SDL_GPUDevice* device, Uint32 vertexSize, Uint32 capacity)
+{
+	SDL_zerop(batch);
+	batch->Device = device;
+	batch->VertexSize = vertexSize;
+
+	batch->IndexBuffer = SDL_CreateGPUBuffer(
+		device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = SPRITE_BATCH_CHUNK_SIZE * 6 * sizeof(Uint16)
+		}
+	);
+	if (batch->IndexBuffer == NULL)
+	{
+		SDL_Log("Failed to create the sprite index buffer: %s", SDL_GetError());
+		return false;
+	}
+
+	StagingAllocation indexStaging;
+	Uint16* indices = MapStagingMemory(device, SPRITE_BATCH_CHUNK_SIZE * 6 * sizeof(Uint16), 0, &indexStaging);
+	if (indices == NULL)
+	{
+		ReleaseSpriteBatch(batch);
+		return false;
+	}
+
+	for (Uint32 i = 0, j = 0; i < SPRITE_BATCH_CHUNK_SIZE * 6; i += 6, j += 4)
+	{
+		indices[i]     = (Uint16) j;
+		indices[i + 1] = (Uint16) (j + 1);
+		indices[i + 2] = (Uint16) (j + 2);
+		indices[i + 3] = (Uint16) (j + 3);
+		indices[i + 4] = (Uint16) (j + 2);
+		indices[i + 5] = (Uint16) (j + 1);
+	}
+
+	UnmapStagingMemory(device, &indexStaging);
+
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = indexStaging.TransferBuffer,
+			.offset = indexStaging.Offset
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = batch->IndexBuffer,
+			.offset = 0,
+			.size = SPRITE_BATCH_CHUNK_SIZE * 6 * sizeof(Uint16)
+		},
+		false
+	);
+	SDL_EndGPUCopyPass(copyPass);
+	SubmitStagingCommandBuffer(device, uploadCmdBuf);
+
+	if (!CreateSpriteBatchBuffers(batch, SDL_max(capacity, 1)))
+	{
+		ReleaseSpriteBatch(batch);
+		return false;
+	}
+
+	return true;
+}
+
+bool ReserveSpriteBatch(SpriteBatch* batch, Uint32 count)
+{
+	if (count <= batch->Capacity)
+	{
+		return true;
+	}
+
+	if (!CreateSpriteBatchBuffers(batch, SDL_max(batch->Capacity * 2, count)))
+	{
+		return false;
+	}
+
+	batch->Stats.Grows += 1;
+	return true;
+}
+
+void ResetSpriteBatchDraws(SpriteBatch* batch, SDL_GPUCopyPass* copyPass)
+{
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = batch->DrawCommandResetBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = batch->DrawCommandBuffer,
+			.offset = 0,
+			.size = GetDrawCommandSize(batch->Capacity)
+		},
+		true
+	);
+}
+
+static void BindSpriteBatch(SpriteBatch* batch, SDL_GPURenderPass* renderPass)
+{
+	SDL_BindGPUVertexBuffers(
+		renderPass,
+		0,
+		&(SDL_GPUBufferBinding){
+			.buffer = batch->VertexBuffer
+		},
+		1
+	);
+	SDL_BindGPUIndexBuffer(
+		renderPass,
+		&(SDL_GPUBufferBinding){
+			.buffer = batch->IndexBuffer
+		},
+		SDL_GPU_INDEXELEMENTSIZE_16BIT
+	);
+}
+
+void DrawSpriteBatch(SpriteBatch* batch, SDL_GPURenderPass* renderPass, Uint32 count)
+{
+	SDL_assert(count <= batch->Capacity);
+
+	BindSpriteBatch(batch, renderPass);
+	for (Uint32 first = 0; first < count; first += SPRITE_BATCH_CHUNK_SIZE)
+	{
+		SDL_DrawGPUIndexedPrimitives(
+			renderPass,
+			SDL_min(count - first, SPRITE_BATCH_CHUNK_SIZE) * 6,
+			1,
+			0,
+			first * 4,
+			0
+		);
+	}
+}
+
+void DrawSpriteBatchIndirect(SpriteBatch* batch, SDL_GPURenderPass* renderPass, Uint32 maxCount)
+{
+	// Only the chunks that could hold a visible sprite are drawn, empty ones draw nothing
+	Uint32 drawCount = GetSpriteChunkCount(SDL_min(maxCount, batch->Capacity));
+	if (drawCount == 0)
+	{
+		return;
+	}
+
+	BindSpriteBatch(batch, renderPass);
+	SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, batch->DrawCommandBuffer, sizeof(Uint32), drawCount);
+}
+
+void ReleaseSpriteBatch(SpriteBatch* batch)
+{
+	if (batch->Device == NULL)
+	{
+		return;
+	}
+
+	ReleaseSpriteBatchBuffers(batch);
+	SDL_ReleaseGPUBuffer(batch->Device, batch->IndexBuffer);
+	SDL_zerop(batch);
+}
@@ -0,0 +1,613 @@
+#include "Common.h"
+
+// Sprite Building
+// Every random value is a hash of the sprite index, the field and the seed, so any range of
+// sprites can be built independently and in any order: the instance array is split into
+// chunks that a pool of workers (and the calling thread) claim until none are left. Within a
+// chunk, sprites are generated four or eight at a time and transposed into whole records
+// (64 bytes, or 16 for the compact format) that are streamed straight into the destination,
+// which is usually a mapped write-combined transfer buffer that should never be read back.
+
+#define SPRITE_BUILD_CHUNK_SIZE 4096 // Sprites per chunk, a multiple of 8
+#define SPRITE_FIELD_X 0
+#define SPRITE_FIELD_Y 1
+#define SPRITE_FIELD_ROTATION 2
+#define SPRITE_FIELD_CELL 3
+
+typedef struct SpriteBuilderPool
+{
+	SDL_Mutex* Lock;
+	SDL_Condition* WorkAvailable;
+	SDL_Condition* WorkFinished;
+	SDL_Thread** Threads;
+	int WorkerCount; // Not counting the calling thread
+	Uint32 Generation;
+	int BusyWorkers;
+	bool ShuttingDown;
+
+	// The build in progress
+	void* Sprites;
+	bool Compact;
+	Uint32 Count;
+	SpriteBuildInfo Info;
+	SDL_AtomicInt NextChunk;
+} SpriteBuilderPool;
+
+static SpriteBuilderPool Builder;
+
+// "lowbias32" integer hash by Chris Wellons
+static inline Uint32 HashSpriteKey(Uint32 x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352Du;
+	x ^= x >> 15;
+	x *= 0x846CA68Bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static inline Uint32 SpriteRandom(Uint32 index, Uint32 field, Uint32 seedHash)
+{
+	return HashSpriteKey(((index << 2) | field) ^ seedHash);
+}
+
+// The top 24 bits as a float in [0, 1)
+static inline float SpriteRandomUnit(Uint32 bits)
+{
+	return (float)(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+static void BuildSpritesScalar(SpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	for (Uint32 i = first; i < end; i += 1)
+	{
+		Uint32 cell = SpriteRandom(i, SPRITE_FIELD_CELL, seedHash);
+		SpriteInstance* sprite = &sprites[i];
+		sprite->x = (float)(Sint32)(SpriteRandomUnit(SpriteRandom(i, SPRITE_FIELD_X, seedHash)) * info->AreaWidth);
+		sprite->y = (float)(Sint32)(SpriteRandomUnit(SpriteRandom(i, SPRITE_FIELD_Y, seedHash)) * info->AreaHeight);
+		sprite->z = 0;
+		sprite->rotation = SpriteRandomUnit(SpriteRandom(i, SPRITE_FIELD_ROTATION, seedHash)) * (SDL_PI_F * 2);
+		sprite->w = info->SpriteSize;
+		sprite->h = info->SpriteSize;
+		sprite->padding_a = 0;
+		sprite->padding_b = 0;
+		sprite->tex_u = (float)((cell >> 30) & 1) * 0.5f;
+		sprite->tex_v = (float)(cell >> 31) * 0.5f;
+		sprite->tex_w = 0.5f;
+		sprite->tex_h = 0.5f;
+		sprite->r = 1.0f;
+		sprite->g = 1.0f;
+		sprite->b = 1.0f;
+		sprite->a = 1.0f;
+	}
+}
+
+// Positions are whole numbers, which halves hold exactly up to 2048 (and rounded down to an even
+// number up to 4096), so the float only needs its exponent rebiased and its mantissa shortened
+static inline Uint16 WholeNumberToHalf(float value)
+{
+	Uint32 bits;
+	SDL_memcpy(&bits, &value, sizeof(bits));
+	return (bits == 0) ? 0 : (Uint16)((bits >> 13) - (112 << 10));
+}
+
+static void BuildCompactSpritesScalar(CompactSpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	Uint16 size = FloatToHalf(info->SpriteSize);
+	for (Uint32 i = first; i < end; i += 1)
+	{
+		CompactSpriteInstance* sprite = &sprites[i];
+		sprite->x = WholeNumberToHalf((float)(Sint32)(SpriteRandomUnit(SpriteRandom(i, SPRITE_FIELD_X, seedHash)) * info->AreaWidth));
+		sprite->y = WholeNumberToHalf((float)(Sint32)(SpriteRandomUnit(SpriteRandom(i, SPRITE_FIELD_Y, seedHash)) * info->AreaHeight));
+		sprite->w = size;
+		sprite->h = size;
+		sprite->rotation = (Uint16)(SpriteRandom(i, SPRITE_FIELD_ROTATION, seedHash) >> 16);
+		sprite->region = (Uint16)(SpriteRandom(i, SPRITE_FIELD_CELL, seedHash) >> 30);
+		sprite->color = 0xFFFFFFFF;
+	}
+}
+
+#if defined(SDL_SSE2_INTRINSICS)
+// SSE2 has no 32-bit low multiply, so do the even and odd lanes separately
+static inline __m128i MulLo32SSE2(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i SpriteRandomSSE2(__m128i index, Uint32 field, __m128i seedHash)
+{
+	__m128i x = _mm_xor_si128(_mm_or_si128(_mm_slli_epi32(index, 2), _mm_set1_epi32(field)), seedHash);
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	x = MulLo32SSE2(x, _mm_set1_epi32(0x7FEB352D));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+	x = MulLo32SSE2(x, _mm_set1_epi32((int)0x846CA68Bu));
+	return _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+}
+
+static inline __m128 SpriteRandomUnitSSE2(__m128i bits)
+{
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+// Transposes four sprites' worth of fields into records and streams them out
+static inline void StoreSpritesSSE2(SpriteInstance* sprites, __m128 x, __m128 y, __m128 rotation, __m128 texU, __m128 texV, const SpriteBuildInfo* info)
+{
+	__m128 z = _mm_setzero_ps();
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 size = _mm_setr_ps(info->SpriteSize, info->SpriteSize, 0, 0);
+	__m128 color = _mm_set1_ps(1.0f);
+	_MM_TRANSPOSE4_PS(x, y, z, rotation);
+	__m128 texW = half;
+	__m128 texH = half;
+	_MM_TRANSPOSE4_PS(texU, texV, texW, texH);
+
+	float* dst = (float*)sprites;
+	__m128 positions[4] = { x, y, z, rotation };
+	__m128 texCoords[4] = { texU, texV, texW, texH };
+	for (int i = 0; i < 4; i += 1)
+	{
+		_mm_stream_ps(dst + i * 16 + 0, positions[i]);
+		_mm_stream_ps(dst + i * 16 + 4, size);
+		_mm_stream_ps(dst + i * 16 + 8, texCoords[i]);
+		_mm_stream_ps(dst + i * 16 + 12, color);
+	}
+}
+
+static inline void StoreSpriteCellsSSE2(SpriteInstance* sprites, __m128i cell, __m128 x, __m128 y, __m128 rotation, const SpriteBuildInfo* info)
+{
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 texU = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(cell, 30), _mm_set1_epi32(1))), half);
+	__m128 texV = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(cell, 31)), half);
+	StoreSpritesSSE2(sprites, x, y, rotation, texU, texV, info);
+}
+
+static Uint32 BuildSpritesSSE2(SpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	__m128i seed = _mm_set1_epi32(seedHash);
+	__m128 areaWidth = _mm_set1_ps(info->AreaWidth);
+	__m128 areaHeight = _mm_set1_ps(info->AreaHeight);
+	__m128 fullTurn = _mm_set1_ps(SDL_PI_F * 2);
+	Uint32 i = first;
+
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128i index = _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3));
+		__m128 x = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(SpriteRandomUnitSSE2(SpriteRandomSSE2(index, SPRITE_FIELD_X, seed)), areaWidth)));
+		__m128 y = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(SpriteRandomUnitSSE2(SpriteRandomSSE2(index, SPRITE_FIELD_Y, seed)), areaHeight)));
+		__m128 rotation = _mm_mul_ps(SpriteRandomUnitSSE2(SpriteRandomSSE2(index, SPRITE_FIELD_ROTATION, seed)), fullTurn);
+		StoreSpriteCellsSSE2(sprites + i, SpriteRandomSSE2(index, SPRITE_FIELD_CELL, seed), x, y, rotation, info);
+	}
+
+	_mm_sfence();
+	return i;
+}
+
+static inline __m128i WholeNumberToHalfSSE2(__m128 value)
+{
+	__m128i bits = _mm_castps_si128(value);
+	__m128i half = _mm_sub_epi32(_mm_srli_epi32(bits, 13), _mm_set1_epi32(112 << 10));
+	return _mm_andnot_si128(_mm_cmpeq_epi32(bits, _mm_setzero_si128()), half);
+}
+
+// Packs four sprites' halves and indices into their 16-byte records and streams them out
+static inline void StoreCompactSpritesSSE2(CompactSpriteInstance* sprites, __m128 x, __m128 y, __m128i rotation, __m128i cell, __m128i size)
+{
+	__m128 position = _mm_castsi128_ps(_mm_or_si128(WholeNumberToHalfSSE2(x), _mm_slli_epi32(WholeNumberToHalfSSE2(y), 16)));
+	__m128 rotationRegion = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(rotation, 16), _mm_slli_epi32(_mm_srli_epi32(cell, 30), 16)));
+	__m128 sizes = _mm_castsi128_ps(size);
+	__m128 color = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	_MM_TRANSPOSE4_PS(position, sizes, rotationRegion, color);
+
+	float* dst = (float*)sprites;
+	_mm_stream_ps(dst + 0, position);
+	_mm_stream_ps(dst + 4, sizes);
+	_mm_stream_ps(dst + 8, rotationRegion);
+	_mm_stream_ps(dst + 12, color);
+}
+
+static Uint32 BuildCompactSpritesSSE2(CompactSpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	__m128i seed = _mm_set1_epi32(seedHash);
+	__m128 areaWidth = _mm_set1_ps(info->AreaWidth);
+	__m128 areaHeight = _mm_set1_ps(info->AreaHeight);
+	Uint16 halfSize = FloatToHalf(info->SpriteSize);
+	__m128i size = _mm_set1_epi32(halfSize | (halfSize << 16));
+	Uint32 i = first;
+
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128i index = _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3));
+		__m128 x = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(SpriteRandomUnitSSE2(SpriteRandomSSE2(index, SPRITE_FIELD_X, seed)), areaWidth)));
+		__m128 y = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(SpriteRandomUnitSSE2(SpriteRandomSSE2(index, SPRITE_FIELD_Y, seed)), areaHeight)));
+		StoreCompactSpritesSSE2(
+			sprites + i,
+			x,
+			y,
+			SpriteRandomSSE2(index, SPRITE_FIELD_ROTATION, seed),
+			SpriteRandomSSE2(index, SPRITE_FIELD_CELL, seed),
+			size
+		);
+	}
+
+	_mm_sfence();
+	return i;
+}
+#endif
+
+#if defined(SDL_SSE2_INTRINSICS) && defined(SDL_AVX2_INTRINSICS)
+static inline __m256i SDL_TARGETING("avx2") SpriteRandomAVX2(__m256i index, Uint32 field, __m256i seedHash)
+{
+	__m256i x = _mm256_xor_si256(_mm256_or_si256(_mm256_slli_epi32(index, 2), _mm256_set1_epi32(field)), seedHash);
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x846CA68Bu));
+	return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+static inline __m256 SDL_TARGETING("avx2") SpriteRandomUnitAVX2(__m256i bits)
+{
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+// Hashes eight sprites at a time; the records are still written four at a time
+static Uint32 SDL_TARGETING("avx2") BuildSpritesAVX2(SpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	__m256i seed = _mm256_set1_epi32(seedHash);
+	__m256 areaWidth = _mm256_set1_ps(info->AreaWidth);
+	__m256 areaHeight = _mm256_set1_ps(info->AreaHeight);
+	__m256 fullTurn = _mm256_set1_ps(SDL_PI_F * 2);
+	Uint32 i = first;
+
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256 x = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(SpriteRandomUnitAVX2(SpriteRandomAVX2(index, SPRITE_FIELD_X, seed)), areaWidth)));
+		__m256 y = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(SpriteRandomUnitAVX2(SpriteRandomAVX2(index, SPRITE_FIELD_Y, seed)), areaHeight)));
+		__m256 rotation = _mm256_mul_ps(SpriteRandomUnitAVX2(SpriteRandomAVX2(index, SPRITE_FIELD_ROTATION, seed)), fullTurn);
+		__m256i cell = SpriteRandomAVX2(index, SPRITE_FIELD_CELL, seed);
+
+		StoreSpriteCellsSSE2(sprites + i, _mm256_castsi256_si128(cell), _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(rotation), info);
+		StoreSpriteCellsSSE2(sprites + i + 4, _mm256_extracti128_si256(cell, 1), _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(rotation, 1), info);
+	}
+
+	_mm_sfence();
+	return i;
+}
+
+static Uint32 SDL_TARGETING("avx2") BuildCompactSpritesAVX2(CompactSpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	__m256i seed = _mm256_set1_epi32(seedHash);
+	__m256 areaWidth = _mm256_set1_ps(info->AreaWidth);
+	__m256 areaHeight = _mm256_set1_ps(info->AreaHeight);
+	Uint16 halfSize = FloatToHalf(info->SpriteSize);
+	__m128i size = _mm_set1_epi32(halfSize | (halfSize << 16));
+	Uint32 i = first;
+
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256 x = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(SpriteRandomUnitAVX2(SpriteRandomAVX2(index, SPRITE_FIELD_X, seed)), areaWidth)));
+		__m256 y = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(SpriteRandomUnitAVX2(SpriteRandomAVX2(index, SPRITE_FIELD_Y, seed)), areaHeight)));
+		__m256i rotation = SpriteRandomAVX2(index, SPRITE_FIELD_ROTATION, seed);
+		__m256i cell = SpriteRandomAVX2(index, SPRITE_FIELD_CELL, seed);
+
+		StoreCompactSpritesSSE2(sprites + i, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castsi256_si128(rotation), _mm256_castsi256_si128(cell), size);
+		StoreCompactSpritesSSE2(sprites + i + 4, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extracti128_si256(rotation, 1), _mm256_extracti128_si256(cell, 1), size);
+	}
+
+	_mm_sfence();
+	return i;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+static inline uint32x4_t SpriteRandomNEON(uint32x4_t index, Uint32 field, uint32x4_t seedHash)
+{
+	uint32x4_t x = veorq_u32(vorrq_u32(vshlq_n_u32(index, 2), vdupq_n_u32(field)), seedHash);
+	x = veorq_u32(x, vshrq_n_u32(x, 16));
+	x = vmulq_u32(x, vdupq_n_u32(0x7FEB352Du));
+	x = veorq_u32(x, vshrq_n_u32(x, 15));
+	x = vmulq_u32(x, vdupq_n_u32(0x846CA68Bu));
+	return veorq_u32(x, vshrq_n_u32(x, 16));
+}
+
+static inline float32x4_t SpriteRandomUnitNEON(uint32x4_t bits)
+{
+	return vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(bits, 8)), 1.0f / 16777216.0f);
+}
+
+static inline float32x4x4_t TransposeNEON(float32x4_t a, float32x4_t b, float32x4_t c, float32x4_t d)
+{
+	float32x4x2_t ab = vtrnq_f32(a, b);
+	float32x4x2_t cd = vtrnq_f32(c, d);
+	float32x4x4_t rows;
+	rows.val[0] = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+	rows.val[1] = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+	rows.val[2] = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+	rows.val[3] = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+	return rows;
+}
+
+static Uint32 BuildSpritesNEON(SpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	static const Uint32 laneOffsets[4] = { 0, 1, 2, 3 };
+	uint32x4_t seed = vdupq_n_u32(seedHash);
+	float32x4_t half = vdupq_n_f32(0.5f);
+	float32x4_t size = vcombine_f32(vdup_n_f32(info->SpriteSize), vdup_n_f32(0));
+	float32x4_t color = vdupq_n_f32(1.0f);
+	Uint32 i = first;
+
+	for (; i + 4 <= end; i += 4)
+	{
+		uint32x4_t index = vaddq_u32(vdupq_n_u32(i), vld1q_u32(laneOffsets));
+		float32x4_t x = vcvtq_f32_s32(vcvtq_s32_f32(vmulq_n_f32(SpriteRandomUnitNEON(SpriteRandomNEON(index, SPRITE_FIELD_X, seed)), info->AreaWidth)));
+		float32x4_t y = vcvtq_f32_s32(vcvtq_s32_f32(vmulq_n_f32(SpriteRandomUnitNEON(SpriteRandomNEON(index, SPRITE_FIELD_Y, seed)), info->AreaHeight)));
+		float32x4_t rotation = vmulq_n_f32(SpriteRandomUnitNEON(SpriteRandomNEON(index, SPRITE_FIELD_ROTATION, seed)), SDL_PI_F * 2);
+		uint32x4_t cell = SpriteRandomNEON(index, SPRITE_FIELD_CELL, seed);
+		float32x4_t texU = vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(cell, 30), vdupq_n_u32(1))), half);
+		float32x4_t texV = vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(cell, 31)), half);
+
+		float32x4x4_t positions = TransposeNEON(x, y, vdupq_n_f32(0), rotation);
+		float32x4x4_t texCoords = TransposeNEON(texU, texV, half, half);
+		float* dst = (float*)(sprites + i);
+		for (int j = 0; j < 4; j += 1)
+		{
+			vst1q_f32(dst + j * 16 + 0, positions.val[j]);
+			vst1q_f32(dst + j * 16 + 4, size);
+			vst1q_f32(dst + j * 16 + 8, texCoords.val[j]);
+			vst1q_f32(dst + j * 16 + 12, color);
+		}
+	}
+
+	return i;
+}
+
+static inline uint32x4_t WholeNumberToHalfNEON(float32x4_t value)
+{
+	uint32x4_t bits = vreinterpretq_u32_f32(value);
+	uint32x4_t half = vsubq_u32(vshrq_n_u32(bits, 13), vdupq_n_u32(112 << 10));
+	return vbicq_u32(half, vceqq_u32(bits, vdupq_n_u32(0)));
+}
+
+static Uint32 BuildCompactSpritesNEON(CompactSpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info, Uint32 seedHash)
+{
+	static const Uint32 laneOffsets[4] = { 0, 1, 2, 3 };
+	uint32x4_t seed = vdupq_n_u32(seedHash);
+	Uint16 halfSize = FloatToHalf(info->SpriteSize);
+	Uint32 i = first;
+
+	for (; i + 4 <= end; i += 4)
+	{
+		uint32x4_t index = vaddq_u32(vdupq_n_u32(i), vld1q_u32(laneOffsets));
+		float32x4_t x = vcvtq_f32_s32(vcvtq_s32_f32(vmulq_n_f32(SpriteRandomUnitNEON(SpriteRandomNEON(index, SPRITE_FIELD_X, seed)), info->AreaWidth)));
+		float32x4_t y = vcvtq_f32_s32(vcvtq_s32_f32(vmulq_n_f32(SpriteRandomUnitNEON(SpriteRandomNEON(index, SPRITE_FIELD_Y, seed)), info->AreaHeight)));
+		uint32x4_t rotation = vshrq_n_u32(SpriteRandomNEON(index, SPRITE_FIELD_ROTATION, seed), 16);
+		uint32x4_t region = vshrq_n_u32(SpriteRandomNEON(index, SPRITE_FIELD_CELL, seed), 30);
+
+		// Each sprite is four consecutive words, which is exactly how vst4 interleaves
+		uint32x4x4_t records;
+		records.val[0] = vorrq_u32(WholeNumberToHalfNEON(x), vshlq_n_u32(WholeNumberToHalfNEON(y), 16));
+		records.val[1] = vdupq_n_u32(halfSize | (halfSize << 16));
+		records.val[2] = vorrq_u32(rotation, vshlq_n_u32(region, 16));
+		records.val[3] = vdupq_n_u32(0xFFFFFFFF);
+		vst4q_u32((Uint32*)(sprites + i), records);
+	}
+
+	return i;
+}
+#endif
+
+static void BuildFullSpriteRange(SpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info)
+{
+	Uint32 seedHash = HashSpriteKey(info->Seed);
+	Uint32 built = first;
+
+#if defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+	built = BuildSpritesNEON(sprites, first, end, info, seedHash);
+#else
+	// Streaming stores need 16-byte alignment, which mapped buffers always have
+	if (((uintptr_t)sprites & 15) == 0)
+	{
+#if defined(SDL_SSE2_INTRINSICS) && defined(SDL_AVX2_INTRINSICS)
+		if (SDL_HasAVX2())
+		{
+			built = BuildSpritesAVX2(sprites, first, end, info, seedHash);
+		}
+		else
+#endif
+		{
+#if defined(SDL_SSE2_INTRINSICS)
+			built = BuildSpritesSSE2(sprites, first, end, info, seedHash);
+#endif
+		}
+	}
+#endif
+
+	BuildSpritesScalar(sprites, built, end, info, seedHash);
+}
+
+static void BuildCompactSpriteRange(CompactSpriteInstance* sprites, Uint32 first, Uint32 end, const SpriteBuildInfo* info)
+{
+	Uint32 seedHash = HashSpriteKey(info->Seed);
+	Uint32 built = first;
+
+#if defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+	built = BuildCompactSpritesNEON(sprites, first, end, info, seedHash);
+#else
+	if (((uintptr_t)sprites & 15) == 0)
+	{
+#if defined(SDL_SSE2_INTRINSICS) && defined(SDL_AVX2_INTRINSICS)
+		if (SDL_HasAVX2())
+		{
+			built = BuildCompactSpritesAVX2(sprites, first, end, info, seedHash);
+		}
+		else
+#endif
+		{
+#if defined(SDL_SSE2_INTRINSICS)
+			built = BuildCompactSpritesSSE2(sprites, first, end, info, seedHash);
+#endif
+		}
+	}
+#endif
+
+	BuildCompactSpritesScalar(sprites, built, end, info, seedHash);
+}
+
+static void BuildSpriteRange(void* sprites, bool compact, Uint32 first, Uint32 end, const SpriteBuildInfo* info)
+{
+	if (compact)
+	{
+		BuildCompactSpriteRange(sprites, first, end, info);
+	}
+	else
+	{
+		BuildFullSpriteRange(sprites, first, end, info);
+	}
+}
+
+// Claims chunks of the current build until there are none left
+static void RunSpriteBuildChunks(void)
+{
+	Uint32 chunkCount = (Builder.Count + SPRITE_BUILD_CHUNK_SIZE - 1) / SPRITE_BUILD_CHUNK_SIZE;
+	while (true)
+	{
+		Uint32 chunk = (Uint32)SDL_AddAtomicInt(&Builder.NextChunk, 1);
+		if (chunk >= chunkCount)
+		{
+			break;
+		}
+
+		Uint32 first = chunk * SPRITE_BUILD_CHUNK_SIZE;
+		BuildSpriteRange(Builder.Sprites, Builder.Compact, first, SDL_min(first + SPRITE_BUILD_CHUNK_SIZE, Builder.Count), &Builder.Info);
+	}
+}
+
+static int SpriteBuilderThread(void* data)
+{
+	Uint32 generation = 0;
+
+	SDL_LockMutex(Builder.Lock);
+	while (true)
+	{
+		while (Builder.Generation == generation && !Builder.ShuttingDown)
+		{
+			SDL_WaitCondition(Builder.WorkAvailable, Builder.Lock);
+		}
+		if (Builder.ShuttingDown)
+		{
+			break;
+		}
+		generation = Builder.Generation;
+
+		SDL_UnlockMutex(Builder.Lock);
+		PROFILE_BEGIN("Build Sprites");
+		RunSpriteBuildChunks();
+		PROFILE_END();
+		SDL_LockMutex(Builder.Lock);
+
+		Builder.BusyWorkers -= 1;
+		if (Builder.BusyWorkers == 0)
+		{
+			SDL_SignalCondition(Builder.WorkFinished);
+		}
+	}
+	SDL_UnlockMutex(Builder.Lock);
+
+	return 0;
+}
+
+void SetSpriteBuilderThreadCount(int threadCount)
+{
+	QuitSpriteBuilder();
+
+	Builder.Lock = SDL_CreateMutex();
+	Builder.WorkAvailable = SDL_CreateCondition();
+	Builder.WorkFinished = SDL_CreateCondition();
+	Builder.WorkerCount = SDL_max(threadCount, 1) - 1;
+	Builder.Threads = SDL_calloc(SDL_max(Builder.WorkerCount, 1), sizeof(SDL_Thread*));
+	for (int i = 0; i < Builder.WorkerCount; i += 1)
+	{
+		Builder.Threads[i] = SDL_CreateThread(SpriteBuilderThread, "SpriteBuilder", NULL);
+		if (Builder.Threads[i] == NULL)
+		{
+			SDL_Log("Failed to create sprite builder thread: %s", SDL_GetError());
+			Builder.WorkerCount = i;
+			break;
+		}
+	}
+}
+
+void QuitSpriteBuilder()
+{
+	if (Builder.Threads == NULL)
+	{
+		return;
+	}
+
+	SDL_LockMutex(Builder.Lock);
+	Builder.ShuttingDown = true;
+	SDL_BroadcastCondition(Builder.WorkAvailable);
+	SDL_UnlockMutex(Builder.Lock);
+
+	for (int i = 0; i < Builder.WorkerCount; i += 1)
+	{
+		SDL_WaitThread(Builder.Threads[i], NULL);
+	}
+
+	SDL_free(Builder.Threads);
+	SDL_DestroyCondition(Builder.WorkFinished);
+	SDL_DestroyCondition(Builder.WorkAvailable);
+	SDL_DestroyMutex(Builder.Lock);
+	SDL_zero(Builder);
+}
+
+static void RunSpriteBuild(void* sprites, bool compact, Uint32 count, const SpriteBuildInfo* info)
+{
+	if (Builder.Threads == NULL)
+	{
+		SetSpriteBuilderThreadCount(SDL_GetNumLogicalCPUCores());
+	}
+
+	// Not worth waking anyone up for a single chunk
+	if (Builder.WorkerCount == 0 || count <= SPRITE_BUILD_CHUNK_SIZE)
+	{
+		BuildSpriteRange(sprites, compact, 0, count, info);
+		return;
+	}
+
+	SDL_LockMutex(Builder.Lock);
+	Builder.Sprites = sprites;
+	Builder.Compact = compact;
+	Builder.Count = count;
+	Builder.Info = *info;
+	SDL_SetAtomicInt(&Builder.NextChunk, 0);
+	Builder.BusyWorkers = Builder.WorkerCount;
+	Builder.Generation += 1;
+	SDL_BroadcastCondition(Builder.WorkAvailable);
+	SDL_UnlockMutex(Builder.Lock);
+
+	PROFILE_BEGIN("Build Sprites");
+	RunSpriteBuildChunks();
+	PROFILE_END();
+
+	SDL_LockMutex(Builder.Lock);
+	while (Builder.BusyWorkers > 0)
+	{
+		SDL_WaitCondition(Builder.WorkFinished, Builder.Lock);
+	}
+	SDL_UnlockMutex(Builder.Lock);
+}
+
+void BuildSprites(SpriteInstance* sprites, Uint32 count, const SpriteBuildInfo* info)
+{
+	RunSpriteBuild(sprites, false, count, info);
+}
+
+void BuildCompactSprites(CompactSpriteInstance* sprites, Uint32 count, const SpriteBuildInfo* info)
+{
+	RunSpriteBuild(sprites, true, count, info);
+}
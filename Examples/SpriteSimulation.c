@@ -0,0 +1,343 @@
+#include "Common.h"
+
+// Sprite Simulation
+// The instance and motion buffers are dense arrays of Count sprites. Each update first fills
+// the despawned slots with the sprites at the end of the arrays (GPU to GPU copies, so the CPU
+// never needs to know where a sprite currently is), then appends the queued spawns from staging
+// memory, then runs SpriteSimulate.comp over the result.
+
+typedef struct SpriteSimulationUniforms
+{
+	float DeltaTime;
+	Uint32 SpriteCount;
+	float AreaWidth;
+	float AreaHeight;
+} SpriteSimulationUniforms;
+
+bool CreateSpriteSimulation(SpriteSimulation* simulation, SDL_GPUDevice* device, Uint32 capacity)
+{
+	SDL_zerop(simulation);
+	simulation->Device = device;
+	simulation->Capacity = capacity;
+
+	simulation->Pipeline = CreateComputePipelineFromShader(
+		device,
+		"SpriteSimulate.comp",
+		&(SDL_GPUComputePipelineCreateInfo){
+			.num_readwrite_storage_buffers = 2,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+	if (simulation->Pipeline == NULL)
+	{
+		ReleaseSpriteSimulation(simulation);
+		return false;
+	}
+
+	// Rendering reads the instances in place, from either a compute or a vertex shader
+	simulation->InstanceBuffer = SDL_CreateGPUBuffer(
+		device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			.size = capacity * sizeof(SpriteInstance)
+		}
+	);
+
+	simulation->MotionBuffer = SDL_CreateGPUBuffer(
+		device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = capacity * sizeof(SpriteMotion)
+		}
+	);
+
+	if (simulation->InstanceBuffer == NULL || simulation->MotionBuffer == NULL)
+	{
+		SDL_Log("Failed to create sprite simulation buffers: %s", SDL_GetError());
+		ReleaseSpriteSimulation(simulation);
+		return false;
+	}
+
+	return true;
+}
+
+SpriteInstance* SpawnSprites(SpriteSimulation* simulation, Uint32 count, SpriteMotion** motions)
+{
+	Uint32 needed = simulation->SpawnCount + count;
+	if (needed > simulation->SpawnCapacity)
+	{
+		// Either array may already have grown when the other fails, which only wastes the space
+		Uint32 capacity = SDL_max(simulation->SpawnCapacity * 2, needed);
+		SpriteInstance* spawnInstances = SDL_realloc(simulation->SpawnInstances, capacity * sizeof(SpriteInstance));
+		if (spawnInstances != NULL)
+		{
+			simulation->SpawnInstances = spawnInstances;
+		}
+		SpriteMotion* spawnMotions = SDL_realloc(simulation->SpawnMotions, capacity * sizeof(SpriteMotion));
+		if (spawnMotions != NULL)
+		{
+			simulation->SpawnMotions = spawnMotions;
+		}
+		if (spawnInstances == NULL || spawnMotions == NULL)
+		{
+			SDL_Log("Could not queue %u sprite spawns!", count);
+			simulation->Stats.Dropped += count;
+			return NULL;
+		}
+		simulation->SpawnCapacity = capacity;
+	}
+
+	*motions = simulation->SpawnMotions + simulation->SpawnCount;
+	SpriteInstance* instances = simulation->SpawnInstances + simulation->SpawnCount;
+	simulation->SpawnCount = needed;
+	return instances;
+}
+
+void SpawnRandomSprites(SpriteSimulation* simulation, Uint32 count, const SpriteBuildInfo* info)
+{
+	SpriteMotion* motions;
+	SpriteInstance* instances = SpawnSprites(simulation, count, &motions);
+	if (instances == NULL)
+	{
+		return;
+	}
+	BuildSprites(instances, count, info);
+
+	Uint64 state = info->Seed;
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		motions[i].vx = (SDL_randf_r(&state) * 2.0f - 1.0f) * 120.0f;
+		motions[i].vy = (SDL_randf_r(&state) * 2.0f - 1.0f) * 120.0f;
+		motions[i].spin = (SDL_randf_r(&state) * 2.0f - 1.0f) * SDL_PI_F;
+		motions[i].hue = SDL_randf_r(&state);
+		instances[i].z = SDL_randf_r(&state); // A random layer, for batches that sort by depth
+	}
+}
+
+void DespawnSprite(SpriteSimulation* simulation, Uint32 index)
+{
+	if (simulation->DespawnCount == simulation->DespawnCapacity)
+	{
+		Uint32 capacity = SDL_max(simulation->DespawnCapacity * 2, 64);
+		Uint32* despawns = SDL_realloc(simulation->Despawns, capacity * sizeof(Uint32));
+		if (despawns == NULL)
+		{
+			SDL_Log("Could not queue a sprite despawn!");
+			return;
+		}
+		simulation->Despawns = despawns;
+		simulation->DespawnCapacity = capacity;
+	}
+	simulation->Despawns[simulation->DespawnCount++] = index;
+}
+
+static int CompareSpriteIndices(const void* a, const void* b)
+{
+	Uint32 left = *(const Uint32*) a;
+	Uint32 right = *(const Uint32*) b;
+	return (left > right) - (left < right);
+}
+
+static void CopySprite(SpriteSimulation* simulation, SDL_GPUCopyPass* copyPass, Uint32 source, Uint32 destination)
+{
+	SDL_CopyGPUBufferToBuffer(
+		copyPass,
+		&(SDL_GPUBufferLocation) {
+			.buffer = simulation->InstanceBuffer,
+			.offset = source * sizeof(SpriteInstance)
+		},
+		&(SDL_GPUBufferLocation) {
+			.buffer = simulation->InstanceBuffer,
+			.offset = destination * sizeof(SpriteInstance)
+		},
+		sizeof(SpriteInstance),
+		false
+	);
+	SDL_CopyGPUBufferToBuffer(
+		copyPass,
+		&(SDL_GPUBufferLocation) {
+			.buffer = simulation->MotionBuffer,
+			.offset = source * sizeof(SpriteMotion)
+		},
+		&(SDL_GPUBufferLocation) {
+			.buffer = simulation->MotionBuffer,
+			.offset = destination * sizeof(SpriteMotion)
+		},
+		sizeof(SpriteMotion),
+		false
+	);
+}
+
+static void ApplyDespawns(SpriteSimulation* simulation, SDL_GPUCommandBuffer* commandBuffer)
+{
+	// Sort, drop duplicates and anything past the end
+	SDL_qsort(simulation->Despawns, simulation->DespawnCount, sizeof(Uint32), CompareSpriteIndices);
+	Uint32 despawnCount = 0;
+	for (Uint32 i = 0; i < simulation->DespawnCount; i += 1)
+	{
+		Uint32 index = simulation->Despawns[i];
+		if (index < simulation->Count && (despawnCount == 0 || simulation->Despawns[despawnCount - 1] != index))
+		{
+			simulation->Despawns[despawnCount++] = index;
+		}
+	}
+	simulation->DespawnCount = 0;
+	if (despawnCount == 0)
+	{
+		return;
+	}
+
+	// Despawned slots below the new end are filled by the surviving sprites above it. Sources
+	// and destinations never overlap, so the order of the copies does not matter.
+	Uint32 newCount = simulation->Count - despawnCount;
+	Uint32 hole = 0;
+	Uint32 skip = 0;
+	while (skip < despawnCount && simulation->Despawns[skip] < newCount)
+	{
+		skip += 1;
+	}
+
+	SDL_GPUCopyPass* copyPass = NULL;
+	for (Uint32 source = newCount; source < simulation->Count; source += 1)
+	{
+		if (skip < despawnCount && simulation->Despawns[skip] == source)
+		{
+			skip += 1;
+			continue;
+		}
+
+		if (copyPass == NULL)
+		{
+			copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+		}
+		CopySprite(simulation, copyPass, source, simulation->Despawns[hole++]);
+	}
+
+	if (copyPass != NULL)
+	{
+		SDL_EndGPUCopyPass(copyPass);
+	}
+
+	simulation->Count = newCount;
+	simulation->Stats.Despawned += despawnCount;
+}
+
+static void ApplySpawns(SpriteSimulation* simulation, SDL_GPUCommandBuffer* commandBuffer)
+{
+	Uint32 spawnCount = SDL_min(simulation->SpawnCount, simulation->Capacity - simulation->Count);
+	simulation->Stats.Dropped += simulation->SpawnCount - spawnCount;
+	simulation->SpawnCount = 0;
+	if (spawnCount == 0)
+	{
+		return;
+	}
+
+	StagingAllocation instanceStaging;
+	StagingAllocation motionStaging;
+	if (!StageData(simulation->Device, simulation->SpawnInstances, spawnCount * sizeof(SpriteInstance), 16, &instanceStaging) ||
+		!StageData(simulation->Device, simulation->SpawnMotions, spawnCount * sizeof(SpriteMotion), 16, &motionStaging))
+	{
+		SDL_Log("Could not stage %u spawned sprites!", spawnCount);
+		simulation->Stats.Dropped += spawnCount;
+		return;
+	}
+
+	// A separate copy pass from the despawn copies, which may still be reading these slots
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = instanceStaging.TransferBuffer,
+			.offset = instanceStaging.Offset
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = simulation->InstanceBuffer,
+			.offset = simulation->Count * sizeof(SpriteInstance),
+			.size = spawnCount * sizeof(SpriteInstance)
+		},
+		false
+	);
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = motionStaging.TransferBuffer,
+			.offset = motionStaging.Offset
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = simulation->MotionBuffer,
+			.offset = simulation->Count * sizeof(SpriteMotion),
+			.size = spawnCount * sizeof(SpriteMotion)
+		},
+		false
+	);
+	SDL_EndGPUCopyPass(copyPass);
+
+	simulation->Count += spawnCount;
+	simulation->Stats.Spawned += spawnCount;
+	simulation->Stats.UploadedBytes += spawnCount * (sizeof(SpriteInstance) + sizeof(SpriteMotion));
+}
+
+void UpdateSpriteSimulation(
+	SpriteSimulation* simulation,
+	SDL_GPUCommandBuffer* commandBuffer,
+	float deltaTime,
+	float areaWidth,
+	float areaHeight
+) {
+	PROFILE_BEGIN("Update Sprite Simulation");
+	ApplyDespawns(simulation, commandBuffer);
+	ApplySpawns(simulation, commandBuffer);
+	if (simulation->Count == 0)
+	{
+		PROFILE_END();
+		return;
+	}
+
+	// The state has to survive the pass, so the buffers must not be cycled
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		commandBuffer,
+		NULL,
+		0,
+		(SDL_GPUStorageBufferReadWriteBinding[]){
+			{ .buffer = simulation->InstanceBuffer, .cycle = false },
+			{ .buffer = simulation->MotionBuffer, .cycle = false }
+		},
+		2
+	);
+
+	SpriteSimulationUniforms uniforms = {
+		.DeltaTime = deltaTime,
+		.SpriteCount = simulation->Count,
+		.AreaWidth = areaWidth,
+		.AreaHeight = areaHeight
+	};
+	SDL_BindGPUComputePipeline(computePass, simulation->Pipeline);
+	SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+	SDL_DispatchGPUCompute(computePass, (simulation->Count + 63) / 64, 1, 1);
+	SDL_EndGPUComputePass(computePass);
+
+	simulation->Stats.Steps += 1;
+	PROFILE_END();
+}
+
+void ReleaseSpriteSimulation(SpriteSimulation* simulation)
+{
+	if (simulation->Device == NULL)
+	{
+		return;
+	}
+
+	if (simulation->Pipeline != NULL)
+	{
+		ReleaseComputePipeline(simulation->Device, simulation->Pipeline);
+	}
+	SDL_ReleaseGPUBuffer(simulation->Device, simulation->InstanceBuffer);
+	SDL_ReleaseGPUBuffer(simulation->Device, simulation->MotionBuffer);
+	SDL_free(simulation->SpawnInstances);
+	SDL_free(simulation->SpawnMotions);
+	SDL_free(simulation->Despawns);
+	SDL_zerop(simulation);
+}
@@ -0,0 +1,377 @@
+#include "Common.h"
+
+// Staging Memory
+// Each page is a bump allocator over one transfer buffer. Every staging submission gets a
+// serial number, and a page remembers the serial of the last submission that used it; once
+// that submission's fence has signaled the page is rewound and reused. Pages are stamped when
+// a command buffer is submitted rather than when they're mapped: the pages written since the
+// previous staging submission are the ones this one reads, and a page written again after
+// that (a resize, or a failed submit) waits for the next stamp.
+
+#define STAGING_PAGE_SIZE (8 * 1024 * 1024)
+#define STAGING_MAX_PAGES 4
+#define STAGING_UNSUBMITTED SDL_MAX_UINT64 // LastUse of a page with allocations not yet submitted
+
+typedef struct StagingPage
+{
+	SDL_GPUTransferBuffer* TransferBuffer;
+	Uint32 Size;
+	Uint32 Head;
+	Uint64 LastUse;
+} StagingPage;
+
+typedef struct StagingSubmission
+{
+	SDL_GPUFence* Fence;
+	Uint64 Serial;
+} StagingSubmission;
+
+typedef struct StagingAllocator
+{
+	SDL_GPUDevice* Device;
+	StagingPage* Pages;
+	int PageCount;
+	int PageCapacity;
+	int CurrentPage;
+	StagingSubmission* Submissions; // Oldest first
+	int SubmissionCount;
+	int SubmissionCapacity;
+	Uint64 NextSerial; // The submission that the allocations being made now will belong to
+	Uint64 CompletedSerial;
+	StagingStats Stats;
+} StagingAllocator;
+
+static StagingAllocator Staging;
+
+// Releases the fences of finished submissions, blocking on any up to waitSerial
+static void RetireStagingSubmissions(SDL_GPUDevice* device, Uint64 waitSerial)
+{
+	int retired = 0;
+	while (retired < Staging.SubmissionCount)
+	{
+		StagingSubmission* submission = &Staging.Submissions[retired];
+		if (submission->Serial <= waitSerial)
+		{
+			PROFILE_BEGIN("Wait For Fence");
+			SDL_WaitForGPUFences(device, true, &submission->Fence, 1);
+			PROFILE_END();
+		}
+		else if (!SDL_QueryGPUFence(device, submission->Fence))
+		{
+			break;
+		}
+
+		SDL_ReleaseGPUFence(device, submission->Fence);
+		Staging.CompletedSerial = submission->Serial;
+		retired += 1;
+	}
+
+	if (retired == 0)
+	{
+		return;
+	}
+	Staging.SubmissionCount -= retired;
+	SDL_memmove(Staging.Submissions, Staging.Submissions + retired, Staging.SubmissionCount * sizeof(StagingSubmission));
+}
+
+static bool CreateStagingPage(SDL_GPUDevice* device, StagingPage* page, Uint32 size)
+{
+	page->TransferBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = size
+		}
+	);
+	if (page->TransferBuffer == NULL)
+	{
+		SDL_Log("Failed to create a %u byte staging page: %s", size, SDL_GetError());
+		return false;
+	}
+
+	page->Size = size;
+	page->Head = 0;
+	page->LastUse = 0;
+	Staging.Stats.PageCount += 1;
+	Staging.Stats.PageBytes += size;
+	return true;
+}
+
+static StagingPage* AcquireStagingPage(SDL_GPUDevice* device, Uint32 size)
+{
+	RetireStagingSubmissions(device, 0);
+
+	// Rewind an idle page that's big enough
+	for (int i = 0; i < Staging.PageCount; i += 1)
+	{
+		StagingPage* page = &Staging.Pages[i];
+		if (page->LastUse <= Staging.CompletedSerial && page->Size >= size)
+		{
+			page->Head = 0;
+			Staging.CurrentPage = i;
+			return page;
+		}
+	}
+
+	// Otherwise wait for the least recently used page that has been submitted. Pages
+	// still holding unsubmitted allocations can't be waited on.
+	int oldest = -1;
+	for (int i = 0; i < Staging.PageCount; i += 1)
+	{
+		if (Staging.Pages[i].LastUse < Staging.NextSerial &&
+			(oldest < 0 || Staging.Pages[i].LastUse < Staging.Pages[oldest].LastUse))
+		{
+			oldest = i;
+		}
+	}
+
+	if (Staging.PageCount < STAGING_MAX_PAGES || oldest < 0)
+	{
+		if (Staging.PageCount == Staging.PageCapacity)
+		{
+			int capacity = SDL_max(Staging.PageCapacity * 2, STAGING_MAX_PAGES);
+			StagingPage* pages = SDL_realloc(Staging.Pages, capacity * sizeof(StagingPage));
+			if (pages == NULL)
+			{
+				SDL_Log("Out of memory, can't add a staging page!");
+				return NULL;
+			}
+			Staging.Pages = pages;
+			Staging.PageCapacity = capacity;
+		}
+
+		StagingPage* page = &Staging.Pages[Staging.PageCount];
+		if (!CreateStagingPage(device, page, SDL_max(size, STAGING_PAGE_SIZE)))
+		{
+			return NULL;
+		}
+		Staging.CurrentPage = Staging.PageCount++;
+		return page;
+	}
+
+	StagingPage* page = &Staging.Pages[oldest];
+	RetireStagingSubmissions(device, page->LastUse);
+	Staging.Stats.FenceWaits += 1;
+
+	if (page->Size < size)
+	{
+		Staging.Stats.PageCount -= 1;
+		Staging.Stats.PageBytes -= page->Size;
+		SDL_ReleaseGPUTransferBuffer(device, page->TransferBuffer);
+		if (!CreateStagingPage(device, page, size))
+		{
+			SDL_memmove(page, page + 1, (Staging.PageCount - oldest - 1) * sizeof(StagingPage));
+			Staging.PageCount -= 1;
+			Staging.CurrentPage = 0;
+			return NULL;
+		}
+	}
+
+	page->Head = 0;
+	Staging.CurrentPage = oldest;
+	return page;
+}
+
+void BindStagingDevice(SDL_GPUDevice* device)
+{
+	if (Staging.Device != device)
+	{
+		if (Staging.Device != NULL)
+		{
+			ReleaseStagingMemory(Staging.Device);
+		}
+		Staging.Device = device;
+		Staging.NextSerial = 1;
+		Staging.CompletedSerial = 0;
+	}
+}
+
+void* MapStagingMemory(SDL_GPUDevice* device, Uint32 size, Uint32 alignment, StagingAllocation* allocation)
+{
+	BindStagingDevice(device);
+
+	if (alignment == 0)
+	{
+		alignment = 16;
+	}
+
+	StagingPage* page = (Staging.PageCount > 0) ? &Staging.Pages[Staging.CurrentPage] : NULL;
+	Uint32 offset = 0;
+	if (page != NULL)
+	{
+		offset = (page->Head + alignment - 1) / alignment * alignment;
+	}
+	if (page == NULL || offset > page->Size || size > page->Size - offset)
+	{
+		page = AcquireStagingPage(device, size);
+		if (page == NULL)
+		{
+			return NULL;
+		}
+		offset = 0;
+	}
+
+	Uint8* data = SDL_MapGPUTransferBuffer(device, page->TransferBuffer, false);
+	if (data == NULL)
+	{
+		SDL_Log("Failed to map staging page: %s", SDL_GetError());
+		return NULL;
+	}
+
+	page->Head = offset + size;
+	page->LastUse = STAGING_UNSUBMITTED;
+	Staging.Stats.Allocations += 1;
+	Staging.Stats.AllocatedBytes += size;
+
+	allocation->TransferBuffer = page->TransferBuffer;
+	allocation->Offset = offset;
+	allocation->Size = size;
+	return data + offset;
+}
+
+void UnmapStagingMemory(SDL_GPUDevice* device, const StagingAllocation* allocation)
+{
+	SDL_UnmapGPUTransferBuffer(device, allocation->TransferBuffer);
+}
+
+bool ResizeStagingMemory(SDL_GPUDevice* device, StagingAllocation* allocation, Uint32 size)
+{
+	if (Staging.Device != device || Staging.PageCount == 0)
+	{
+		return false;
+	}
+
+	StagingPage* page = &Staging.Pages[Staging.CurrentPage];
+	if (page->TransferBuffer != allocation->TransferBuffer ||
+		page->Head != allocation->Offset + allocation->Size ||
+		size > page->Size - allocation->Offset)
+	{
+		return false;
+	}
+
+	// The grown allocation may be recorded after the page's last stamp
+	page->Head = allocation->Offset + size;
+	page->LastUse = STAGING_UNSUBMITTED;
+	Staging.Stats.AllocatedBytes = Staging.Stats.AllocatedBytes - allocation->Size + size;
+	allocation->Size = size;
+	return true;
+}
+
+bool StageData(SDL_GPUDevice* device, const void* data, Uint32 size, Uint32 alignment, StagingAllocation* allocation)
+{
+	void* dst = MapStagingMemory(device, size, alignment, allocation);
+	if (dst == NULL)
+	{
+		return false;
+	}
+
+	SDL_memcpy(dst, data, size);
+	UnmapStagingMemory(device, allocation);
+	return true;
+}
+
+bool SubmitStagingCommandBuffer(SDL_GPUDevice* device, SDL_GPUCommandBuffer* commandBuffer)
+{
+	PROFILE_BEGIN("Submit");
+	Uint64 submitStart = SDL_GetPerformanceCounter();
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	CountSubmit(submitStart);
+	PROFILE_END();
+	if (fence == NULL)
+	{
+		SDL_Log("Failed to submit staging command buffer: %s", SDL_GetError());
+		return false;
+	}
+
+	// Even with nothing staged yet, the fence may be waited on (e.g. to throttle headless frames)
+	BindStagingDevice(device);
+
+	if (Staging.SubmissionCount == Staging.SubmissionCapacity)
+	{
+		int capacity = SDL_max(Staging.SubmissionCapacity * 2, 16);
+		StagingSubmission* submissions = SDL_realloc(Staging.Submissions, capacity * sizeof(StagingSubmission));
+		if (submissions == NULL)
+		{
+			// The pages it used stay unsubmitted, so the next submission's fence, which signals
+			// after this one, covers them
+			SDL_Log("Out of memory, can't track a staging submission!");
+			SDL_ReleaseGPUFence(device, fence);
+			return false;
+		}
+		Staging.Submissions = submissions;
+		Staging.SubmissionCapacity = capacity;
+	}
+	Staging.Submissions[Staging.SubmissionCount++] = (StagingSubmission) {
+		.Fence = fence,
+		.Serial = Staging.NextSerial
+	};
+	for (int i = 0; i < Staging.PageCount; i += 1)
+	{
+		if (Staging.Pages[i].LastUse == STAGING_UNSUBMITTED)
+		{
+			Staging.Pages[i].LastUse = Staging.NextSerial;
+		}
+	}
+	Staging.NextSerial += 1;
+
+	RetireStagingSubmissions(device, 0);
+	return true;
+}
+
+void WaitForStagingSubmissions(SDL_GPUDevice* device)
+{
+	if (Staging.Device == device)
+	{
+		RetireStagingSubmissions(device, Staging.NextSerial - 1);
+	}
+}
+
+Uint64 GetNextStagingSerial(SDL_GPUDevice* device)
+{
+	// The first submission on any other device binds it and starts over from 1
+	return (Staging.Device == device) ? Staging.NextSerial : 1;
+}
+
+Uint64 GetCompletedStagingSerial(SDL_GPUDevice* device)
+{
+	if (Staging.Device != device)
+	{
+		return 0;
+	}
+
+	RetireStagingSubmissions(device, 0);
+	return Staging.CompletedSerial;
+}
+
+void WaitForStagingSerial(SDL_GPUDevice* device, Uint64 serial)
+{
+	if (Staging.Device == device && serial > Staging.CompletedSerial)
+	{
+		RetireStagingSubmissions(device, serial);
+	}
+}
+
+void ReleaseStagingMemory(SDL_GPUDevice* device)
+{
+	if (Staging.Device != device)
+	{
+		return;
+	}
+
+	RetireStagingSubmissions(device, Staging.NextSerial);
+	for (int i = 0; i < Staging.PageCount; i += 1)
+	{
+		SDL_ReleaseGPUTransferBuffer(device, Staging.Pages[i].TransferBuffer);
+	}
+
+	SDL_free(Staging.Pages);
+	SDL_free(Staging.Submissions);
+	SDL_zero(Staging);
+}
+
+StagingStats GetStagingStats()
+{
+	StagingStats stats = Staging.Stats;
+	stats.InFlightSubmissions = Staging.SubmissionCount;
+	return stats;
+}
@@ -0,0 +1,163 @@
+#include "Common.h"
+
+// Texture Compression Cache
+// Uncompressed images can be encoded to a block format at load time. Encoding is slow, so
+// each result is written to the user's pref directory, named after a hash of the source
+// pixels and the target format; the next run with the same pixels just reads the blocks.
+
+#define TEXTURE_CACHE_MAGIC 0x43544753 // 'SGTC'
+#define TEXTURE_CACHE_VERSION 1
+
+typedef struct TextureCacheHeader
+{
+	Uint32 Magic;
+	Uint32 Version;
+	Uint32 Format;
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 DataLength;
+	Uint64 SourceHash;
+} TextureCacheHeader;
+
+static bool ImageCompressionEnabled = false;
+
+void SetImageCompressionEnabled(bool enabled)
+{
+	ImageCompressionEnabled = enabled;
+}
+
+static bool IsSurfaceOpaque(const SDL_Surface* image)
+{
+	const Uint8* pixels = image->pixels;
+	for (int i = 0; i < image->w * image->h; i += 1)
+	{
+		if (pixels[i * 4 + 3] != 255)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+SDL_GPUTextureFormat SelectImageTextureFormat(SDL_GPUDevice* device, const SDL_Surface* image)
+{
+	// Block formats need whole blocks at the top level
+	if (!ImageCompressionEnabled || image->w % 4 != 0 || image->h % 4 != 0)
+	{
+		return SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+	}
+
+	// Opaque images fit BC1 (8:1); anything with alpha gets BC7, or BC3 without it (4:1)
+	static const SDL_GPUTextureFormat OpaqueFormats[] = { SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM };
+	static const SDL_GPUTextureFormat AlphaFormats[] = { SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM };
+	const SDL_GPUTextureFormat* candidates = IsSurfaceOpaque(image) ? OpaqueFormats : AlphaFormats;
+
+	for (int i = 0; i < 2; i += 1)
+	{
+		if (SDL_GPUTextureSupportsFormat(device, candidates[i], SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+		{
+			return candidates[i];
+		}
+	}
+	return SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+}
+
+static Uint64 HashImagePixels(const SDL_Surface* image, SDL_GPUTextureFormat format)
+{
+	// FNV-1a over the encoding parameters, then the pixels
+	Uint32 parameters[4] = { TEXTURE_CACHE_VERSION, (Uint32)format, (Uint32)image->w, (Uint32)image->h };
+	Uint64 hash = 14695981039346656037ull;
+	const Uint8* bytes = (const Uint8*)parameters;
+	for (size_t i = 0; i < sizeof(parameters); i += 1)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	bytes = image->pixels;
+	for (size_t i = 0; i < (size_t)image->w * image->h * 4; i += 1)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+static bool GetTextureCachePath(Uint64 hash, char* path, size_t pathSize)
+{
+	char* prefPath = SDL_GetPrefPath("libsdl", "SDL_gpu_examples");
+	if (prefPath == NULL)
+	{
+		return false;
+	}
+
+	SDL_snprintf(path, pathSize, "%sTextureCache", prefPath);
+	bool created = SDL_CreateDirectory(path);
+	SDL_snprintf(path, pathSize, "%sTextureCache/%016" SDL_PRIx64 ".tex", prefPath, hash);
+	SDL_free(prefPath);
+	return created;
+}
+
+void* EncodeImage(const SDL_Surface* image, SDL_GPUTextureFormat format, Uint32* pLength)
+{
+	Uint32 dataLength = GetCompressedTextureLength(format, image->w, image->h);
+	if (dataLength == 0)
+	{
+		SDL_Log("No software encoder for texture format %d!", format);
+		return NULL;
+	}
+
+	Uint64 hash = HashImagePixels(image, format);
+	char path[256];
+	bool cacheAvailable = GetTextureCachePath(hash, path, sizeof(path));
+
+	// Blocks are returned in place, so the cached file's header is just moved out of the way
+	size_t fileSize = 0;
+	Uint8* file = cacheAvailable ? SDL_LoadFile(path, &fileSize) : NULL;
+	if (file != NULL)
+	{
+		TextureCacheHeader header;
+		SDL_memcpy(&header, file, SDL_min(fileSize, sizeof(header)));
+		if (fileSize == sizeof(header) + dataLength &&
+			header.Magic == TEXTURE_CACHE_MAGIC &&
+			header.Version == TEXTURE_CACHE_VERSION &&
+			header.Format == (Uint32)format &&
+			header.Width == (Uint32)image->w &&
+			header.Height == (Uint32)image->h &&
+			header.DataLength == dataLength &&
+			header.SourceHash == hash)
+		{
+			SDL_memmove(file, file + sizeof(header), dataLength);
+			*pLength = dataLength;
+			return file;
+		}
+		SDL_free(file);
+	}
+
+	file = SDL_malloc(sizeof(TextureCacheHeader) + dataLength);
+	if (file == NULL)
+	{
+		return NULL;
+	}
+
+	Uint64 encodeStart = SDL_GetPerformanceCounter();
+	CompressTextureData(format, image->pixels, image->w, image->h, file + sizeof(TextureCacheHeader));
+	double encodeMilliseconds = (double)(SDL_GetPerformanceCounter() - encodeStart) * 1000.0 / SDL_GetPerformanceFrequency();
+	SDL_Log("Encoded a %dx%d image to format %d in %.1f ms", image->w, image->h, format, encodeMilliseconds);
+
+	TextureCacheHeader header = {
+		.Magic = TEXTURE_CACHE_MAGIC,
+		.Version = TEXTURE_CACHE_VERSION,
+		.Format = (Uint32)format,
+		.Width = (Uint32)image->w,
+		.Height = (Uint32)image->h,
+		.DataLength = dataLength,
+		.SourceHash = hash
+	};
+	SDL_memcpy(file, &header, sizeof(header));
+	if (cacheAvailable && !SDL_SaveFile(path, file, sizeof(header) + dataLength))
+	{
+		SDL_Log("Failed to write texture cache entry %s: %s", path, SDL_GetError());
+	}
+
+	SDL_memmove(file, file + sizeof(header), dataLength);
+	*pLength = dataLength;
+	return file;
+}
@@ -0,0 +1,2525 @@
+#include "Common.h"
+
+// Software Texture Decoding and Encoding
+// CPU fallbacks for block-compressed formats a device can't sample. Every format decodes a
+// whole block at a time (4x4 for BCn, up to 12x12 for ASTC) into a small RGBA scratch tile,
+// which is then clipped into the destination; rows of blocks are spread across threads for
+// the larger subresources. BC1, BC3 and BC7 can also be encoded, the same way in reverse.
+
+#define MIN_BLOCK_ROWS_PER_THREAD 16
+#define MAX_DECODE_THREADS 64
+
+typedef struct BlockFormatInfo BlockFormatInfo;
+typedef void (*BlockDecoder)(const BlockFormatInfo* info, const Uint8* block, void* texels);
+typedef void (*BlockEncoder)(const Uint8* texels, Uint8* block);
+
+struct BlockFormatInfo
+{
+	SDL_GPUTextureFormat Format;
+	SDL_GPUTextureFormat DecompressedFormat;
+	int BlockWidth;
+	int BlockHeight;
+	int BlockSize;
+	int TexelSize;
+	bool IsSRGB;
+	BlockDecoder Decoder;
+	BlockEncoder Encoder; // NULL if the format can only be decoded
+};
+
+// The 128 bits of a block, read from the least significant bit up
+typedef struct BlockBits
+{
+	Uint64 Low;
+	Uint64 High;
+	int Position;
+} BlockBits;
+
+static BlockBits LoadBlockBits(const Uint8* block)
+{
+	BlockBits bits = { 0 };
+	for (int i = 0; i < 8; i += 1)
+	{
+		bits.Low |= (Uint64)block[i] << (i * 8);
+		bits.High |= (Uint64)block[i + 8] << (i * 8);
+	}
+	return bits;
+}
+
+static Uint32 ReadBlockBits(BlockBits* bits, int count)
+{
+	Uint32 result;
+	if (count == 0)
+	{
+		return 0;
+	}
+	else if (bits->Position >= 64)
+	{
+		result = (Uint32)(bits->High >> (bits->Position - 64));
+	}
+	else if (bits->Position + count <= 64)
+	{
+		result = (Uint32)(bits->Low >> bits->Position);
+	}
+	else
+	{
+		result = (Uint32)((bits->Low >> bits->Position) | (bits->High << (64 - bits->Position)));
+	}
+
+	bits->Position += count;
+	return result & ((1u << count) - 1);
+}
+
+static void WriteBlockBits(BlockBits* bits, Uint32 value, int count)
+{
+	if (bits->Position >= 64)
+	{
+		bits->High |= (Uint64)value << (bits->Position - 64);
+	}
+	else
+	{
+		bits->Low |= (Uint64)value << bits->Position;
+		if (bits->Position + count > 64)
+		{
+			bits->High |= (Uint64)value >> (64 - bits->Position);
+		}
+	}
+	bits->Position += count;
+}
+
+static void StoreBlockBits(const BlockBits* bits, Uint8* block)
+{
+	for (int i = 0; i < 8; i += 1)
+	{
+		block[i] = (Uint8)(bits->Low >> (i * 8));
+		block[i + 8] = (Uint8)(bits->High >> (i * 8));
+	}
+}
+
+// Some BC6H fields are stored with their bits in reverse order
+static Uint32 ReadBlockBitsReversed(BlockBits* bits, int count)
+{
+	Uint32 result = 0;
+	for (int i = 0; i < count; i += 1)
+	{
+		result = (result << 1) | ReadBlockBits(bits, 1);
+	}
+	return result;
+}
+
+// BC1 - BC5
+
+static void DecodeBC1Colors(const Uint8* block, Uint8* texels, bool allowTransparency)
+{
+	Uint16 c0 = block[0] | (block[1] << 8);
+	Uint16 c1 = block[2] | (block[3] << 8);
+	Uint8 palette[4][4];
+
+	palette[0][0] = ((c0 >> 11) << 3) | (c0 >> 13);
+	palette[0][1] = (((c0 >> 5) & 0x3F) << 2) | ((c0 >> 9) & 0x3);
+	palette[0][2] = ((c0 & 0x1F) << 3) | ((c0 >> 2) & 0x7);
+	palette[1][0] = ((c1 >> 11) << 3) | (c1 >> 13);
+	palette[1][1] = (((c1 >> 5) & 0x3F) << 2) | ((c1 >> 9) & 0x3);
+	palette[1][2] = ((c1 & 0x1F) << 3) | ((c1 >> 2) & 0x7);
+	palette[0][3] = palette[1][3] = 255;
+
+	if (c0 > c1 || !allowTransparency)
+	{
+		for (int c = 0; c < 3; c += 1)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		palette[2][3] = palette[3][3] = 255;
+	}
+	else
+	{
+		for (int c = 0; c < 3; c += 1)
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+		palette[2][3] = 255;
+		palette[3][3] = 0;
+	}
+
+	Uint32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((Uint32)block[7] << 24);
+	for (int i = 0; i < 16; i += 1)
+	{
+		SDL_memcpy(texels + i * 4, palette[(indices >> (i * 2)) & 0x3], 4);
+	}
+}
+
+static void DecodeBC4Channel(const Uint8* block, Uint8* texels, int channel)
+{
+	Uint8 palette[8];
+	palette[0] = block[0];
+	palette[1] = block[1];
+
+	if (palette[0] > palette[1])
+	{
+		for (int i = 1; i < 7; i += 1)
+		{
+			palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7;
+		}
+	}
+	else
+	{
+		for (int i = 1; i < 5; i += 1)
+		{
+			palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	Uint64 indices = 0;
+	for (int i = 0; i < 6; i += 1)
+	{
+		indices |= (Uint64)block[2 + i] << (i * 8);
+	}
+	for (int i = 0; i < 16; i += 1)
+	{
+		texels[i * 4 + channel] = palette[(indices >> (i * 3)) & 0x7];
+	}
+}
+
+static void DecodeBC1Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	DecodeBC1Colors(block, texels, true);
+}
+
+static void DecodeBC2Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	Uint8* rgba = texels;
+	DecodeBC1Colors(block + 8, rgba, false);
+	for (int i = 0; i < 16; i += 1)
+	{
+		Uint8 alpha = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+		rgba[i * 4 + 3] = alpha * 17;
+	}
+}
+
+static void DecodeBC3Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	DecodeBC1Colors(block + 8, texels, false);
+	DecodeBC4Channel(block, texels, 3);
+}
+
+// BC4 and BC5 sample as (r, 0, 0, 1) and (r, g, 0, 1)
+static void DecodeBC4Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	Uint8* rgba = texels;
+	for (int i = 0; i < 16; i += 1)
+	{
+		rgba[i * 4 + 1] = 0;
+		rgba[i * 4 + 2] = 0;
+		rgba[i * 4 + 3] = 255;
+	}
+	DecodeBC4Channel(block, rgba, 0);
+}
+
+static void DecodeBC5Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	Uint8* rgba = texels;
+	for (int i = 0; i < 16; i += 1)
+	{
+		rgba[i * 4 + 2] = 0;
+		rgba[i * 4 + 3] = 255;
+	}
+	DecodeBC4Channel(block, rgba, 0);
+	DecodeBC4Channel(block + 8, rgba, 1);
+}
+
+// BC6H and BC7 shared tables
+
+// Subset 1 membership of each texel for the 64 two-subset partitions
+static const Uint16 Partitions2[64] =
+{
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+	0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+	0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+	0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+	0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+static const Uint8 Partitions3[64][16] =
+{
+	{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+	{ 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+	{ 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+	{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+	{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+	{ 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+	{ 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+	{ 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+	{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+	{ 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+	{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+	{ 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+	{ 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+	{ 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+	{ 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+	{ 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+	{ 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+	{ 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+	{ 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+	{ 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+	{ 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+	{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+	{ 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+	{ 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+	{ 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+	{ 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+	{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+	{ 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+	{ 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+	{ 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+	{ 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+	{ 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+	{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+	{ 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+	{ 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+	{ 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+	{ 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+	{ 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+	{ 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+	{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+	{ 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+	{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+	{ 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+	{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+	{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+	{ 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+	{ 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+	{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+	{ 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+	{ 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+	{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+	{ 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+	{ 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+	{ 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+	{ 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+};
+
+// The anchor texel of each subset stores its index with one bit fewer (subset 0's is texel 0)
+static const Uint8 Anchors2[64] =
+{
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+	15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+	 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+static const Uint8 Anchors3Second[64] =
+{
+	 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+	 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+	 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+	 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+};
+
+static const Uint8 Anchors3Third[64] =
+{
+	15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+	15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+	15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+	15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+};
+
+static const Uint8 Weights2[4] = { 0, 21, 43, 64 };
+static const Uint8 Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const Uint8 Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const Uint8* GetInterpolationWeights(int indexBits)
+{
+	return (indexBits == 2) ? Weights2 : (indexBits == 3) ? Weights3 : Weights4;
+}
+
+static int GetSubset(int subsetCount, int partition, int texel)
+{
+	if (subsetCount == 2)
+	{
+		return (Partitions2[partition] >> texel) & 1;
+	}
+	else if (subsetCount == 3)
+	{
+		return Partitions3[partition][texel];
+	}
+	return 0;
+}
+
+static bool IsAnchorTexel(int subsetCount, int partition, int texel)
+{
+	if (texel == 0)
+	{
+		return true;
+	}
+	else if (subsetCount == 2)
+	{
+		return texel == Anchors2[partition];
+	}
+	else if (subsetCount == 3)
+	{
+		return texel == Anchors3Second[partition] || texel == Anchors3Third[partition];
+	}
+	return false;
+}
+
+// BC7
+
+typedef struct BC7ModeInfo
+{
+	Uint8 SubsetCount;
+	Uint8 PartitionBits;
+	Uint8 RotationBits;
+	Uint8 IndexSelectionBits;
+	Uint8 ColorBits;
+	Uint8 AlphaBits;
+	Uint8 EndpointPBits;
+	Uint8 SharedPBits;
+	Uint8 IndexBits;
+	Uint8 SecondaryIndexBits;
+} BC7ModeInfo;
+
+static const BC7ModeInfo BC7Modes[8] =
+{
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+// Builds an RGBA8 palette between two endpoints: (e0 * (64 - w) + e1 * w + 32) >> 6
+static void InterpolateBC7Palette(const Uint8* e0, const Uint8* e1, const Uint8* weights, int count, Uint8* palette)
+{
+	int i = 0;
+
+#if defined(SDL_SSE2_INTRINSICS)
+	const __m128i zero = _mm_setzero_si128();
+	Uint32 packed0, packed1;
+	SDL_memcpy(&packed0, e0, 4);
+	SDL_memcpy(&packed1, e1, 4);
+	__m128i endpoint0 = _mm_unpacklo_epi8(_mm_set1_epi32((int)packed0), zero);
+	__m128i endpoint1 = _mm_unpacklo_epi8(_mm_set1_epi32((int)packed1), zero);
+
+	// Two palette entries per iteration, one per 64-bit half
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128i weight = _mm_set_epi16(
+			weights[i + 1], weights[i + 1], weights[i + 1], weights[i + 1],
+			weights[i], weights[i], weights[i], weights[i]
+		);
+		__m128i sum = _mm_add_epi16(
+			_mm_mullo_epi16(endpoint0, _mm_sub_epi16(_mm_set1_epi16(64), weight)),
+			_mm_mullo_epi16(endpoint1, weight)
+		);
+		__m128i result = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(32)), 6);
+		_mm_storel_epi64((__m128i*)(palette + i * 4), _mm_packus_epi16(result, zero));
+	}
+#elif defined(SDL_NEON_INTRINSICS)
+	uint16x8_t endpoint0 = vmovl_u8(vcreate_u8((Uint64)e0[0] | ((Uint64)e0[1] << 8) | ((Uint64)e0[2] << 16) | ((Uint64)e0[3] << 24) |
+		((Uint64)e0[0] << 32) | ((Uint64)e0[1] << 40) | ((Uint64)e0[2] << 48) | ((Uint64)e0[3] << 56)));
+	uint16x8_t endpoint1 = vmovl_u8(vcreate_u8((Uint64)e1[0] | ((Uint64)e1[1] << 8) | ((Uint64)e1[2] << 16) | ((Uint64)e1[3] << 24) |
+		((Uint64)e1[0] << 32) | ((Uint64)e1[1] << 40) | ((Uint64)e1[2] << 48) | ((Uint64)e1[3] << 56)));
+
+	for (; i + 2 <= count; i += 2)
+	{
+		uint16x8_t weight = vcombine_u16(vdup_n_u16(weights[i]), vdup_n_u16(weights[i + 1]));
+		uint16x8_t sum = vmlaq_u16(vmulq_u16(endpoint0, vsubq_u16(vdupq_n_u16(64), weight)), endpoint1, weight);
+		vst1_u8(palette + i * 4, vrshrn_n_u16(sum, 6));
+	}
+#endif
+
+	for (; i < count; i += 1)
+	{
+		for (int c = 0; c < 4; c += 1)
+		{
+			palette[i * 4 + c] = (Uint8)((e0[c] * (64 - weights[i]) + e1[c] * weights[i] + 32) >> 6);
+		}
+	}
+}
+
+static void DecodeBC7Block(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	Uint8* rgba = texels;
+	BlockBits bits = LoadBlockBits(block);
+
+	int mode = 0;
+	while (mode < 8 && ReadBlockBits(&bits, 1) == 0)
+	{
+		mode += 1;
+	}
+	if (mode == 8)
+	{
+		// Reserved encodings decode to transparent black
+		SDL_memset(rgba, 0, 64);
+		return;
+	}
+
+	const BC7ModeInfo* modeInfo = &BC7Modes[mode];
+	int partition = ReadBlockBits(&bits, modeInfo->PartitionBits);
+	int rotation = ReadBlockBits(&bits, modeInfo->RotationBits);
+	int indexSelection = ReadBlockBits(&bits, modeInfo->IndexSelectionBits);
+
+	// Endpoints are stored channel by channel: every R, then every G, B and A
+	Uint8 endpoints[6][4];
+	int endpointCount = modeInfo->SubsetCount * 2;
+	for (int c = 0; c < 3; c += 1)
+	{
+		for (int e = 0; e < endpointCount; e += 1)
+		{
+			endpoints[e][c] = (Uint8)ReadBlockBits(&bits, modeInfo->ColorBits);
+		}
+	}
+	for (int e = 0; e < endpointCount; e += 1)
+	{
+		endpoints[e][3] = (modeInfo->AlphaBits > 0) ? (Uint8)ReadBlockBits(&bits, modeInfo->AlphaBits) : 255;
+	}
+
+	int colorBits = modeInfo->ColorBits;
+	int alphaBits = modeInfo->AlphaBits;
+	if (modeInfo->EndpointPBits || modeInfo->SharedPBits)
+	{
+		Uint8 pBits[6];
+		for (int e = 0; e < endpointCount; e += 1)
+		{
+			pBits[e] = (modeInfo->EndpointPBits || e % 2 == 0) ? (Uint8)ReadBlockBits(&bits, 1) : pBits[e - 1];
+		}
+		for (int e = 0; e < endpointCount; e += 1)
+		{
+			for (int c = 0; c < 4; c += 1)
+			{
+				if (c < 3 || alphaBits > 0)
+				{
+					endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+				}
+			}
+		}
+		colorBits += 1;
+		alphaBits += (alphaBits > 0) ? 1 : 0;
+	}
+
+	// Expand to 8 bits by replicating the high bits into the low ones
+	for (int e = 0; e < endpointCount; e += 1)
+	{
+		for (int c = 0; c < 3; c += 1)
+		{
+			endpoints[e][c] = (Uint8)((endpoints[e][c] << (8 - colorBits)) | (endpoints[e][c] >> (2 * colorBits - 8)));
+		}
+		if (alphaBits > 0)
+		{
+			endpoints[e][3] = (Uint8)((endpoints[e][3] << (8 - alphaBits)) | (endpoints[e][3] >> (2 * alphaBits - 8)));
+		}
+	}
+
+	Uint8 indices[16];
+	Uint8 secondaryIndices[16];
+	for (int i = 0; i < 16; i += 1)
+	{
+		indices[i] = (Uint8)ReadBlockBits(&bits, modeInfo->IndexBits - (IsAnchorTexel(modeInfo->SubsetCount, partition, i) ? 1 : 0));
+	}
+	for (int i = 0; modeInfo->SecondaryIndexBits > 0 && i < 16; i += 1)
+	{
+		secondaryIndices[i] = (Uint8)ReadBlockBits(&bits, modeInfo->SecondaryIndexBits - (i == 0 ? 1 : 0));
+	}
+
+	Uint8 palettes[3][16 * 4];
+	int paletteSize = 1 << modeInfo->IndexBits;
+	for (int s = 0; s < modeInfo->SubsetCount; s += 1)
+	{
+		InterpolateBC7Palette(endpoints[s * 2], endpoints[s * 2 + 1], GetInterpolationWeights(modeInfo->IndexBits), paletteSize, palettes[s]);
+	}
+
+	if (modeInfo->SecondaryIndexBits == 0)
+	{
+		for (int i = 0; i < 16; i += 1)
+		{
+			SDL_memcpy(rgba + i * 4, &palettes[GetSubset(modeInfo->SubsetCount, partition, i)][indices[i] * 4], 4);
+		}
+	}
+	else
+	{
+		// Modes 4 and 5 index color and alpha separately; the selection bit swaps the two index sets
+		Uint8 secondaryPalette[8 * 4];
+		int secondarySize = 1 << modeInfo->SecondaryIndexBits;
+		InterpolateBC7Palette(endpoints[0], endpoints[1], GetInterpolationWeights(modeInfo->SecondaryIndexBits), secondarySize, secondaryPalette);
+
+		for (int i = 0; i < 16; i += 1)
+		{
+			const Uint8* color = indexSelection ? &secondaryPalette[secondaryIndices[i] * 4] : &palettes[0][indices[i] * 4];
+			const Uint8* alpha = indexSelection ? &palettes[0][indices[i] * 4] : &secondaryPalette[secondaryIndices[i] * 4];
+			rgba[i * 4 + 0] = color[0];
+			rgba[i * 4 + 1] = color[1];
+			rgba[i * 4 + 2] = color[2];
+			rgba[i * 4 + 3] = alpha[3];
+		}
+	}
+
+	if (rotation > 0)
+	{
+		for (int i = 0; i < 16; i += 1)
+		{
+			Uint8 swap = rgba[i * 4 + 3];
+			rgba[i * 4 + 3] = rgba[i * 4 + rotation - 1];
+			rgba[i * 4 + rotation - 1] = swap;
+		}
+	}
+}
+
+// BC6H
+
+typedef struct BC6HModeInfo
+{
+	Uint8 Mode;
+	Uint8 Transformed;
+	Uint8 EndpointBits;
+	Uint8 DeltaBits[3];
+} BC6HModeInfo;
+
+// Indexed by the 5-bit mode; the two-bit modes 0 and 1 are reached through 0x00 and 0x01
+static const BC6HModeInfo BC6HModes[32] =
+{
+	[0x00] = { 1, 1, 10, { 5, 5, 5 } },
+	[0x01] = { 2, 1, 7, { 6, 6, 6 } },
+	[0x02] = { 3, 1, 11, { 5, 4, 4 } },
+	[0x06] = { 4, 1, 11, { 4, 5, 4 } },
+	[0x0A] = { 5, 1, 11, { 4, 4, 5 } },
+	[0x0E] = { 6, 1, 9, { 5, 5, 5 } },
+	[0x12] = { 7, 1, 8, { 6, 5, 5 } },
+	[0x16] = { 8, 1, 8, { 5, 6, 5 } },
+	[0x1A] = { 9, 1, 8, { 5, 5, 6 } },
+	[0x1E] = { 10, 0, 6, { 6, 6, 6 } },
+	[0x03] = { 11, 0, 10, { 10, 10, 10 } },
+	[0x07] = { 12, 1, 11, { 9, 9, 9 } },
+	[0x0B] = { 13, 1, 12, { 8, 8, 8 } },
+	[0x0F] = { 14, 1, 16, { 4, 4, 4 } },
+};
+
+static Sint32 SignExtend(Uint32 value, int bits)
+{
+	Uint32 sign = 1u << (bits - 1);
+	return (Sint32)((value ^ sign) - sign);
+}
+
+static Sint32 UnquantizeBC6H(Sint32 value, int bits, bool isSigned)
+{
+	if (!isSigned)
+	{
+		if (bits >= 15 || value == 0)
+		{
+			return value;
+		}
+		else if (value == (1 << bits) - 1)
+		{
+			return 0xFFFF;
+		}
+		return ((value << 16) + 0x8000) >> bits;
+	}
+
+	bool negative = value < 0;
+	Sint32 magnitude = negative ? -value : value;
+	Sint32 result;
+	if (bits >= 16 || magnitude == 0)
+	{
+		result = magnitude;
+	}
+	else if (magnitude >= (1 << (bits - 1)) - 1)
+	{
+		result = 0x7FFF;
+	}
+	else
+	{
+		result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+	}
+	return negative ? -result : result;
+}
+
+static Uint16 FinishUnquantizeBC6H(Sint32 value, bool isSigned)
+{
+	if (!isSigned)
+	{
+		return (Uint16)((value * 31) >> 6);
+	}
+	else if (value < 0)
+	{
+		return (Uint16)(0x8000 | ((-value * 31) >> 5));
+	}
+	return (Uint16)((value * 31) >> 5);
+}
+
+// Reads the endpoint header of a two-region mode. The fields of each mode are scattered
+// across the header in a fixed order; each step reads (field, first bit, bit count).
+typedef struct BC6HField
+{
+	Uint8 Endpoint; // 0-3 = w, x, y, z
+	Uint8 Channel;
+	Uint8 FirstBit;
+	Uint8 BitCount;
+} BC6HField;
+
+#define W(c, b, n) { 0, c, b, n }
+#define X(c, b, n) { 1, c, b, n }
+#define Y(c, b, n) { 2, c, b, n }
+#define Z(c, b, n) { 3, c, b, n }
+#define R 0
+#define G 1
+#define B 2
+
+static const BC6HField BC6HLayouts[10][32] =
+{
+	// Mode 1
+	{ Y(G, 4, 1), Y(B, 4, 1), Z(B, 4, 1), W(R, 0, 10), W(G, 0, 10), W(B, 0, 10), X(R, 0, 5), Z(G, 4, 1), Y(G, 0, 4), X(G, 0, 5), Z(B, 0, 1),
+	  Z(G, 0, 4), X(B, 0, 5), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 5), Z(B, 2, 1), Z(R, 0, 5), Z(B, 3, 1) },
+	// Mode 2
+	{ Y(G, 5, 1), Z(G, 4, 1), Z(G, 5, 1), W(R, 0, 7), Z(B, 0, 1), Z(B, 1, 1), Y(B, 4, 1), W(G, 0, 7), Y(B, 5, 1), Z(B, 2, 1), Y(G, 4, 1),
+	  W(B, 0, 7), Z(B, 3, 1), Z(B, 5, 1), Z(B, 4, 1), X(R, 0, 6), Y(G, 0, 4), X(G, 0, 6), Z(G, 0, 4), X(B, 0, 6), Y(B, 0, 4), Y(R, 0, 6),
+	  Z(R, 0, 6) },
+	// Mode 3
+	{ W(R, 0, 10), W(G, 0, 10), W(B, 0, 10), X(R, 0, 5), W(R, 10, 1), Y(G, 0, 4), X(G, 0, 4), W(G, 10, 1), Z(B, 0, 1), Z(G, 0, 4), X(B, 0, 4),
+	  W(B, 10, 1), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 5), Z(B, 2, 1), Z(R, 0, 5), Z(B, 3, 1) },
+	// Mode 4
+	{ W(R, 0, 10), W(G, 0, 10), W(B, 0, 10), X(R, 0, 4), W(R, 10, 1), Z(G, 4, 1), Y(G, 0, 4), X(G, 0, 5), W(G, 10, 1), Z(G, 0, 4), X(B, 0, 4),
+	  W(B, 10, 1), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 4), Z(B, 0, 1), Z(B, 2, 1), Z(R, 0, 4), Y(G, 4, 1), Z(B, 3, 1) },
+	// Mode 5
+	{ W(R, 0, 10), W(G, 0, 10), W(B, 0, 10), X(R, 0, 4), W(R, 10, 1), Y(B, 4, 1), Y(G, 0, 4), X(G, 0, 4), W(G, 10, 1), Z(B, 0, 1), Z(G, 0, 4),
+	  X(B, 0, 5), W(B, 10, 1), Y(B, 0, 4), Y(R, 0, 4), Z(B, 1, 1), Z(B, 2, 1), Z(R, 0, 4), Z(B, 4, 1), Z(B, 3, 1) },
+	// Mode 6
+	{ W(R, 0, 9), Y(B, 4, 1), W(G, 0, 9), Y(G, 4, 1), W(B, 0, 9), Z(B, 4, 1), X(R, 0, 5), Z(G, 4, 1), Y(G, 0, 4), X(G, 0, 5), Z(B, 0, 1),
+	  Z(G, 0, 4), X(B, 0, 5), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 5), Z(B, 2, 1), Z(R, 0, 5), Z(B, 3, 1) },
+	// Mode 7
+	{ W(R, 0, 8), Z(G, 4, 1), Y(B, 4, 1), W(G, 0, 8), Z(B, 2, 1), Y(G, 4, 1), W(B, 0, 8), Z(B, 3, 1), Z(B, 4, 1), X(R, 0, 6), Y(G, 0, 4),
+	  X(G, 0, 5), Z(B, 0, 1), Z(G, 0, 4), X(B, 0, 5), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 6), Z(R, 0, 6) },
+	// Mode 8
+	{ W(R, 0, 8), Z(B, 0, 1), Y(B, 4, 1), W(G, 0, 8), Y(G, 5, 1), Y(G, 4, 1), W(B, 0, 8), Z(G, 5, 1), Z(B, 4, 1), X(R, 0, 5), Z(G, 4, 1),
+	  Y(G, 0, 4), X(G, 0, 6), Z(G, 0, 4), X(B, 0, 5), Z(B, 1, 1), Y(B, 0, 4), Y(R, 0, 5), Z(B, 2, 1), Z(R, 0, 5), Z(B, 3, 1) },
+	// Mode 9
+	{ W(R, 0, 8), Z(B, 1, 1), Y(B, 4, 1), W(G, 0, 8), Y(B, 5, 1), Y(G, 4, 1), W(B, 0, 8), Z(B, 5, 1), Z(B, 4, 1), X(R, 0, 5), Z(G, 4, 1),
+	  Y(G, 0, 4), X(G, 0, 5), Z(B, 0, 1), Z(G, 0, 4), X(B, 0, 6), Y(B, 0, 4), Y(R, 0, 5), Z(B, 2, 1), Z(R, 0, 5), Z(B, 3, 1) },
+	// Mode 10
+	{ W(R, 0, 6), Z(G, 4, 1), Z(B, 0, 1), Z(B, 1, 1), Y(B, 4, 1), W(G, 0, 6), Y(G, 5, 1), Y(B, 5, 1), Z(B, 2, 1), Y(G, 4, 1), W(B, 0, 6),
+	  Z(G, 5, 1), Z(B, 3, 1), Z(B, 5, 1), Z(B, 4, 1), X(R, 0, 6), Y(G, 0, 4), X(G, 0, 6), Z(G, 0, 4), X(B, 0, 6), Y(B, 0, 4), Y(R, 0, 6),
+	  Z(R, 0, 6) },
+};
+
+#undef W
+#undef X
+#undef Y
+#undef Z
+#undef R
+#undef G
+#undef B
+
+static void DecodeBC6HBlock(const Uint8* block, Uint16* texels, bool isSigned)
+{
+	BlockBits bits = LoadBlockBits(block);
+
+	int modeBits = ReadBlockBits(&bits, 2);
+	if (modeBits >= 2)
+	{
+		modeBits |= ReadBlockBits(&bits, 3) << 2;
+	}
+
+	const BC6HModeInfo* info = &BC6HModes[modeBits];
+	if (info->Mode == 0)
+	{
+		SDL_memset(texels, 0, 16 * 4 * sizeof(Uint16));
+		return;
+	}
+
+	// endpoints[e][c]: e = w, x, y, z (subset 0 is w/x, subset 1 is y/z)
+	Uint32 raw[4][3] = { { 0 } };
+	int regionCount = (info->Mode <= 10) ? 2 : 1;
+	if (regionCount == 2)
+	{
+		const BC6HField* field = BC6HLayouts[info->Mode - 1];
+		for (int i = 0; i < 32 && field[i].BitCount > 0; i += 1)
+		{
+			raw[field[i].Endpoint][field[i].Channel] |= ReadBlockBits(&bits, field[i].BitCount) << field[i].FirstBit;
+		}
+	}
+	else
+	{
+		// Single-region modes: w then x, where w's bits above 10 follow x (reversed for modes 13 and 14)
+		for (int c = 0; c < 3; c += 1)
+		{
+			raw[0][c] = ReadBlockBits(&bits, 10);
+		}
+		int highBits = info->EndpointBits - 10;
+		for (int c = 0; c < 3; c += 1)
+		{
+			raw[1][c] = ReadBlockBits(&bits, info->DeltaBits[c]);
+			if (highBits > 0)
+			{
+				raw[0][c] |= ReadBlockBitsReversed(&bits, highBits) << 10;
+			}
+		}
+	}
+	int partition = (regionCount == 2) ? ReadBlockBits(&bits, 5) : 0;
+
+	Sint32 endpoints[4][3];
+	int endpointCount = regionCount * 2;
+	for (int c = 0; c < 3; c += 1)
+	{
+		int endpointBits = info->EndpointBits;
+		Sint32 base = isSigned ? SignExtend(raw[0][c], endpointBits) : (Sint32)raw[0][c];
+		endpoints[0][c] = base;
+
+		for (int e = 1; e < endpointCount; e += 1)
+		{
+			if (info->Transformed)
+			{
+				Sint32 value = (Sint32)((raw[0][c] + SignExtend(raw[e][c], info->DeltaBits[c])) & ((1u << endpointBits) - 1));
+				endpoints[e][c] = isSigned ? SignExtend(value, endpointBits) : value;
+			}
+			else
+			{
+				endpoints[e][c] = isSigned ? SignExtend(raw[e][c], endpointBits) : (Sint32)raw[e][c];
+			}
+		}
+
+		for (int e = 0; e < endpointCount; e += 1)
+		{
+			endpoints[e][c] = UnquantizeBC6H(endpoints[e][c], endpointBits, isSigned);
+		}
+	}
+
+	int indexBits = (regionCount == 2) ? 3 : 4;
+	const Uint8* weights = GetInterpolationWeights(indexBits);
+	for (int i = 0; i < 16; i += 1)
+	{
+		int subset = (regionCount == 2) ? GetSubset(2, partition, i) : 0;
+		bool isAnchor = (regionCount == 2) ? IsAnchorTexel(2, partition, i) : (i == 0);
+		int weight = weights[ReadBlockBits(&bits, indexBits - (isAnchor ? 1 : 0))];
+
+		for (int c = 0; c < 3; c += 1)
+		{
+			Sint32 value = (endpoints[subset * 2][c] * (64 - weight) + endpoints[subset * 2 + 1][c] * weight + 32) >> 6;
+			texels[i * 4 + c] = FinishUnquantizeBC6H(value, isSigned);
+		}
+		texels[i * 4 + 3] = 0x3C00;
+	}
+}
+
+static void DecodeBC6HUnsignedBlock(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	DecodeBC6HBlock(block, texels, false);
+}
+
+static void DecodeBC6HSignedBlock(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	DecodeBC6HBlock(block, texels, true);
+}
+
+// ASTC (LDR profile)
+
+// Quantization ranges in order of increasing level count (2, 3, 4, 5, 6, 8 ... 192, 256). Each
+// range is a power of two, optionally times three (one trit) or five (one quint) per value.
+typedef struct ASTCRange
+{
+	Uint8 Trits;
+	Uint8 Quints;
+	Uint8 Bits;
+} ASTCRange;
+
+static const ASTCRange ASTCRanges[21] =
+{
+	{ 0, 0, 1 }, { 1, 0, 0 }, { 0, 0, 2 }, { 0, 1, 0 }, { 1, 0, 1 }, { 0, 0, 3 }, { 0, 1, 1 },
+	{ 1, 0, 2 }, { 0, 0, 4 }, { 0, 1, 2 }, { 1, 0, 3 }, { 0, 0, 5 }, { 0, 1, 3 }, { 1, 0, 4 },
+	{ 0, 0, 6 }, { 0, 1, 4 }, { 1, 0, 5 }, { 0, 0, 7 }, { 0, 1, 5 }, { 1, 0, 6 }, { 0, 0, 8 }
+};
+
+#define ASTC_MIN_COLOR_RANGE 4 // Endpoints need at least 6 levels
+#define ASTC_MAX_COLOR_VALUES 18
+#define ASTC_MAX_WEIGHTS 64
+#define ASTC_MAX_TEXELS (12 * 12)
+
+// One value of an integer sequence: its low bits and its trit or quint
+typedef struct ISEValue
+{
+	Uint8 Bits;
+	Uint8 Digit;
+} ISEValue;
+
+static int GetISEBitCount(int count, int range)
+{
+	const ASTCRange* info = &ASTCRanges[range];
+	return count * info->Bits +
+		(info->Trits ? (count * 8 + 4) / 5 : 0) +
+		(info->Quints ? (count * 7 + 2) / 3 : 0);
+}
+
+// Bits at or past the end of a sequence read as zero, which pads its last trit or quint group
+static int ReadASTCBits(const Uint8* data, int position, int count, int end)
+{
+	int result = 0;
+	for (int i = 0; i < count && position + i < end; i += 1)
+	{
+		result |= ((data[(position + i) >> 3] >> ((position + i) & 7)) & 1) << i;
+	}
+	return result;
+}
+
+// Five trits are packed into 8 bits
+static void UnpackTrits(int packed, Uint8* trits)
+{
+	int c;
+	if ((packed & 0x1C) == 0x1C)
+	{
+		c = ((packed >> 3) & 0x1C) | (packed & 0x3);
+		trits[4] = 2;
+		trits[3] = 2;
+	}
+	else
+	{
+		c = packed & 0x1F;
+		if (((packed >> 5) & 0x3) == 0x3)
+		{
+			trits[4] = 2;
+			trits[3] = (packed >> 7) & 0x1;
+		}
+		else
+		{
+			trits[4] = (packed >> 7) & 0x1;
+			trits[3] = (packed >> 5) & 0x3;
+		}
+	}
+
+	if ((c & 0x3) == 0x3)
+	{
+		trits[2] = 2;
+		trits[1] = (c >> 4) & 0x1;
+		trits[0] = (((c >> 3) & 0x1) << 1) | ((c >> 2) & ~(c >> 3) & 0x1);
+	}
+	else if (((c >> 2) & 0x3) == 0x3)
+	{
+		trits[2] = 2;
+		trits[1] = 2;
+		trits[0] = c & 0x3;
+	}
+	else
+	{
+		trits[2] = (c >> 4) & 0x1;
+		trits[1] = (c >> 2) & 0x3;
+		trits[0] = (((c >> 1) & 0x1) << 1) | (c & ~(c >> 1) & 0x1);
+	}
+}
+
+// Three quints are packed into 7 bits
+static void UnpackQuints(int packed, Uint8* quints)
+{
+	if (((packed >> 1) & 0x3) == 0x3 && ((packed >> 5) & 0x3) == 0)
+	{
+		quints[2] = ((packed & 0x1) << 2) | (((packed >> 4) & ~packed & 0x1) << 1) | ((packed >> 3) & ~packed & 0x1);
+		quints[1] = 4;
+		quints[0] = 4;
+		return;
+	}
+
+	int c;
+	if (((packed >> 1) & 0x3) == 0x3)
+	{
+		quints[2] = 4;
+		c = (((packed >> 3) & 0x3) << 3) | ((~packed >> 4) & 0x6) | (packed & 0x1);
+	}
+	else
+	{
+		quints[2] = (packed >> 5) & 0x3;
+		c = packed & 0x1F;
+	}
+
+	if ((c & 0x7) == 0x5)
+	{
+		quints[1] = 4;
+		quints[0] = (c >> 3) & 0x3;
+	}
+	else
+	{
+		quints[1] = (c >> 3) & 0x3;
+		quints[0] = c & 0x7;
+	}
+}
+
+static void DecodeISE(const Uint8* data, int start, int count, int range, ISEValue* values)
+{
+	// Where the bits of each packed trit/quint group sit between the values' low bits
+	static const Uint8 TritFieldBits[5] = { 2, 2, 1, 2, 1 };
+	static const Uint8 QuintFieldBits[3] = { 3, 2, 2 };
+
+	const ASTCRange* info = &ASTCRanges[range];
+	int end = start + GetISEBitCount(count, range);
+	int position = start;
+	int groupSize = info->Trits ? 5 : info->Quints ? 3 : 1;
+	const Uint8* fieldBits = info->Trits ? TritFieldBits : QuintFieldBits;
+
+	for (int i = 0; i < count; i += groupSize)
+	{
+		Uint8 low[5];
+		Uint8 digits[5] = { 0 };
+		int packed = 0;
+		int shift = 0;
+
+		for (int j = 0; j < groupSize; j += 1)
+		{
+			low[j] = (Uint8)ReadASTCBits(data, position, info->Bits, end);
+			position += info->Bits;
+			if (groupSize > 1)
+			{
+				packed |= ReadASTCBits(data, position, fieldBits[j], end) << shift;
+				position += fieldBits[j];
+				shift += fieldBits[j];
+			}
+		}
+
+		if (info->Trits)
+		{
+			UnpackTrits(packed, digits);
+		}
+		else if (info->Quints)
+		{
+			UnpackQuints(packed, digits);
+		}
+
+		for (int j = 0; j < groupSize && i + j < count; j += 1)
+		{
+			values[i + j].Bits = low[j];
+			values[i + j].Digit = digits[j];
+		}
+	}
+}
+
+static int ReplicateBits(int value, int bits, int toBits)
+{
+	int result = 0;
+	for (int shift = toBits - bits; shift > -bits; shift -= bits)
+	{
+		result |= (shift >= 0) ? (value << shift) : (value >> -shift);
+	}
+	return result & ((1 << toBits) - 1);
+}
+
+// Trit and quint values are spread over 0-255 as D * C + B, where B scatters the low bits
+// and the lowest bit mirrors the whole value
+static Uint8 UnquantizeASTCColor(ISEValue value, int range)
+{
+	const ASTCRange* info = &ASTCRanges[range];
+	if (!info->Trits && !info->Quints)
+	{
+		return (Uint8)ReplicateBits(value.Bits, info->Bits, 8);
+	}
+
+	int a = (value.Bits & 0x1) ? 0x1FF : 0;
+	int b = (value.Bits >> 1) & 0x1;
+	int c = (value.Bits >> 2) & 0x1;
+	int d = (value.Bits >> 3) & 0x1;
+	int e = (value.Bits >> 4) & 0x1;
+	int f = (value.Bits >> 5) & 0x1;
+	int scale = 0;
+	int spread = 0;
+
+	if (info->Trits)
+	{
+		switch (info->Bits)
+		{
+			case 1: scale = 204; break;
+			case 2: scale = 93; spread = b * 0x116; break;
+			case 3: scale = 44; spread = c * 0x10A + b * 0x085; break;
+			case 4: scale = 22; spread = d * 0x104 + c * 0x082 + b * 0x041; break;
+			case 5: scale = 11; spread = e * 0x102 + d * 0x081 + c * 0x040 + b * 0x020; break;
+			case 6: scale = 5; spread = f * 0x101 + e * 0x080 + d * 0x040 + c * 0x020 + b * 0x010; break;
+		}
+	}
+	else
+	{
+		switch (info->Bits)
+		{
+			case 1: scale = 113; break;
+			case 2: scale = 54; spread = b * 0x10C; break;
+			case 3: scale = 26; spread = c * 0x105 + b * 0x082; break;
+			case 4: scale = 13; spread = d * 0x102 + c * 0x081 + b * 0x040; break;
+			case 5: scale = 6; spread = e * 0x101 + d * 0x080 + c * 0x040 + b * 0x020; break;
+		}
+	}
+
+	int t = (value.Digit * scale + spread) ^ a;
+	return (Uint8)((a & 0x80) | (t >> 2));
+}
+
+// Weights unquantize to 0-64
+static Uint8 UnquantizeASTCWeight(ISEValue value, int range)
+{
+	static const Uint8 TritsOnly[3] = { 0, 32, 63 };
+	static const Uint8 QuintsOnly[5] = { 0, 16, 32, 47, 63 };
+
+	const ASTCRange* info = &ASTCRanges[range];
+	int result;
+	if (!info->Trits && !info->Quints)
+	{
+		result = ReplicateBits(value.Bits, info->Bits, 6);
+	}
+	else if (info->Bits == 0)
+	{
+		result = info->Trits ? TritsOnly[value.Digit] : QuintsOnly[value.Digit];
+	}
+	else
+	{
+		int a = (value.Bits & 0x1) ? 0x7F : 0;
+		int b = (value.Bits >> 1) & 0x1;
+		int c = (value.Bits >> 2) & 0x1;
+		int scale = 0;
+		int spread = 0;
+
+		if (info->Trits)
+		{
+			switch (info->Bits)
+			{
+				case 1: scale = 50; break;
+				case 2: scale = 23; spread = b * 0x45; break;
+				case 3: scale = 11; spread = c * 0x42 + b * 0x21; break;
+			}
+		}
+		else
+		{
+			switch (info->Bits)
+			{
+				case 1: scale = 28; break;
+				case 2: scale = 13; spread = b * 0x42; break;
+			}
+		}
+
+		int t = (value.Digit * scale + spread) ^ a;
+		result = (a & 0x20) | (t >> 2);
+	}
+
+	return (Uint8)((result > 32) ? result + 1 : result);
+}
+
+typedef struct ASTCBlockMode
+{
+	int GridWidth;
+	int GridHeight;
+	bool DualPlane;
+	int WeightRange;
+} ASTCBlockMode;
+
+static bool DecodeASTCBlockMode(int blockMode, ASTCBlockMode* mode)
+{
+	int rangeBits = (blockMode >> 4) & 0x1;
+	int highPrecision = (blockMode >> 9) & 0x1;
+	int dualPlane = (blockMode >> 10) & 0x1;
+	int a = (blockMode >> 5) & 0x3;
+
+	if ((blockMode & 0x3) != 0)
+	{
+		int b = (blockMode >> 7) & 0x3;
+		rangeBits |= (blockMode & 0x3) << 1;
+		switch ((blockMode >> 2) & 0x3)
+		{
+			case 0: mode->GridWidth = b + 4; mode->GridHeight = a + 2; break;
+			case 1: mode->GridWidth = b + 8; mode->GridHeight = a + 2; break;
+			case 2: mode->GridWidth = a + 2; mode->GridHeight = b + 8; break;
+			case 3:
+				if (blockMode & 0x100)
+				{
+					mode->GridWidth = (b & 0x1) + 2;
+					mode->GridHeight = a + 2;
+				}
+				else
+				{
+					mode->GridWidth = a + 2;
+					mode->GridHeight = (b & 0x1) + 6;
+				}
+				break;
+		}
+	}
+	else
+	{
+		int b = (blockMode >> 9) & 0x3;
+		rangeBits |= ((blockMode >> 2) & 0x3) << 1;
+		if (((blockMode >> 2) & 0x3) == 0)
+		{
+			return false;
+		}
+
+		switch ((blockMode >> 7) & 0x3)
+		{
+			case 0: mode->GridWidth = 12; mode->GridHeight = a + 2; break;
+			case 1: mode->GridWidth = a + 2; mode->GridHeight = 12; break;
+			case 2:
+				mode->GridWidth = a + 6;
+				mode->GridHeight = b + 6;
+				highPrecision = 0;
+				dualPlane = 0;
+				break;
+			case 3:
+				if (a >= 2)
+				{
+					return false;
+				}
+				mode->GridWidth = (a == 0) ? 6 : 10;
+				mode->GridHeight = (a == 0) ? 10 : 6;
+				break;
+		}
+	}
+
+	mode->DualPlane = dualPlane != 0;
+	mode->WeightRange = (rangeBits - 2) + 6 * highPrecision;
+	return true;
+}
+
+static Uint32 HashASTCSeed(Uint32 seed)
+{
+	seed ^= seed >> 15;
+	seed -= seed << 17;
+	seed += seed << 7;
+	seed += seed << 4;
+	seed ^= seed >> 5;
+	seed += seed << 16;
+	seed ^= seed >> 7;
+	seed ^= seed >> 3;
+	seed ^= seed << 6;
+	seed ^= seed >> 17;
+	return seed;
+}
+
+// Partitions are generated from a hash of the seed rather than stored in a table
+static int SelectASTCPartition(int seed, int x, int y, int partitionCount, bool smallBlock)
+{
+	if (smallBlock)
+	{
+		x <<= 1;
+		y <<= 1;
+	}
+
+	seed += (partitionCount - 1) * 1024;
+	Uint32 random = HashASTCSeed(seed);
+
+	Uint8 seeds[8];
+	for (int i = 0; i < 8; i += 1)
+	{
+		Uint8 value = (random >> (i * 4)) & 0xF;
+		seeds[i] = value * value;
+	}
+
+	int shift1, shift2;
+	if (seed & 1)
+	{
+		shift1 = (seed & 2) ? 4 : 5;
+		shift2 = (partitionCount == 3) ? 6 : 5;
+	}
+	else
+	{
+		shift1 = (partitionCount == 3) ? 6 : 5;
+		shift2 = (seed & 2) ? 4 : 5;
+	}
+	for (int i = 0; i < 8; i += 1)
+	{
+		seeds[i] >>= (i & 1) ? shift2 : shift1;
+	}
+
+	int a = (seeds[0] * x + seeds[1] * y + (random >> 14)) & 0x3F;
+	int b = (seeds[2] * x + seeds[3] * y + (random >> 10)) & 0x3F;
+	int c = (partitionCount >= 3) ? (seeds[4] * x + seeds[5] * y + (random >> 6)) & 0x3F : 0;
+	int d = (partitionCount >= 4) ? (seeds[6] * x + seeds[7] * y + (random >> 2)) & 0x3F : 0;
+
+	if (a >= b && a >= c && a >= d)
+	{
+		return 0;
+	}
+	else if (b >= c && b >= d)
+	{
+		return 1;
+	}
+	else if (c >= d)
+	{
+		return 2;
+	}
+	return 3;
+}
+
+static void BitTransferSigned(int* a, int* b)
+{
+	*b = (*b >> 1) | (*a & 0x80);
+	*a = (*a >> 1) & 0x3F;
+	if (*a & 0x20)
+	{
+		*a -= 0x40;
+	}
+}
+
+static void SetASTCEndpoint(Uint8* endpoint, int r, int g, int b, int a, bool blueContract)
+{
+	if (blueContract)
+	{
+		r = (r + b) >> 1;
+		g = (g + b) >> 1;
+	}
+	endpoint[0] = (Uint8)SDL_clamp(r, 0, 255);
+	endpoint[1] = (Uint8)SDL_clamp(g, 0, 255);
+	endpoint[2] = (Uint8)SDL_clamp(b, 0, 255);
+	endpoint[3] = (Uint8)SDL_clamp(a, 0, 255);
+}
+
+// Returns false for the HDR endpoint modes
+static bool DecodeASTCEndpoints(int endpointMode, int* v, Uint8* e0, Uint8* e1)
+{
+	switch (endpointMode)
+	{
+		case 0: // Luminance
+			SetASTCEndpoint(e0, v[0], v[0], v[0], 255, false);
+			SetASTCEndpoint(e1, v[1], v[1], v[1], 255, false);
+			return true;
+
+		case 1: // Luminance, base + offset
+		{
+			int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+			int l1 = SDL_min(l0 + (v[1] & 0x3F), 255);
+			SetASTCEndpoint(e0, l0, l0, l0, 255, false);
+			SetASTCEndpoint(e1, l1, l1, l1, 255, false);
+			return true;
+		}
+
+		case 4: // Luminance + alpha
+			SetASTCEndpoint(e0, v[0], v[0], v[0], v[2], false);
+			SetASTCEndpoint(e1, v[1], v[1], v[1], v[3], false);
+			return true;
+
+		case 5: // Luminance + alpha, base + offset
+			BitTransferSigned(&v[1], &v[0]);
+			BitTransferSigned(&v[3], &v[2]);
+			SetASTCEndpoint(e0, v[0], v[0], v[0], v[2], false);
+			SetASTCEndpoint(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3], false);
+			return true;
+
+		case 6: // RGB, base * scale
+			SetASTCEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255, false);
+			SetASTCEndpoint(e1, v[0], v[1], v[2], 255, false);
+			return true;
+
+		case 10: // RGB, base * scale + two alphas
+			SetASTCEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4], false);
+			SetASTCEndpoint(e1, v[0], v[1], v[2], v[5], false);
+			return true;
+
+		case 8: // RGB
+		case 12: // RGBA
+		{
+			int a0 = (endpointMode == 12) ? v[6] : 255;
+			int a1 = (endpointMode == 12) ? v[7] : 255;
+			if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+			{
+				SetASTCEndpoint(e0, v[0], v[2], v[4], a0, false);
+				SetASTCEndpoint(e1, v[1], v[3], v[5], a1, false);
+			}
+			else
+			{
+				SetASTCEndpoint(e0, v[1], v[3], v[5], a1, true);
+				SetASTCEndpoint(e1, v[0], v[2], v[4], a0, true);
+			}
+			return true;
+		}
+
+		case 9: // RGB, base + offset
+		case 13: // RGBA, base + offset
+		{
+			BitTransferSigned(&v[1], &v[0]);
+			BitTransferSigned(&v[3], &v[2]);
+			BitTransferSigned(&v[5], &v[4]);
+			if (endpointMode == 13)
+			{
+				BitTransferSigned(&v[7], &v[6]);
+			}
+			int a0 = (endpointMode == 13) ? v[6] : 255;
+			int a1 = (endpointMode == 13) ? v[6] + v[7] : 255;
+			if (v[1] + v[3] + v[5] >= 0)
+			{
+				SetASTCEndpoint(e0, v[0], v[2], v[4], a0, false);
+				SetASTCEndpoint(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1, false);
+			}
+			else
+			{
+				SetASTCEndpoint(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1, true);
+				SetASTCEndpoint(e1, v[0], v[2], v[4], a0, true);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+// Bilinearly infills a weight grid coarser than the block up to one weight per texel:
+// (w00 * p00 + w01 * p01 + w10 * p10 + w11 * p11 + 8) >> 4 with 4-bit fractional weights
+static void InfillASTCWeights(const Uint8* grid, int stride, int gridWidth, int gridHeight, int blockWidth, int blockHeight, Uint8* weights)
+{
+	int texelCount = blockWidth * blockHeight;
+	if (gridWidth == blockWidth && gridHeight == blockHeight)
+	{
+		for (int i = 0; i < texelCount; i += 1)
+		{
+			weights[i] = grid[i * stride];
+		}
+		return;
+	}
+
+	Uint16 fractionS[ASTC_MAX_TEXELS];
+	Uint16 fractionT[ASTC_MAX_TEXELS];
+	Uint16 corners[4][ASTC_MAX_TEXELS];
+	int scaleS = (1024 + blockWidth / 2) / (blockWidth - 1);
+	int scaleT = (1024 + blockHeight / 2) / (blockHeight - 1);
+
+	for (int t = 0, i = 0; t < blockHeight; t += 1)
+	{
+		int gt = (scaleT * t * (gridHeight - 1) + 32) >> 6;
+		int y0 = gt >> 4;
+		int y1 = SDL_min(y0 + 1, gridHeight - 1);
+		for (int s = 0; s < blockWidth; s += 1, i += 1)
+		{
+			int gs = (scaleS * s * (gridWidth - 1) + 32) >> 6;
+			int x0 = gs >> 4;
+			int x1 = SDL_min(x0 + 1, gridWidth - 1);
+			fractionS[i] = gs & 0xF;
+			fractionT[i] = gt & 0xF;
+			corners[0][i] = grid[(y0 * gridWidth + x0) * stride];
+			corners[1][i] = grid[(y0 * gridWidth + x1) * stride];
+			corners[2][i] = grid[(y1 * gridWidth + x0) * stride];
+			corners[3][i] = grid[(y1 * gridWidth + x1) * stride];
+		}
+	}
+
+	int i = 0;
+#if defined(SDL_SSE2_INTRINSICS)
+	for (; i + 8 <= texelCount; i += 8)
+	{
+		__m128i fs = _mm_loadu_si128((const __m128i*)&fractionS[i]);
+		__m128i ft = _mm_loadu_si128((const __m128i*)&fractionT[i]);
+		__m128i w11 = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(fs, ft), _mm_set1_epi16(8)), 4);
+		__m128i w10 = _mm_sub_epi16(ft, w11);
+		__m128i w01 = _mm_sub_epi16(fs, w11);
+		__m128i w00 = _mm_add_epi16(_mm_sub_epi16(_mm_sub_epi16(_mm_set1_epi16(16), fs), ft), w11);
+		__m128i sum = _mm_add_epi16(
+			_mm_add_epi16(_mm_mullo_epi16(w00, _mm_loadu_si128((const __m128i*)&corners[0][i])), _mm_mullo_epi16(w01, _mm_loadu_si128((const __m128i*)&corners[1][i]))),
+			_mm_add_epi16(_mm_mullo_epi16(w10, _mm_loadu_si128((const __m128i*)&corners[2][i])), _mm_mullo_epi16(w11, _mm_loadu_si128((const __m128i*)&corners[3][i])))
+		);
+		__m128i result = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(8)), 4);
+		_mm_storel_epi64((__m128i*)&weights[i], _mm_packus_epi16(result, result));
+	}
+#elif defined(SDL_NEON_INTRINSICS)
+	for (; i + 8 <= texelCount; i += 8)
+	{
+		uint16x8_t fs = vld1q_u16(&fractionS[i]);
+		uint16x8_t ft = vld1q_u16(&fractionT[i]);
+		uint16x8_t w11 = vrshrq_n_u16(vmulq_u16(fs, ft), 4);
+		uint16x8_t w10 = vsubq_u16(ft, w11);
+		uint16x8_t w01 = vsubq_u16(fs, w11);
+		uint16x8_t w00 = vaddq_u16(vsubq_u16(vsubq_u16(vdupq_n_u16(16), fs), ft), w11);
+		uint16x8_t sum = vmulq_u16(w00, vld1q_u16(&corners[0][i]));
+		sum = vmlaq_u16(sum, w01, vld1q_u16(&corners[1][i]));
+		sum = vmlaq_u16(sum, w10, vld1q_u16(&corners[2][i]));
+		sum = vmlaq_u16(sum, w11, vld1q_u16(&corners[3][i]));
+		vst1_u8(&weights[i], vrshrn_n_u16(sum, 4));
+	}
+#endif
+
+	for (; i < texelCount; i += 1)
+	{
+		int w11 = (fractionS[i] * fractionT[i] + 8) >> 4;
+		int w10 = fractionT[i] - w11;
+		int w01 = fractionS[i] - w11;
+		int w00 = 16 - fractionS[i] - fractionT[i] + w11;
+		weights[i] = (Uint8)((w00 * corners[0][i] + w01 * corners[1][i] + w10 * corners[2][i] + w11 * corners[3][i] + 8) >> 4);
+	}
+}
+
+// Blends each texel between its partition's endpoints. The spec expands endpoints to 16 bits
+// (e * 257, or e * 256 + 128 for sRGB), interpolates with (c0 * (64 - w) + c1 * w + 32) >> 6
+// and keeps the top 8 bits; all of that folds into (x * 256 + bias) >> 14 on the 8-bit sum x.
+static void InterpolateASTCTexels(Uint8 endpoints[4][2][4], const Uint8* partitions, Uint8 weights[2][ASTC_MAX_TEXELS], int planeChannel, int texelCount, bool isSRGB, Uint8* rgba)
+{
+	Uint8 channelPlanes[4] = { 0, 0, 0, 0 };
+	if (planeChannel >= 0)
+	{
+		channelPlanes[planeChannel] = 1;
+	}
+
+#if defined(SDL_SSE2_INTRINSICS)
+	// Each texel is one madd of interleaved (e0, e1) pairs against (64 - w, w) pairs
+	__m128i pairs[4];
+	for (int p = 0; p < 4; p += 1)
+	{
+		pairs[p] = _mm_set_epi16(
+			endpoints[p][1][3], endpoints[p][0][3], endpoints[p][1][2], endpoints[p][0][2],
+			endpoints[p][1][1], endpoints[p][0][1], endpoints[p][1][0], endpoints[p][0][0]
+		);
+	}
+	__m128i bias = _mm_set1_epi32(isSRGB ? 8224 : 32);
+	for (int i = 0; i < texelCount; i += 1)
+	{
+		int w[4];
+		for (int c = 0; c < 4; c += 1)
+		{
+			int weight = weights[channelPlanes[c]][i];
+			w[c] = (weight << 16) | (64 - weight);
+		}
+		__m128i x = _mm_madd_epi16(pairs[partitions[i]], _mm_set_epi32(w[3], w[2], w[1], w[0]));
+		__m128i scaled = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(x, 8), bias), isSRGB ? _mm_setzero_si128() : x);
+		__m128i result = _mm_packs_epi32(_mm_srli_epi32(scaled, 14), _mm_setzero_si128());
+		Uint32 packed = (Uint32)_mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+		SDL_memcpy(rgba + i * 4, &packed, 4);
+	}
+#elif defined(SDL_NEON_INTRINSICS)
+	uint16x4_t e0[4], e1[4];
+	for (int p = 0; p < 4; p += 1)
+	{
+		Uint16 low[4], high[4];
+		for (int c = 0; c < 4; c += 1)
+		{
+			low[c] = endpoints[p][0][c];
+			high[c] = endpoints[p][1][c];
+		}
+		e0[p] = vld1_u16(low);
+		e1[p] = vld1_u16(high);
+	}
+	uint32x4_t bias = vdupq_n_u32(isSRGB ? 8224 : 32);
+	for (int i = 0; i < texelCount; i += 1)
+	{
+		Uint16 w[4];
+		for (int c = 0; c < 4; c += 1)
+		{
+			w[c] = weights[channelPlanes[c]][i];
+		}
+		uint16x4_t weight = vld1_u16(w);
+		uint32x4_t x = vmlal_u16(vmull_u16(e0[partitions[i]], vsub_u16(vdup_n_u16(64), weight)), e1[partitions[i]], weight);
+		uint32x4_t scaled = vaddq_u32(vaddq_u32(vshlq_n_u32(x, 8), bias), isSRGB ? vdupq_n_u32(0) : x);
+		uint16x4_t result = vmovn_u32(vshrq_n_u32(scaled, 14));
+		uint8x8_t bytes = vmovn_u16(vcombine_u16(result, result));
+		vst1_lane_u32((uint32_t*)(rgba + i * 4), vreinterpret_u32_u8(bytes), 0);
+	}
+#else
+	for (int i = 0; i < texelCount; i += 1)
+	{
+		for (int c = 0; c < 4; c += 1)
+		{
+			int weight = weights[channelPlanes[c]][i];
+			int x = endpoints[partitions[i]][0][c] * (64 - weight) + endpoints[partitions[i]][1][c] * weight;
+			rgba[i * 4 + c] = (Uint8)((x * 256 + (isSRGB ? 8224 : x + 32)) >> 14);
+		}
+	}
+#endif
+}
+
+static Uint8 ReverseByte(Uint8 value)
+{
+	value = (Uint8)((value >> 4) | (value << 4));
+	value = (Uint8)(((value & 0xCC) >> 2) | ((value & 0x33) << 2));
+	return (Uint8)(((value & 0xAA) >> 1) | ((value & 0x55) << 1));
+}
+
+// Malformed blocks decode to opaque magenta, as the spec requires
+static void FillASTCErrorColor(Uint8* rgba, int texelCount)
+{
+	for (int i = 0; i < texelCount; i += 1)
+	{
+		rgba[i * 4 + 0] = 255;
+		rgba[i * 4 + 1] = 0;
+		rgba[i * 4 + 2] = 255;
+		rgba[i * 4 + 3] = 255;
+	}
+}
+
+static void DecodeASTCBlock(const BlockFormatInfo* info, const Uint8* block, void* texels)
+{
+	Uint8* rgba = texels;
+	int texelCount = info->BlockWidth * info->BlockHeight;
+	int blockMode = ReadASTCBits(block, 0, 11, 128);
+
+	if ((blockMode & 0x1FF) == 0x1FC)
+	{
+		// Void-extent block: a single color, stored as four UNORM16s in the top half. The HDR
+		// (FP16) variant is outside the LDR profile.
+		if (blockMode & 0x200)
+		{
+			FillASTCErrorColor(rgba, texelCount);
+			return;
+		}
+		for (int i = 0; i < texelCount; i += 1)
+		{
+			for (int c = 0; c < 4; c += 1)
+			{
+				rgba[i * 4 + c] = block[9 + c * 2];
+			}
+		}
+		return;
+	}
+
+	ASTCBlockMode mode;
+	int partitionCount = ReadASTCBits(block, 11, 2, 128) + 1;
+	if (!DecodeASTCBlockMode(blockMode, &mode) ||
+		mode.GridWidth > info->BlockWidth || mode.GridHeight > info->BlockHeight ||
+		(mode.DualPlane && partitionCount == 4))
+	{
+		FillASTCErrorColor(rgba, texelCount);
+		return;
+	}
+
+	int planeCount = mode.DualPlane ? 2 : 1;
+	int weightCount = mode.GridWidth * mode.GridHeight * planeCount;
+	int weightBits = GetISEBitCount(weightCount, mode.WeightRange);
+	if (weightCount > ASTC_MAX_WEIGHTS || weightBits < 24 || weightBits > 96)
+	{
+		FillASTCErrorColor(rgba, texelCount);
+		return;
+	}
+
+	// Weights fill the block from the top down; any extra endpoint mode bits and the
+	// dual-plane channel sit just below them
+	int belowWeights = 128 - weightBits;
+	int endpointModes[4];
+	int partitionSeed = 0;
+	int colorStart;
+	if (partitionCount == 1)
+	{
+		endpointModes[0] = ReadASTCBits(block, 13, 4, 128);
+		colorStart = 17;
+	}
+	else
+	{
+		partitionSeed = ReadASTCBits(block, 13, 10, 128);
+		int encoded = ReadASTCBits(block, 23, 6, 128);
+		colorStart = 29;
+
+		if ((encoded & 0x3) == 0)
+		{
+			for (int p = 0; p < partitionCount; p += 1)
+			{
+				endpointModes[p] = encoded >> 2;
+			}
+		}
+		else
+		{
+			// A shared class (plus a per-partition bump) and a two-bit mode within it
+			int extraBits = partitionCount * 3 - 4;
+			belowWeights -= extraBits;
+			encoded |= ReadASTCBits(block, belowWeights, extraBits, 128) << 6;
+
+			int baseClass = (encoded & 0x3) - 1;
+			for (int p = 0; p < partitionCount; p += 1)
+			{
+				int classBump = (encoded >> (2 + p)) & 0x1;
+				int modeBits = (encoded >> (2 + partitionCount + p * 2)) & 0x3;
+				endpointModes[p] = ((baseClass + classBump) << 2) | modeBits;
+			}
+		}
+	}
+
+	int planeChannel = -1;
+	if (mode.DualPlane)
+	{
+		belowWeights -= 2;
+		planeChannel = ReadASTCBits(block, belowWeights, 2, 128);
+	}
+
+	int colorCount = 0;
+	for (int p = 0; p < partitionCount; p += 1)
+	{
+		colorCount += ((endpointModes[p] >> 2) + 1) * 2;
+	}
+
+	// Endpoints use the finest range that fits in the bits left over
+	int colorRange = SDL_arraysize(ASTCRanges) - 1;
+	while (colorRange >= ASTC_MIN_COLOR_RANGE && GetISEBitCount(colorCount, colorRange) > belowWeights - colorStart)
+	{
+		colorRange -= 1;
+	}
+	if (colorCount > ASTC_MAX_COLOR_VALUES || colorRange < ASTC_MIN_COLOR_RANGE)
+	{
+		FillASTCErrorColor(rgba, texelCount);
+		return;
+	}
+
+	ISEValue colorValues[ASTC_MAX_COLOR_VALUES];
+	DecodeISE(block, colorStart, colorCount, colorRange, colorValues);
+
+	Uint8 endpoints[4][2][4];
+	SDL_zeroa(endpoints);
+	for (int p = 0, first = 0; p < partitionCount; p += 1)
+	{
+		int values[8];
+		int valueCount = ((endpointModes[p] >> 2) + 1) * 2;
+		for (int i = 0; i < valueCount; i += 1)
+		{
+			values[i] = UnquantizeASTCColor(colorValues[first + i], colorRange);
+		}
+		first += valueCount;
+
+		if (!DecodeASTCEndpoints(endpointModes[p], values, endpoints[p][0], endpoints[p][1]))
+		{
+			FillASTCErrorColor(rgba, texelCount);
+			return;
+		}
+	}
+
+	// The weight sequence is stored bit-reversed from the top of the block
+	Uint8 reversed[16];
+	for (int i = 0; i < 16; i += 1)
+	{
+		reversed[i] = ReverseByte(block[15 - i]);
+	}
+
+	ISEValue weightValues[ASTC_MAX_WEIGHTS];
+	Uint8 gridWeights[ASTC_MAX_WEIGHTS];
+	DecodeISE(reversed, 0, weightCount, mode.WeightRange, weightValues);
+	for (int i = 0; i < weightCount; i += 1)
+	{
+		gridWeights[i] = UnquantizeASTCWeight(weightValues[i], mode.WeightRange);
+	}
+
+	// Dual-plane weights are interleaved
+	Uint8 weights[2][ASTC_MAX_TEXELS];
+	for (int plane = 0; plane < planeCount; plane += 1)
+	{
+		InfillASTCWeights(gridWeights + plane, planeCount, mode.GridWidth, mode.GridHeight, info->BlockWidth, info->BlockHeight, weights[plane]);
+	}
+
+	Uint8 partitions[ASTC_MAX_TEXELS];
+	for (int y = 0, i = 0; y < info->BlockHeight; y += 1)
+	{
+		for (int x = 0; x < info->BlockWidth; x += 1, i += 1)
+		{
+			partitions[i] = (partitionCount > 1) ? (Uint8)SelectASTCPartition(partitionSeed, x, y, partitionCount, texelCount < 31) : 0;
+		}
+	}
+
+	InterpolateASTCTexels(endpoints, partitions, weights, planeChannel, texelCount, info->IsSRGB, rgba);
+}
+
+// BC1, BC3 and BC7 encoding
+// Endpoints come from the principal axis of the block's colors, are refined once by least
+// squares against the chosen indices, and every texel takes the palette entry nearest its
+// projection onto the endpoint line.
+
+// Fits a line through the texels (the principal axis of their covariance) and returns the
+// extreme projections onto it
+static void FitEndpoints(const Uint8* texels, int channels, float* e0, float* e1)
+{
+	float mean[4] = { 0 };
+	for (int i = 0; i < 16; i += 1)
+	{
+		for (int c = 0; c < channels; c += 1)
+		{
+			mean[c] += texels[i * 4 + c];
+		}
+	}
+	for (int c = 0; c < channels; c += 1)
+	{
+		mean[c] /= 16.0f;
+	}
+
+	float covariance[4][4] = { { 0 } };
+	for (int i = 0; i < 16; i += 1)
+	{
+		for (int a = 0; a < channels; a += 1)
+		{
+			for (int b = 0; b < channels; b += 1)
+			{
+				covariance[a][b] += (texels[i * 4 + a] - mean[a]) * (texels[i * 4 + b] - mean[b]);
+			}
+		}
+	}
+
+	// Power iteration from the diagonal converges quickly for 16 points
+	float axis[4] = { 0 };
+	for (int c = 0; c < channels; c += 1)
+	{
+		axis[c] = covariance[c][c];
+	}
+	for (int iteration = 0; iteration < 8; iteration += 1)
+	{
+		float next[4] = { 0 };
+		float largest = 0.0f;
+		for (int a = 0; a < channels; a += 1)
+		{
+			for (int b = 0; b < channels; b += 1)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+			largest = SDL_max(largest, SDL_fabsf(next[a]));
+		}
+		if (largest < 1e-6f)
+		{
+			break;
+		}
+		for (int c = 0; c < channels; c += 1)
+		{
+			axis[c] = next[c] / largest;
+		}
+	}
+
+	float length = 0.0f;
+	for (int c = 0; c < channels; c += 1)
+	{
+		length += axis[c] * axis[c];
+	}
+
+	float minT = 0.0f, maxT = 0.0f;
+	if (length > 1e-6f)
+	{
+		minT = SDL_MAX_SINT32;
+		maxT = SDL_MIN_SINT32;
+		for (int i = 0; i < 16; i += 1)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < channels; c += 1)
+			{
+				t += (texels[i * 4 + c] - mean[c]) * axis[c];
+			}
+			minT = SDL_min(minT, t);
+			maxT = SDL_max(maxT, t);
+		}
+		minT /= length;
+		maxT /= length;
+	}
+
+	for (int c = 0; c < 4; c += 1)
+	{
+		e0[c] = (c < channels) ? SDL_clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f) : 255.0f;
+		e1[c] = (c < channels) ? SDL_clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f) : 255.0f;
+	}
+}
+
+// Re-solves the endpoints for fixed per-texel weights (0-64); texels with a zero mask are ignored
+static void RefineEndpoints(const Uint8* texels, const Uint8* weights, const bool* mask, int channels, float* e0, float* e1)
+{
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = { 0 }, bx[4] = { 0 };
+	for (int i = 0; i < 16; i += 1)
+	{
+		if (mask != NULL && !mask[i])
+		{
+			continue;
+		}
+		float b = weights[i] / 64.0f;
+		float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < channels; c += 1)
+		{
+			ax[c] += a * texels[i * 4 + c];
+			bx[c] += b * texels[i * 4 + c];
+		}
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (SDL_fabsf(determinant) < 1e-6f)
+	{
+		return;
+	}
+	for (int c = 0; c < channels; c += 1)
+	{
+		e0[c] = SDL_clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+		e1[c] = SDL_clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+	}
+}
+
+// Positions of the 16 texels along e0 -> e1, from 0 at e0 to 64 at e1. Channels with a zero
+// direction (alpha for BC1) drop out of the projection.
+static void ProjectTexels(const Uint8* texels, const int* e0, const int* e1, Uint8* positions)
+{
+	int direction[4];
+	int lengthSquared = 0;
+	for (int c = 0; c < 4; c += 1)
+	{
+		direction[c] = e1[c] - e0[c];
+		lengthSquared += direction[c] * direction[c];
+	}
+	if (lengthSquared == 0)
+	{
+		SDL_memset(positions, 0, 16);
+		return;
+	}
+	float scale = 64.0f / lengthSquared;
+
+	int i = 0;
+#if defined(SDL_SSE2_INTRINSICS)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i origin = _mm_set_epi16(e0[3], e0[2], e0[1], e0[0], e0[3], e0[2], e0[1], e0[0]);
+	__m128i axis = _mm_set_epi16(direction[3], direction[2], direction[1], direction[0], direction[3], direction[2], direction[1], direction[0]);
+	__m128 scales = _mm_set1_ps(scale);
+
+	// Four texels per iteration: madd gives (r + g, b + a) partial dots, which are then paired up
+	for (; i < 16; i += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(texels + i * 4));
+		__m128i dots01 = _mm_madd_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(pixels, zero), origin), axis);
+		__m128i dots23 = _mm_madd_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(pixels, zero), origin), axis);
+		__m128 even = _mm_shuffle_ps(_mm_castsi128_ps(dots01), _mm_castsi128_ps(dots23), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(dots01), _mm_castsi128_ps(dots23), _MM_SHUFFLE(3, 1, 3, 1));
+		__m128i dots = _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+		__m128i t = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(dots), scales));
+		t = _mm_packs_epi32(t, t);
+		t = _mm_min_epi16(_mm_max_epi16(t, zero), _mm_set1_epi16(64));
+		int packed = _mm_cvtsi128_si32(_mm_packus_epi16(t, t));
+		SDL_memcpy(positions + i, &packed, 4);
+	}
+#elif defined(SDL_NEON_INTRINSICS)
+	Sint16 origins[4] = { (Sint16)e0[0], (Sint16)e0[1], (Sint16)e0[2], (Sint16)e0[3] };
+	Sint16 directions[4] = { (Sint16)direction[0], (Sint16)direction[1], (Sint16)direction[2], (Sint16)direction[3] };
+	int16x8_t origin = vcombine_s16(vld1_s16(origins), vld1_s16(origins));
+	int16x4_t axis = vld1_s16(directions);
+
+	for (; i < 16; i += 4)
+	{
+		uint8x16_t pixels = vld1q_u8(texels + i * 4);
+		int16x8_t low = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(pixels))), origin);
+		int16x8_t high = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(pixels))), origin);
+		int32x4_t p0 = vmull_s16(vget_low_s16(low), axis);
+		int32x4_t p1 = vmull_s16(vget_high_s16(low), axis);
+		int32x4_t p2 = vmull_s16(vget_low_s16(high), axis);
+		int32x4_t p3 = vmull_s16(vget_high_s16(high), axis);
+		int32x2_t dots01 = vpadd_s32(vpadd_s32(vget_low_s32(p0), vget_high_s32(p0)), vpadd_s32(vget_low_s32(p1), vget_high_s32(p1)));
+		int32x2_t dots23 = vpadd_s32(vpadd_s32(vget_low_s32(p2), vget_high_s32(p2)), vpadd_s32(vget_low_s32(p3), vget_high_s32(p3)));
+		float32x4_t t = vmulq_n_f32(vcvtq_f32_s32(vcombine_s32(dots01, dots23)), scale);
+		t = vminq_f32(vmaxq_f32(t, vdupq_n_f32(0.0f)), vdupq_n_f32(64.0f));
+		uint16x4_t rounded = vmovn_u32(vcvtq_u32_f32(vaddq_f32(t, vdupq_n_f32(0.5f))));
+		uint8x8_t bytes = vmovn_u16(vcombine_u16(rounded, rounded));
+		vst1_lane_u32((uint32_t*)(positions + i), vreinterpret_u32_u8(bytes), 0);
+	}
+#endif
+
+	for (; i < 16; i += 1)
+	{
+		int dot = 0;
+		for (int c = 0; c < 4; c += 1)
+		{
+			dot += (texels[i * 4 + c] - e0[c]) * direction[c];
+		}
+		float t = SDL_clamp(dot * scale, 0.0f, 64.0f);
+		positions[i] = (Uint8)(t + 0.5f);
+	}
+}
+
+static Uint16 PackRGB565(const float* color)
+{
+	int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+	int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+	int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+	return (Uint16)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(Uint16 color, int* rgba)
+{
+	rgba[0] = ((color >> 11) << 3) | (color >> 13);
+	rgba[1] = (((color >> 5) & 0x3F) << 2) | ((color >> 9) & 0x3);
+	rgba[2] = ((color & 0x1F) << 3) | ((color >> 2) & 0x7);
+	rgba[3] = 0;
+}
+
+// Without transparency this uses the four-color mode (c0 > c1); texels with alpha below 128
+// switch the block to the three-color mode, where index 3 is transparent black
+static void EncodeBC1Colors(const Uint8* texels, Uint8* block, bool allowTransparency)
+{
+	static const Uint8 FourColorIndices[4] = { 0, 2, 3, 1 };
+	static const Uint8 ThreeColorIndices[3] = { 0, 2, 1 };
+
+	bool opaque[16];
+	bool transparent = false;
+	for (int i = 0; i < 16; i += 1)
+	{
+		opaque[i] = !allowTransparency || texels[i * 4 + 3] >= 128;
+		transparent |= !opaque[i];
+	}
+	int steps = transparent ? 2 : 3;
+
+	float e0[4], e1[4];
+	FitEndpoints(texels, 3, e0, e1);
+
+	Uint16 c0 = 0, c1 = 0;
+	Uint8 positions[16];
+	Uint8 weights[16];
+	for (int pass = 0; pass < 2; pass += 1)
+	{
+		c0 = PackRGB565(e0);
+		c1 = PackRGB565(e1);
+
+		int endpoint0[4], endpoint1[4];
+		UnpackRGB565(c0, endpoint0);
+		UnpackRGB565(c1, endpoint1);
+		ProjectTexels(texels, endpoint0, endpoint1, positions);
+
+		for (int i = 0; i < 16; i += 1)
+		{
+			int step = (positions[i] * steps + 32) >> 6;
+			weights[i] = (Uint8)(step * 64 / steps);
+			positions[i] = (Uint8)step;
+		}
+
+		if (pass == 0)
+		{
+			RefineEndpoints(texels, weights, opaque, 3, e0, e1);
+		}
+	}
+
+	// The mode is selected by the endpoint order, so flip the endpoints (and steps) if needed
+	bool swap = transparent ? (c0 > c1) : (c0 < c1);
+	if (swap)
+	{
+		Uint16 temp = c0;
+		c0 = c1;
+		c1 = temp;
+	}
+
+	Uint32 indices = 0;
+	for (int i = 0; i < 16; i += 1)
+	{
+		int step = swap ? steps - positions[i] : positions[i];
+		int index;
+		if (!opaque[i])
+		{
+			index = 3;
+		}
+		else if (transparent)
+		{
+			index = ThreeColorIndices[step];
+		}
+		else
+		{
+			// Equal endpoints can only use index 0 in the four-color mode
+			index = (c0 == c1) ? 0 : FourColorIndices[step];
+		}
+		indices |= (Uint32)index << (i * 2);
+	}
+
+	block[0] = (Uint8)c0;
+	block[1] = (Uint8)(c0 >> 8);
+	block[2] = (Uint8)c1;
+	block[3] = (Uint8)(c1 >> 8);
+	for (int i = 0; i < 4; i += 1)
+	{
+		block[4 + i] = (Uint8)(indices >> (i * 8));
+	}
+}
+
+// Always uses the eight-value mode (a0 > a1)
+static void EncodeBC4Channel(const Uint8* texels, int channel, Uint8* block)
+{
+	int low = 255, high = 0;
+	for (int i = 0; i < 16; i += 1)
+	{
+		low = SDL_min(low, texels[i * 4 + channel]);
+		high = SDL_max(high, texels[i * 4 + channel]);
+	}
+
+	block[0] = (Uint8)high;
+	block[1] = (Uint8)low;
+
+	Uint64 indices = 0;
+	int range = high - low;
+	for (int i = 0; range > 0 && i < 16; i += 1)
+	{
+		// Steps run from a0 (index 0) through the six blends to a1 (index 1)
+		int step = ((high - texels[i * 4 + channel]) * 7 + range / 2) / range;
+		int index = (step == 0) ? 0 : (step == 7) ? 1 : step + 1;
+		indices |= (Uint64)index << (i * 3);
+	}
+	for (int i = 0; i < 6; i += 1)
+	{
+		block[2 + i] = (Uint8)(indices >> (i * 8));
+	}
+}
+
+static void EncodeBC1Block(const Uint8* texels, Uint8* block)
+{
+	EncodeBC1Colors(texels, block, true);
+}
+
+static void EncodeBC3Block(const Uint8* texels, Uint8* block)
+{
+	EncodeBC4Channel(texels, 3, block);
+	EncodeBC1Colors(texels, block + 8, false);
+}
+
+// Quantizes an endpoint to mode 6's 7 bits per channel plus a shared p-bit
+static int QuantizeBC7Endpoint(const float* endpoint, int* quantized)
+{
+	int bestPBit = 0;
+	float bestError = SDL_MAX_SINT32;
+	for (int pBit = 0; pBit < 2; pBit += 1)
+	{
+		float error = 0.0f;
+		int candidate[4];
+		for (int c = 0; c < 4; c += 1)
+		{
+			candidate[c] = SDL_clamp((int)((endpoint[c] - pBit) / 2.0f + 0.5f), 0, 127);
+			float difference = endpoint[c] - (candidate[c] * 2 + pBit);
+			error += difference * difference;
+		}
+		if (error < bestError)
+		{
+			bestError = error;
+			bestPBit = pBit;
+			SDL_memcpy(quantized, candidate, sizeof(candidate));
+		}
+	}
+	return bestPBit;
+}
+
+// Mode 6: one RGBA subset with 7.1-bit endpoints and 4-bit indices
+static void EncodeBC7Mode6(const Uint8* texels, Uint8* block)
+{
+	float e0[4], e1[4];
+	FitEndpoints(texels, 4, e0, e1);
+
+	int q0[4], q1[4];
+	int p0 = 0, p1 = 0;
+	Uint8 positions[16];
+	for (int pass = 0; pass < 2; pass += 1)
+	{
+		p0 = QuantizeBC7Endpoint(e0, q0);
+		p1 = QuantizeBC7Endpoint(e1, q1);
+
+		int endpoint0[4], endpoint1[4];
+		for (int c = 0; c < 4; c += 1)
+		{
+			endpoint0[c] = q0[c] * 2 + p0;
+			endpoint1[c] = q1[c] * 2 + p1;
+		}
+		ProjectTexels(texels, endpoint0, endpoint1, positions);
+
+		Uint8 weights[16];
+		for (int i = 0; i < 16; i += 1)
+		{
+			positions[i] = (Uint8)((positions[i] * 15 + 32) >> 6);
+			weights[i] = Weights4[positions[i]];
+		}
+
+		if (pass == 0)
+		{
+			RefineEndpoints(texels, weights, NULL, 4, e0, e1);
+		}
+	}
+
+	// Texel 0's index drops its top bit, so it must be in the lower half
+	if (positions[0] >= 8)
+	{
+		for (int c = 0; c < 4; c += 1)
+		{
+			int temp = q0[c];
+			q0[c] = q1[c];
+			q1[c] = temp;
+		}
+		int temp = p0;
+		p0 = p1;
+		p1 = temp;
+		for (int i = 0; i < 16; i += 1)
+		{
+			positions[i] = 15 - positions[i];
+		}
+	}
+
+	BlockBits bits = { 0 };
+	WriteBlockBits(&bits, 1 << 6, 7);
+	for (int c = 0; c < 4; c += 1)
+	{
+		WriteBlockBits(&bits, q0[c], 7);
+		WriteBlockBits(&bits, q1[c], 7);
+	}
+	WriteBlockBits(&bits, p0, 1);
+	WriteBlockBits(&bits, p1, 1);
+	for (int i = 0; i < 16; i += 1)
+	{
+		WriteBlockBits(&bits, positions[i], (i == 0) ? 3 : 4);
+	}
+	StoreBlockBits(&bits, block);
+}
+
+// Mode 5: 7-bit RGB and 8-bit alpha endpoints with separate 2-bit color and alpha indices,
+// for blocks whose alpha doesn't follow their color
+static void EncodeBC7Mode5(const Uint8* texels, Uint8* block)
+{
+	float e0[4], e1[4];
+	FitEndpoints(texels, 3, e0, e1);
+
+	int q0[4], q1[4];
+	Uint8 colorIndices[16];
+	for (int pass = 0; pass < 2; pass += 1)
+	{
+		int endpoint0[4] = { 0 }, endpoint1[4] = { 0 };
+		for (int c = 0; c < 3; c += 1)
+		{
+			q0[c] = SDL_clamp((int)(e0[c] * 127.0f / 255.0f + 0.5f), 0, 127);
+			q1[c] = SDL_clamp((int)(e1[c] * 127.0f / 255.0f + 0.5f), 0, 127);
+			endpoint0[c] = (q0[c] << 1) | (q0[c] >> 6);
+			endpoint1[c] = (q1[c] << 1) | (q1[c] >> 6);
+		}
+		ProjectTexels(texels, endpoint0, endpoint1, colorIndices);
+
+		Uint8 weights[16];
+		for (int i = 0; i < 16; i += 1)
+		{
+			colorIndices[i] = (Uint8)((colorIndices[i] * 3 + 32) >> 6);
+			weights[i] = Weights2[colorIndices[i]];
+		}
+
+		if (pass == 0)
+		{
+			RefineEndpoints(texels, weights, NULL, 3, e0, e1);
+		}
+	}
+
+	int alpha0 = 255, alpha1 = 0;
+	for (int i = 0; i < 16; i += 1)
+	{
+		alpha0 = SDL_min(alpha0, texels[i * 4 + 3]);
+		alpha1 = SDL_max(alpha1, texels[i * 4 + 3]);
+	}
+	Uint8 alphaIndices[16];
+	for (int i = 0; i < 16; i += 1)
+	{
+		int range = alpha1 - alpha0;
+		alphaIndices[i] = (range > 0) ? (Uint8)(((texels[i * 4 + 3] - alpha0) * 3 + range / 2) / range) : 0;
+	}
+
+	// Both index sets have an anchor at texel 0
+	if (colorIndices[0] >= 2)
+	{
+		for (int c = 0; c < 3; c += 1)
+		{
+			int temp = q0[c];
+			q0[c] = q1[c];
+			q1[c] = temp;
+		}
+		for (int i = 0; i < 16; i += 1)
+		{
+			colorIndices[i] = 3 - colorIndices[i];
+		}
+	}
+	if (alphaIndices[0] >= 2)
+	{
+		int temp = alpha0;
+		alpha0 = alpha1;
+		alpha1 = temp;
+		for (int i = 0; i < 16; i += 1)
+		{
+			alphaIndices[i] = 3 - alphaIndices[i];
+		}
+	}
+
+	BlockBits bits = { 0 };
+	WriteBlockBits(&bits, 1 << 5, 6);
+	WriteBlockBits(&bits, 0, 2); // No rotation
+	for (int c = 0; c < 3; c += 1)
+	{
+		WriteBlockBits(&bits, q0[c], 7);
+		WriteBlockBits(&bits, q1[c], 7);
+	}
+	WriteBlockBits(&bits, alpha0, 8);
+	WriteBlockBits(&bits, alpha1, 8);
+	for (int i = 0; i < 16; i += 1)
+	{
+		WriteBlockBits(&bits, colorIndices[i], (i == 0) ? 1 : 2);
+	}
+	for (int i = 0; i < 16; i += 1)
+	{
+		WriteBlockBits(&bits, alphaIndices[i], (i == 0) ? 1 : 2);
+	}
+	StoreBlockBits(&bits, block);
+}
+
+static int GetBC7BlockError(const Uint8* texels, const Uint8* block)
+{
+	Uint8 decoded[16 * 4];
+	DecodeBC7Block(NULL, block, decoded);
+
+	int error = 0;
+	for (int i = 0; i < 16 * 4; i += 1)
+	{
+		int difference = texels[i] - decoded[i];
+		error += difference * difference;
+	}
+	return error;
+}
+
+// Single-subset modes only: mode 6, or mode 5 when alpha varies and it decodes closer
+static void EncodeBC7Block(const Uint8* texels, Uint8* block)
+{
+	EncodeBC7Mode6(texels, block);
+
+	bool opaque = true;
+	for (int i = 0; i < 16; i += 1)
+	{
+		opaque &= texels[i * 4 + 3] == 255;
+	}
+	if (opaque)
+	{
+		return;
+	}
+
+	Uint8 candidate[16];
+	EncodeBC7Mode5(texels, candidate);
+	if (GetBC7BlockError(texels, candidate) < GetBC7BlockError(texels, block))
+	{
+		SDL_memcpy(block, candidate, 16);
+	}
+}
+
+static const BlockFormatInfo BlockFormats[] =
+{
+	{ SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 8, 4, false, DecodeBC1Block, EncodeBC1Block },
+	{ SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 16, 4, false, DecodeBC2Block, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 16, 4, false, DecodeBC3Block, EncodeBC3Block },
+	{ SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 8, 4, false, DecodeBC4Block, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 16, 4, false, DecodeBC5Block, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, 4, 4, 16, 8, false, DecodeBC6HSignedBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, 4, 4, 16, 8, false, DecodeBC6HUnsignedBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 16, 4, false, DecodeBC7Block, EncodeBC7Block },
+	{ SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 8, 4, true, DecodeBC1Block, EncodeBC1Block },
+	{ SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 16, 4, true, DecodeBC2Block, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 16, 4, true, DecodeBC3Block, EncodeBC3Block },
+	{ SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 16, 4, true, DecodeBC7Block, EncodeBC7Block },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 4, 4, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_5x4_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 5, 4, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_5x5_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 5, 5, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_6x5_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 6, 5, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_6x6_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 6, 6, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x5_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 8, 5, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x6_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 8, 6, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x8_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 8, 8, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x5_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 10, 5, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x6_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 10, 6, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x8_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 10, 8, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x10_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 10, 10, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_12x10_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 12, 10, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_12x12_UNORM, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 12, 12, 16, 4, false, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_5x4_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 5, 4, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_5x5_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 5, 5, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_6x5_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 6, 5, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_6x6_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 6, 6, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x5_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 8, 5, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x6_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 8, 6, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_8x8_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 8, 8, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x5_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 10, 5, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x6_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 10, 6, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x8_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 10, 8, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_10x10_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 10, 10, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_12x10_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 12, 10, 16, 4, true, DecodeASTCBlock, NULL },
+	{ SDL_GPU_TEXTUREFORMAT_ASTC_12x12_UNORM_SRGB, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 12, 12, 16, 4, true, DecodeASTCBlock, NULL },
+};
+
+static const BlockFormatInfo* GetBlockFormatInfo(SDL_GPUTextureFormat format)
+{
+	for (int i = 0; i < SDL_arraysize(BlockFormats); i += 1)
+	{
+		if (BlockFormats[i].Format == format)
+		{
+			return &BlockFormats[i];
+		}
+	}
+	return NULL;
+}
+
+// Parallel block processing
+
+typedef struct BlockRowBand
+{
+	const BlockFormatInfo* Info;
+	const Uint8* Src;
+	Uint8* Dst;
+	int Width;
+	int Height;
+	int FirstBlockRow;
+	int BlockRowCount;
+} BlockRowBand;
+
+static int DecodeBlockRows(void* data)
+{
+	const BlockRowBand* band = data;
+	const BlockFormatInfo* info = band->Info;
+	int blocksPerRow = (band->Width + info->BlockWidth - 1) / info->BlockWidth;
+	size_t dstPitch = (size_t)band->Width * info->TexelSize;
+	Uint8 tile[12 * 12 * 8];
+
+	for (int blockY = band->FirstBlockRow; blockY < band->FirstBlockRow + band->BlockRowCount; blockY += 1)
+	{
+		const Uint8* block = band->Src + (size_t)blockY * blocksPerRow * info->BlockSize;
+		int rows = SDL_min(info->BlockHeight, band->Height - blockY * info->BlockHeight);
+
+		for (int blockX = 0; blockX < blocksPerRow; blockX += 1, block += info->BlockSize)
+		{
+			info->Decoder(info, block, tile);
+
+			int columns = SDL_min(info->BlockWidth, band->Width - blockX * info->BlockWidth);
+			Uint8* dst = band->Dst + (size_t)blockY * info->BlockHeight * dstPitch + (size_t)blockX * info->BlockWidth * info->TexelSize;
+			for (int y = 0; y < rows; y += 1)
+			{
+				SDL_memcpy(dst + y * dstPitch, tile + y * info->BlockWidth * info->TexelSize, columns * info->TexelSize);
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Edge blocks are padded by repeating the last row and column
+static int EncodeBlockRows(void* data)
+{
+	const BlockRowBand* band = data;
+	const BlockFormatInfo* info = band->Info;
+	int blocksPerRow = (band->Width + info->BlockWidth - 1) / info->BlockWidth;
+	size_t srcPitch = (size_t)band->Width * info->TexelSize;
+	Uint8 tile[4 * 4 * 4];
+
+	for (int blockY = band->FirstBlockRow; blockY < band->FirstBlockRow + band->BlockRowCount; blockY += 1)
+	{
+		Uint8* block = band->Dst + (size_t)blockY * blocksPerRow * info->BlockSize;
+
+		for (int blockX = 0; blockX < blocksPerRow; blockX += 1, block += info->BlockSize)
+		{
+			for (int y = 0; y < 4; y += 1)
+			{
+				int srcY = SDL_min(blockY * 4 + y, band->Height - 1);
+				for (int x = 0; x < 4; x += 1)
+				{
+					int srcX = SDL_min(blockX * 4 + x, band->Width - 1);
+					SDL_memcpy(tile + (y * 4 + x) * 4, band->Src + srcY * srcPitch + srcX * 4, 4);
+				}
+			}
+			info->Encoder(tile, block);
+		}
+	}
+
+	return 0;
+}
+
+static void ProcessBlocks(const BlockFormatInfo* info, const Uint8* src, int width, int height, Uint8* dst, SDL_ThreadFunction processRows)
+{
+	int blockRows = (height + info->BlockHeight - 1) / info->BlockHeight;
+	BlockRowBand bands[MAX_DECODE_THREADS];
+	SDL_Thread* threads[MAX_DECODE_THREADS];
+
+	int bandCount = SDL_clamp(SDL_min(SDL_GetNumLogicalCPUCores(), blockRows / MIN_BLOCK_ROWS_PER_THREAD), 1, MAX_DECODE_THREADS);
+	for (int i = 0; i < bandCount; i += 1)
+	{
+		bands[i].Info = info;
+		bands[i].Src = src;
+		bands[i].Dst = dst;
+		bands[i].Width = width;
+		bands[i].Height = height;
+		bands[i].FirstBlockRow = blockRows * i / bandCount;
+		bands[i].BlockRowCount = blockRows * (i + 1) / bandCount - bands[i].FirstBlockRow;
+	}
+
+	// The calling thread takes the first band itself
+	for (int i = 1; i < bandCount; i += 1)
+	{
+		threads[i] = SDL_CreateThread(processRows, "TextureCodec", &bands[i]);
+		if (threads[i] == NULL)
+		{
+			processRows(&bands[i]);
+		}
+	}
+	processRows(&bands[0]);
+	for (int i = 1; i < bandCount; i += 1)
+	{
+		if (threads[i] != NULL)
+		{
+			SDL_WaitThread(threads[i], NULL);
+		}
+	}
+}
+
+SDL_GPUTextureFormat GetDecompressedTextureFormat(SDL_GPUTextureFormat format)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	return (info != NULL) ? info->DecompressedFormat : SDL_GPU_TEXTUREFORMAT_INVALID;
+}
+
+bool DecompressTextureData(SDL_GPUTextureFormat format, const void* src, int width, int height, void* dst)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	if (info == NULL)
+	{
+		SDL_Log("No software decoder for texture format %d!", format);
+		return false;
+	}
+
+	ProcessBlocks(info, src, width, height, dst, DecodeBlockRows);
+	return true;
+}
+
+Uint32 GetDecompressedImageLength(const CompressedImage* image, SDL_GPUTextureFormat format)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	Uint32 length = 0;
+
+	for (int i = 0; info != NULL && i < image->SubresourceCount; i += 1)
+	{
+		length += image->Subresources[i].Width * image->Subresources[i].Height * info->TexelSize;
+	}
+	return length;
+}
+
+bool DecompressImage(CompressedImage* image, SDL_GPUTextureFormat format, const void* src, void* dst)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	if (info == NULL)
+	{
+		SDL_Log("No software decoder for texture format %d!", format);
+		return false;
+	}
+
+	// Decoded subresources are packed back to back in the same order
+	int offset = 0;
+	for (int i = 0; i < image->SubresourceCount; i += 1)
+	{
+		CompressedImageSubresource* subresource = &image->Subresources[i];
+		ProcessBlocks(info, (const Uint8*)src + subresource->Offset, subresource->Width, subresource->Height, (Uint8*)dst + offset, DecodeBlockRows);
+
+		subresource->Offset = offset;
+		subresource->Length = subresource->Width * subresource->Height * info->TexelSize;
+		offset += subresource->Length;
+	}
+	image->DataLength = offset;
+
+	return true;
+}
+
+bool CompressTextureData(SDL_GPUTextureFormat format, const void* src, int width, int height, void* dst)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	if (info == NULL || info->Encoder == NULL)
+	{
+		SDL_Log("No software encoder for texture format %d!", format);
+		return false;
+	}
+
+	ProcessBlocks(info, src, width, height, dst, EncodeBlockRows);
+	return true;
+}
+
+Uint32 GetCompressedTextureLength(SDL_GPUTextureFormat format, int width, int height)
+{
+	const BlockFormatInfo* info = GetBlockFormatInfo(format);
+	if (info == NULL)
+	{
+		return 0;
+	}
+	Uint32 blocksWide = (width + info->BlockWidth - 1) / info->BlockWidth;
+	Uint32 blocksHigh = (height + info->BlockHeight - 1) / info->BlockHeight;
+	return blocksWide * blocksHigh * info->BlockSize;
+}
@@ -125,23 +125,44 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	// Create and populate the upload transfer buffer
+	// Queue the texture data. Every texture type gets the same four quadrants,
+	// so each image is staged once and uploaded from there to all five textures.
 
-	SDL_GPUTransferBuffer* uploadTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.size = (baseMipDataSize + secondMipDataSize) * 4
-		}
-	);
+	UploadBatch uploads;
+	BeginUploadBatch(&uploads, context->Device);
 
-	Uint8* transferPtr = SDL_MapGPUTransferBuffer(context->Device, uploadTransferBuffer, false);
 	for (int i = 0; i < 4; i += 1)
 	{
-		Uint32 offset = i * (baseMipDataSize + secondMipDataSize);
-		SDL_memcpy(transferPtr + offset, baseMips[i]->pixels, baseMipDataSize);
-		SDL_memcpy(transferPtr + offset + baseMipDataSize, secondMips[i]->pixels, secondMipDataSize);
+		Uint32 x0 = (i % 2) * 32;
+		Uint32 y0 = (i / 2) * 32;
+		Uint32 x1 = (i % 2) * 16;
+		Uint32 y1 = (i / 2) * 16;
+
+		Uint8* baseMipData = ReserveUploadData(&uploads, baseMipDataSize);
+		Uint8* secondMipData = ReserveUploadData(&uploads, secondMipDataSize);
+		SDL_memcpy(baseMipData, baseMips[i]->pixels, baseMipDataSize);
+		SDL_memcpy(secondMipData, secondMips[i]->pixels, secondMipDataSize);
+
+		// 2D
+		QueueReservedTextureUpload(&uploads, baseMipData, &(SDL_GPUTextureRegion){ SrcTextures[0], 0, 0, x0, y0, 0, 32, 32, 1 });
+		QueueReservedTextureUpload(&uploads, secondMipData, &(SDL_GPUTextureRegion){ SrcTextures[0], 1, 0, x1, y1, 0, 16, 16, 1 });
+
+		// 2D Array
+		QueueReservedTextureUpload(&uploads, baseMipData, &(SDL_GPUTextureRegion){ SrcTextures[1], 0, 1, x0, y0, 0, 32, 32, 1 });
+		QueueReservedTextureUpload(&uploads, secondMipData, &(SDL_GPUTextureRegion){ SrcTextures[1], 1, 1, x1, y1, 0, 16, 16, 1 });
+
+		// 3D
+		QueueReservedTextureUpload(&uploads, baseMipData, &(SDL_GPUTextureRegion){ SrcTextures[2], 0, 0, x0, y0, 1, 32, 32, 1 });
+		QueueReservedTextureUpload(&uploads, secondMipData, &(SDL_GPUTextureRegion){ SrcTextures[2], 1, 0, x1, y1, 0, 16, 16, 1 });
+
+		// Cubemap
+		QueueReservedTextureUpload(&uploads, baseMipData, &(SDL_GPUTextureRegion){ SrcTextures[3], 0, 1, x0, y0, 0, 32, 32, 1 });
+		QueueReservedTextureUpload(&uploads, secondMipData, &(SDL_GPUTextureRegion){ SrcTextures[3], 1, 1, x1, y1, 0, 16, 16, 1 });
+
+		// Cubemap Array
+		QueueReservedTextureUpload(&uploads, baseMipData, &(SDL_GPUTextureRegion){ SrcTextures[4], 0, 7, x0, y0, 0, 32, 32, 1 });
+		QueueReservedTextureUpload(&uploads, secondMipData, &(SDL_GPUTextureRegion){ SrcTextures[4], 1, 7, x1, y1, 0, 16, 16, 1 });
 	}
-	SDL_UnmapGPUTransferBuffer(context->Device, uploadTransferBuffer);
 
 	// Create the download transfer buffer
 
@@ -158,79 +179,50 @@ static int Init(Context* context)
 	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
 
-	for (int i = 0; i < 4; i += 1)
-	{
-		Uint32 offset = i * (baseMipDataSize + secondMipDataSize);
-		Uint32 x0 = (i % 2) * 32;
-		Uint32 y0 = (i / 2) * 32;
-		Uint32 x1 = (i % 2) * 16;
-		Uint32 y1 = (i / 2) * 16;
+	RecordUploadBatch(&uploads, copyPass);
 
-		SDL_GPUTextureTransferInfo baseMipTransferInfo = { uploadTransferBuffer, offset };
-		SDL_GPUTextureTransferInfo secondMipTransferInfo = { uploadTransferBuffer, offset + baseMipDataSize };
+	// We'll download the final section to sanity-check that the values are what we'd expect
+	{
+		Uint32 x0 = 32;
+		Uint32 y0 = 32;
+		Uint32 x1 = 16;
+		Uint32 y1 = 16;
+		Uint32 downloadOffset = 0;
 
 		// 2D
-		SDL_UploadToGPUTexture(copyPass, &baseMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[0], 0, 0, x0, y0, 0, 32, 32, 1 }, false);
-		SDL_UploadToGPUTexture(copyPass, &secondMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[0], 1, 0, x1, y1, 0, 16, 16, 1 }, false);
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[0], 0, 0, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[0], 1, 0, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
+		downloadOffset += baseMipDataSize + secondMipDataSize;
 
 		// 2D Array
-		SDL_UploadToGPUTexture(copyPass, &baseMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[1], 0, 1, x0, y0, 0, 32, 32, 1 }, false);
-		SDL_UploadToGPUTexture(copyPass, &secondMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[1], 1, 1, x1, y1, 0, 16, 16, 1 }, false);
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[1], 0, 1, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[1], 1, 1, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
+		downloadOffset += baseMipDataSize + secondMipDataSize;
 
 		// 3D
-		SDL_UploadToGPUTexture(copyPass, &baseMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[2], 0, 0, x0, y0, 1, 32, 32, 1 }, false);
-		SDL_UploadToGPUTexture(copyPass, &secondMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[2], 1, 0, x1, y1, 0, 16, 16, 1 }, false);
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[2], 0, 0, x0, y0, 1, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[2], 1, 0, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
+		downloadOffset += baseMipDataSize + secondMipDataSize;
 
 		// Cubemap
-		SDL_UploadToGPUTexture(copyPass, &baseMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[3], 0, 1, x0, y0, 0, 32, 32, 1 }, false);
-		SDL_UploadToGPUTexture(copyPass, &secondMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[3], 1, 1, x1, y1, 0, 16, 16, 1 }, false);
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[3], 0, 1, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[3], 1, 1, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
+		downloadOffset += baseMipDataSize + secondMipDataSize;
 
 		// Cubemap Array
-		SDL_UploadToGPUTexture(copyPass, &baseMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[4], 0, 7, x0, y0, 0, 32, 32, 1 }, false);
-		SDL_UploadToGPUTexture(copyPass, &secondMipTransferInfo, &(SDL_GPUTextureRegion){ SrcTextures[4], 1, 7, x1, y1, 0, 16, 16, 1 }, false);
-
-		// On the final section, we'll download to sanity-check that the values are what we'd expect
-		if (i == 3)
-		{
-			Uint32 downloadOffset = 0;
-
-			// 2D
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[0], 0, 0, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[0], 1, 0, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
-			downloadOffset += baseMipDataSize + secondMipDataSize;
-
-			// 2D Array
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[1], 0, 1, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[1], 1, 1, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
-			downloadOffset += baseMipDataSize + secondMipDataSize;
-
-			// 3D
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[2], 0, 0, x0, y0, 1, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[2], 1, 0, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
-			downloadOffset += baseMipDataSize + secondMipDataSize;
-
-			// Cubemap
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[3], 0, 1, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[3], 1, 1, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
-			downloadOffset += baseMipDataSize + secondMipDataSize;
-
-			// Cubemap Array
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[4], 0, 7, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
-			SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[4], 1, 7, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
-		}
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[4], 0, 7, x0, y0, 0, 32, 32, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset });
+		SDL_DownloadFromGPUTexture(copyPass, &(SDL_GPUTextureRegion){ SrcTextures[4], 1, 7, x1, y1, 0, 16, 16, 1 }, &(SDL_GPUTextureTransferInfo){ downloadTransferBuffer, downloadOffset + baseMipDataSize });
 	}
 
 	SDL_EndGPUCopyPass(copyPass);
-	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
-
-	// Readback
-
-	if (!SDL_WaitForGPUFences(context->Device, true, &fence, 1))
+	if (!SubmitStagingCommandBuffer(context->Device, commandBuffer))
 	{
-		SDL_Log("WaitForGPUFences failed: %s", SDL_GetError());
 		return -1;
 	}
-	SDL_ReleaseGPUFence(context->Device, fence);
+
+	// Readback
+
+	WaitForStagingSubmissions(context->Device);
 
 	Uint8* downloadPtr = SDL_MapGPUTransferBuffer(context->Device, downloadTransferBuffer, false);
 	for (int i = 0; i < 5; i += 1)
@@ -264,7 +256,6 @@ static int Init(Context* context)
 		SDL_DestroySurface(baseMips[i]);
 		SDL_DestroySurface(secondMips[i]);
 	}
-	SDL_ReleaseGPUTransferBuffer(context->Device, uploadTransferBuffer);
 	SDL_ReleaseGPUTransferBuffer(context->Device, downloadTransferBuffer);
 
 	// Set up the program
@@ -313,9 +304,9 @@ static int Draw(Context* context)
 	}
 
 	SDL_GPUTexture* swapchainTexture;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL))
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, NULL, NULL))
 	{
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -451,7 +442,7 @@ static int Draw(Context* context)
 			}
 		);
 
-		SDL_SubmitGPUCommandBuffer(cmdbuf);
+		SubmitCommandBuffer(cmdbuf);
 	}
 	else
 	{
@@ -43,6 +43,12 @@ static int w, h;
 
 static void ChangeSwapchainComposition(Context* context, Uint32 selectionIndex)
 {
+	if (context->Headless)
+	{
+		SDL_Log("Rendering offscreen, there's no swapchain composition to change");
+		return;
+	}
+
 	if (SDL_WindowSupportsGPUSwapchainComposition(context->Device, context->Window, swapchainCompositions[selectionIndex]))
 	{
 		currentSwapchainComposition = swapchainCompositions[selectionIndex];
@@ -84,8 +90,7 @@ static int Init(Context* context)
 		return result;
 	}
 
-	int n;
-	float *hdrImageData = LoadHDRImage("memorial.hdr", &w, &h, &n, 4);
+	Uint16 *hdrImageData = LoadHDRImageHalf("memorial.hdr", &w, &h);
 
 	if (hdrImageData == NULL)
 	{
@@ -111,7 +116,7 @@ static int Init(Context* context)
 
 	HDRTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
 		.type = SDL_GPU_TEXTURETYPE_2D,
-		.format = SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT,
+		.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
 		.width = w,
 		.height = h,
 		.layer_count_or_depth = 1,
@@ -139,24 +144,13 @@ static int Init(Context* context)
 		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
 	});
 
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
-
-	SDL_GPUTransferBuffer* imageDataTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = sizeof(float) * 4 * w * h
-		}
-	);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
-	Uint8* imageTransferPtr = SDL_MapGPUTransferBuffer(
-		context->Device,
-		imageDataTransferBuffer,
-		false
-	);
-	SDL_memcpy(imageTransferPtr, hdrImageData, sizeof(float) * 4 * w * h);
-	SDL_UnmapGPUTransferBuffer(context->Device, imageDataTransferBuffer);
+	StagingAllocation imageDataStaging;
+	Uint8* imageTransferPtr = MapStagingMemory(context->Device, sizeof(Uint16) * 4 * w * h, 0, &imageDataStaging);
+	SDL_memcpy(imageTransferPtr, hdrImageData, sizeof(Uint16) * 4 * w * h);
+	UnmapStagingMemory(context->Device, &imageDataStaging);
 
 	SDL_free(hdrImageData);
 
@@ -166,8 +160,8 @@ static int Init(Context* context)
 	SDL_UploadToGPUTexture(
 		copyPass,
 		&(SDL_GPUTextureTransferInfo) {
-			.transfer_buffer = imageDataTransferBuffer,
-			.offset = 0, /* Zeroes out the rest */
+			.transfer_buffer = imageDataStaging.TransferBuffer,
+			.offset = imageDataStaging.Offset, /* Zeroes out the rest */
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = HDRTexture,
@@ -180,9 +174,7 @@ static int Init(Context* context)
 
 	SDL_EndGPUCopyPass(copyPass);
 
-	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-
-	SDL_ReleaseGPUTransferBuffer(context->Device, imageDataTransferBuffer);
+	SubmitStagingCommandBuffer(context->Device, uploadCmdBuf);
 
 	tonemapOperators[0] = BuildPostProcessComputePipeline(context->Device, "ToneMapReinhard.comp");
 	tonemapOperators[1] = BuildPostProcessComputePipeline(context->Device, "ToneMapExtendedReinhardLuminance.comp");
@@ -251,8 +243,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 swapchainWidth, swapchainHeight;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &swapchainWidth, &swapchainHeight)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &swapchainWidth, &swapchainHeight)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -335,7 +327,7 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -344,19 +336,17 @@ static void Quit(Context* context)
 {
 	for (Sint32 i = 0; i < tonemapOperatorCount; i += 1)
 	{
-		SDL_ReleaseGPUComputePipeline(context->Device, tonemapOperators[i]);
+		ReleaseComputePipeline(context->Device, tonemapOperators[i]);
 	}
 
-	SDL_ReleaseGPUComputePipeline(context->Device, LinearToSRGBPipeline);
-	SDL_ReleaseGPUComputePipeline(context->Device, LinearToST2084Pipeline);
+	ReleaseComputePipeline(context->Device, LinearToSRGBPipeline);
+	ReleaseComputePipeline(context->Device, LinearToST2084Pipeline);
 
 	SDL_ReleaseGPUTexture(context->Device, HDRTexture);
 	SDL_ReleaseGPUTexture(context->Device, ToneMapTexture);
 	SDL_ReleaseGPUTexture(context->Device, TransferTexture);
 
-	SDL_ReleaseWindowFromGPUDevice(context->Device, context->Window);
-	SDL_DestroyWindow(context->Window);
-	SDL_DestroyGPUDevice(context->Device);
+	CommonQuit(context);
 }
 
 Example ToneMapping_Example = { "ToneMapping", Init, Update, Draw, Quit };
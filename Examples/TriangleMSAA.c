@@ -33,7 +33,7 @@ static int Init(Context* context)
 	}
 
 	// Create the pipelines
-	RTFormat = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window);
+	RTFormat = GetFrameTextureFormat(context->Device, context->Window);
 	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
 		.target_info = {
 			.num_color_targets = 1,
@@ -58,7 +58,7 @@ static int Init(Context* context)
 			continue;
 		}
 		pipelineCreateInfo.multisample_state.sample_count = sample_count;
-		Pipelines[SampleCounts] = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		Pipelines[SampleCounts] = AcquireGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (Pipelines[SampleCounts] == NULL)
 		{
 			SDL_Log("Failed to create pipeline!");
@@ -82,7 +82,7 @@ static int Init(Context* context)
 		MSAARenderTextures[SampleCounts] = SDL_CreateGPUTexture(context->Device, &textureCreateInfo);
 		if (MSAARenderTextures[SampleCounts] == NULL) {
 			SDL_Log("Failed to create MSAA render target texture!");
-			SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[SampleCounts]);
+			ReleaseGraphicsPipeline(context->Device, Pipelines[SampleCounts]);
 		}
 		SampleCounts += 1;
 	}
@@ -102,8 +102,8 @@ static int Init(Context* context)
 	);
 
 	// Clean up shader resources
-	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	ReleaseShader(context->Device, vertexShader);
+	ReleaseShader(context->Device, fragmentShader);
 
 	// Print the instructions
 	SDL_Log("Press Left/Right to cycle between sample counts");
@@ -151,8 +151,8 @@ static int Draw(Context* context)
 
 	SDL_GPUTexture* swapchainTexture;
 	Uint32 w, h;
-	if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
-		SDL_Log("WaitAndAcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+	if (!AcquireFrameTexture(cmdbuf, context->Window, &swapchainTexture, &w, &h)) {
+		SDL_Log("AcquireFrameTexture failed: %s", SDL_GetError());
 		return -1;
 	}
 
@@ -197,7 +197,7 @@ static int Draw(Context* context)
 		);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	SubmitCommandBuffer(cmdbuf);
 
 	return 0;
 }
@@ -206,7 +206,7 @@ static void Quit(Context* context)
 {
 	for (int i = 0; i < SampleCounts; i += 1)
 	{
-		SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[i]);
+		ReleaseGraphicsPipeline(context->Device, Pipelines[i]);
 		SDL_ReleaseGPUTexture(context->Device, MSAARenderTextures[i]);
 	}
 	SDL_ReleaseGPUTexture(context->Device, ResolveTexture);
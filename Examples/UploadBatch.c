@@ -0,0 +1,338 @@
+#include "Common.h"
+
+// Upload Batching
+// Payloads are packed into ranges of staging memory, growing the current range in place while
+// its page has room and starting a new one when it doesn't. Recording walks the queue in order,
+// so buffer uploads queued back to back from and to contiguous memory become a single copy.
+
+#define UPLOAD_BATCH_RANGE_SIZE (1024 * 1024)
+#define TEXTURE_UPLOAD_ALIGNMENT 512
+
+typedef struct QueuedUpload
+{
+	bool IsTexture;
+	SDL_GPUTransferBuffer* TransferBuffer;
+	Uint32 TransferOffset;
+	SDL_GPUBufferRegion BufferRegion;
+	SDL_GPUTextureRegion TextureRegion;
+} QueuedUpload;
+
+// A staging allocation the batch packs payloads into, mapped until the batch is recorded
+typedef struct UploadRange
+{
+	StagingAllocation Allocation;
+	Uint32 Used;
+	Uint8* Data;
+} UploadRange;
+
+void BeginUploadBatch(UploadBatch* batch, SDL_GPUDevice* device)
+{
+	SDL_zerop(batch);
+	batch->Device = device;
+}
+
+static Uint8* ReserveUploadSpace(
+	UploadBatch* batch,
+	Uint32 size,
+	Uint32 alignment,
+	SDL_GPUTransferBuffer** pTransferBuffer,
+	Uint32* pTransferOffset
+) {
+	UploadRange* range = (batch->RangeCount > 0) ? &batch->Ranges[batch->RangeCount - 1] : NULL;
+	if (range != NULL)
+	{
+		// Alignment is relative to the transfer buffer, not to the start of the range
+		Uint32 end = range->Allocation.Offset + range->Used;
+		Uint32 offset = (end + alignment - 1) / alignment * alignment - range->Allocation.Offset;
+		if (offset + size <= range->Allocation.Size ||
+			ResizeStagingMemory(batch->Device, &range->Allocation, SDL_max(offset + size, range->Allocation.Size * 2)) ||
+			ResizeStagingMemory(batch->Device, &range->Allocation, offset + size))
+		{
+			range->Used = offset + size;
+			*pTransferBuffer = range->Allocation.TransferBuffer;
+			*pTransferOffset = range->Allocation.Offset + offset;
+			return range->Data + offset;
+		}
+	}
+
+	if (batch->RangeCount == batch->RangeCapacity)
+	{
+		int capacity = SDL_max(batch->RangeCapacity * 2, 4);
+		UploadRange* ranges = SDL_realloc(batch->Ranges, capacity * sizeof(UploadRange));
+		if (ranges == NULL)
+		{
+			SDL_Log("Out of memory, can't reserve %u bytes of upload space!", size);
+			return NULL;
+		}
+		batch->Ranges = ranges;
+		batch->RangeCapacity = capacity;
+	}
+
+	range = &batch->Ranges[batch->RangeCount];
+	range->Data = MapStagingMemory(
+		batch->Device,
+		SDL_max(size, UPLOAD_BATCH_RANGE_SIZE),
+		TEXTURE_UPLOAD_ALIGNMENT,
+		&range->Allocation
+	);
+	if (range->Data == NULL)
+	{
+		return NULL;
+	}
+	batch->RangeCount += 1;
+	batch->Stats.StagingRanges += 1;
+
+	range->Used = size;
+	*pTransferBuffer = range->Allocation.TransferBuffer;
+	*pTransferOffset = range->Allocation.Offset;
+	return range->Data;
+}
+
+static QueuedUpload* AddQueuedUpload(UploadBatch* batch)
+{
+	if (batch->UploadCount == batch->UploadCapacity)
+	{
+		int capacity = SDL_max(batch->UploadCapacity * 2, 16);
+		QueuedUpload* uploads = SDL_realloc(batch->Uploads, capacity * sizeof(QueuedUpload));
+		if (uploads == NULL)
+		{
+			SDL_Log("Out of memory, can't queue another upload!");
+			return NULL;
+		}
+		batch->Uploads = uploads;
+		batch->UploadCapacity = capacity;
+	}
+
+	QueuedUpload* upload = &batch->Uploads[batch->UploadCount++];
+	SDL_zerop(upload);
+	batch->Stats.Uploads += 1;
+	return upload;
+}
+
+void* QueueBufferUpload(UploadBatch* batch, SDL_GPUBuffer* buffer, Uint32 offset, Uint32 size)
+{
+	SDL_GPUTransferBuffer* transferBuffer;
+	Uint32 transferOffset;
+	Uint8* data = ReserveUploadSpace(batch, size, 16, &transferBuffer, &transferOffset);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+
+	QueuedUpload* upload = AddQueuedUpload(batch);
+	if (upload == NULL)
+	{
+		return NULL;
+	}
+	upload->TransferBuffer = transferBuffer;
+	upload->TransferOffset = transferOffset;
+	upload->BufferRegion = (SDL_GPUBufferRegion) {
+		.buffer = buffer,
+		.offset = offset,
+		.size = size
+	};
+	batch->Stats.Bytes += size;
+	return data;
+}
+
+void* QueueTextureUpload(UploadBatch* batch, SDL_GPUTextureFormat format, const SDL_GPUTextureRegion* region)
+{
+	Uint32 size = SDL_CalculateGPUTextureFormatSize(format, region->w, region->h, region->d);
+
+	SDL_GPUTransferBuffer* transferBuffer;
+	Uint32 transferOffset;
+	Uint8* data = ReserveUploadSpace(batch, size, TEXTURE_UPLOAD_ALIGNMENT, &transferBuffer, &transferOffset);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+
+	QueuedUpload* upload = AddQueuedUpload(batch);
+	if (upload == NULL)
+	{
+		return NULL;
+	}
+	upload->IsTexture = true;
+	upload->TransferBuffer = transferBuffer;
+	upload->TransferOffset = transferOffset;
+	upload->TextureRegion = *region;
+	batch->Stats.Bytes += size;
+	return data;
+}
+
+void* ReserveUploadData(UploadBatch* batch, Uint32 size)
+{
+	SDL_GPUTransferBuffer* transferBuffer;
+	Uint32 transferOffset;
+	Uint8* data = ReserveUploadSpace(batch, size, TEXTURE_UPLOAD_ALIGNMENT, &transferBuffer, &transferOffset);
+	if (data != NULL)
+	{
+		batch->Stats.Bytes += size;
+	}
+	return data;
+}
+
+void QueueReservedTextureUpload(UploadBatch* batch, const void* data, const SDL_GPUTextureRegion* region)
+{
+	const UploadRange* range = NULL;
+	for (int i = 0; i < batch->RangeCount; i += 1)
+	{
+		const Uint8* start = batch->Ranges[i].Data;
+		if ((const Uint8*) data >= start && (const Uint8*) data < start + batch->Ranges[i].Used)
+		{
+			range = &batch->Ranges[i];
+			break;
+		}
+	}
+	if (range == NULL)
+	{
+		SDL_Log("Upload data wasn't reserved from this upload batch!");
+		return;
+	}
+
+	QueuedUpload* upload = AddQueuedUpload(batch);
+	if (upload == NULL)
+	{
+		return;
+	}
+	upload->IsTexture = true;
+	upload->TransferBuffer = range->Allocation.TransferBuffer;
+	upload->TransferOffset = range->Allocation.Offset + (Uint32) ((const Uint8*) data - range->Data);
+	upload->TextureRegion = *region;
+}
+
+void QueueCompressedImageUpload(UploadBatch* batch, const void* data, SDL_GPUTexture* texture, const CompressedImage* image)
+{
+	for (int i = 0; i < image->SubresourceCount; i += 1)
+	{
+		const CompressedImageSubresource* subresource = &image->Subresources[i];
+		QueueReservedTextureUpload(
+			batch,
+			(const Uint8*) data + subresource->Offset,
+			&(SDL_GPUTextureRegion) {
+				.texture = texture,
+				.mip_level = subresource->MipLevel,
+				.layer = subresource->Layer,
+				.w = subresource->Width,
+				.h = subresource->Height,
+				.d = 1
+			}
+		);
+	}
+}
+
+static void EndUploadBatch(UploadBatch* batch)
+{
+	for (int i = 0; i < batch->RangeCount; i += 1)
+	{
+		UnmapStagingMemory(batch->Device, &batch->Ranges[i].Allocation);
+	}
+
+	SDL_free(batch->Uploads);
+	SDL_free(batch->Ranges);
+	batch->Uploads = NULL;
+	batch->Ranges = NULL;
+	batch->UploadCount = batch->UploadCapacity = 0;
+	batch->RangeCount = batch->RangeCapacity = 0;
+}
+
+void RecordUploadBatch(UploadBatch* batch, SDL_GPUCopyPass* copyPass)
+{
+	// Give back what the last range grew into but didn't use
+	int rangeCount = batch->RangeCount;
+	if (rangeCount > 0)
+	{
+		UploadRange* range = &batch->Ranges[rangeCount - 1];
+		ResizeStagingMemory(batch->Device, &range->Allocation, range->Used);
+	}
+
+	// The ranges have to be unmapped before anything reads from them
+	for (int i = 0; i < batch->RangeCount; i += 1)
+	{
+		UnmapStagingMemory(batch->Device, &batch->Ranges[i].Allocation);
+	}
+	batch->RangeCount = 0;
+
+	for (int i = 0; i < batch->UploadCount; i += 1)
+	{
+		QueuedUpload* upload = &batch->Uploads[i];
+		if (upload->IsTexture)
+		{
+			SDL_UploadToGPUTexture(
+				copyPass,
+				&(SDL_GPUTextureTransferInfo) {
+					.transfer_buffer = upload->TransferBuffer,
+					.offset = upload->TransferOffset
+				},
+				&upload->TextureRegion,
+				false
+			);
+			batch->Stats.Copies += 1;
+			continue;
+		}
+
+		// Fold in the following uploads while both sides stay contiguous
+		SDL_GPUBufferRegion region = upload->BufferRegion;
+		while (i + 1 < batch->UploadCount)
+		{
+			const QueuedUpload* next = &batch->Uploads[i + 1];
+			if (next->IsTexture ||
+				next->TransferBuffer != upload->TransferBuffer ||
+				next->TransferOffset != upload->TransferOffset + region.size ||
+				next->BufferRegion.buffer != region.buffer ||
+				next->BufferRegion.offset != region.offset + region.size)
+			{
+				break;
+			}
+			region.size += next->BufferRegion.size;
+			i += 1;
+		}
+
+		SDL_UploadToGPUBuffer(
+			copyPass,
+			&(SDL_GPUTransferBufferLocation) {
+				.transfer_buffer = upload->TransferBuffer,
+				.offset = upload->TransferOffset
+			},
+			&region,
+			false
+		);
+		batch->Stats.Copies += 1;
+	}
+
+	SDL_Log(
+		"Upload batch: %d uploads (%" SDL_PRIu64 " bytes) recorded as %d copies from %d staging range(s)",
+		batch->Stats.Uploads,
+		batch->Stats.Bytes,
+		batch->Stats.Copies,
+		rangeCount
+	);
+	EndUploadBatch(batch);
+}
+
+bool FlushUploadBatch(UploadBatch* batch)
+{
+	if (batch->UploadCount == 0)
+	{
+		EndUploadBatch(batch);
+		return true;
+	}
+
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(batch->Device);
+	if (commandBuffer == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		CancelUploadBatch(batch);
+		return false;
+	}
+
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+	RecordUploadBatch(batch, copyPass);
+	SDL_EndGPUCopyPass(copyPass);
+	return SubmitStagingCommandBuffer(batch->Device, commandBuffer);
+}
+
+void CancelUploadBatch(UploadBatch* batch)
+{
+	EndUploadBatch(batch);
+}
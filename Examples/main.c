@@ -41,6 +41,20 @@ static Example* Examples[] =
 	&Bloom_Example
 };
 
+// Stops the worker pools, so no other thread records, then writes the trace of everything profiled
+// since -trace enabled it. Every exit after InitializeAssetLoader goes through here.
+static int QuitRunner(const char* tracePath, int result)
+{
+	QuitSpriteBuilder();
+	QuitAssetLoader();
+	if (tracePath != NULL)
+	{
+		WriteProfileTrace(tracePath);
+	}
+	QuitProfiler();
+	return result;
+}
+
 bool AppLifecycleWatcher(void *userdata, SDL_Event *event)
 {
 	/* This callback may be on a different thread, so let's
@@ -74,6 +88,21 @@ int main(int argc, char **argv)
 	int gotoExampleIndex = 0;
 	int quit = 0;
 	float lastTime = 0;
+	bool benchmarkLoader = false;
+	bool benchmarkSprites = false;
+	bool benchmarkRadixSort = false;
+	bool checkDecoders = false;
+	BenchmarkOptions benchmark = {
+		.WarmupFrames = 30,
+		.MeasuredFrames = 300,
+		.Seed = 1,
+		.TimingTolerance = 10,
+		.CountTolerance = 0
+	};
+	const char* tracePath = NULL;
+	const char* packAssetsPath = NULL;
+	bool logCommandStats = false;
+	Uint64 commandStatsLogTime = 0;
 
 	for (int i = 1; i < argc; i += 1)
 	{
@@ -98,6 +127,107 @@ int main(int argc, char **argv)
 				return 1;
 			}
 		}
+		else if (SDL_strcmp(argv[i], "-loaderbench") == 0)
+		{
+			benchmarkLoader = true;
+		}
+		else if (SDL_strcmp(argv[i], "-spritebench") == 0)
+		{
+			benchmarkSprites = true;
+		}
+		else if (SDL_strcmp(argv[i], "-radixbench") == 0)
+		{
+			benchmarkRadixSort = true;
+		}
+		else if (SDL_strcmp(argv[i], "-decodercheck") == 0)
+		{
+			checkDecoders = true;
+		}
+		else if (SDL_strcmp(argv[i], "-bench") == 0 && argc > i + 1)
+		{
+			benchmark.Name = argv[i + 1];
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-frames") == 0 && argc > i + 1)
+		{
+			benchmark.MeasuredFrames = SDL_max(SDL_atoi(argv[i + 1]), 1);
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-warmup") == 0 && argc > i + 1)
+		{
+			benchmark.WarmupFrames = SDL_max(SDL_atoi(argv[i + 1]), 0);
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-json") == 0 && argc > i + 1)
+		{
+			benchmark.JSONPath = argv[i + 1];
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-seed") == 0 && argc > i + 1)
+		{
+			benchmark.Seed = SDL_strtoull(argv[i + 1], NULL, 10);
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-baseline") == 0 && argc > i + 1)
+		{
+			benchmark.BaselinePath = argv[i + 1];
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-tolerance") == 0 && argc > i + 1)
+		{
+			benchmark.TimingTolerance = SDL_max(SDL_atof(argv[i + 1]), 0);
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-counttolerance") == 0 && argc > i + 1)
+		{
+			benchmark.CountTolerance = SDL_max(SDL_atof(argv[i + 1]), 0);
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-trace") == 0)
+		{
+			tracePath = "trace.json";
+			if (argc > i + 1 && argv[i + 1][0] != '-')
+			{
+				tracePath = argv[i + 1];
+				i += 1;
+			}
+		}
+		else if (SDL_strcmp(argv[i], "-commandstats") == 0)
+		{
+#ifdef SDL_GPU_EXAMPLES_INSTRUMENTATION
+			logCommandStats = true;
+#else
+			SDL_Log("-commandstats needs a build with SDL_GPU_EXAMPLES_INSTRUMENTATION");
+			return 1;
+#endif
+		}
+		else if (SDL_strcmp(argv[i], "-packassets") == 0 && argc > i + 1)
+		{
+			packAssetsPath = argv[i + 1];
+			i += 1;
+		}
+		else if (SDL_strcmp(argv[i], "-compresstextures") == 0)
+		{
+			SetImageCompressionEnabled(true);
+		}
+		else if (SDL_strcmp(argv[i], "-readbacklatency") == 0 && argc > i + 1)
+		{
+			SetReadbackLatency(SDL_atoi(argv[i + 1]));
+			i += 1;
+		}
+	}
+
+	// Benchmarks and the decoder check need no display: windows go to the offscreen video driver
+	// (unless SDL_VIDEO_DRIVER says otherwise) and are never claimed for the GPU
+	if (benchmark.Name != NULL || checkDecoders)
+	{
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+		SetHeadlessRendering(true);
+	}
+
+	if (tracePath != NULL)
+	{
+		SetProfilingEnabled(true);
 	}
 
 	if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
@@ -107,6 +237,45 @@ int main(int argc, char **argv)
 	}
 
 	InitializeAssetLoader();
+
+	if (packAssetsPath != NULL)
+	{
+		bool packed = WriteAssetArchive(packAssetsPath);
+		return QuitRunner(tracePath, packed ? 0 : 1);
+	}
+
+	if (benchmarkLoader)
+	{
+		BenchmarkAssetLoader();
+		BenchmarkHDRDecode();
+		return QuitRunner(tracePath, 0);
+	}
+
+	if (benchmarkSprites)
+	{
+		BenchmarkSpriteBuilder();
+		BenchmarkSpriteUploads();
+		return QuitRunner(tracePath, 0);
+	}
+
+	if (benchmark.Name != NULL)
+	{
+		int failures = RunBenchmarks(&benchmark, Examples, SDL_arraysize(Examples));
+		return QuitRunner(tracePath, failures > 0 ? 1 : 0);
+	}
+
+	if (benchmarkRadixSort)
+	{
+		BenchmarkRadixSort();
+		return QuitRunner(tracePath, 0);
+	}
+
+	if (checkDecoders)
+	{
+		int failures = CheckTextureDecoders();
+		return QuitRunner(tracePath, failures != 0 ? 1 : 0);
+	}
+
 	SDL_AddEventWatch(AppLifecycleWatcher, NULL);
 
 	SDL_Log("Welcome to the SDL_GPU example suite!");
@@ -248,11 +417,14 @@ int main(int argc, char **argv)
 			exampleIndex = gotoExampleIndex;
 			context.ExampleName = Examples[exampleIndex]->Name;
 			SDL_Log("STARTING EXAMPLE: %s", context.ExampleName);
+			PROFILE_BEGIN("Init");
 			if (Examples[exampleIndex]->Init(&context) < 0)
 			{
 				SDL_Log("Init failed!");
-				return 1;
+				return QuitRunner(tracePath, 1);
 			}
+			PROFILE_END();
+			EndCommandStatsFrame();
 
 			gotoExampleIndex = -1;
 		}
@@ -261,21 +433,36 @@ int main(int argc, char **argv)
 		context.DeltaTime = newTime - lastTime;
 		lastTime = newTime;
 
+		PROFILE_BEGIN(context.ExampleName);
+		PROFILE_BEGIN("Update");
 		if (Examples[exampleIndex]->Update(&context) < 0)
 		{
 			SDL_Log("Update failed!");
-			return 1;
+			return QuitRunner(tracePath, 1);
 		}
+		PROFILE_END();
 
 		if (canDraw)
 		{
+			PROFILE_BEGIN("Draw");
 			if (Examples[exampleIndex]->Draw(&context) < 0)
 			{
 				SDL_Log("Draw failed!");
-				return 1;
+				return QuitRunner(tracePath, 1);
 			}
+			PROFILE_END();
+		}
+
+		UpdateReadbacks(context.Device);
+		PROFILE_END();
+
+		CommandStats commands = EndCommandStatsFrame();
+		if (logCommandStats && SDL_GetTicks() - commandStatsLogTime >= 1000)
+		{
+			LogCommandStats(&commands);
+			commandStatsLogTime = SDL_GetTicks();
 		}
 	}
 
-	return 0;
+	return QuitRunner(tracePath, 0);
 }